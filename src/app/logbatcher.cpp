@@ -0,0 +1,114 @@
+#include "logbatcher.h"
+
+#include <QTimer>
+#include <QDebug>
+
+LogBatcher::LogBatcher(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<LogEntry>();
+    qRegisterMetaType<QList<LogEntry>>();
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(m_intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &LogBatcher::flush);
+}
+
+LogBatcher::~LogBatcher()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending.isEmpty()) {
+        qDebug() << "[LogBatcher] Discarding" << m_pending.size() << "undelivered messages";
+    }
+}
+
+void LogBatcher::setInterval(int intervalMs)
+{
+    m_intervalMs = intervalMs;
+    m_timer->setInterval(intervalMs);
+}
+
+void LogBatcher::setMaxBatchSize(int size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBatchSize = qMax(1, size);
+}
+
+void LogBatcher::post(LogLevel level, const QString &message)
+{
+    if (int(level) < m_minimumLevel.load()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.size() >= m_maxBatchSize) {
+        m_pending.removeFirst();
+        m_dropped++;
+    }
+    m_pending.append({level, message});
+    scheduleFlush();
+}
+
+int LogBatcher::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.size();
+}
+
+void LogBatcher::updateProgress(int current, int total, const QString &message)
+{
+    QMutexLocker locker(&m_mutex);
+    m_hasProgress = true;
+    m_progressCurrent = current;
+    m_progressTotal = total;
+    m_progressMessage = message;
+    scheduleFlush();
+}
+
+void LogBatcher::scheduleFlush()
+{
+    if (m_flushScheduled) {
+        return;
+    }
+    m_flushScheduled = true;
+
+    // One queued call per batch rather than per message; the timer has to
+    // be started from the batcher's own thread
+    QMetaObject::invokeMethod(m_timer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+}
+
+void LogBatcher::flush()
+{
+    QList<LogEntry> entries;
+    int dropped;
+    bool hasProgress;
+    int current, total;
+    QString progressMessage;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries.swap(m_pending);
+        dropped = m_dropped;
+        m_dropped = 0;
+        hasProgress = m_hasProgress;
+        m_hasProgress = false;
+        current = m_progressCurrent;
+        total = m_progressTotal;
+        progressMessage = m_progressMessage;
+        m_flushScheduled = false;
+    }
+    m_timer->stop();
+
+    if (dropped > 0) {
+        entries.prepend({LogLevel::Warning,
+                         QString("%1 earlier messages not shown").arg(dropped)});
+    }
+
+    if (!entries.isEmpty()) {
+        m_batchesDelivered++;
+        emit entriesReady(entries);
+    }
+    if (hasProgress) {
+        emit progressUpdated(current, total, progressMessage);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef LOGBATCHER_H
+#define LOGBATCHER_H
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+class QTimer;
+
+enum class LogLevel {
+    Debug = 0,
+    Info,
+    Warning,
+    Error
+};
+
+struct LogEntry
+{
+    LogLevel level = LogLevel::Info;
+    QString message;
+};
+
+Q_DECLARE_METATYPE(LogEntry)
+
+/**
+ * @brief Collects log and progress messages and delivers them in batches
+ *
+ * A sync logs several lines per record, from the device worker thread and
+ * the conduit pool threads. Delivering each one as its own queued signal
+ * floods the UI thread and slows the sync down.
+ *
+ * The post and progress slots are thread-safe: connect worker signals to
+ * them with Qt::DirectConnection. Messages are queued under a mutex, and
+ * once per interval (50 ms by default) the batcher's own thread emits
+ * everything gathered so far as one entriesReady() and the latest progress
+ * as one progressUpdated(). Messages below the minimum level are dropped
+ * when posted.
+ */
+class LogBatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogBatcher(QObject *parent = nullptr);
+    ~LogBatcher() override;
+
+    void setInterval(int intervalMs);
+    int interval() const { return m_intervalMs; }
+
+    void setMinimumLevel(LogLevel level) { m_minimumLevel = int(level); }
+    LogLevel minimumLevel() const { return LogLevel(m_minimumLevel.load()); }
+
+    /**
+     * @brief Cap on entries held per batch; older ones are dropped beyond it
+     *
+     * LogWidget keeps only the last 1000 lines anyway.
+     */
+    void setMaxBatchSize(int size);
+
+    void post(LogLevel level, const QString &message);
+
+    int pendingCount() const;
+    int batchesDelivered() const { return m_batchesDelivered; }
+
+public slots:
+    void logDebug(const QString &message) { post(LogLevel::Debug, message); }
+    void logInfo(const QString &message) { post(LogLevel::Info, message); }
+    void logWarning(const QString &message) { post(LogLevel::Warning, message); }
+    void logError(const QString &message) { post(LogLevel::Error, message); }
+
+    /**
+     * @brief Record progress; only the latest update per batch is delivered
+     */
+    void updateProgress(int current, int total, const QString &message);
+
+    /**
+     * @brief Deliver what is pending now (call on the batcher's thread)
+     */
+    void flush();
+
+signals:
+    void entriesReady(const QList<LogEntry> &entries);
+    void progressUpdated(int current, int total, const QString &message);
+
+private:
+    void scheduleFlush();   // m_mutex must be held
+
+    QTimer *m_timer;
+    int m_intervalMs = 50;
+    int m_maxBatchSize = 1000;
+    std::atomic<int> m_minimumLevel{int(LogLevel::Info)};
+    int m_batchesDelivered = 0;
+
+    mutable QMutex m_mutex;         // protects everything below
+    QList<LogEntry> m_pending;
+    int m_dropped = 0;
+    bool m_hasProgress = false;
+    int m_progressCurrent = 0;
+    int m_progressTotal = 0;
+    QString m_progressMessage;
+    bool m_flushScheduled = false;
+};
+
+#endif // LOGBATCHER_H
@@ -1,28 +1,82 @@
 #include "logwidget.h"
 
+#include <QScrollBar>
+#include <QTextCursor>
+
+namespace {
+
+QString levelTag(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Debug:   return "[DEBUG]";
+    case LogLevel::Info:    return "[INFO]";
+    case LogLevel::Warning: return "[WARNING]";
+    case LogLevel::Error:   return "[ERROR]";
+    }
+    return "[INFO]";
+}
+
+} // namespace
+
 LogWidget::LogWidget(QWidget *parent)
     : QTextEdit(parent)
 {
     setReadOnly(true);
+    setUndoRedoEnabled(false);
     document()->setMaximumBlockCount(1000); // Limit log size
+
+    m_batcher = new LogBatcher(this);
+    connect(m_batcher, &LogBatcher::entriesReady, this, &LogWidget::appendEntries);
+}
+
+void LogWidget::logDebug(const QString &message)
+{
+    m_batcher->logDebug(message);
 }
 
 void LogWidget::logInfo(const QString &message)
 {
-    append(QString("[INFO] %1").arg(message));
+    m_batcher->logInfo(message);
 }
 
 void LogWidget::logWarning(const QString &message)
 {
-    append(QString("[WARNING] %1").arg(message));
+    m_batcher->logWarning(message);
 }
 
 void LogWidget::logError(const QString &message)
 {
-    append(QString("[ERROR] %1").arg(message));
+    m_batcher->logError(message);
 }
 
 void LogWidget::clear()
 {
+    m_batcher->flush();   // Pending lines belong to the log being cleared
     QTextEdit::clear();
 }
+
+void LogWidget::appendEntries(const QList<LogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    // Stay at the bottom only if the user hasn't scrolled up
+    QScrollBar *scrollBar = verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    for (const LogEntry &entry : entries) {
+        if (!document()->isEmpty()) {
+            cursor.insertBlock();
+        }
+        cursor.insertText(QString("%1 %2").arg(levelTag(entry.level), entry.message));
+    }
+    cursor.endEditBlock();
+
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
@@ -2,12 +2,18 @@
 #define LOGWIDGET_H
 
 #include <QTextEdit>
+#include "logbatcher.h"
 
 /**
  * @brief Simple logging widget for displaying application messages
  *
- * Provides formatted log output with INFO, WARNING, and ERROR levels.
+ * Provides formatted log output with DEBUG, INFO, WARNING, and ERROR levels.
  * Automatically limits the log size to prevent memory issues.
+ *
+ * Messages go through a LogBatcher and are added one batch at a time.
+ * Connect signals from worker threads to batcher() with
+ * Qt::DirectConnection; that way they keep their order with the widget's
+ * own log slots.
  */
 class LogWidget : public QTextEdit
 {
@@ -16,11 +22,22 @@ class LogWidget : public QTextEdit
 public:
     explicit LogWidget(QWidget *parent = nullptr);
 
+    LogBatcher *batcher() const { return m_batcher; }
+
 public slots:
+    void logDebug(const QString &message);
     void logInfo(const QString &message);
     void logWarning(const QString &message);
     void logError(const QString &message);
     void clear();
+
+    /**
+     * @brief Add a batch of messages as a single document edit
+     */
+    void appendEntries(const QList<LogEntry> &entries);
+
+private:
+    LogBatcher *m_batcher;
 };
 
 #endif // LOGWIDGET_H
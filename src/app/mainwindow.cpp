@@ -6,10 +6,12 @@
 #include "../qpilotsync_version.h"
 #include "../palm/kpilotdevicelink.h"
 #include "../palm/devicesession.h"
+#include "../palm/devicewatcher.h"
 #include "../palm/pilotrecord.h"
 #include "../palm/categoryinfo.h"
 #include "../settings.h"
 #include "../settingsdialog.h"
+#include "../synclog.h"
 #include "../profile.h"
 
 #include "../sync/syncengine.h"
@@ -20,7 +22,9 @@
 #include "../sync/conduits/calendarconduit.h"
 #include "../sync/conduits/todoconduit.h"
 #include "../sync/conduits/installconduit.h"
+#include "../sync/conduits/backupconduit.h"
 #include "../sync/conduits/webcalendarconduit.h"
+#include "../sync/conduits/webfeedrefresher.h"
 
 #include <QApplication>
 #include <QMenuBar>
@@ -123,6 +127,7 @@ MainWindow::~MainWindow()
 {
     delete m_session;  // DeviceSession handles disconnection
     m_deviceLink = nullptr;  // Owned by DeviceSession
+    delete m_feedRefresher;  // Joins its thread; uses a conduit owned by the engine
     delete m_syncEngine;
     delete m_currentProfile;
 }
@@ -228,8 +233,8 @@ void MainWindow::onConnectDevice()
         m_currentProfile->save();
     }
 
-    // Check if device exists (skip check for "usb:" protocol)
-    bool deviceExists = devicePath.startsWith("usb:") || QFile::exists(devicePath);
+    // Check if device exists (skip check for "usb:" and "net:" addresses)
+    bool deviceExists = DeviceWatcher::isPseudoDevice(devicePath) || QFile::exists(devicePath);
 
     if (deviceExists) {
         // Device exists - connect immediately
@@ -249,14 +254,18 @@ void MainWindow::startListening(const QString &devicePath)
     m_logWidget->logInfo("Press the HotSync button on your Palm device.");
     statusBar()->showMessage(QString("Waiting for HotSync on %1...").arg(devicePath));
 
-    // Create poll timer if needed
-    if (!m_devicePollTimer) {
-        m_devicePollTimer = new QTimer(this);
-        connect(m_devicePollTimer, &QTimer::timeout, this, &MainWindow::onDevicePoll);
+    // Create device watcher if needed
+    if (!m_deviceWatcher) {
+        m_deviceWatcher = new DeviceWatcher(this);
+        connect(m_deviceWatcher, &DeviceWatcher::deviceAppeared, this, &MainWindow::onDeviceAppeared);
     }
 
-    // Poll every 500ms for device appearance
-    m_devicePollTimer->start(500);
+    // Signalled as soon as the node is created
+    m_deviceWatcher->watch(devicePath);
+    if (m_deviceWatcher->isPresent()) {
+        // Appeared between the check and the watch
+        QTimer::singleShot(0, this, [this, devicePath]() { onDeviceAppeared(devicePath); });
+    }
 
     // Update UI
     m_cancelConnectionAction->setEnabled(true);
@@ -272,8 +281,8 @@ void MainWindow::stopListening()
     m_listeningForDevice = false;
     m_listeningDevicePath.clear();
 
-    if (m_devicePollTimer) {
-        m_devicePollTimer->stop();
+    if (m_deviceWatcher) {
+        m_deviceWatcher->stop();
     }
 
     m_logWidget->logInfo("Stopped listening for HotSync");
@@ -283,26 +292,21 @@ void MainWindow::stopListening()
     updateMenuState(false);
 }
 
-void MainWindow::onDevicePoll()
+void MainWindow::onDeviceAppeared(const QString &devicePath)
 {
-    if (!m_listeningForDevice || m_listeningDevicePath.isEmpty()) {
+    if (!m_listeningForDevice || devicePath != m_listeningDevicePath) {
         return;
     }
 
-    // Check if device appeared
-    if (QFile::exists(m_listeningDevicePath)) {
-        m_logWidget->logInfo(QString("Device %1 detected!").arg(m_listeningDevicePath));
-
-        // Stop polling
-        m_devicePollTimer->stop();
-        m_listeningForDevice = false;
+    m_logWidget->logInfo(QString("Device %1 detected!").arg(devicePath));
 
-        QString devicePath = m_listeningDevicePath;
-        m_listeningDevicePath.clear();
+    // Stop watching
+    m_deviceWatcher->stop();
+    m_listeningForDevice = false;
+    m_listeningDevicePath.clear();
 
-        // Connect to the device
-        startConnection(devicePath);
-    }
+    // Connect to the device
+    startConnection(devicePath);
 }
 
 void MainWindow::startConnection(const QString &devicePath)
@@ -321,6 +325,9 @@ void MainWindow::startConnection(const QString &devicePath)
     if (m_currentProfile) {
         m_session->setConnectionMode(m_currentProfile->connectionMode());
     }
+    if (Settings::instance().dlpTrace()) {
+        m_session->setTraceDirectory(Settings::instance().dlpTraceDirectory());
+    }
 
     // Connect DeviceSession signals
     connect(m_session, &DeviceSession::connectionComplete,
@@ -332,14 +339,23 @@ void MainWindow::startConnection(const QString &devicePath)
     connect(m_session, &DeviceSession::errorOccurred,
             m_logWidget, &LogWidget::logError);
     connect(m_session, &DeviceSession::progressUpdated,
-            this, &MainWindow::onSyncProgress);
+            m_logWidget->batcher(), &LogBatcher::updateProgress);
     connect(m_session, &DeviceSession::palmScreenMessage,
             this, &MainWindow::onSessionPalmScreen);
     connect(m_session, &DeviceSession::installFinished,
             this, &MainWindow::onInstallFinished);
+    connect(m_session, &DeviceSession::backupFinished,
+            this, &MainWindow::onBackupFinished);
+    connect(m_session, &DeviceSession::pendingInstallFinished,
+            this, &MainWindow::onPendingInstallFinished);
+    connect(m_session, &DeviceSession::operationStarted,
+            this, [this]() { m_cancelOperationAction->setEnabled(true); });
+    connect(m_session, &DeviceSession::operationFinished,
+            this, [this]() { m_cancelOperationAction->setEnabled(false); });
     connect(m_session, &DeviceSession::syncFinished,
             this, [this](bool success, const QString &summary) {
                 Q_UNUSED(summary);
+                m_cancelOperationAction->setEnabled(false);
                 statusBar()->showMessage(success ? "Sync complete" : "Sync failed");
             });
     connect(m_session, &DeviceSession::syncResultReady,
@@ -349,6 +365,8 @@ void MainWindow::startConnection(const QString &devicePath)
                 m_deviceLink = nullptr;
                 m_exportHandler->setDeviceLink(nullptr);
                 m_importHandler->setDeviceLink(nullptr);
+                m_syncQueued = false;
+                m_cancelOperationAction->setEnabled(false);
                 updateMenuState(false);
                 statusBar()->showMessage("Disconnected");
             });
@@ -835,7 +853,19 @@ void MainWindow::initializeSyncEngine()
     m_syncEngine->registerConduit(new Sync::ContactConduit());
     m_syncEngine->registerConduit(new Sync::CalendarConduit());
     m_syncEngine->registerConduit(new Sync::TodoConduit());
-    m_syncEngine->registerConduit(new Sync::WebCalendarConduit());
+    auto *webCalendar = new Sync::WebCalendarConduit();
+    m_syncEngine->registerConduit(webCalendar);
+
+    // Download web calendar feeds between syncs, not while the Palm waits
+    m_feedRefresher = new Sync::WebFeedRefresher(webCalendar, this);
+    m_feedRefresher->setIdleCheck([this]() {
+        return m_currentProfile && m_currentProfile->conduitEnabled("webcalendar")
+            && !m_syncEngine->isSyncing();
+    });
+    connect(m_feedRefresher, &Sync::WebFeedRefresher::logMessage,
+            m_logWidget, &LogWidget::logInfo);
+    connect(m_feedRefresher, &Sync::WebFeedRefresher::refreshFinished,
+            this, [this]() { saveConduitSettings(); });
 
     // Create install conduit (handled separately)
     m_installConduit = new Sync::InstallConduit(this);
@@ -849,50 +879,90 @@ void MainWindow::initializeSyncEngine()
                     .arg(fileName).arg(current).arg(total));
             });
 
-    // Connect sync engine signals
-    connect(m_syncEngine, &Sync::SyncEngine::logMessage,
+    // Create device image backup conduit (handled separately)
+    m_backupConduit = new Sync::BackupConduit(this);
+    connect(m_backupConduit, &Sync::BackupConduit::logMessage,
             m_logWidget, &LogWidget::logInfo);
-    connect(m_syncEngine, &Sync::SyncEngine::errorOccurred,
+    connect(m_backupConduit, &Sync::BackupConduit::errorOccurred,
             m_logWidget, &LogWidget::logError);
+    connect(m_backupConduit, &Sync::BackupConduit::progressUpdated,
+            this, [this](int current, int total, const QString &databaseName) {
+                statusBar()->showMessage(QString("Backing up %1 (%2/%3)")
+                    .arg(databaseName).arg(current).arg(total));
+            });
+
+    // Connect sync engine signals. Log and progress go straight into the
+    // batcher from the sync threads instead of one queued event per record.
+    LogBatcher *batcher = m_logWidget->batcher();
+    connect(m_syncEngine, &Sync::SyncEngine::logMessage,
+            batcher, &LogBatcher::logInfo, Qt::DirectConnection);
+    connect(m_syncEngine, &Sync::SyncEngine::debugMessage,
+            batcher, &LogBatcher::logDebug, Qt::DirectConnection);
+    connect(m_syncEngine, &Sync::SyncEngine::errorOccurred,
+            batcher, &LogBatcher::logError, Qt::DirectConnection);
     connect(m_syncEngine, &Sync::SyncEngine::syncStarted,
             this, &MainWindow::onSyncStarted);
     connect(m_syncEngine, &Sync::SyncEngine::syncFinished,
             this, &MainWindow::onSyncFinished);
     connect(m_syncEngine, &Sync::SyncEngine::progressUpdated,
+            batcher, &LogBatcher::updateProgress, Qt::DirectConnection);
+    connect(batcher, &LogBatcher::progressUpdated,
             this, &MainWindow::onSyncProgress);
 }
 
-void MainWindow::runInstallConduit()
+bool MainWindow::runInstallConduit()
 {
-    if (!m_installConduit || !m_session || !m_session->isConnected()) {
-        return;
+    if (!m_installConduit || !m_session || !m_session->isConnected() || m_session->isBusy()) {
+        return false;
     }
 
     if (!m_installConduit->hasPendingFiles()) {
-        return;
+        return false;
     }
 
     m_logWidget->logInfo("--- Installing pending files ---");
+    statusBar()->showMessage("Installing pending files...");
 
-    int socket = m_deviceLink->socketDescriptor();
-    QList<Sync::InstallResult> results = m_installConduit->installAll(socket);
+    // Runs on the worker thread so it can be cancelled; results come via
+    // onPendingInstallFinished()
+    m_session->requestInstallPending(m_installConduit);
+    return true;
+}
 
-    int successCount = 0;
-    int failCount = 0;
-    for (const Sync::InstallResult &r : results) {
-        if (r.success) {
-            successCount++;
-        } else {
-            failCount++;
-        }
+void MainWindow::installPendingThenSync(Sync::SyncMode mode)
+{
+    if (runInstallConduit()) {
+        m_syncQueued = true;
+        m_queuedSyncMode = mode;
+        return;
     }
+    m_session->requestSync(mode, m_syncEngine);
+}
 
-    if (successCount > 0 || failCount > 0) {
-        m_logWidget->logInfo(QString("Install complete: %1 succeeded, %2 failed")
-            .arg(successCount).arg(failCount));
+void MainWindow::startQueuedSync()
+{
+    bool queued = m_syncQueued;
+    m_syncQueued = false;
+    if (queued && m_session && m_session->isConnected()) {
+        m_session->requestSync(m_queuedSyncMode, m_syncEngine);
     }
 }
 
+bool MainWindow::runBackupConduit()
+{
+    if (!m_backupConduit || !m_session || !m_session->isConnected() || m_session->isBusy()) {
+        return false;
+    }
+
+    m_logWidget->logInfo("--- Backing up database images ---");
+    statusBar()->showMessage("Backing up database images...");
+
+    // A first full image backup can take hours: run it on the worker
+    // thread, results come via onBackupFinished()
+    m_session->requestBackupImages(m_backupConduit);
+    return true;
+}
+
 void MainWindow::showWebCalendarSettings(QWidget *parent)
 {
     // Get the WebCalendarConduit from the sync engine
@@ -1039,6 +1109,15 @@ void MainWindow::showWebCalendarSettings(QWidget *parent)
             feed.name = item->data(Qt::UserRole + 1).toString();
             feed.category = item->data(Qt::UserRole + 2).toString();
             feed.enabled = item->checkState() == Qt::Checked;
+
+            // Keep HTTP validators for feeds that are still the same download
+            for (const Sync::WebCalendarFeed &oldFeed : feeds) {
+                if (oldFeed.url == feed.url && oldFeed.name == feed.name) {
+                    feed.etag = oldFeed.etag;
+                    feed.lastModified = oldFeed.lastModified;
+                    break;
+                }
+            }
             newFeeds.append(feed);
         }
         webCal->setFeeds(newFeeds);
@@ -1075,6 +1154,29 @@ void MainWindow::showWebCalendarSettings(QWidget *parent)
     }
 }
 
+void MainWindow::saveConduitSettings()
+{
+    if (!m_currentProfile) {
+        return;
+    }
+
+    bool changed = false;
+    for (const QString &conduitId : m_syncEngine->registeredConduits()) {
+        Sync::Conduit *conduit = m_syncEngine->conduit(conduitId);
+        if (!conduit || !conduit->hasSettings()) {
+            continue;
+        }
+        QJsonObject settings = conduit->saveSettings();
+        if (settings != m_currentProfile->conduitSettings(conduitId)) {
+            m_currentProfile->setConduitSettings(conduitId, settings);
+            changed = true;
+        }
+    }
+    if (changed) {
+        m_currentProfile->save();
+    }
+}
+
 // ========== Profile Management ==========
 
 void MainWindow::loadProfile(const QString &path)
@@ -1134,13 +1236,24 @@ void MainWindow::loadProfile(const QString &path)
         }
     }
 
+    // Web calendar feeds are staged inside the profile and copied in on sync
+    if (auto *webCal = dynamic_cast<Sync::WebCalendarConduit*>(m_syncEngine->conduit("webcalendar"))) {
+        m_feedRefresher->stop();
+        webCal->setStagingDirectory(QDir(m_currentProfile->stateDirectoryPath()).filePath("webcal-staging"));
+        m_feedRefresher->start();
+    }
+
     // Apply connection mode to session
     if (m_session) {
         m_session->setConnectionMode(m_currentProfile->connectionMode());
     }
 
-    // Configure install conduit
+    // Configure install and device backup conduits
     m_installConduit->setInstallFolder(m_currentProfile->installFolderPath());
+    m_backupConduit->setBackupFolder(m_currentProfile->deviceBackupFolderPath());
+
+    // Categorized diagnostics go to the profile's rotating log
+    SyncLog::openProfileLog(m_currentProfile->logDirectoryPath());
 
     // Add to recent profiles
     Settings::instance().addRecentProfile(path);
@@ -1159,15 +1272,22 @@ void MainWindow::loadProfile(const QString &path)
 
     m_logWidget->logInfo(QString("Loaded profile: %1").arg(m_currentProfile->name()));
     m_logWidget->logInfo(QString("Sync folder: %1").arg(m_syncPath));
+    m_logWidget->logInfo(QString("Sync log: %1").arg(SyncLog::currentLogFile()));
 }
 
 void MainWindow::closeProfile()
 {
+    m_feedRefresher->stop();
+    if (auto *webCal = dynamic_cast<Sync::WebCalendarConduit*>(m_syncEngine->conduit("webcalendar"))) {
+        webCal->setStagingDirectory(QString());
+    }
+
     if (m_currentProfile) {
         m_currentProfile->save();
         delete m_currentProfile;
         m_currentProfile = nullptr;
     }
+    SyncLog::closeProfileLog();
 
     m_syncPath.clear();
 
@@ -1421,10 +1541,8 @@ void MainWindow::onHotSync()
     }
 
     m_logWidget->logInfo("=== Starting HotSync ===");
-    runInstallConduit();
-
     m_pendingSyncOperationName = "HotSync";
-    m_session->requestSync(Sync::SyncMode::HotSync, m_syncEngine);
+    installPendingThenSync(Sync::SyncMode::HotSync);
 }
 
 void MainWindow::onFullSync()
@@ -1446,10 +1564,8 @@ void MainWindow::onFullSync()
     if (ret != QMessageBox::Yes) return;
 
     m_logWidget->logInfo("=== Starting Full Sync ===");
-    runInstallConduit();
-
     m_pendingSyncOperationName = "Full Sync";
-    m_session->requestSync(Sync::SyncMode::FullSync, m_syncEngine);
+    installPendingThenSync(Sync::SyncMode::FullSync);
 }
 
 void MainWindow::onCopyPalmToPC()
@@ -1494,10 +1610,8 @@ void MainWindow::onCopyPCToPalm()
     if (ret != QMessageBox::Yes) return;
 
     m_logWidget->logInfo("=== Copying PC → Palm ===");
-    runInstallConduit();
-
     m_pendingSyncOperationName = "Copy PC → Palm";
-    m_session->requestSync(Sync::SyncMode::CopyPCToPalm, m_syncEngine);
+    installPendingThenSync(Sync::SyncMode::CopyPCToPalm);
 }
 
 void MainWindow::onBackup()
@@ -1514,13 +1628,22 @@ void MainWindow::onBackup()
     int ret = QMessageBox::question(this, "Backup Palm → PC",
         "This will backup all Palm data to your PC.\n"
         "Existing backup files will be updated.\n"
-        "Old files not on Palm will be preserved.\n\nProceed?",
+        "Old files not on Palm will be preserved.\n"
+        "Every database is also saved as an image in device-backup/;\n"
+        "unchanged databases are not transferred again.\n\nProceed?",
         QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
 
     if (ret != QMessageBox::Yes) return;
 
     m_logWidget->logInfo("=== Backing up Palm → PC ===");
     m_pendingSyncOperationName = "Backup";
+
+    // The record backup follows once the images are done
+    if (runBackupConduit()) {
+        m_syncQueued = true;
+        m_queuedSyncMode = Sync::SyncMode::Backup;
+        return;
+    }
     m_session->requestSync(Sync::SyncMode::Backup, m_syncEngine);
 }
 
@@ -1545,10 +1668,8 @@ void MainWindow::onRestore()
     if (ret != QMessageBox::Yes) return;
 
     m_logWidget->logInfo("=== Restoring PC → Palm ===");
-    runInstallConduit();
-
     m_pendingSyncOperationName = "Restore";
-    m_session->requestSync(Sync::SyncMode::Restore, m_syncEngine);
+    installPendingThenSync(Sync::SyncMode::Restore);
 }
 
 void MainWindow::onChangeSyncFolder()
@@ -1664,6 +1785,37 @@ void MainWindow::showSyncResult(const Sync::SyncResult &result, const QString &o
         .arg(result.pcStats.summary())
         .arg(errorCount);
 
+    // Where the time went: per conduit, then per phase across all conduits
+    if (!result.timings.isEmpty()) {
+        Sync::SyncTiming overall;
+        overall.conduitId = "All conduits";
+        summary += "\n\nTiming:";
+        for (const Sync::SyncTiming &timing : result.timings) {
+            summary += QString("\n  %1: %2 ms, %3 DLP calls (%4 KB in, %5 KB out)")
+                .arg(timing.conduitId)
+                .arg(timing.totalUs / 1000)
+                .arg(timing.dlpCalls)
+                .arg(timing.dlpBytesReceived / 1024.0, 0, 'f', 1)
+                .arg(timing.dlpBytesSent / 1024.0, 0, 'f', 1);
+
+            for (int i = 0; i < Sync::SyncPhaseCount; ++i) {
+                overall.phaseUs[i] += timing.phaseUs[i];
+            }
+            overall.totalUs += timing.totalUs;
+            overall.dlpCalls += timing.dlpCalls;
+            overall.dlpBytesSent += timing.dlpBytesSent;
+            overall.dlpBytesReceived += timing.dlpBytesReceived;
+        }
+        for (int i = 0; i < Sync::SyncPhaseCount; ++i) {
+            if (overall.phaseUs[i] >= 1000) {
+                summary += QString("\n  %1: %2 ms")
+                    .arg(Sync::syncPhaseName(static_cast<Sync::SyncPhase>(i)))
+                    .arg(overall.phaseUs[i] / 1000);
+            }
+        }
+        m_logWidget->logInfo(QString("Timing: %1").arg(overall.summary()));
+    }
+
     if (result.success && errorCount == 0) {
         QMessageBox::information(this, operationName + " Complete", summary);
     } else {
@@ -1692,6 +1844,7 @@ void MainWindow::onSessionPalmScreen(const QString &message)
 
 void MainWindow::onInstallFinished(bool success, int successCount, int failCount)
 {
+    m_cancelOperationAction->setEnabled(false);
     statusBar()->showMessage("Install complete");
 
     m_logWidget->logInfo(QString("Installation complete: %1 succeeded, %2 failed")
@@ -1707,6 +1860,49 @@ void MainWindow::onInstallFinished(bool success, int successCount, int failCount
     }
 }
 
+void MainWindow::onBackupFinished(bool success, int backedUpCount, int failCount, bool cancelled)
+{
+    m_cancelOperationAction->setEnabled(false);
+
+    if (cancelled) {
+        statusBar()->showMessage("Backup cancelled");
+        m_logWidget->logInfo(QString("Image backup cancelled after %1 database(s)")
+            .arg(backedUpCount));
+        m_syncQueued = false;
+        m_pendingSyncOperationName.clear();
+        return;
+    }
+
+    statusBar()->showMessage(success ? "Image backup complete" : "Image backup failed");
+    m_logWidget->logInfo(QString("Image backup complete: %1 copied, %2 failed")
+        .arg(backedUpCount).arg(failCount));
+
+    startQueuedSync();
+}
+
+void MainWindow::onPendingInstallFinished(bool success, int successCount, int failCount,
+                                          bool cancelled)
+{
+    Q_UNUSED(success);
+    m_cancelOperationAction->setEnabled(false);
+
+    if (cancelled) {
+        // Files not installed stay queued for the next sync
+        statusBar()->showMessage("Install cancelled");
+        m_logWidget->logInfo(QString("Install cancelled after %1 file(s)").arg(successCount));
+        m_syncQueued = false;
+        m_pendingSyncOperationName.clear();
+        return;
+    }
+
+    if (successCount > 0 || failCount > 0) {
+        m_logWidget->logInfo(QString("Install complete: %1 succeeded, %2 failed")
+            .arg(successCount).arg(failCount));
+    }
+
+    startQueuedSync();
+}
+
 void MainWindow::onAsyncSyncResult(const Sync::SyncResult &result)
 {
     // Get the operation name that was pending
@@ -1717,6 +1913,10 @@ void MainWindow::onAsyncSyncResult(const Sync::SyncResult &result)
         operationName = "Sync";
     }
 
+    // Conduits may update their settings during sync (e.g. web calendar
+    // last fetch time and HTTP validators) - persist them to the profile
+    saveConduitSettings();
+
     // Show the result dialog
     showSyncResult(result, operationName);
 }
@@ -1748,6 +1948,7 @@ void MainWindow::onSettings()
 {
     SettingsDialog dialog(this);
     connect(&dialog, &SettingsDialog::settingsChanged, this, [this]() {
+        applyDebugLogging();
         m_logWidget->logInfo("Settings updated");
     });
     dialog.exec();
@@ -1766,6 +1967,7 @@ void MainWindow::onClearLog()
 void MainWindow::createLogWindow()
 {
     m_logWidget = new LogWidget();
+    applyDebugLogging();
     m_logSubWindow = m_mdiArea->addSubWindow(m_logWidget);
     m_logSubWindow->setWindowTitle("Log");
     m_logSubWindow->resize(800, 300);
@@ -1776,6 +1978,13 @@ void MainWindow::createLogWindow()
     m_logSubWindow->show();
 }
 
+void MainWindow::applyDebugLogging()
+{
+    bool enabled = Settings::instance().debugLogging();
+    SyncLog::setDebugEnabled(enabled);
+    m_logWidget->batcher()->setMinimumLevel(enabled ? LogLevel::Debug : LogLevel::Info);
+}
+
 void MainWindow::showLogWindow()
 {
     if (m_logSubWindow) {
@@ -1882,6 +2091,16 @@ void MainWindow::createMenus()
     m_cancelConnectionAction->setEnabled(false);
     connect(m_cancelConnectionAction, &QAction::triggered, this, &MainWindow::onCancelConnection);
 
+    // Stops a running sync, install or backup within one record
+    m_cancelOperationAction = deviceMenu->addAction("Cancel &Operation");
+    m_cancelOperationAction->setIcon(style()->standardIcon(QStyle::SP_BrowserStop));
+    m_cancelOperationAction->setEnabled(false);
+    connect(m_cancelOperationAction, &QAction::triggered, this, [this]() {
+        if (m_session && m_session->isBusy()) {
+            m_session->requestCancel();
+        }
+    });
+
     deviceMenu->addSeparator();
 
     m_listDatabasesAction = deviceMenu->addAction("List &Databases");
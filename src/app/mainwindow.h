@@ -4,7 +4,6 @@
 #include <QMainWindow>
 
 // Forward declarations
-class QTimer;
 class QMdiArea;
 class QMdiSubWindow;
 class QMenu;
@@ -12,6 +11,7 @@ class QAction;
 class LogWidget;
 class KPilotDeviceLink;
 class DeviceSession;
+class DeviceWatcher;
 class ExportHandler;
 class ImportHandler;
 class Profile;
@@ -20,6 +20,8 @@ namespace Sync {
 class SyncEngine;
 class SyncResult;
 class InstallConduit;
+class BackupConduit;
+class WebFeedRefresher;
 }
 
 /**
@@ -44,7 +46,7 @@ private slots:
     void onConnectDevice();
     void onConnectionComplete(bool success);
     void onDisconnectDevice();
-    void onDevicePoll();  // Check if device appeared while listening
+    void onDeviceAppeared(const QString &devicePath);  // Device node showed up while listening
     void onCancelConnection();
     void startListening(const QString &devicePath);
     void stopListening();
@@ -79,6 +81,8 @@ private slots:
     // DeviceSession callbacks
     void onSessionPalmScreen(const QString &message);
     void onInstallFinished(bool success, int successCount, int failCount);
+    void onBackupFinished(bool success, int backedUpCount, int failCount, bool cancelled);
+    void onPendingInstallFinished(bool success, int successCount, int failCount, bool cancelled);
     void onAsyncSyncResult(const Sync::SyncResult &result);
 
     // Misc
@@ -92,6 +96,7 @@ private:
     void createMenus();
     void createToolBar();
     void createLogWindow();
+    void applyDebugLogging();
     void showLogWindow();
     void updateMenuState(bool connected);
     void updateWindowTitle();
@@ -100,9 +105,13 @@ private:
 
     // Sync engine
     void initializeSyncEngine();
-    void runInstallConduit();
+    bool runInstallConduit();
+    void installPendingThenSync(Sync::SyncMode mode);
+    void startQueuedSync();
+    bool runBackupConduit();
     void showSyncResult(const Sync::SyncResult &result, const QString &operationName);
     void showWebCalendarSettings(QWidget *parent);
+    void saveConduitSettings();
 
     // Profile management
     void loadProfile(const QString &path);
@@ -125,6 +134,8 @@ private:
     // Sync engine and conduits
     Sync::SyncEngine *m_syncEngine;
     Sync::InstallConduit *m_installConduit;
+    Sync::BackupConduit *m_backupConduit = nullptr;
+    Sync::WebFeedRefresher *m_feedRefresher = nullptr;
     QString m_syncPath;
 
     // Export/Import handlers
@@ -136,12 +147,14 @@ private:
     QString m_lastUsedBaudRate;
 
     // Device listening mode
-    QTimer *m_devicePollTimer = nullptr;
+    DeviceWatcher *m_deviceWatcher = nullptr;
     bool m_listeningForDevice = false;
     QString m_listeningDevicePath;
 
     // Current async operation
     QString m_pendingSyncOperationName;
+    bool m_syncQueued = false;        // Sync waits for pending installs / image backup
+    Sync::SyncMode m_queuedSyncMode = Sync::SyncMode::HotSync;
 
     // Profile
     Profile *m_currentProfile;
@@ -152,6 +165,7 @@ private:
     // Menu actions that need to be enabled/disabled
     QAction *m_disconnectAction;
     QAction *m_cancelConnectionAction;
+    QAction *m_cancelOperationAction;
     QAction *m_listDatabasesAction;
     QAction *m_setUserInfoAction;
     QAction *m_deviceInfoAction;
@@ -1,14 +1,21 @@
 #include <QApplication>
 #include "app/mainwindow.h"
+#include "synclog.h"
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
     app.setApplicationName("QPilotSync");
     app.setOrganizationName("QPilotSync");
+    SyncLog::install();
 
-    MainWindow window;
-    window.show();
+    int result;
+    {
+        MainWindow window;
+        window.show();
+        result = app.exec();
+    }
 
-    return app.exec();
+    SyncLog::closeProfileLog();
+    return result;
 }
@@ -4,9 +4,13 @@
 #include "kpilotdevicelink.h"
 #include "../sync/syncengine.h"
 #include "../sync/synctypes.h"
+#include "../sync/conduits/backupconduit.h"
+#include "../sync/conduits/installconduit.h"
 
 #include <QDebug>
 #include <QMetaObject>
+#include <QDateTime>
+#include <QDir>
 
 DeviceSession::DeviceSession(QObject *parent)
     : QObject(parent)
@@ -46,6 +50,12 @@ void DeviceSession::connectDevice(const QString &devicePath)
     connect(m_deviceLink, &KPilotDeviceLink::errorOccurred,
             this, &DeviceSession::errorOccurred);
 
+    if (!m_traceDirectory.isEmpty() && QDir().mkpath(m_traceDirectory)) {
+        QString traceFile = QString("%1/dlp-%2.qpdt")
+            .arg(m_traceDirectory, QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+        m_deviceLink->startTrace(traceFile);
+    }
+
     m_conduitOpened = false;
     m_deviceLink->openConnection();
 }
@@ -102,6 +112,54 @@ void DeviceSession::requestInstall(const QStringList &filePaths)
                               Q_ARG(QStringList, filePaths));
 }
 
+void DeviceSession::requestBackupImages(Sync::BackupConduit *conduit)
+{
+    if (!isConnected()) {
+        emit errorOccurred("Not connected to device");
+        return;
+    }
+
+    if (m_busy) {
+        emit errorOccurred("Another operation is in progress");
+        return;
+    }
+
+    m_busy = true;
+    m_currentOperation = "backup";
+    emit operationStarted("Backing up database images");
+
+    ensureWorkerThread();
+    stopTickle();  // Pause tickle - operation keeps connection alive
+
+    QMetaObject::invokeMethod(m_worker, "doBackupImages",
+                              Qt::QueuedConnection,
+                              Q_ARG(Sync::BackupConduit*, conduit));
+}
+
+void DeviceSession::requestInstallPending(Sync::InstallConduit *conduit)
+{
+    if (!isConnected()) {
+        emit errorOccurred("Not connected to device");
+        return;
+    }
+
+    if (m_busy) {
+        emit errorOccurred("Another operation is in progress");
+        return;
+    }
+
+    m_busy = true;
+    m_currentOperation = "install";
+    emit operationStarted("Installing pending files");
+
+    ensureWorkerThread();
+    stopTickle();  // Pause tickle - operation keeps connection alive
+
+    QMetaObject::invokeMethod(m_worker, "doInstallPending",
+                              Qt::QueuedConnection,
+                              Q_ARG(Sync::InstallConduit*, conduit));
+}
+
 void DeviceSession::requestSync(Sync::SyncMode mode, Sync::SyncEngine *engine)
 {
     if (!isConnected()) {
@@ -152,9 +210,11 @@ void DeviceSession::requestCancel()
 
     emit logMessage("Cancelling operation...");
 
+    // Called directly: the worker thread is busy with the operation, so a
+    // queued call would only run after it had finished. doCancel() just
+    // sets an atomic flag.
     if (m_worker) {
-        QMetaObject::invokeMethod(m_worker, "doCancel",
-                                  Qt::QueuedConnection);
+        m_worker->doCancel();
     }
 }
 
@@ -219,6 +279,32 @@ void DeviceSession::onWorkerInstallFinished(bool success, int successCount, int
     emit installFinished(success, successCount, failCount);
 }
 
+void DeviceSession::onWorkerBackupFinished(bool success, int backedUpCount, int failCount,
+                                           bool cancelled)
+{
+    m_busy = false;
+    m_currentOperation.clear();
+
+    if (m_connectionMode == ConnectionMode::KeepAlive) {
+        startTickle();
+    }
+
+    emit backupFinished(success, backedUpCount, failCount, cancelled);
+}
+
+void DeviceSession::onWorkerPendingInstallFinished(bool success, int successCount, int failCount,
+                                                   bool cancelled)
+{
+    m_busy = false;
+    m_currentOperation.clear();
+
+    if (m_connectionMode == ConnectionMode::KeepAlive) {
+        startTickle();
+    }
+
+    emit pendingInstallFinished(success, successCount, failCount, cancelled);
+}
+
 void DeviceSession::onWorkerSyncFinished(bool success, const QString &summary)
 {
     m_busy = false;
@@ -322,6 +408,10 @@ void DeviceSession::ensureWorkerThread()
             this, &DeviceSession::onWorkerPalmScreen);
     connect(m_worker, &DeviceWorker::installFinished,
             this, &DeviceSession::onWorkerInstallFinished);
+    connect(m_worker, &DeviceWorker::backupFinished,
+            this, &DeviceSession::onWorkerBackupFinished);
+    connect(m_worker, &DeviceWorker::pendingInstallFinished,
+            this, &DeviceSession::onWorkerPendingInstallFinished);
     connect(m_worker, &DeviceWorker::syncFinished,
             this, &DeviceSession::onWorkerSyncFinished);
     connect(m_worker, &DeviceWorker::syncResultReady,
@@ -342,6 +432,7 @@ void DeviceSession::ensureWorkerThread()
     // Set the socket
     if (m_deviceLink) {
         m_worker->setSocket(m_deviceLink->socketDescriptor());
+        m_worker->setDeviceLink(m_deviceLink);
     }
 
     m_workerThread->start();
@@ -390,10 +481,9 @@ void DeviceSession::ensureTickleThread()
     connect(m_tickleThread, &QThread::finished,
             m_tickle, &QObject::deleteLater);
 
-    // Set the socket
-    if (m_deviceLink) {
-        m_tickle->setSocket(m_deviceLink->socketDescriptor());
-    }
+    // Set the link and how long it must be idle before a tickle
+    m_tickle->setLink(m_deviceLink);
+    m_tickle->setIdleInterval(m_tickleIdleMs);
 
     m_tickleThread->start();
     qDebug() << "[DeviceSession] Tickle thread started";
@@ -17,6 +17,8 @@ class TickleWorker;
 
 namespace Sync {
 class SyncEngine;
+class BackupConduit;
+class InstallConduit;
 enum class SyncMode;
 }
 
@@ -81,6 +83,22 @@ public:
      */
     void requestInstall(const QStringList &filePaths);
 
+    /**
+     * @brief Update the device image backup (async)
+     *
+     * A full first backup can take hours over a serial cradle. Progress
+     * comes through the conduit's own signals, the result via
+     * backupFinished().
+     */
+    void requestBackupImages(Sync::BackupConduit *conduit);
+
+    /**
+     * @brief Install the files queued in the install folder (async)
+     *
+     * Used before a sync. Results via pendingInstallFinished().
+     */
+    void requestInstallPending(Sync::InstallConduit *conduit);
+
     /**
      * @brief Run sync operation (async)
      *
@@ -119,6 +137,19 @@ public:
      */
     ConnectionMode connectionMode() const { return m_connectionMode; }
 
+    /**
+     * @brief Set how long the link must be idle before a keep-alive is sent
+     *
+     * Default is 5000ms. Takes effect from the next connection.
+     */
+    void setTickleIdleInterval(int intervalMs) { m_tickleIdleMs = intervalMs; }
+    int tickleIdleInterval() const { return m_tickleIdleMs; }
+
+    /**
+     * @brief Record a DLP trace of each connection into @p directory (empty = off)
+     */
+    void setTraceDirectory(const QString &directory) { m_traceDirectory = directory; }
+
 signals:
     // ========== Connection Signals ==========
 
@@ -142,6 +173,8 @@ signals:
     // ========== Results ==========
 
     void installFinished(bool success, int successCount, int failCount);
+    void backupFinished(bool success, int backedUpCount, int failCount, bool cancelled);
+    void pendingInstallFinished(bool success, int successCount, int failCount, bool cancelled);
     void syncFinished(bool success, const QString &summary);
     void syncResultReady(const Sync::SyncResult &result);
 
@@ -159,6 +192,9 @@ private slots:
     void onWorkerProgress(int current, int total, const QString &msg);
     void onWorkerPalmScreen(const QString &message);
     void onWorkerInstallFinished(bool success, int successCount, int failCount);
+    void onWorkerBackupFinished(bool success, int backedUpCount, int failCount, bool cancelled);
+    void onWorkerPendingInstallFinished(bool success, int successCount, int failCount,
+                                        bool cancelled);
     void onWorkerSyncFinished(bool success, const QString &summary);
     void onWorkerSyncResultReady(const Sync::SyncResult &result);
     void onWorkerOpenConduitFinished(bool success);
@@ -188,6 +224,8 @@ private:
     QString m_currentOperation;
     bool m_conduitOpened = false;
     ConnectionMode m_connectionMode = ConnectionMode::KeepAlive;
+    int m_tickleIdleMs = 5000;
+    QString m_traceDirectory;
 
     // Pending operation state
     Sync::SyncEngine *m_pendingSyncEngine = nullptr;
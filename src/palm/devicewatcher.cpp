@@ -0,0 +1,206 @@
+#include "devicewatcher.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int POLL_INTERVAL_MS = 500;
+
+#ifdef Q_OS_LINUX
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM
+                          | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+#endif
+
+/**
+ * @brief Whether the node exists and this process may open it read/write
+ *
+ * udev creates the node first and fixes its mode and group afterwards;
+ * the chmod arrives as IN_ATTRIB and triggers another check.
+ */
+bool isUsable(const QString &path)
+{
+#ifdef Q_OS_LINUX
+    return ::access(QFile::encodeName(path).constData(), R_OK | W_OK) == 0;
+#else
+    QFileInfo info(path);
+    return info.exists() && info.isReadable() && info.isWritable();
+#endif
+}
+
+} // namespace
+
+DeviceWatcher::DeviceWatcher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DeviceWatcher::~DeviceWatcher()
+{
+    stop();
+}
+
+bool DeviceWatcher::isPseudoDevice(const QString &devicePath)
+{
+    return devicePath.startsWith("usb:") || devicePath.startsWith("net:")
+        || devicePath.startsWith("bt:");
+}
+
+void DeviceWatcher::watch(const QString &devicePath)
+{
+    stop();
+    m_devicePath = devicePath;
+
+    if (isPseudoDevice(devicePath)) {
+        m_present = true;
+        return;
+    }
+    m_present = QFile::exists(devicePath);
+
+#ifdef Q_OS_LINUX
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd >= 0) {
+        m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &DeviceWatcher::onNotify);
+    } else {
+        qWarning() << "[DeviceWatcher] inotify unavailable, errno:" << errno;
+    }
+#endif
+
+    updateWatchedDirectory();
+    qDebug() << "[DeviceWatcher] Watching" << devicePath << "via" << m_watchedDirectory
+             << (isEventDriven() ? "(inotify)" : "(polling)");
+}
+
+void DeviceWatcher::stop()
+{
+    if (m_pollTimer) {
+        m_pollTimer->stop();
+    }
+
+    // stop() is often called from a deviceAppeared() handler, i.e. from
+    // within the notifier's own signal
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+        m_notifier->deleteLater();
+        m_notifier = nullptr;
+    }
+
+#ifdef Q_OS_LINUX
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);   // also drops the watch
+    }
+#endif
+    m_inotifyFd = -1;
+    m_watchDescriptor = -1;
+
+    m_devicePath.clear();
+    m_watchedDirectory.clear();
+    m_present = false;
+}
+
+void DeviceWatcher::updateWatchedDirectory()
+{
+    // /dev/serial/by-id only exists while some serial adapter is plugged in.
+    // Look again after moving the watch: a directory created in between
+    // would not be reported by either watch.
+    while (true) {
+        QString directory = QFileInfo(m_devicePath).absolutePath();
+        while (!QFileInfo(directory).isDir() && directory != QDir::rootPath()) {
+            directory = QFileInfo(directory).absolutePath();
+        }
+
+        if (directory == m_watchedDirectory && m_watchDescriptor >= 0) {
+            break;
+        }
+
+        int previous = m_watchDescriptor;
+        m_watchDescriptor = -1;
+#ifdef Q_OS_LINUX
+        if (m_inotifyFd >= 0) {
+            if (previous >= 0) {
+                inotify_rm_watch(m_inotifyFd, previous);
+            }
+            m_watchDescriptor = inotify_add_watch(m_inotifyFd, QFile::encodeName(directory).constData(),
+                                                  WATCH_MASK);
+        }
+#else
+        Q_UNUSED(previous);
+#endif
+        m_watchedDirectory = directory;
+
+        if (m_watchDescriptor < 0) {
+            break;
+        }
+    }
+
+    if (m_watchDescriptor >= 0) {
+        if (m_pollTimer) {
+            m_pollTimer->stop();
+        }
+        return;
+    }
+
+    if (!m_pollTimer) {
+        m_pollTimer = new QTimer(this);
+        connect(m_pollTimer, &QTimer::timeout, this, &DeviceWatcher::check);
+    }
+    if (!m_pollTimer->isActive()) {
+        m_pollTimer->start(POLL_INTERVAL_MS);
+    }
+}
+
+void DeviceWatcher::onNotify()
+{
+#ifdef Q_OS_LINUX
+    // Any change in the directory is reason enough to look at the node
+    // again; only a dropped watch needs handling here
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(p);
+            if ((event->mask & IN_IGNORED) && event->wd == m_watchDescriptor) {
+                // Watched directory was removed
+                m_watchDescriptor = -1;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#endif
+
+    check();
+}
+
+void DeviceWatcher::check()
+{
+    if (m_devicePath.isEmpty() || isPseudoDevice(m_devicePath)) {
+        return;
+    }
+
+    // A directory on the way may have appeared or gone away
+    updateWatchedDirectory();
+
+    // Not yet present while the node is still root-only
+    bool present = isUsable(m_devicePath);
+    if (present == m_present) {
+        return;
+    }
+    m_present = present;
+
+    qDebug() << "[DeviceWatcher]" << m_devicePath << (present ? "appeared" : "removed");
+    if (present) {
+        emit deviceAppeared(m_devicePath);
+    } else {
+        emit deviceRemoved(m_devicePath);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef DEVICEWATCHER_H
+#define DEVICEWATCHER_H
+
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+class QTimer;
+
+/**
+ * @brief Reports when a device node such as /dev/ttyUSB0 appears or goes away
+ *
+ * USB serial adapters and the Visor's cradle only create their node once
+ * the HotSync button is pressed. Rather than polling for the file, the
+ * watcher asks inotify about the closest existing parent directory
+ * (/dev, or /dev/serial/by-id once it exists) and checks the node only
+ * when that directory changes, so waiting costs no wakeups and the node
+ * is reported as soon as udev has created it and granted us read/write
+ * access.
+ *
+ * If inotify is unavailable the watcher falls back to checking every
+ * 500 ms. Used by MainWindow and qpilotsync-cli.
+ *
+ * Usage:
+ * @code
+ * DeviceWatcher watcher;
+ * connect(&watcher, &DeviceWatcher::deviceAppeared, this, &MyClass::connectTo);
+ * watcher.watch("/dev/ttyUSB0");
+ * if (watcher.isPresent()) connectTo(watcher.devicePath());
+ * @endcode
+ */
+class DeviceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceWatcher(QObject *parent = nullptr);
+    ~DeviceWatcher() override;
+
+    /**
+     * @brief Whether @p devicePath is a pilot-link address rather than a file
+     *
+     * "usb:" and "net:" are listened on by pilot-link itself; there is no
+     * node to wait for.
+     */
+    static bool isPseudoDevice(const QString &devicePath);
+
+    /**
+     * @brief Start watching @p devicePath, replacing any previous path
+     *
+     * Does not signal a node that is already there; check isPresent().
+     */
+    void watch(const QString &devicePath);
+
+    /**
+     * @brief Stop watching
+     */
+    void stop();
+
+    QString devicePath() const { return m_devicePath; }
+    bool isWatching() const { return !m_devicePath.isEmpty(); }
+    bool isPresent() const { return m_present; }
+
+    /**
+     * @brief Whether changes come from inotify (false: polling fallback)
+     */
+    bool isEventDriven() const { return m_watchDescriptor >= 0; }
+
+signals:
+    void deviceAppeared(const QString &devicePath);
+    void deviceRemoved(const QString &devicePath);
+
+private slots:
+    void onNotify();
+    void check();
+
+private:
+    /**
+     * @brief Watch the closest existing directory on the way to the node
+     */
+    void updateWatchedDirectory();
+
+    QString m_devicePath;
+    QString m_watchedDirectory;
+    bool m_present = false;
+
+    int m_inotifyFd = -1;
+    int m_watchDescriptor = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QTimer *m_pollTimer = nullptr;
+};
+
+#endif // DEVICEWATCHER_H
@@ -1,7 +1,11 @@
 #include "deviceworker.h"
+#include "kpilotdevicelink.h"
+#include "dlptrace.h"
+#include "filetransfer.h"
 #include "../sync/syncengine.h"
 #include "../sync/synctypes.h"
 #include "../sync/conduits/installconduit.h"
+#include "../sync/conduits/backupconduit.h"
 
 #include <QDebug>
 #include <QThread>
@@ -14,6 +18,28 @@ extern "C" {
 #include <pi-file.h>
 }
 
+namespace {
+
+// Run a raw socket call on the link's DLP thread; inline when no link is set
+template<typename F>
+auto onLink(KPilotDeviceLink *link, F &&function,
+            DlpExecutor::Priority priority = DlpExecutor::Priority::Sync)
+{
+    return link ? link->execute(std::forward<F>(function), priority) : function();
+}
+
+// dlp_OpenConduit on the link's DLP thread, recorded in its trace
+int openConduit(KPilotDeviceLink *link, int socket)
+{
+    return onLink(link, [socket]() {
+        return KPilotDeviceLink::traceRaw(DlpCall::OpenConduit, [socket]() {
+            return dlp_OpenConduit(socket);
+        });
+    });
+}
+
+} // namespace
+
 DeviceWorker::DeviceWorker(QObject *parent)
     : QObject(parent)
 {
@@ -44,7 +70,7 @@ void DeviceWorker::doOpenConduit()
     emit palmScreenChanged("Syncing...");
     emit logMessage("Opening conduit session...");
 
-    int result = dlp_OpenConduit(m_socket);
+    int result = openConduit(m_link, m_socket);
     if (result < 0) {
         emit error(QString("dlp_OpenConduit failed: %1").arg(result));
         emit openConduitFinished(false);
@@ -97,6 +123,12 @@ void DeviceWorker::doInstall(const QStringList &filePaths)
 
     emit palmScreenChanged("Installing files...");
 
+    // Leave databases the Palm already has at this version alone
+    QList<DBInfo> onDevice = onLink(m_link, [this]() {
+        return Sync::InstallConduit::readDeviceDatabases(m_socket);
+    });
+    int skippedCount = 0;
+
     for (int i = 0; i < filePaths.size(); ++i) {
         if (isCancelled()) {
             emit logMessage("Install cancelled by user");
@@ -110,7 +142,7 @@ void DeviceWorker::doInstall(const QStringList &filePaths)
         emit progress(i + 1, total, QString("Installing %1").arg(fileName));
         emit logMessage(QString("Installing: %1").arg(fileName));
 
-        // Use pi_file_install from pilot-link
+        // pilot-link's pi_file_install, stopped mid-file on cancel
         struct pi_file *pf = pi_file_open(filePath.toLocal8Bit().constData());
         if (!pf) {
             emit logMessage(QString("Failed to open: %1").arg(fileName));
@@ -118,10 +150,29 @@ void DeviceWorker::doInstall(const QStringList &filePaths)
             continue;
         }
 
-        int result = pi_file_install(pf, m_socket, 0, nullptr);
+        struct DBInfo info;
+        pi_file_get_info(pf, &info);
+        if (Sync::InstallConduit::isInstalled(info, onDevice)) {
+            pi_file_close(pf);
+            emit logMessage(QString("Skipped %1: %2 version %3, modnum %4 is already on the Palm")
+                                .arg(fileName, QString::fromLatin1(info.name))
+                                .arg(info.version)
+                                .arg(info.modnum));
+            skippedCount++;
+            successCount++;
+            continue;
+        }
+
+        int result = onLink(m_link, [this, pf]() {
+            return FileTransfer::install(pf, m_socket, 0, [this]() { return isCancelled(); });
+        }, DlpExecutor::Priority::Install);
         pi_file_close(pf);
 
-        if (result < 0) {
+        if (result < 0 && isCancelled()) {
+            emit logMessage(QString("Install cancelled while sending %1").arg(fileName));
+            failCount++;
+            break;
+        } else if (result < 0) {
             emit logMessage(QString("Failed to install %1: error %2").arg(fileName).arg(result));
             failCount++;
         } else {
@@ -133,12 +184,12 @@ void DeviceWorker::doInstall(const QStringList &filePaths)
     emit progress(total, total, "Install complete");
 
     // Call dlp_OpenConduit to reset Palm screen back to ready state
-    dlp_OpenConduit(m_socket);
+    openConduit(m_link, m_socket);
 
     emit palmScreenChanged("Install complete");
 
-    QString summary = QString("Installed %1 file(s), %2 failed")
-                          .arg(successCount).arg(failCount);
+    QString summary = QString("Installed %1 file(s) (%2 already on the Palm), %3 failed")
+                          .arg(successCount).arg(skippedCount).arg(failCount);
     emit logMessage(summary);
     emit installFinished(failCount == 0, successCount, failCount);
     emit operationFinished(failCount == 0, "install");
@@ -170,7 +221,7 @@ void DeviceWorker::doSync(int mode,
 
     // First, open the conduit to update Palm screen
     emit palmScreenChanged("Syncing...");
-    int openResult = dlp_OpenConduit(m_socket);
+    int openResult = openConduit(m_link, m_socket);
     if (openResult < 0) {
         emit logMessage(QString("Warning: dlp_OpenConduit returned %1").arg(openResult));
         // Continue anyway - some devices may not require this
@@ -210,6 +261,84 @@ void DeviceWorker::doSync(int mode,
     emit operationFinished(result.success, "sync");
 }
 
+void DeviceWorker::doBackupImages(Sync::BackupConduit *conduit)
+{
+    qDebug() << "[DeviceWorker] doBackupImages() on thread:" << QThread::currentThread();
+
+    if (m_socket < 0 || !conduit) {
+        emit error("No socket connection");
+        emit operationFinished(false, "backup");
+        emit backupFinished(false, 0, 0, false);
+        return;
+    }
+
+    resetCancel();
+    emit palmScreenChanged("Backing up databases...");
+
+    conduit->setCancelCheck([this]() { return isCancelled(); });
+    QList<Sync::BackupResult> results = onLink(m_link, [this, conduit]() {
+        return conduit->backupAll(m_socket);
+    }, DlpExecutor::Priority::Install);
+    conduit->setCancelCheck(nullptr);
+
+    int backedUpCount = 0;
+    int failCount = 0;
+    for (const Sync::BackupResult &result : results) {
+        if (result.success && !result.skipped) {
+            backedUpCount++;
+        } else if (!result.success && !result.cancelled) {
+            failCount++;
+        }
+    }
+    bool cancelled = isCancelled();
+    bool success = failCount == 0 && !cancelled;
+
+    emit palmScreenChanged(cancelled ? "Backup cancelled" : "Backup complete");
+
+    // Before backupFinished: a request made from its handler must find the
+    // session idle
+    emit operationFinished(success, "backup");
+    emit backupFinished(success, backedUpCount, failCount, cancelled);
+}
+
+void DeviceWorker::doInstallPending(Sync::InstallConduit *conduit)
+{
+    qDebug() << "[DeviceWorker] doInstallPending() on thread:" << QThread::currentThread();
+
+    if (m_socket < 0 || !conduit) {
+        emit error("No socket connection");
+        emit operationFinished(false, "install");
+        emit pendingInstallFinished(false, 0, 0, false);
+        return;
+    }
+
+    resetCancel();
+    emit palmScreenChanged("Installing files...");
+
+    conduit->setCancelCheck([this]() { return isCancelled(); });
+    QList<Sync::InstallResult> results = onLink(m_link, [this, conduit]() {
+        return conduit->installAll(m_socket);
+    }, DlpExecutor::Priority::Install);
+    conduit->setCancelCheck(nullptr);
+
+    int successCount = 0;
+    int failCount = 0;
+    for (const Sync::InstallResult &result : results) {
+        if (result.success) {
+            successCount++;
+        } else if (!result.cancelled) {
+            failCount++;
+        }
+    }
+    bool cancelled = isCancelled();
+    bool success = failCount == 0 && !cancelled;
+
+    // Before pendingInstallFinished: a request made from its handler must
+    // find the session idle
+    emit operationFinished(success, "install");
+    emit pendingInstallFinished(success, successCount, failCount, cancelled);
+}
+
 void DeviceWorker::doCancel()
 {
     qDebug() << "[DeviceWorker] Cancel requested";
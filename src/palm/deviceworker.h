@@ -9,9 +9,12 @@
 #include "../sync/synctypes.h"
 
 // Forward declarations
+class KPilotDeviceLink;
+
 namespace Sync {
 class SyncEngine;
 class InstallConduit;
+class BackupConduit;
 enum class SyncMode;
 }
 
@@ -50,6 +53,14 @@ public:
      */
     int socket() const { return m_socket; }
 
+    /**
+     * @brief Set the link the socket belongs to
+     *
+     * Raw socket calls are submitted to its DLP executor, so keep-alives
+     * never interleave with them.
+     */
+    void setDeviceLink(KPilotDeviceLink *link) { m_link = link; }
+
 public slots:
     /**
      * @brief Signal to Palm that a conduit is starting
@@ -74,6 +85,26 @@ public slots:
      */
     void doInstall(const QStringList &filePaths);
 
+    /**
+     * @brief Bring the device image backup up to date
+     *
+     * Runs BackupConduit::backupAll() on the link's DLP thread; a cancel
+     * stops it within one record of the database being retrieved.
+     *
+     * @param conduit Backup conduit (configured by the caller)
+     */
+    void doBackupImages(Sync::BackupConduit *conduit);
+
+    /**
+     * @brief Install the files queued in the install folder
+     *
+     * Runs InstallConduit::installAll() on the link's DLP thread; a cancel
+     * stops it within one record of the file being sent.
+     *
+     * @param conduit Install conduit (configured by the caller)
+     */
+    void doInstallPending(Sync::InstallConduit *conduit);
+
     /**
      * @brief Execute a sync operation
      *
@@ -118,6 +149,16 @@ signals:
      */
     void installFinished(bool success, int successCount, int failCount);
 
+    /**
+     * @brief Image backup completed, failed or was cancelled
+     */
+    void backupFinished(bool success, int backedUpCount, int failCount, bool cancelled);
+
+    /**
+     * @brief Install of the queued files completed, failed or was cancelled
+     */
+    void pendingInstallFinished(bool success, int successCount, int failCount, bool cancelled);
+
     /**
      * @brief Sync operation completed (simple version)
      */
@@ -155,6 +196,7 @@ private:
     bool isCancelled() const;
 
     int m_socket = -1;
+    KPilotDeviceLink *m_link = nullptr;
     std::atomic<bool> m_cancelRequested{false};
 };
 
@@ -0,0 +1,129 @@
+#include "dlpexecutor.h"
+#include "../synclog.h"
+
+#include <QThread>
+#include <QDebug>
+
+DlpExecutor::DlpExecutor(const QString &name)
+{
+    m_clock.start();
+
+    m_thread = QThread::create([this]() { loop(); });
+    m_thread->setObjectName(name);
+    m_thread->start();
+}
+
+DlpExecutor::~DlpExecutor()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+
+    qCDebug(lcLink) << "[DlpExecutor] Stopped -" << m_stats.commands << "commands,"
+             << m_stats.busyUs / 1000 << "ms busy";
+}
+
+bool DlpExecutor::isExecutorThread() const
+{
+    return QThread::currentThread() == m_thread;
+}
+
+bool DlpExecutor::isIdle() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_running && !hasTasks();
+}
+
+qint64 DlpExecutor::idleMs() const
+{
+    return m_clock.elapsed() - m_lastActivityMs.load();
+}
+
+DlpExecutor::Stats DlpExecutor::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.wallUs = m_clock.nsecsElapsed() / 1000 - m_statsStartUs;
+    return stats;
+}
+
+void DlpExecutor::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats = Stats();
+    m_statsStartUs = m_clock.nsecsElapsed() / 1000;
+}
+
+void DlpExecutor::enqueue(Priority priority, std::function<void()> function,
+                          std::function<void()> complete)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping) {
+        // The link is going away; nobody else can be using the socket now
+        locker.unlock();
+        function();
+        complete();
+        return;
+    }
+
+    m_queues[int(priority)].append({std::move(function), std::move(complete),
+                                    m_clock.nsecsElapsed()});
+    m_stats.perPriority[int(priority)]++;
+    m_wake.wakeOne();
+}
+
+bool DlpExecutor::hasTasks() const
+{
+    for (const QList<Task> &queue : m_queues) {
+        if (!queue.isEmpty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DlpExecutor::loop()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (!m_stopping && !hasTasks()) {
+            m_wake.wait(&m_mutex);
+        }
+        if (!hasTasks()) {
+            break;  // Stopping, and everything queued has run
+        }
+
+        Task task;
+        for (QList<Task> &queue : m_queues) {
+            if (!queue.isEmpty()) {
+                task = queue.takeFirst();
+                break;
+            }
+        }
+        m_running = true;
+        locker.unlock();
+
+        qint64 startNs = m_clock.nsecsElapsed();
+        task.function();
+        qint64 endNs = m_clock.nsecsElapsed();
+        m_lastActivityMs = endNs / 1000000;
+
+        locker.relock();
+        m_running = false;
+
+        qint64 waitUs = (startNs - task.queuedNs) / 1000;
+        m_stats.commands++;
+        m_stats.busyUs += (endNs - startNs) / 1000;
+        m_stats.queueWaitUs += waitUs;
+        m_stats.maxQueueWaitUs = qMax(m_stats.maxQueueWaitUs, waitUs);
+
+        // Only now release the caller, so it sees the link as idle again
+        locker.unlock();
+        task.complete();
+        locker.relock();
+    }
+}
@@ -0,0 +1,156 @@
+#ifndef DLPEXECUTOR_H
+#define DLPEXECUTOR_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QPromise>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+class QThread;
+
+/**
+ * @brief The one thread that talks to a pilot-link socket
+ *
+ * pilot-link sockets are not safe to use from two threads: packets of
+ * concurrent DLP calls interleave. Every call on a KPilotDeviceLink -
+ * conduit reads and writes, DeviceWorker's installs, TickleWorker's
+ * keep-alives - is queued here and runs on this thread, one at a time.
+ *
+ * Commands are taken by priority, then in order of submission, so sync
+ * traffic always goes before keep-alives. Callers get a QFuture, or use
+ * run() to wait for the result.
+ *
+ * Since every exchange passes through here, the executor also measures
+ * how busy the link is (see Stats).
+ */
+class DlpExecutor
+{
+public:
+    /**
+     * @brief Command priority; lower values run first
+     */
+    enum class Priority {
+        Sync = 0,       // Record traffic from conduits
+        Install = 1,    // Bulk transfers (pi_file_install, image backup)
+        KeepAlive = 2   // Tickles; only when nothing else is waiting
+    };
+    static constexpr int PriorityCount = 3;
+
+    /**
+     * @brief Link utilization since start or resetStats()
+     */
+    struct Stats
+    {
+        int commands = 0;
+        int perPriority[PriorityCount] = {};
+        qint64 busyUs = 0;          // Time spent running commands
+        qint64 queueWaitUs = 0;     // Summed time commands waited to start
+        qint64 maxQueueWaitUs = 0;
+        qint64 wallUs = 0;
+
+        double utilization() const { return wallUs > 0 ? double(busyUs) / wallUs : 0.0; }
+    };
+
+    explicit DlpExecutor(const QString &name = "DlpExecutor");
+
+    /**
+     * @brief Runs what is already queued, then stops the thread
+     */
+    ~DlpExecutor();
+
+    DlpExecutor(const DlpExecutor &) = delete;
+    DlpExecutor &operator=(const DlpExecutor &) = delete;
+
+    /**
+     * @brief Queue @p function and return a future for its result
+     */
+    template<typename F>
+    auto submit(Priority priority, F &&function) -> QFuture<std::invoke_result_t<F>>
+    {
+        using Result = std::invoke_result_t<F>;
+        auto promise = std::make_shared<QPromise<Result>>();
+        QFuture<Result> future = promise->future();
+
+        enqueue(priority, [promise, function = std::forward<F>(function)]() mutable {
+            promise->start();
+            if constexpr (std::is_void_v<Result>) {
+                function();
+            } else {
+                promise->addResult(function());
+            }
+        }, [promise]() {
+            promise->finish();
+        });
+        return future;
+    }
+
+    /**
+     * @brief Run @p function on the executor thread and wait for it
+     *
+     * Runs inline when called from the executor thread itself, so
+     * commands may use other commands.
+     */
+    template<typename F>
+    auto run(Priority priority, F &&function) -> std::invoke_result_t<F>
+    {
+        if (isExecutorThread()) {
+            return function();
+        }
+
+        auto future = submit(priority, std::forward<F>(function));
+        if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
+            future.waitForFinished();
+        } else {
+            return future.result();
+        }
+    }
+
+    bool isExecutorThread() const;
+
+    /**
+     * @brief Whether no command is running or waiting
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Milliseconds since the last command finished
+     */
+    qint64 idleMs() const;
+
+    Stats stats() const;
+    void resetStats();
+
+private:
+    struct Task
+    {
+        std::function<void()> function;
+        std::function<void()> complete;     // wakes the caller
+        qint64 queuedNs = 0;
+    };
+
+    void enqueue(Priority priority, std::function<void()> function,
+                 std::function<void()> complete);
+    bool hasTasks() const;
+    void loop();
+
+    QThread *m_thread = nullptr;
+    mutable QMutex m_mutex;         // protects everything below
+    QWaitCondition m_wake;
+    QList<Task> m_queues[PriorityCount];
+    bool m_running = false;
+    bool m_stopping = false;
+
+    QElapsedTimer m_clock;
+    std::atomic<qint64> m_lastActivityMs{0};
+    qint64 m_statsStartUs = 0;
+    Stats m_stats;
+};
+
+#endif // DLPEXECUTOR_H
@@ -0,0 +1,203 @@
+#include "dlptrace.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+namespace {
+
+void writeEntry(QDataStream &out, const DlpTraceEntry &entry, bool includePayload)
+{
+    out << static_cast<quint8>(entry.call)
+        << entry.result
+        << entry.handle
+        << entry.index
+        << entry.recordId
+        << entry.category
+        << entry.attributes
+        << entry.name
+        << entry.bytesSent
+        << entry.bytesReceived
+        << (includePayload ? entry.payload : QByteArray())
+        << entry.startUs
+        << entry.latencyUs;
+}
+
+void readEntry(QDataStream &in, DlpTraceEntry &entry)
+{
+    quint8 call = 0;
+    in >> call
+       >> entry.result
+       >> entry.handle
+       >> entry.index
+       >> entry.recordId
+       >> entry.category
+       >> entry.attributes
+       >> entry.name
+       >> entry.bytesSent
+       >> entry.bytesReceived
+       >> entry.payload
+       >> entry.startUs
+       >> entry.latencyUs;
+    entry.call = static_cast<DlpCall>(call);
+}
+
+} // namespace
+
+QString dlpCallName(DlpCall call)
+{
+    switch (call) {
+        case DlpCall::ReadUserInfo: return "dlp_ReadUserInfo";
+        case DlpCall::WriteUserInfo: return "dlp_WriteUserInfo";
+        case DlpCall::ReadSysInfo: return "dlp_ReadSysInfo";
+        case DlpCall::OpenDB: return "dlp_OpenDB";
+        case DlpCall::CloseDB: return "dlp_CloseDB";
+        case DlpCall::ReadDBList: return "dlp_ReadDBList";
+        case DlpCall::ReadRecordByIndex: return "dlp_ReadRecordByIndex";
+        case DlpCall::ReadRecordById: return "dlp_ReadRecordById";
+        case DlpCall::WriteRecord: return "dlp_WriteRecord";
+        case DlpCall::DeleteRecord: return "dlp_DeleteRecord";
+        case DlpCall::ReadAppBlock: return "dlp_ReadAppBlock";
+        case DlpCall::WriteAppBlock: return "dlp_WriteAppBlock";
+        case DlpCall::OpenConduit: return "dlp_OpenConduit";
+        case DlpCall::AddSyncLogEntry: return "dlp_AddSyncLogEntry";
+        case DlpCall::EndOfSync: return "dlp_EndOfSync";
+        case DlpCall::CleanUpDatabase: return "dlp_CleanUpDatabase";
+        case DlpCall::ResetSyncFlags: return "dlp_ResetSyncFlags";
+        case DlpCall::GetSysDateTime: return "dlp_GetSysDateTime";
+        case DlpCall::ReadStorageInfo: return "dlp_ReadStorageInfo";
+        case DlpCall::FileInstall: return "pi_file_install";
+        case DlpCall::FileRetrieve: return "pi_file_retrieve";
+    }
+    return QString("dlp_<%1>").arg(static_cast<int>(call));
+}
+
+bool isOutOfBandCall(DlpCall call)
+{
+    switch (call) {
+        case DlpCall::GetSysDateTime:
+        case DlpCall::ReadStorageInfo:
+        case DlpCall::FileInstall:
+        case DlpCall::FileRetrieve:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ========== DlpTraceWriter ==========
+
+DlpTraceWriter::~DlpTraceWriter()
+{
+    close();
+}
+
+bool DlpTraceWriter::open(const QString &path, const DlpTraceHeader &header)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_file.isOpen()) {
+        m_stream.setDevice(nullptr);
+        m_file.close();
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[DlpTraceWriter] Cannot create trace file:" << path << m_file.errorString();
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+    m_stream << MAGIC << VERSION
+             << header.recorded << header.devicePath << header.includesPayloads;
+
+    m_includePayloads = header.includesPayloads;
+    m_callCount = 0;
+
+    qDebug() << "[DlpTraceWriter] Recording DLP trace to" << path
+             << (m_includePayloads ? "(with payloads)" : "(sizes only)");
+    return true;
+}
+
+void DlpTraceWriter::close()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    qDebug() << "[DlpTraceWriter] Trace closed," << m_callCount << "calls recorded";
+}
+
+void DlpTraceWriter::record(const DlpTraceEntry &entry)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    writeEntry(m_stream, entry, m_includePayloads);
+    m_callCount++;
+}
+
+// ========== DlpTraceReader ==========
+
+bool DlpTraceReader::load(const QString &path)
+{
+    m_header = DlpTraceHeader();
+    m_entries.clear();
+    m_error.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = QString("Cannot open trace file: %1").arg(file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != DlpTraceWriter::MAGIC) {
+        m_error = "Not a DLP trace file";
+        return false;
+    }
+    if (version != DlpTraceWriter::VERSION) {
+        m_error = QString("Unsupported DLP trace version: %1").arg(version);
+        return false;
+    }
+
+    in >> m_header.recorded >> m_header.devicePath >> m_header.includesPayloads;
+    if (in.status() != QDataStream::Ok) {
+        m_error = "Truncated DLP trace header";
+        return false;
+    }
+
+    while (!in.atEnd()) {
+        DlpTraceEntry entry;
+        readEntry(in, entry);
+        if (in.status() != QDataStream::Ok) {
+            // Recording was cut off mid-call; keep what is complete
+            qWarning() << "[DlpTraceReader] Trace truncated after" << m_entries.size() << "calls";
+            break;
+        }
+        m_entries.append(entry);
+    }
+
+    return true;
+}
+
+qint64 DlpTraceReader::totalLatencyUs() const
+{
+    qint64 total = 0;
+    for (const DlpTraceEntry &entry : m_entries) {
+        total += entry.latencyUs;
+    }
+    return total;
+}
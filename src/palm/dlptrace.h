@@ -0,0 +1,170 @@
+#ifndef DLPTRACE_H
+#define DLPTRACE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief DLP calls made by KPilotDeviceLink, as recorded in a trace
+ *
+ * Values are part of the trace file format: append only, never renumber.
+ */
+enum class DlpCall : quint8 {
+    ReadUserInfo = 1,
+    WriteUserInfo,
+    ReadSysInfo,
+    OpenDB,
+    CloseDB,
+    ReadDBList,
+    ReadRecordByIndex,
+    ReadRecordById,
+    WriteRecord,
+    DeleteRecord,
+    ReadAppBlock,
+    WriteAppBlock,
+    OpenConduit,
+    AddSyncLogEntry,
+    EndOfSync,
+    CleanUpDatabase,
+    ResetSyncFlags,
+    GetSysDateTime,
+    ReadStorageInfo,
+    FileInstall,
+    FileRetrieve
+};
+
+/**
+ * @brief Whether @p call is made outside the KPilotLink interface
+ *
+ * Keep-alives and the raw calls of installs and image backups show up in
+ * traces but have no KPilotLink counterpart to replay them.
+ */
+bool isOutOfBandCall(DlpCall call);
+
+/**
+ * @brief Printable name of a DLP call ("dlp_ReadRecordByIndex", ...)
+ */
+QString dlpCallName(DlpCall call);
+
+/**
+ * @brief One DLP call as it crossed the link
+ *
+ * Which argument fields are meaningful depends on the call: @c handle is the
+ * database handle (or the handle returned by OpenDB), @c index the record or
+ * database list index, @c recordId / @c category / @c attributes the record
+ * metadata sent or received, @c name the database or user name.
+ */
+struct DlpTraceEntry
+{
+    DlpCall call = DlpCall::ReadUserInfo;
+    qint32 result = 0;          ///< pilot-link return value (< 0 = failure)
+    qint32 handle = 0;
+    qint32 index = 0;
+    quint32 recordId = 0;
+    quint8 category = 0;
+    quint8 attributes = 0;
+    QByteArray name;
+
+    quint32 bytesSent = 0;      ///< Payload bytes to the device
+    quint32 bytesReceived = 0;  ///< Payload bytes from the device
+    QByteArray payload;         ///< Payload itself (only if the trace includes payloads)
+
+    qint64 startUs = 0;         ///< Call start, relative to the start of the trace
+    quint32 latencyUs = 0;      ///< Wall-clock time spent inside the call
+
+    DlpTraceEntry() = default;
+    DlpTraceEntry(DlpCall c, qint32 r) : call(c), result(r) {}
+
+    bool failed() const { return result < 0; }
+};
+
+/**
+ * @brief Header of a DLP trace file
+ */
+struct DlpTraceHeader
+{
+    QDateTime recorded;         ///< When recording started
+    QString devicePath;         ///< Port the device was on
+    bool includesPayloads = false;
+};
+
+/**
+ * @brief Appends DLP calls to a compact binary trace file
+ *
+ * File layout: the magic "QPDT", a format version, the DlpTraceHeader, then
+ * one fixed-order QDataStream record per call until end of file. A call costs
+ * about 40 bytes plus its name and, if enabled, its payload.
+ *
+ * Payloads are off by default: record contents are the user's personal data,
+ * and sizes plus latencies are enough to see where link time goes. Traces
+ * without payloads replay with zero-filled records of the recorded size.
+ *
+ * Thread-safe; calls may be recorded from the sync worker and the main thread.
+ */
+class DlpTraceWriter
+{
+public:
+    static constexpr quint32 MAGIC = 0x51504454;   // "QPDT"
+    static constexpr quint16 VERSION = 1;
+
+    DlpTraceWriter() = default;
+    ~DlpTraceWriter();
+
+    /**
+     * @brief Create (truncate) the trace file and write its header
+     */
+    bool open(const QString &path, const DlpTraceHeader &header);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    /**
+     * @brief Append one call (its payload is dropped unless the header asked for payloads)
+     */
+    void record(const DlpTraceEntry &entry);
+
+    int callCount() const { return m_callCount; }
+
+private:
+    QFile m_file;
+    QDataStream m_stream;
+    QMutex m_mutex;
+    bool m_includePayloads = false;
+    int m_callCount = 0;
+};
+
+/**
+ * @brief Reads a trace file written by DlpTraceWriter
+ */
+class DlpTraceReader
+{
+public:
+    /**
+     * @brief Load a whole trace
+     * @return false if the file is missing, not a trace, or an unknown version
+     */
+    bool load(const QString &path);
+
+    DlpTraceHeader header() const { return m_header; }
+    QList<DlpTraceEntry> entries() const { return m_entries; }
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Sum of recorded call latencies (microseconds)
+     */
+    qint64 totalLatencyUs() const;
+
+private:
+    DlpTraceHeader m_header;
+    QList<DlpTraceEntry> m_entries;
+    QString m_error;
+};
+
+#endif // DLPTRACE_H
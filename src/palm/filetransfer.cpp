@@ -0,0 +1,64 @@
+#include "filetransfer.h"
+#include "kpilotdevicelink.h"
+#include "dlptrace.h"
+
+#include <QtGlobal>
+
+// pilot-link headers
+extern "C" {
+#include <pi-file.h>
+}
+
+namespace {
+
+// The progress callback only gets the socket; transfers run one at a time
+// per thread, so the check for the current one is kept here
+thread_local const std::function<bool()> *t_cancelCheck = nullptr;
+
+int reportProgress(int socket, pi_progress_t *progress)
+{
+    Q_UNUSED(socket);
+    Q_UNUSED(progress);
+    if (t_cancelCheck && *t_cancelCheck && (*t_cancelCheck)()) {
+        return PI_TRANSFER_STOP;
+    }
+    return PI_TRANSFER_CONTINUE;
+}
+
+class CancelScope
+{
+public:
+    explicit CancelScope(const std::function<bool()> &cancelCheck)
+        : m_previous(t_cancelCheck)
+    {
+        t_cancelCheck = &cancelCheck;
+    }
+    ~CancelScope() { t_cancelCheck = m_previous; }
+
+private:
+    const std::function<bool()> *m_previous;
+};
+
+} // namespace
+
+namespace FileTransfer {
+
+int install(struct pi_file *pf, int socket, int cardno,
+            const std::function<bool()> &cancelCheck)
+{
+    CancelScope scope(cancelCheck);
+    return KPilotDeviceLink::traceRaw(DlpCall::FileInstall, [&]() {
+        return pi_file_install(pf, socket, cardno, reportProgress);
+    });
+}
+
+int retrieve(struct pi_file *pf, int socket, int cardno,
+             const std::function<bool()> &cancelCheck)
+{
+    CancelScope scope(cancelCheck);
+    return KPilotDeviceLink::traceRaw(DlpCall::FileRetrieve, [&]() {
+        return pi_file_retrieve(pf, socket, cardno, reportProgress);
+    });
+}
+
+} // namespace FileTransfer
@@ -0,0 +1,31 @@
+#ifndef FILETRANSFER_H
+#define FILETRANSFER_H
+
+#include <functional>
+
+struct pi_file;
+
+/**
+ * @brief Cancellable pi_file_install() / pi_file_retrieve()
+ *
+ * pilot-link reports progress after every record or resource it moves.
+ * These wrappers answer that report with PI_TRANSFER_STOP once
+ * @p cancelCheck returns true, so a transfer stops within one record.
+ * pilot-link then takes its own failure path: it closes the database on
+ * the Palm, and an aborted install also deletes the half-written copy.
+ *
+ * An empty @p cancelCheck never cancels. Results are pilot-link's return
+ * codes; after a cancel they are negative. Run inside
+ * KPilotDeviceLink::execute(), each transfer is one call in the link's
+ * DLP trace.
+ */
+namespace FileTransfer {
+
+int install(struct pi_file *pf, int socket, int cardno,
+            const std::function<bool()> &cancelCheck);
+int retrieve(struct pi_file *pf, int socket, int cardno,
+             const std::function<bool()> &cancelCheck);
+
+} // namespace FileTransfer
+
+#endif // FILETRANSFER_H
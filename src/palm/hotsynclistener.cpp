@@ -0,0 +1,149 @@
+#include "hotsynclistener.h"
+#include "kpilotdevicelink.h"
+
+#include <pi-socket.h>
+
+#include <QDebug>
+
+// ============================================================================
+// PilotLinkAcceptor
+// ============================================================================
+
+PilotLinkAcceptor::PilotLinkAcceptor(const QString &address)
+    : m_address(address)
+{
+}
+
+PilotLinkAcceptor::~PilotLinkAcceptor()
+{
+    close();
+}
+
+KPilotLink *PilotLinkAcceptor::accept()
+{
+    while (true) {
+        int sock;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_closed) {
+                return nullptr;
+            }
+            sock = pi_socket(PI_AF_PILOT, PI_SOCK_STREAM, PI_PF_DLP);
+            if (sock < 0) {
+                qWarning() << "[PilotLinkAcceptor] Failed to create pilot-link socket, errno:" << errno;
+                return nullptr;
+            }
+            m_listenSocket = sock;
+        }
+
+        if (pi_bind(sock, m_address.toUtf8().constData()) < 0 || pi_listen(sock, 1) < 0) {
+            qWarning() << "[PilotLinkAcceptor] Failed to listen on" << m_address << "errno:" << errno;
+            QMutexLocker locker(&m_mutex);
+            if (m_listenSocket >= 0) {
+                pi_close(m_listenSocket);
+                m_listenSocket = -1;
+            }
+            return nullptr;
+        }
+
+        qDebug() << "[PilotLinkAcceptor] Waiting for HotSync on" << m_address;
+        int result = pi_accept(sock, nullptr, nullptr);
+
+        QMutexLocker locker(&m_mutex);
+        if (m_closed) {
+            // close() already released the socket
+            return nullptr;
+        }
+        m_listenSocket = -1;
+
+        if (result < 0) {
+            // A handshake that went wrong only loses that handheld
+            qWarning() << "[PilotLinkAcceptor] Accept failed, result:" << result << "errno:" << errno;
+            pi_close(sock);
+            continue;
+        }
+
+        KPilotDeviceLink *link = new KPilotDeviceLink(m_address);
+        link->adoptSocket(sock);
+        return link;
+    }
+}
+
+void PilotLinkAcceptor::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_closed = true;
+    if (m_listenSocket >= 0) {
+        // Interrupts a blocking pi_accept(), as ConnectionWorker::forceCloseSocket() does
+        pi_close(m_listenSocket);
+        m_listenSocket = -1;
+    }
+}
+
+// ============================================================================
+// HotSyncListener
+// ============================================================================
+
+HotSyncListener::HotSyncListener(LinkAcceptor *acceptor, QObject *parent)
+    : QObject(parent)
+    , m_acceptor(acceptor)
+{
+}
+
+HotSyncListener::~HotSyncListener()
+{
+    stop();
+}
+
+QString HotSyncListener::address() const
+{
+    return m_acceptor ? m_acceptor->address() : QString();
+}
+
+bool HotSyncListener::start()
+{
+    if (!m_acceptor || m_thread) {
+        return false;
+    }
+
+    m_thread = QThread::create([this]() { acceptLoop(); });
+    m_thread->setObjectName("HotSyncListener");
+    m_thread->start();
+
+    emit logMessage(QString("Listening for HotSync on %1").arg(address()));
+    return true;
+}
+
+void HotSyncListener::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_acceptor->close();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    emit logMessage(QString("Stopped listening on %1").arg(address()));
+    emit stopped();
+}
+
+bool HotSyncListener::isListening() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+void HotSyncListener::acceptLoop()
+{
+    while (KPilotLink *link = m_acceptor->accept()) {
+        int count = ++m_accepted;
+        qDebug() << "[HotSyncListener] Accepted handheld" << count << "on" << m_acceptor->address();
+
+        // Acceptors create links on this thread; receivers expect them in ours
+        if (link->thread() == QThread::currentThread()) {
+            link->moveToThread(thread());
+        }
+        emit linkAccepted(link);
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef HOTSYNCLISTENER_H
+#define HOTSYNCLISTENER_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+
+class KPilotLink;
+
+/**
+ * @brief Source of connected links for HotSyncListener
+ *
+ * accept() blocks until a handheld has connected and returns its link,
+ * or nullptr once close() has been called. close() is called from
+ * another thread and must wake a pending accept().
+ */
+class LinkAcceptor
+{
+public:
+    virtual ~LinkAcceptor() = default;
+
+    virtual KPilotLink *accept() = 0;
+    virtual void close() = 0;
+    virtual QString address() const = 0;
+};
+
+/**
+ * @brief Accepts HotSyncs with pilot-link, e.g. network HotSync on "net:any"
+ *
+ * pilot-link turns the listening socket into the connection when
+ * pi_accept() returns, so a fresh socket is bound for every handheld.
+ * Each accepted connection becomes a KPilotDeviceLink.
+ */
+class PilotLinkAcceptor : public LinkAcceptor
+{
+public:
+    explicit PilotLinkAcceptor(const QString &address = "net:any");
+    ~PilotLinkAcceptor() override;
+
+    KPilotLink *accept() override;
+    void close() override;
+    QString address() const override { return m_address; }
+
+private:
+    QString m_address;
+    QMutex m_mutex;          // protects m_listenSocket and m_closed
+    int m_listenSocket = -1;
+    bool m_closed = false;
+};
+
+/**
+ * @brief Accepts any number of handhelds, one after another
+ *
+ * Where KPilotDeviceLink waits for a single HotSync, the listener keeps
+ * accepting on a background thread and hands every connected link out
+ * through linkAccepted(), so several handhelds can sync at once (see
+ * Sync::MultiDeviceSync).
+ *
+ * Usage:
+ * @code
+ * HotSyncListener listener(new PilotLinkAcceptor("net:any"));
+ * connect(&listener, &HotSyncListener::linkAccepted,
+ *         &dispatcher, &Sync::MultiDeviceSync::handleLink);
+ * listener.start();
+ * @endcode
+ */
+class HotSyncListener : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Create a listener; takes ownership of @p acceptor
+     */
+    explicit HotSyncListener(LinkAcceptor *acceptor, QObject *parent = nullptr);
+    ~HotSyncListener() override;
+
+    QString address() const;
+
+    /**
+     * @brief Start accepting on the background thread
+     */
+    bool start();
+
+    /**
+     * @brief Stop accepting; links already handed out are unaffected
+     */
+    void stop();
+
+    bool isListening() const;
+    int acceptedCount() const { return m_accepted.load(); }
+
+signals:
+    /**
+     * @brief A handheld connected
+     *
+     * The link lives in the listener's thread and belongs to the receiver.
+     */
+    void linkAccepted(KPilotLink *link);
+
+    void logMessage(const QString &message);
+    void stopped();
+
+private:
+    void acceptLoop();
+
+    std::unique_ptr<LinkAcceptor> m_acceptor;
+    QThread *m_thread = nullptr;
+    std::atomic<int> m_accepted{0};
+};
+
+#endif // HOTSYNCLISTENER_H
@@ -1,5 +1,7 @@
 #include "kpilotdevicelink.h"
 #include "pilotrecord.h"
+#include "dlptrace.h"
+#include "../synclog.h"
 
 // pilot-link headers
 #include <pi-source.h>
@@ -10,6 +12,7 @@
 
 #include <QDebug>
 #include <QCoreApplication>
+#include <QDateTime>
 #include <cstring>
 
 // ============================================================================
@@ -22,18 +25,18 @@ ConnectionWorker::ConnectionWorker(const QString &devicePath, QObject *parent)
     , m_socket(-1)
     , m_cancelRequested(false)
 {
-    qDebug() << "[ConnectionWorker] Created for device:" << devicePath;
+    qCDebug(lcLink) << "[ConnectionWorker] Created for device:" << devicePath;
 }
 
 ConnectionWorker::~ConnectionWorker()
 {
-    qDebug() << "[ConnectionWorker] Destroyed";
+    qCDebug(lcLink) << "[ConnectionWorker] Destroyed";
     // Note: socket cleanup is handled by KPilotDeviceLink or forceCloseSocket
 }
 
 void ConnectionWorker::requestCancel()
 {
-    qDebug() << "[ConnectionWorker] Cancel requested";
+    qCDebug(lcLink) << "[ConnectionWorker] Cancel requested";
     m_cancelRequested = true;
 }
 
@@ -42,7 +45,7 @@ void ConnectionWorker::forceCloseSocket()
     QMutexLocker locker(&m_socketMutex);
     int sock = m_socket.load();
     if (sock >= 0) {
-        qDebug() << "[ConnectionWorker] Force-closing socket" << sock << "to interrupt pi_accept()";
+        qCDebug(lcLink) << "[ConnectionWorker] Force-closing socket" << sock << "to interrupt pi_accept()";
         m_cancelRequested = true;
         pi_close(sock);
         m_socket = -1;
@@ -51,17 +54,17 @@ void ConnectionWorker::forceCloseSocket()
 
 void ConnectionWorker::doConnect()
 {
-    qDebug() << "[ConnectionWorker] doConnect() starting on thread:" << QThread::currentThread();
-    qDebug() << "[ConnectionWorker] Device path:" << m_devicePath;
+    qCDebug(lcLink) << "[ConnectionWorker] doConnect() starting on thread:" << QThread::currentThread();
+    qCDebug(lcLink) << "[ConnectionWorker] Device path:" << m_devicePath;
 
     emit statusUpdate("Creating pilot-link socket...");
 
     // Create socket
-    qDebug() << "[ConnectionWorker] Calling pi_socket(PI_AF_PILOT, PI_SOCK_STREAM, PI_PF_DLP)";
+    qCDebug(lcLink) << "[ConnectionWorker] Calling pi_socket(PI_AF_PILOT, PI_SOCK_STREAM, PI_PF_DLP)";
     int sock = pi_socket(PI_AF_PILOT, PI_SOCK_STREAM, PI_PF_DLP);
     if (sock < 0) {
         QString error = QString("Failed to create pilot-link socket (errno: %1)").arg(errno);
-        qWarning() << "[ConnectionWorker]" << error;
+        qCWarning(lcLink) << "[ConnectionWorker]" << error;
         emit connectionFailed(error);
         return;
     }
@@ -70,10 +73,10 @@ void ConnectionWorker::doConnect()
         QMutexLocker locker(&m_socketMutex);
         m_socket = sock;
     }
-    qDebug() << "[ConnectionWorker] Socket created successfully, fd:" << sock;
+    qCDebug(lcLink) << "[ConnectionWorker] Socket created successfully, fd:" << sock;
 
     if (m_cancelRequested) {
-        qDebug() << "[ConnectionWorker] Cancel requested after socket creation";
+        qCDebug(lcLink) << "[ConnectionWorker] Cancel requested after socket creation";
         QMutexLocker locker(&m_socketMutex);
         if (m_socket >= 0) {
             pi_close(m_socket);
@@ -85,13 +88,13 @@ void ConnectionWorker::doConnect()
 
     // Bind to device
     emit statusUpdate(QString("Binding to device %1...").arg(m_devicePath));
-    qDebug() << "[ConnectionWorker] Calling pi_bind() with path:" << m_devicePath.toUtf8().constData();
+    qCDebug(lcLink) << "[ConnectionWorker] Calling pi_bind() with path:" << m_devicePath.toUtf8().constData();
 
     int bindResult = pi_bind(sock, m_devicePath.toUtf8().constData());
     if (bindResult < 0) {
         QString error = QString("Failed to bind to device %1 (result: %2, errno: %3)")
             .arg(m_devicePath).arg(bindResult).arg(errno);
-        qWarning() << "[ConnectionWorker]" << error;
+        qCWarning(lcLink) << "[ConnectionWorker]" << error;
         QMutexLocker locker(&m_socketMutex);
         if (m_socket >= 0) {
             pi_close(m_socket);
@@ -100,10 +103,10 @@ void ConnectionWorker::doConnect()
         emit connectionFailed(error);
         return;
     }
-    qDebug() << "[ConnectionWorker] Bind successful, result:" << bindResult;
+    qCDebug(lcLink) << "[ConnectionWorker] Bind successful, result:" << bindResult;
 
     if (m_cancelRequested) {
-        qDebug() << "[ConnectionWorker] Cancel requested after bind";
+        qCDebug(lcLink) << "[ConnectionWorker] Cancel requested after bind";
         QMutexLocker locker(&m_socketMutex);
         if (m_socket >= 0) {
             pi_close(m_socket);
@@ -115,13 +118,13 @@ void ConnectionWorker::doConnect()
 
     // Listen for connection
     emit statusUpdate("Listening for device...");
-    qDebug() << "[ConnectionWorker] Calling pi_listen() with backlog 1";
+    qCDebug(lcLink) << "[ConnectionWorker] Calling pi_listen() with backlog 1";
 
     int listenResult = pi_listen(sock, 1);
     if (listenResult < 0) {
         QString error = QString("Failed to listen on device (result: %1, errno: %2)")
             .arg(listenResult).arg(errno);
-        qWarning() << "[ConnectionWorker]" << error;
+        qCWarning(lcLink) << "[ConnectionWorker]" << error;
         QMutexLocker locker(&m_socketMutex);
         if (m_socket >= 0) {
             pi_close(m_socket);
@@ -130,10 +133,10 @@ void ConnectionWorker::doConnect()
         emit connectionFailed(error);
         return;
     }
-    qDebug() << "[ConnectionWorker] Listen successful";
+    qCDebug(lcLink) << "[ConnectionWorker] Listen successful";
 
     if (m_cancelRequested) {
-        qDebug() << "[ConnectionWorker] Cancel requested after listen";
+        qCDebug(lcLink) << "[ConnectionWorker] Cancel requested after listen";
         QMutexLocker locker(&m_socketMutex);
         if (m_socket >= 0) {
             pi_close(m_socket);
@@ -145,18 +148,18 @@ void ConnectionWorker::doConnect()
 
     // Accept connection - THIS BLOCKS until HotSync button is pressed
     emit statusUpdate("Waiting for HotSync button press... (press button on Palm now)");
-    qDebug() << "[ConnectionWorker] Calling pi_accept() - THIS WILL BLOCK until HotSync";
-    qDebug() << "[ConnectionWorker] Press the HotSync button on your Palm device now!";
+    qCDebug(lcLink) << "[ConnectionWorker] Calling pi_accept() - THIS WILL BLOCK until HotSync";
+    qCDebug(lcLink) << "[ConnectionWorker] Press the HotSync button on your Palm device now!";
 
     int acceptResult = pi_accept(sock, nullptr, nullptr);
     if (acceptResult < 0) {
         if (m_cancelRequested) {
-            qDebug() << "[ConnectionWorker] Accept interrupted - connection cancelled by user";
+            qCDebug(lcLink) << "[ConnectionWorker] Accept interrupted - connection cancelled by user";
             emit connectionFailed("Connection cancelled by user");
         } else {
             QString error = QString("Failed to accept connection (result: %1, errno: %2)")
                 .arg(acceptResult).arg(errno);
-            qWarning() << "[ConnectionWorker]" << error;
+            qCWarning(lcLink) << "[ConnectionWorker]" << error;
             emit connectionFailed(error);
         }
         // Socket may already be closed by forceCloseSocket(), check first
@@ -168,7 +171,7 @@ void ConnectionWorker::doConnect()
         return;
     }
 
-    qDebug() << "[ConnectionWorker] Connection accepted! Accept result:" << acceptResult;
+    qCDebug(lcLink) << "[ConnectionWorker] Connection accepted! Accept result:" << acceptResult;
     emit statusUpdate("Device connected!");
     emit connectionEstablished(sock);
 }
@@ -184,35 +187,36 @@ KPilotDeviceLink::KPilotDeviceLink(const QString &devicePath, QObject *parent)
     , m_isConnected(false)
     , m_workerThread(nullptr)
     , m_worker(nullptr)
+    , m_executor(std::make_unique<DlpExecutor>("DlpExecutor"))
 {
-    qDebug() << "[KPilotDeviceLink] Initialized for device:" << devicePath;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Initialized for device:" << devicePath;
     emit logMessage(QString("Initialized device link for: %1").arg(devicePath));
 }
 
 KPilotDeviceLink::~KPilotDeviceLink()
 {
-    qDebug() << "[KPilotDeviceLink] Destructor called";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Destructor called";
     closeConnection();
 }
 
 void KPilotDeviceLink::cleanupWorker()
 {
-    qDebug() << "[KPilotDeviceLink] cleanupWorker() called";
+    qCDebug(lcLink) << "[KPilotDeviceLink] cleanupWorker() called";
 
     if (m_worker) {
-        qDebug() << "[KPilotDeviceLink] Requesting worker cancellation";
+        qCDebug(lcLink) << "[KPilotDeviceLink] Requesting worker cancellation";
         m_worker->requestCancel();
     }
 
     if (m_workerThread) {
-        qDebug() << "[KPilotDeviceLink] Waiting for worker thread to finish...";
+        qCDebug(lcLink) << "[KPilotDeviceLink] Waiting for worker thread to finish...";
         m_workerThread->quit();
         if (!m_workerThread->wait(3000)) {
-            qWarning() << "[KPilotDeviceLink] Worker thread did not finish in time, terminating";
+            qCWarning(lcLink) << "[KPilotDeviceLink] Worker thread did not finish in time, terminating";
             m_workerThread->terminate();
             m_workerThread->wait();
         }
-        qDebug() << "[KPilotDeviceLink] Worker thread finished";
+        qCDebug(lcLink) << "[KPilotDeviceLink] Worker thread finished";
 
         delete m_workerThread;
         m_workerThread = nullptr;
@@ -224,10 +228,10 @@ void KPilotDeviceLink::cleanupWorker()
 
 void KPilotDeviceLink::cancelConnection()
 {
-    qDebug() << "[KPilotDeviceLink] cancelConnection() called";
+    qCDebug(lcLink) << "[KPilotDeviceLink] cancelConnection() called";
 
     if (!m_worker) {
-        qDebug() << "[KPilotDeviceLink] No active connection attempt to cancel";
+        qCDebug(lcLink) << "[KPilotDeviceLink] No active connection attempt to cancel";
         return;
     }
 
@@ -238,9 +242,9 @@ void KPilotDeviceLink::cancelConnection()
 
     // Wait for worker to finish cleanly
     if (m_workerThread) {
-        qDebug() << "[KPilotDeviceLink] Waiting for worker thread after cancel...";
+        qCDebug(lcLink) << "[KPilotDeviceLink] Waiting for worker thread after cancel...";
         if (!m_workerThread->wait(2000)) {
-            qWarning() << "[KPilotDeviceLink] Worker thread did not respond to cancel, terminating";
+            qCWarning(lcLink) << "[KPilotDeviceLink] Worker thread did not respond to cancel, terminating";
             m_workerThread->terminate();
             m_workerThread->wait();
         }
@@ -253,10 +257,10 @@ void KPilotDeviceLink::cancelConnection()
 
 bool KPilotDeviceLink::openConnection()
 {
-    qDebug() << "[KPilotDeviceLink] openConnection() called";
+    qCDebug(lcLink) << "[KPilotDeviceLink] openConnection() called";
 
     if (m_isConnected) {
-        qDebug() << "[KPilotDeviceLink] Already connected, returning true";
+        qCDebug(lcLink) << "[KPilotDeviceLink] Already connected, returning true";
         emit logMessage("Already connected");
         return true;
     }
@@ -268,7 +272,7 @@ bool KPilotDeviceLink::openConnection()
     setStatus(WaitingForDevice);
 
     // Create worker thread
-    qDebug() << "[KPilotDeviceLink] Creating worker thread";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Creating worker thread";
     m_workerThread = new QThread(this);
     m_worker = new ConnectionWorker(m_devicePath);
     m_worker->moveToThread(m_workerThread);
@@ -286,18 +290,32 @@ bool KPilotDeviceLink::openConnection()
     connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
 
     // Start the worker thread
-    qDebug() << "[KPilotDeviceLink] Starting worker thread";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Starting worker thread";
     m_workerThread->start();
 
     emit logMessage("Connection started in background - press HotSync button on Palm");
-    qDebug() << "[KPilotDeviceLink] openConnection() returning true (async)";
+    qCDebug(lcLink) << "[KPilotDeviceLink] openConnection() returning true (async)";
 
     return true;  // Connection started successfully (but not yet complete)
 }
 
+bool KPilotDeviceLink::adoptSocket(int socket)
+{
+    qCDebug(lcLink) << "[KPilotDeviceLink] adoptSocket() socket:" << socket;
+
+    if (socket < 0 || m_isConnected || isConnecting()) {
+        return false;
+    }
+
+    m_socket = socket;
+    m_isConnected = true;
+    setStatus(AcceptedDevice);
+    return true;
+}
+
 void KPilotDeviceLink::onConnectionEstablished(int socket)
 {
-    qDebug() << "[KPilotDeviceLink] onConnectionEstablished() socket:" << socket;
+    qCDebug(lcLink) << "[KPilotDeviceLink] onConnectionEstablished() socket:" << socket;
 
     m_socket = socket;
     m_isConnected = true;
@@ -306,12 +324,12 @@ void KPilotDeviceLink::onConnectionEstablished(int socket)
     emit logMessage("Device connected successfully!");
     emit connectionComplete(true);
 
-    qDebug() << "[KPilotDeviceLink] Connection established, m_isConnected = true";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Connection established, m_isConnected = true";
 }
 
 void KPilotDeviceLink::onConnectionFailed(const QString &error)
 {
-    qWarning() << "[KPilotDeviceLink] onConnectionFailed():" << error;
+    qCWarning(lcLink) << "[KPilotDeviceLink] onConnectionFailed():" << error;
 
     m_socket = -1;
     m_isConnected = false;
@@ -323,50 +341,70 @@ void KPilotDeviceLink::onConnectionFailed(const QString &error)
 
 void KPilotDeviceLink::onWorkerStatus(const QString &status)
 {
-    qDebug() << "[KPilotDeviceLink] Worker status:" << status;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Worker status:" << status;
     emit logMessage(status);
 }
 
 void KPilotDeviceLink::closeConnection()
 {
-    qDebug() << "[KPilotDeviceLink] closeConnection() called, m_isConnected:" << m_isConnected;
+    qCDebug(lcLink) << "[KPilotDeviceLink] closeConnection() called, m_isConnected:" << m_isConnected;
 
     // First clean up any pending worker
     cleanupWorker();
 
     if (m_socket >= 0) {
-        qDebug() << "[KPilotDeviceLink] Closing socket:" << m_socket;
+        qCDebug(lcLink) << "[KPilotDeviceLink] Closing socket:" << m_socket;
         emit logMessage("Closing connection...");
-        pi_close(m_socket);
-        m_socket = -1;
+        execute([this]() {
+            pi_close(m_socket);
+            m_socket = -1;
+            m_isConnected = false;
+        });
     }
 
+    stopTrace();
+
     m_isConnected = false;
     setStatus(Init);
-    qDebug() << "[KPilotDeviceLink] Connection closed";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Connection closed";
 }
 
 bool KPilotDeviceLink::readUserInfo(struct PilotUser &user)
 {
-    qDebug() << "[KPilotDeviceLink] readUserInfo() called";
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readUserInfo(user); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readUserInfo() called";
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readUserInfo() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readUserInfo() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_ReadUserInfo()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_ReadUserInfo()";
     struct PilotUser pilotUser;
+    qint64 callStart = traceStart();
     int result = dlp_ReadUserInfo(m_socket, &pilotUser);
+    countCall(0, result >= 0 ? sizeof(pilotUser) : 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::ReadUserInfo, result);
+        if (result >= 0) {
+            entry.recordId = pilotUser.userID;
+            entry.bytesReceived = sizeof(pilotUser);
+            entry.payload = QByteArray(pilotUser.username);
+        }
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ReadUserInfo() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ReadUserInfo() failed, result:" << result;
         setError("Failed to read user info");
         return false;
     }
 
     user = pilotUser;
-    qDebug() << "[KPilotDeviceLink] User info read successfully:"
+    qCDebug(lcLink) << "[KPilotDeviceLink] User info read successfully:"
              << "username=" << user.username
              << "userID=" << user.userID;
 
@@ -381,48 +419,75 @@ bool KPilotDeviceLink::readUserInfo(struct PilotUser &user)
 
 bool KPilotDeviceLink::writeUserInfo(const struct PilotUser &user)
 {
-    qDebug() << "[KPilotDeviceLink] writeUserInfo() called for user:" << user.username;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return writeUserInfo(user); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] writeUserInfo() called for user:" << user.username;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] writeUserInfo() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] writeUserInfo() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_WriteUserInfo()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_WriteUserInfo()";
+    qint64 callStart = traceStart();
     int result = dlp_WriteUserInfo(m_socket, const_cast<struct PilotUser*>(&user));
+    countCall(sizeof(user), 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::WriteUserInfo, result);
+        entry.recordId = user.userID;
+        entry.bytesSent = sizeof(user);
+        entry.payload = QByteArray(user.username);
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_WriteUserInfo() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_WriteUserInfo() failed, result:" << result;
         setError("Failed to write user info");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] User info written successfully";
+    qCDebug(lcLink) << "[KPilotDeviceLink] User info written successfully";
     emit logMessage(QString("User info updated: %1").arg(user.username));
     return true;
 }
 
 bool KPilotDeviceLink::readSysInfo(struct SysInfo &sysInfo)
 {
-    qDebug() << "[KPilotDeviceLink] readSysInfo() called";
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readSysInfo(sysInfo); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readSysInfo() called";
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readSysInfo() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readSysInfo() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_ReadSysInfo()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_ReadSysInfo()";
     struct SysInfo info;
+    qint64 callStart = traceStart();
     int result = dlp_ReadSysInfo(m_socket, &info);
+    countCall(0, result >= 0 ? sizeof(info) : 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::ReadSysInfo, result);
+        if (result >= 0) {
+            entry.recordId = info.romVersion;
+            entry.bytesReceived = sizeof(info);
+        }
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ReadSysInfo() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ReadSysInfo() failed, result:" << result;
         setError("Failed to read system info");
         return false;
     }
 
     sysInfo = info;
-    qDebug() << "[KPilotDeviceLink] System info read:"
+    qCDebug(lcLink) << "[KPilotDeviceLink] System info read:"
              << "romVersion=0x" << Qt::hex << sysInfo.romVersion
              << "prodID=" << sysInfo.prodID;
 
@@ -435,11 +500,15 @@ bool KPilotDeviceLink::readSysInfo(struct SysInfo &sysInfo)
 
 int KPilotDeviceLink::openDatabase(const QString &dbName, bool readWrite)
 {
-    qDebug() << "[KPilotDeviceLink] openDatabase() called for:" << dbName
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return openDatabase(dbName, readWrite); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] openDatabase() called for:" << dbName
              << "readWrite:" << readWrite;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] openDatabase() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] openDatabase() - not connected";
         setError("Not connected");
         return -1;
     }
@@ -447,52 +516,76 @@ int KPilotDeviceLink::openDatabase(const QString &dbName, bool readWrite)
     int dbHandle = 0;
     int mode = readWrite ? (dlpOpenRead | dlpOpenWrite) : dlpOpenRead;
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_OpenDB() mode:" << mode;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_OpenDB() mode:" << mode;
     emit logMessage(QString("Opening database: %1 (%2)")
                    .arg(dbName, readWrite ? "read-write" : "read-only"));
 
+    qint64 callStart = traceStart();
     int result = dlp_OpenDB(m_socket, 0, mode, dbName.toUtf8().constData(), &dbHandle);
+    countCall(dbName.size(), 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::OpenDB, result);
+        entry.handle = dbHandle;
+        entry.index = mode;
+        entry.name = dbName.toUtf8();
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_OpenDB() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_OpenDB() failed, result:" << result;
         setError(QString("Failed to open database: %1").arg(dbName));
         return -1;
     }
 
-    qDebug() << "[KPilotDeviceLink] Database opened, handle:" << dbHandle;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Database opened, handle:" << dbHandle;
     emit logMessage(QString("Database opened with handle: %1").arg(dbHandle));
     return dbHandle;
 }
 
 bool KPilotDeviceLink::closeDatabase(int handle)
 {
-    qDebug() << "[KPilotDeviceLink] closeDatabase() called for handle:" << handle;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return closeDatabase(handle); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] closeDatabase() called for handle:" << handle;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] closeDatabase() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] closeDatabase() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_CloseDB()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_CloseDB()";
+    qint64 callStart = traceStart();
     int result = dlp_CloseDB(m_socket, handle);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::CloseDB, result);
+        entry.handle = handle;
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_CloseDB() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_CloseDB() failed, result:" << result;
         setError(QString("Failed to close database handle: %1").arg(handle));
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Database closed successfully";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Database closed successfully";
     emit logMessage(QString("Database closed: %1").arg(handle));
     return true;
 }
 
 QStringList KPilotDeviceLink::listDatabases()
 {
-    qDebug() << "[KPilotDeviceLink] listDatabases() called";
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return listDatabases(); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] listDatabases() called";
     QStringList databases;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] listDatabases() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] listDatabases() - not connected";
         setError("Not connected");
         return databases;
     }
@@ -503,13 +596,24 @@ QStringList KPilotDeviceLink::listDatabases()
     int dbIndex = 0;
     int flags = dlpDBListRAM;  // List databases in RAM
 
-    qDebug() << "[KPilotDeviceLink] Starting database enumeration";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Starting database enumeration";
 
     while (true) {
         struct DBInfo info;
+        qint64 callStart = traceStart();
         int result = dlp_ReadDBList(m_socket, 0, flags, dbIndex, buffer);
+        countCall(0, result >= 0 ? buffer->used : 0);
+        if (m_trace) {
+            DlpTraceEntry entry(DlpCall::ReadDBList, result);
+            entry.index = dbIndex;
+            if (result >= 0) {
+                entry.bytesReceived = buffer->used;
+                entry.name = QByteArray(reinterpret_cast<const DBInfo*>(buffer->data)->name);
+            }
+            traceCall(entry, callStart);
+        }
         if (result < 0) {
-            qDebug() << "[KPilotDeviceLink] dlp_ReadDBList() ended at index:" << dbIndex;
+            qCDebug(lcLink) << "[KPilotDeviceLink] dlp_ReadDBList() ended at index:" << dbIndex;
             break;
         }
 
@@ -519,25 +623,29 @@ QStringList KPilotDeviceLink::listDatabases()
         QString dbName = QString::fromLatin1(info.name);
         databases.append(dbName);
 
-        qDebug() << "[KPilotDeviceLink] Found database:" << dbName;
+        qCDebug(lcLink) << "[KPilotDeviceLink] Found database:" << dbName;
         emit logMessage(QString("  Found: %1").arg(dbName));
         dbIndex++;
     }
 
     pi_buffer_free(buffer);
 
-    qDebug() << "[KPilotDeviceLink] Total databases found:" << databases.size();
+    qCDebug(lcLink) << "[KPilotDeviceLink] Total databases found:" << databases.size();
     emit logMessage(QString("Found %1 databases").arg(databases.size()));
     return databases;
 }
 
 QList<PilotRecord*> KPilotDeviceLink::readAllRecords(int dbHandle)
 {
-    qDebug() << "[KPilotDeviceLink] readAllRecords() called for handle:" << dbHandle;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readAllRecords(dbHandle); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readAllRecords() called for handle:" << dbHandle;
     QList<PilotRecord*> records;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readAllRecords() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readAllRecords() - not connected";
         setError("Not connected");
         return records;
     }
@@ -548,21 +656,34 @@ QList<PilotRecord*> KPilotDeviceLink::readAllRecords(int dbHandle)
     int index = 0;
 
     while (m_isConnected) {
+        // Checked per record: a large database takes minutes to read
+        if (isCancelled()) {
+            qCDebug(lcLink) << "[KPilotDeviceLink] readAllRecords() cancelled at index:" << index;
+            emit logMessage(QString("Reading cancelled after %1 records").arg(index));
+            break;
+        }
+
         recordid_t id = 0;
         int attr = 0;
         int category = 0;
 
+        qint64 callStart = traceStart();
         int result = dlp_ReadRecordByIndex(m_socket, dbHandle, index,
                                           buffer, &id, &attr, &category);
+        countCall(0, result >= 0 ? buffer->used : 0);
+        if (m_trace) {
+            traceRecordRead(DlpCall::ReadRecordByIndex, result, dbHandle, index,
+                            id, category, attr, buffer->data, buffer->used, callStart);
+        }
 
         if (result < 0) {
             if (index == 0) {
-                qWarning() << "[KPilotDeviceLink] Failed to read first record, possible disconnect";
+                qCWarning(lcLink) << "[KPilotDeviceLink] Failed to read first record, possible disconnect";
                 setError("Failed to read records - device may be disconnected");
                 setStatus(PilotLinkError);
                 m_isConnected = false;
             } else {
-                qDebug() << "[KPilotDeviceLink] End of records at index:" << index;
+                qCDebug(lcLink) << "[KPilotDeviceLink] End of records at index:" << index;
             }
             break;
         }
@@ -572,7 +693,7 @@ QList<PilotRecord*> KPilotDeviceLink::readAllRecords(int dbHandle)
         records.append(record);
 
         if (index % 50 == 0 && index > 0) {
-            qDebug() << "[KPilotDeviceLink] Read" << index << "records so far...";
+            qCDebug(lcLink) << "[KPilotDeviceLink] Read" << index << "records so far...";
         }
 
         index++;
@@ -580,17 +701,21 @@ QList<PilotRecord*> KPilotDeviceLink::readAllRecords(int dbHandle)
 
     pi_buffer_free(buffer);
 
-    qDebug() << "[KPilotDeviceLink] Total records read:" << records.size();
+    qCDebug(lcLink) << "[KPilotDeviceLink] Total records read:" << records.size();
     emit logMessage(QString("Read %1 records").arg(records.size()));
     return records;
 }
 
 PilotRecord* KPilotDeviceLink::readRecordByIndex(int dbHandle, int index)
 {
-    qDebug() << "[KPilotDeviceLink] readRecordByIndex() handle:" << dbHandle << "index:" << index;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readRecordByIndex(dbHandle, index); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readRecordByIndex() handle:" << dbHandle << "index:" << index;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readRecordByIndex() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readRecordByIndex() - not connected";
         setError("Not connected");
         return nullptr;
     }
@@ -600,11 +725,17 @@ PilotRecord* KPilotDeviceLink::readRecordByIndex(int dbHandle, int index)
     int attr = 0;
     int category = 0;
 
+    qint64 callStart = traceStart();
     int result = dlp_ReadRecordByIndex(m_socket, dbHandle, index,
                                       buffer, &id, &attr, &category);
+    countCall(0, result >= 0 ? buffer->used : 0);
+    if (m_trace) {
+        traceRecordRead(DlpCall::ReadRecordByIndex, result, dbHandle, index,
+                        id, category, attr, buffer->data, buffer->used, callStart);
+    }
 
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ReadRecordByIndex() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ReadRecordByIndex() failed, result:" << result;
         pi_buffer_free(buffer);
         setError(QString("Failed to read record at index: %1").arg(index));
         return nullptr;
@@ -614,16 +745,20 @@ PilotRecord* KPilotDeviceLink::readRecordByIndex(int dbHandle, int index)
     PilotRecord *record = new PilotRecord(id, category, attr, data);
 
     pi_buffer_free(buffer);
-    qDebug() << "[KPilotDeviceLink] Record read successfully, id:" << id;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Record read successfully, id:" << id;
     return record;
 }
 
 PilotRecord* KPilotDeviceLink::readRecordById(int dbHandle, int recordId)
 {
-    qDebug() << "[KPilotDeviceLink] readRecordById() handle:" << dbHandle << "id:" << recordId;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readRecordById(dbHandle, recordId); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readRecordById() handle:" << dbHandle << "id:" << recordId;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readRecordById() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readRecordById() - not connected";
         setError("Not connected");
         return nullptr;
     }
@@ -633,11 +768,17 @@ PilotRecord* KPilotDeviceLink::readRecordById(int dbHandle, int recordId)
     int category = 0;
     int index = 0;
 
+    qint64 callStart = traceStart();
     int result = dlp_ReadRecordById(m_socket, dbHandle, recordId, buffer,
                                    &index, &attr, &category);
+    countCall(0, result >= 0 ? buffer->used : 0);
+    if (m_trace) {
+        traceRecordRead(DlpCall::ReadRecordById, result, dbHandle, index,
+                        recordId, category, attr, buffer->data, buffer->used, callStart);
+    }
 
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ReadRecordById() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ReadRecordById() failed, result:" << result;
         pi_buffer_free(buffer);
         setError(QString("Failed to read record by ID: %1").arg(recordId));
         return nullptr;
@@ -647,23 +788,27 @@ PilotRecord* KPilotDeviceLink::readRecordById(int dbHandle, int recordId)
     PilotRecord *record = new PilotRecord(recordId, category, attr, data);
 
     pi_buffer_free(buffer);
-    qDebug() << "[KPilotDeviceLink] Record read successfully by id:" << recordId;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Record read successfully by id:" << recordId;
     return record;
 }
 
 bool KPilotDeviceLink::writeRecord(int dbHandle, PilotRecord *record)
 {
-    qDebug() << "[KPilotDeviceLink] writeRecord() called for handle:" << dbHandle
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return writeRecord(dbHandle, record); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] writeRecord() called for handle:" << dbHandle
              << "recordId:" << record->id() << "category:" << record->category();
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] writeRecord() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] writeRecord() - not connected";
         setError("Not connected");
         return false;
     }
 
     if (!record) {
-        qWarning() << "[KPilotDeviceLink] writeRecord() - null record";
+        qCWarning(lcLink) << "[KPilotDeviceLink] writeRecord() - null record";
         setError("Cannot write null record");
         return false;
     }
@@ -675,21 +820,32 @@ bool KPilotDeviceLink::writeRecord(int dbHandle, PilotRecord *record)
     // recuid: 0 = create new record, otherwise update existing
     recordid_t recuid = record->id();
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_WriteRecord() size:" << data.size()
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_WriteRecord() size:" << data.size()
              << "category:" << record->category() << "recuid:" << recuid;
 
+    qint64 callStart = traceStart();
     int result = dlp_WriteRecord(m_socket, dbHandle, 0, recuid,
                                  record->category(),
                                  reinterpret_cast<const void*>(data.constData()),
                                  data.size(), &newRecordId);
+    countCall(data.size(), 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::WriteRecord, result);
+        entry.handle = dbHandle;
+        entry.recordId = (result >= 0 && newRecordId != 0) ? newRecordId : recuid;
+        entry.category = record->category();
+        entry.bytesSent = data.size();
+        entry.payload = data;
+        traceCall(entry, callStart);
+    }
 
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_WriteRecord() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_WriteRecord() failed, result:" << result;
         setError(QString("Failed to write record: error %1").arg(result));
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Record written successfully, newRecordId:" << newRecordId;
+    qCDebug(lcLink) << "[KPilotDeviceLink] Record written successfully, newRecordId:" << newRecordId;
 
     // Update record with new ID if it was a create operation
     if (recuid == 0 && newRecordId != 0) {
@@ -703,44 +859,71 @@ bool KPilotDeviceLink::writeRecord(int dbHandle, PilotRecord *record)
 
 bool KPilotDeviceLink::deleteRecord(int dbHandle, int recordId)
 {
-    qDebug() << "[KPilotDeviceLink] deleteRecord() handle:" << dbHandle << "recordId:" << recordId;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return deleteRecord(dbHandle, recordId); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] deleteRecord() handle:" << dbHandle << "recordId:" << recordId;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] deleteRecord() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] deleteRecord() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_DeleteRecord()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_DeleteRecord()";
+    qint64 callStart = traceStart();
     int result = dlp_DeleteRecord(m_socket, dbHandle, 0, recordId);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::DeleteRecord, result);
+        entry.handle = dbHandle;
+        entry.recordId = recordId;
+        traceCall(entry, callStart);
+    }
 
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_DeleteRecord() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_DeleteRecord() failed, result:" << result;
         setError(QString("Failed to delete record %1: error %2").arg(recordId).arg(result));
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Record deleted successfully";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Record deleted successfully";
     emit logMessage(QString("Record deleted (ID: %1)").arg(recordId));
     return true;
 }
 
 bool KPilotDeviceLink::readAppBlock(int dbHandle, unsigned char *buffer, size_t *size)
 {
-    qDebug() << "[KPilotDeviceLink] readAppBlock() called for handle:" << dbHandle;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return readAppBlock(dbHandle, buffer, size); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] readAppBlock() called for handle:" << dbHandle;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] readAppBlock() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] readAppBlock() - not connected";
         setError("Not connected");
         return false;
     }
 
     pi_buffer_t *buf = pi_buffer_new(0xffff);
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_ReadAppBlock()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_ReadAppBlock()";
+    qint64 callStart = traceStart();
     int result = dlp_ReadAppBlock(m_socket, dbHandle, 0, -1, buf);
+    countCall(0, result >= 0 ? buf->used : 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::ReadAppBlock, result);
+        entry.handle = dbHandle;
+        if (result >= 0) {
+            entry.bytesReceived = buf->used;
+            entry.payload = QByteArray(reinterpret_cast<const char*>(buf->data), buf->used);
+        }
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ReadAppBlock() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ReadAppBlock() failed, result:" << result;
         pi_buffer_free(buf);
         setError("Failed to read AppInfo block");
         return false;
@@ -750,7 +933,7 @@ bool KPilotDeviceLink::readAppBlock(int dbHandle, unsigned char *buffer, size_t
     memcpy(buffer, buf->data, buf->used);
 
     pi_buffer_free(buf);
-    qDebug() << "[KPilotDeviceLink] AppInfo block read," << *size << "bytes";
+    qCDebug(lcLink) << "[KPilotDeviceLink] AppInfo block read," << *size << "bytes";
     emit logMessage(QString("Read AppInfo block (%1 bytes)").arg(*size));
 
     return true;
@@ -758,65 +941,92 @@ bool KPilotDeviceLink::readAppBlock(int dbHandle, unsigned char *buffer, size_t
 
 bool KPilotDeviceLink::writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size)
 {
-    qDebug() << "[KPilotDeviceLink] writeAppBlock() called for handle:" << dbHandle
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return writeAppBlock(dbHandle, buffer, size); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] writeAppBlock() called for handle:" << dbHandle
              << "size:" << size;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] writeAppBlock() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] writeAppBlock() - not connected";
         setError("Not connected");
         return false;
     }
 
     if (!buffer || size == 0) {
-        qWarning() << "[KPilotDeviceLink] writeAppBlock() - invalid buffer";
+        qCWarning(lcLink) << "[KPilotDeviceLink] writeAppBlock() - invalid buffer";
         setError("Invalid buffer");
         return false;
     }
 
+    qint64 callStart = traceStart();
     int result = dlp_WriteAppBlock(m_socket, dbHandle,
                                    reinterpret_cast<const void*>(buffer), size);
+    countCall(size, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::WriteAppBlock, result);
+        entry.handle = dbHandle;
+        entry.bytesSent = size;
+        entry.payload = QByteArray(reinterpret_cast<const char*>(buffer), size);
+        traceCall(entry, callStart);
+    }
 
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_WriteAppBlock() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_WriteAppBlock() failed, result:" << result;
         setError(QString("Failed to write AppInfo block: error %1").arg(result));
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] AppInfo block written successfully";
+    qCDebug(lcLink) << "[KPilotDeviceLink] AppInfo block written successfully";
     emit logMessage(QString("AppInfo block written (%1 bytes)").arg(size));
     return true;
 }
 
 bool KPilotDeviceLink::beginSync()
 {
-    qDebug() << "[KPilotDeviceLink] beginSync() called";
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return beginSync(); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] beginSync() called";
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] beginSync() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] beginSync() - not connected";
         setError("Not connected");
         return false;
     }
 
     emit logMessage("Beginning sync...");
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_OpenConduit()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_OpenConduit()";
+    qint64 callStart = traceStart();
     int result = dlp_OpenConduit(m_socket);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::OpenConduit, result);
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_OpenConduit() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_OpenConduit() failed, result:" << result;
         setError("Failed to open sync conduit");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Sync conduit opened";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Sync conduit opened";
     return true;
 }
 
 bool KPilotDeviceLink::endSync()
 {
-    qDebug() << "[KPilotDeviceLink] endSync() called";
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return endSync(); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] endSync() called";
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] endSync() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] endSync() - not connected";
         setError("Not connected");
         return false;
     }
@@ -824,21 +1034,35 @@ bool KPilotDeviceLink::endSync()
     emit logMessage("Ending sync...");
 
     char logEntry[] = "Sync completed by QPilotSync.\n";
-    qDebug() << "[KPilotDeviceLink] Adding sync log entry";
-    if (dlp_AddSyncLogEntry(m_socket, logEntry) < 0) {
-        qWarning() << "[KPilotDeviceLink] Failed to add sync log entry (non-fatal)";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Adding sync log entry";
+    qint64 callStart = traceStart();
+    int logResult = dlp_AddSyncLogEntry(m_socket, logEntry);
+    countCall(sizeof(logEntry), 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::AddSyncLogEntry, logResult);
+        entry.bytesSent = sizeof(logEntry);
+        traceCall(entry, callStart);
+    }
+    if (logResult < 0) {
+        qCWarning(lcLink) << "[KPilotDeviceLink] Failed to add sync log entry (non-fatal)";
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_EndOfSync()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_EndOfSync()";
+    callStart = traceStart();
     int result = dlp_EndOfSync(m_socket, 0);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::EndOfSync, result);
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_EndOfSync() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_EndOfSync() failed, result:" << result;
         setError("Failed to end sync");
         return false;
     }
 
     setStatus(SyncDone);
-    qDebug() << "[KPilotDeviceLink] Sync complete!";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Sync complete!";
     emit logMessage("Sync complete!");
 
     return true;
@@ -846,44 +1070,182 @@ bool KPilotDeviceLink::endSync()
 
 bool KPilotDeviceLink::cleanUpDatabase(int dbHandle)
 {
-    qDebug() << "[KPilotDeviceLink] cleanUpDatabase() called for handle:" << dbHandle;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return cleanUpDatabase(dbHandle); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] cleanUpDatabase() called for handle:" << dbHandle;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] cleanUpDatabase() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] cleanUpDatabase() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_CleanUpDatabase()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_CleanUpDatabase()";
+    qint64 callStart = traceStart();
     int result = dlp_CleanUpDatabase(m_socket, dbHandle);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::CleanUpDatabase, result);
+        entry.handle = dbHandle;
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_CleanUpDatabase() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_CleanUpDatabase() failed, result:" << result;
         setError("Failed to clean up database");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Database cleanup complete";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Database cleanup complete";
     return true;
 }
 
 bool KPilotDeviceLink::resetSyncFlags(int dbHandle)
 {
-    qDebug() << "[KPilotDeviceLink] resetSyncFlags() called for handle:" << dbHandle;
+    if (!m_executor->isExecutorThread()) {
+        return execute([&]() { return resetSyncFlags(dbHandle); });
+    }
+
+    qCDebug(lcLink) << "[KPilotDeviceLink] resetSyncFlags() called for handle:" << dbHandle;
 
     if (!m_isConnected) {
-        qWarning() << "[KPilotDeviceLink] resetSyncFlags() - not connected";
+        qCWarning(lcLink) << "[KPilotDeviceLink] resetSyncFlags() - not connected";
         setError("Not connected");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Calling dlp_ResetSyncFlags()";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Calling dlp_ResetSyncFlags()";
+    qint64 callStart = traceStart();
     int result = dlp_ResetSyncFlags(m_socket, dbHandle);
+    countCall(0, 0);
+    if (m_trace) {
+        DlpTraceEntry entry(DlpCall::ResetSyncFlags, result);
+        entry.handle = dbHandle;
+        traceCall(entry, callStart);
+    }
     if (result < 0) {
-        qWarning() << "[KPilotDeviceLink] dlp_ResetSyncFlags() failed, result:" << result;
+        qCWarning(lcLink) << "[KPilotDeviceLink] dlp_ResetSyncFlags() failed, result:" << result;
         setError("Failed to reset sync flags");
         return false;
     }
 
-    qDebug() << "[KPilotDeviceLink] Sync flags reset complete";
+    qCDebug(lcLink) << "[KPilotDeviceLink] Sync flags reset complete";
+    return true;
+}
+
+// ========== DLP Thread ==========
+
+KPilotDeviceLink::TickleResult KPilotDeviceLink::tickle(int minIdleMs)
+{
+    // Never queue behind a sync: it keeps the Palm awake by itself
+    if (!m_executor->isIdle()) {
+        return TickleResult::Busy;
+    }
+
+    auto keepAlive = [this, minIdleMs]() {
+        if (idleMs() < minIdleMs) {
+            return TickleResult::NotIdle;
+        }
+        if (!m_isConnected || m_socket < 0) {
+            return TickleResult::Failed;
+        }
+
+        // dlp_GetSysDateTime is the cheapest call that needs an answer
+        time_t palmTime = 0;
+        qint64 callStart = traceStart();
+        int result = dlp_GetSysDateTime(m_socket, &palmTime);
+        countCall(0, result >= 0 ? sizeof(palmTime) : 0);
+        if (m_trace) {
+            DlpTraceEntry entry(DlpCall::GetSysDateTime, result);
+            entry.bytesReceived = result >= 0 ? sizeof(palmTime) : 0;
+            traceCall(entry, callStart);
+        }
+        return result < 0 ? TickleResult::Failed : TickleResult::Sent;
+    };
+    return m_executor->run(DlpExecutor::Priority::KeepAlive, keepAlive);
+}
+
+// ========== Wire Trace ==========
+
+bool KPilotDeviceLink::startTrace(const QString &path, bool includePayloads)
+{
+    stopTrace();
+
+    DlpTraceHeader header;
+    header.recorded = QDateTime::currentDateTime();
+    header.devicePath = m_devicePath;
+    header.includesPayloads = includePayloads;
+
+    auto writer = std::make_unique<DlpTraceWriter>();
+    if (!writer->open(path, header)) {
+        emit logMessage(QString("Cannot record DLP trace to %1: %2").arg(path, writer->errorString()));
+        return false;
+    }
+
+    m_trace = std::move(writer);
+    m_traceClock.start();
+    emit logMessage(QString("Recording DLP trace to %1").arg(path));
     return true;
 }
+
+void KPilotDeviceLink::stopTrace()
+{
+    if (!m_trace) {
+        return;
+    }
+
+    emit logMessage(QString("DLP trace closed (%1 calls): %2")
+                   .arg(m_trace->callCount()).arg(m_trace->fileName()));
+    m_trace.reset();
+}
+
+thread_local KPilotDeviceLink *KPilotDeviceLink::s_executingLink = nullptr;
+
+qint64 KPilotDeviceLink::rawCallStart()
+{
+    return s_executingLink ? s_executingLink->traceStart() : 0;
+}
+
+void KPilotDeviceLink::rawCallDone(DlpCall call, int result, int index, qint64 startNs)
+{
+    KPilotDeviceLink *link = s_executingLink;
+    if (!link) {
+        return;
+    }
+    link->countCall(0, 0);
+    if (link->m_trace) {
+        DlpTraceEntry entry(call, result);
+        entry.index = index;
+        link->traceCall(entry, startNs);
+    }
+}
+
+qint64 KPilotDeviceLink::traceStart() const
+{
+    return m_trace ? m_traceClock.nsecsElapsed() : 0;
+}
+
+void KPilotDeviceLink::traceCall(DlpTraceEntry &entry, qint64 startNs)
+{
+    entry.startUs = startNs / 1000;
+    entry.latencyUs = static_cast<quint32>((m_traceClock.nsecsElapsed() - startNs) / 1000);
+    m_trace->record(entry);
+}
+
+void KPilotDeviceLink::traceRecordRead(DlpCall call, int result, int dbHandle, int index,
+                                       quint32 recordId, int category, int attributes,
+                                       const void *data, size_t size, qint64 startNs)
+{
+    DlpTraceEntry entry(call, result);
+    entry.handle = dbHandle;
+    entry.index = index;
+    if (result >= 0) {
+        entry.recordId = recordId;
+        entry.category = category;
+        entry.attributes = attributes;
+        entry.bytesReceived = size;
+        entry.payload = QByteArray(static_cast<const char*>(data), size);
+    }
+    traceCall(entry, startNs);
+}
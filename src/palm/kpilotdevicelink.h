@@ -2,10 +2,17 @@
 #define KPILOTDEVICELINK_H
 
 #include "kpilotlink.h"
+#include "dlpexecutor.h"
 #include <QString>
 #include <QThread>
 #include <QMutex>
+#include <QElapsedTimer>
 #include <atomic>
+#include <memory>
+
+class DlpTraceWriter;
+struct DlpTraceEntry;
+enum class DlpCall : quint8;
 
 /**
  * @brief Worker object for blocking pilot-link connection in separate thread
@@ -63,7 +70,7 @@ public:
     LinkStatus status() const override { return m_status; }
 
     // Check if fully connected (async connection complete)
-    bool isConnected() const { return m_isConnected; }
+    bool isConnected() const override { return m_isConnected; }
 
     // Check if connection attempt is in progress
     bool isConnecting() const { return m_workerThread != nullptr && m_workerThread->isRunning(); }
@@ -74,6 +81,14 @@ public:
     // Cancel a pending connection attempt
     void cancelConnection();
 
+    /**
+     * @brief Take over a socket that is already connected
+     *
+     * Used by HotSyncListener, which accepts handhelds itself rather than
+     * through openConnection(). The link closes the socket from then on.
+     */
+    bool adoptSocket(int socket);
+
     bool readUserInfo(struct PilotUser &user) override;
     bool writeUserInfo(const struct PilotUser &user) override;
     bool readSysInfo(struct SysInfo &sysInfo) override;
@@ -100,7 +115,7 @@ public:
      * Removes records marked for deletion from the Palm database.
      * Should be called after sync to finalize deletions.
      */
-    bool cleanUpDatabase(int dbHandle);
+    bool cleanUpDatabase(int dbHandle) override;
 
     /**
      * @brief Reset sync flags (dirty bits) on all records
@@ -108,7 +123,85 @@ public:
      * Clears the "modified" flag on all records in the database.
      * Should be called after a successful sync.
      */
-    bool resetSyncFlags(int dbHandle);
+    bool resetSyncFlags(int dbHandle) override;
+
+    // ========== Wire Trace ==========
+
+    /**
+     * @brief Record every DLP call to a binary trace file
+     *
+     * Each call is stored with its arguments, payload sizes, result and
+     * wall-clock latency; KPilotReplayLink plays a trace back offline.
+     * Recording stops at closeConnection() or stopTrace().
+     *
+     * @param includePayloads Also store record contents (personal data)
+     */
+    bool startTrace(const QString &path, bool includePayloads = false);
+    void stopTrace();
+    bool isTracing() const { return m_trace != nullptr; }
+
+    // ========== DLP Thread ==========
+
+    /**
+     * @brief Run @p function on the link's DLP thread and wait for its result
+     *
+     * Every DLP call on the link already goes through here. Code that
+     * uses socketDescriptor() directly (DeviceWorker, InstallConduit,
+     * BackupConduit) should do the same, so it never interleaves with a
+     * keep-alive or a conduit's calls, and wrap each pilot-link call in
+     * traceRaw(). Runs inline on the DLP thread.
+     */
+    template<typename F>
+    auto execute(F &&function, DlpExecutor::Priority priority = DlpExecutor::Priority::Sync)
+    {
+        return m_executor->run(priority, [this, &function]() {
+            ExecutingScope scope(this);
+            return function();
+        });
+    }
+
+    /**
+     * @brief Count and trace a raw pilot-link call made inside execute()
+     *
+     * The call is recorded on the link whose execute() is running it, like
+     * the link's own calls; outside execute() @p function just runs.
+     *
+     * @param function Makes the call and returns pilot-link's result
+     * @param index Database list index, for calls that take one
+     */
+    template<typename F>
+    static int traceRaw(DlpCall call, F &&function, int index = 0)
+    {
+        qint64 callStart = rawCallStart();
+        int result = function();
+        rawCallDone(call, result, index, callStart);
+        return result;
+    }
+
+    /**
+     * @brief Milliseconds since the last DLP exchange finished
+     */
+    qint64 idleMs() const { return m_executor->idleMs(); }
+
+    /**
+     * @brief Link utilization measured on the DLP thread
+     */
+    DlpExecutor::Stats executorStats() const { return m_executor->stats(); }
+
+    enum class TickleResult {
+        Sent,       // Keep-alive went out
+        Busy,       // A DLP call is in flight
+        NotIdle,    // Link was used more recently than the idle period
+        Failed      // Not connected, or the Palm did not answer
+    };
+
+    /**
+     * @brief Send a keep-alive if the link has been idle for @p minIdleMs
+     *
+     * Thread-safe, for TickleWorker. Never waits behind other commands;
+     * the keep-alive runs at the lowest priority.
+     */
+    TickleResult tickle(int minIdleMs);
 
 signals:
     void connectionComplete(bool success);
@@ -121,6 +214,26 @@ private slots:
 private:
     void cleanupWorker();
 
+    // Link whose execute() runs on this thread, for traceRaw()
+    static thread_local KPilotDeviceLink *s_executingLink;
+
+    struct ExecutingScope
+    {
+        explicit ExecutingScope(KPilotDeviceLink *link) : previous(s_executingLink) { s_executingLink = link; }
+        ~ExecutingScope() { s_executingLink = previous; }
+        KPilotDeviceLink *previous;
+    };
+
+    static qint64 rawCallStart();
+    static void rawCallDone(DlpCall call, int result, int index, qint64 startNs);
+
+    // Trace helpers, only called while m_trace is set
+    qint64 traceStart() const;
+    void traceCall(DlpTraceEntry &entry, qint64 startNs);
+    void traceRecordRead(DlpCall call, int result, int dbHandle, int index,
+                         quint32 recordId, int category, int attributes,
+                         const void *data, size_t size, qint64 startNs);
+
     QString m_devicePath;      // Device path (e.g., "/dev/ttyUSB0", "usb:")
     int m_socket;              // pilot-link socket descriptor
     bool m_isConnected;
@@ -128,6 +241,13 @@ private:
     // Worker thread for async connection
     QThread *m_workerThread;
     ConnectionWorker *m_worker;
+
+    // DLP wire trace (null unless recording)
+    std::unique_ptr<DlpTraceWriter> m_trace;
+    QElapsedTimer m_traceClock;
+
+    // Runs every DLP exchange on one thread
+    std::unique_ptr<DlpExecutor> m_executor;
 };
 
 #endif // KPILOTDEVICELINK_H
@@ -32,6 +32,22 @@ void KPilotLink::setStatus(LinkStatus newStatus)
     }
 }
 
+void KPilotLink::countCall(qint64 bytesSent, qint64 bytesReceived)
+{
+    m_calls.fetch_add(1, std::memory_order_relaxed);
+    m_bytesSent.fetch_add(bytesSent, std::memory_order_relaxed);
+    m_bytesReceived.fetch_add(bytesReceived, std::memory_order_relaxed);
+}
+
+KPilotLink::Traffic KPilotLink::traffic() const
+{
+    Traffic traffic;
+    traffic.calls = m_calls.load(std::memory_order_relaxed);
+    traffic.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+    traffic.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+    return traffic;
+}
+
 void KPilotLink::setError(const QString &error)
 {
     m_lastError = error;
@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <atomic>
+#include <functional>
 
 // Forward declarations
 struct PilotUser;
@@ -15,7 +17,7 @@ class PilotRecord;
  *
  * This class provides a device-independent interface for communicating
  * with Palm devices. Implementations can use real hardware (KPilotDeviceLink)
- * or filesystem-based testing (KPilotLocalLink).
+ * or in-memory databases for tests and benchmarks (KPilotMemoryLink).
  */
 class KPilotLink : public QObject
 {
@@ -44,6 +46,7 @@ public:
     virtual bool openConnection() = 0;
     virtual void closeConnection() = 0;
     virtual LinkStatus status() const = 0;
+    virtual bool isConnected() const = 0;
 
     // User information
     virtual bool readUserInfo(struct PilotUser &user) = 0;
@@ -62,6 +65,10 @@ public:
     virtual bool writeRecord(int dbHandle, PilotRecord *record) = 0;
     virtual bool deleteRecord(int dbHandle, int recordId) = 0;
 
+    // End-of-sync database maintenance
+    virtual bool cleanUpDatabase(int dbHandle) = 0;   // Purge deleted/archived records
+    virtual bool resetSyncFlags(int dbHandle) = 0;    // Clear dirty bits
+
     // AppInfo block (categories, etc.)
     virtual bool readAppBlock(int dbHandle, unsigned char *buffer, size_t *size) = 0;
     virtual bool writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size) = 0;
@@ -70,6 +77,27 @@ public:
     virtual bool beginSync() = 0;
     virtual bool endSync() = 0;
 
+    /**
+     * @brief DLP traffic over the link's lifetime
+     *
+     * Safe to call from any thread while the DLP thread is counting.
+     */
+    struct Traffic {
+        int calls = 0;
+        qint64 bytesSent = 0;       // Payload bytes to the device
+        qint64 bytesReceived = 0;   // Payload bytes from the device
+    };
+    Traffic traffic() const;
+
+    /**
+     * @brief Set a callback that reports whether to stop bulk reads
+     *
+     * readAllRecords() asks it before every record, so a cancelled sync
+     * stops within one record rather than after the whole database. Set
+     * it between calls, not while one is running.
+     */
+    void setCancelCheck(std::function<bool()> callback) { m_cancelCheck = std::move(callback); }
+
 signals:
     void statusChanged(LinkStatus status);
     void deviceReady(const QString &userName, const QString &deviceName);
@@ -82,6 +110,19 @@ protected:
 
     void setStatus(LinkStatus newStatus);
     void setError(const QString &error);
+
+    // Implementations call this once per DLP call, on whatever thread runs it
+    void countCall(qint64 bytesSent, qint64 bytesReceived);
+
+    bool isCancelled() const { return m_cancelCheck && m_cancelCheck(); }
+
+private:
+    std::function<bool()> m_cancelCheck;
+
+    // Written by the DLP thread, read by the sync thread
+    std::atomic<int> m_calls{0};
+    std::atomic<qint64> m_bytesSent{0};
+    std::atomic<qint64> m_bytesReceived{0};
 };
 
 #endif // KPILOTLINK_H
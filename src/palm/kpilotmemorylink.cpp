@@ -0,0 +1,541 @@
+#include "kpilotmemorylink.h"
+
+// pilot-link headers
+#include <pi-dlp.h>
+#include <pi-file.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <cstring>
+
+// ========== LinkProfile ==========
+
+qint64 LinkProfile::callCostUs(qint64 payloadBytes) const
+{
+    qint64 cost = callLatencyUs;
+    if (bytesPerSecond > 0) {
+        cost += payloadBytes * 1000000 / bytesPerSecond;
+    }
+    return cost;
+}
+
+LinkProfile LinkProfile::instant()
+{
+    return LinkProfile{"instant", 0, 0};
+}
+
+LinkProfile LinkProfile::serial()
+{
+    // 115200 baud, 8N1 minus SLP/PADP framing and acks
+    return LinkProfile{"serial", 25000, 9000};
+}
+
+LinkProfile LinkProfile::usb()
+{
+    return LinkProfile{"usb", 6000, 60000};
+}
+
+LinkProfile LinkProfile::network()
+{
+    // NetSync over TCP: one round trip per DLP call dominates
+    return LinkProfile{"network", 3000, 250000};
+}
+
+LinkProfile LinkProfile::fromName(const QString &name)
+{
+    QString lower = name.toLower();
+    if (lower == "serial") {
+        return serial();
+    } else if (lower == "usb") {
+        return usb();
+    } else if (lower == "network" || lower == "net") {
+        return network();
+    }
+    return instant();
+}
+
+// ========== KPilotMemoryLink ==========
+
+KPilotMemoryLink::KPilotMemoryLink(QObject *parent)
+    : KPilotLink(parent)
+{
+}
+
+KPilotMemoryLink::~KPilotMemoryLink()
+{
+}
+
+void KPilotMemoryLink::setUser(const QString &userName, quint32 userId)
+{
+    m_userName = userName;
+    m_userId = userId;
+}
+
+void KPilotMemoryLink::addDatabase(const MemoryDatabase &database)
+{
+    m_databases.insert(database.name, database);
+}
+
+bool KPilotMemoryLink::loadDatabaseFile(const QString &path)
+{
+    pi_file_t *pf = pi_file_open(QFile::encodeName(path).constData());
+    if (!pf) {
+        qWarning() << "[KPilotMemoryLink] Cannot open database file:" << path;
+        return false;
+    }
+
+    struct DBInfo info;
+    pi_file_get_info(pf, &info);
+    if (info.flags & dlpDBFlagResource) {
+        qWarning() << "[KPilotMemoryLink] Resource databases are not supported:" << path;
+        pi_file_close(pf);
+        return false;
+    }
+
+    MemoryDatabase db;
+    db.name = QString::fromLatin1(info.name);
+    db.creator = info.creator;
+    db.type = info.type;
+
+    void *appData = nullptr;
+    size_t appSize = 0;
+    pi_file_get_app_info(pf, &appData, &appSize);
+    if (appData && appSize > 0) {
+        db.appBlock = QByteArray(static_cast<const char*>(appData), appSize);
+    }
+
+    int entries = 0;
+    pi_file_get_entries(pf, &entries);
+    for (int i = 0; i < entries; ++i) {
+        void *buf = nullptr;
+        size_t size = 0;
+        int attr = 0;
+        int category = 0;
+        recordid_t id = 0;
+        if (pi_file_read_record(pf, i, &buf, &size, &attr, &category, &id) < 0) {
+            continue;
+        }
+        db.records.append(PilotRecord(id, category, attr,
+                                      QByteArray(static_cast<const char*>(buf), size)));
+        db.nextRecordId = qMax<quint32>(db.nextRecordId, id + 1);
+    }
+
+    pi_file_close(pf);
+
+    qDebug() << "[KPilotMemoryLink] Loaded" << db.name << "with" << db.records.size()
+             << "records from" << QFileInfo(path).fileName();
+    addDatabase(db);
+    return true;
+}
+
+const MemoryDatabase* KPilotMemoryLink::database(const QString &name) const
+{
+    auto it = m_databases.constFind(name);
+    return it != m_databases.constEnd() ? &it.value() : nullptr;
+}
+
+void KPilotMemoryLink::clearDatabases()
+{
+    m_databases.clear();
+    m_openHandles.clear();
+}
+
+void KPilotMemoryLink::simulateCall(qint64 bytesRead, qint64 bytesWritten)
+{
+    countCall(bytesWritten, bytesRead);
+
+    m_stats.calls++;
+    m_stats.bytesRead += bytesRead;
+    m_stats.bytesWritten += bytesWritten;
+
+    qint64 cost = m_profile.callCostUs(bytesRead + bytesWritten);
+    m_stats.simulatedUs += cost;
+    if (m_realTime && cost > 0) {
+        QThread::usleep(cost);
+    }
+}
+
+MemoryDatabase* KPilotMemoryLink::databaseForHandle(int dbHandle)
+{
+    auto handle = m_openHandles.constFind(dbHandle);
+    if (handle == m_openHandles.constEnd()) {
+        setError(QString("Invalid database handle: %1").arg(dbHandle));
+        return nullptr;
+    }
+    auto it = m_databases.find(handle.value());
+    return it != m_databases.end() ? &it.value() : nullptr;
+}
+
+// ========== Connection ==========
+
+bool KPilotMemoryLink::openConnection()
+{
+    m_connected = true;
+    setStatus(AcceptedDevice);
+    return true;
+}
+
+void KPilotMemoryLink::closeConnection()
+{
+    m_connected = false;
+    m_openHandles.clear();
+    setStatus(Init);
+}
+
+// ========== User Information ==========
+
+bool KPilotMemoryLink::readUserInfo(struct PilotUser &user)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    memset(&user, 0, sizeof(user));
+    QByteArray name = m_userName.toUtf8();
+    strncpy(user.username, name.constData(), sizeof(user.username) - 1);
+    user.userID = m_userId;
+
+    simulateCall(sizeof(user), 0);
+    return true;
+}
+
+bool KPilotMemoryLink::writeUserInfo(const struct PilotUser &user)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    m_userName = QString::fromUtf8(user.username);
+    m_userId = user.userID;
+
+    simulateCall(0, sizeof(user));
+    return true;
+}
+
+bool KPilotMemoryLink::readSysInfo(struct SysInfo &sysInfo)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    memset(&sysInfo, 0, sizeof(sysInfo));
+    sysInfo.romVersion = 0x04003000;  // Palm OS 4.0
+    sysInfo.dlpMajorVersion = 1;
+    sysInfo.dlpMinorVersion = 2;
+    sysInfo.maxRecSize = 0xffff;
+
+    simulateCall(sizeof(sysInfo), 0);
+    return true;
+}
+
+// ========== Database Operations ==========
+
+int KPilotMemoryLink::openDatabase(const QString &dbName, bool readWrite)
+{
+    Q_UNUSED(readWrite);
+
+    if (!m_connected) {
+        setError("Not connected");
+        return -1;
+    }
+
+    simulateCall(0, dbName.size());
+    if (!m_databases.contains(dbName)) {
+        setError(QString("Failed to open database: %1").arg(dbName));
+        return -1;
+    }
+
+    int handle = m_nextHandle++;
+    m_openHandles.insert(handle, dbName);
+    return handle;
+}
+
+bool KPilotMemoryLink::closeDatabase(int handle)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    simulateCall(0, 0);
+    if (!m_openHandles.remove(handle)) {
+        setError(QString("Failed to close database handle: %1").arg(handle));
+        return false;
+    }
+    return true;
+}
+
+QStringList KPilotMemoryLink::listDatabases()
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return QStringList();
+    }
+
+    // One dlp_ReadDBList per database, plus the terminating failed call
+    for (int i = 0; i <= m_databases.size(); ++i) {
+        simulateCall(sizeof(struct DBInfo), 0);
+    }
+    return m_databases.keys();
+}
+
+// ========== Record Operations ==========
+
+QList<PilotRecord*> KPilotMemoryLink::readAllRecords(int dbHandle)
+{
+    QList<PilotRecord*> records;
+    if (!m_connected) {
+        setError("Not connected");
+        return records;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return records;
+    }
+
+    // Mirrors KPilotDeviceLink: one dlp_ReadRecordByIndex per record
+    records.reserve(db->records.size());
+    for (const PilotRecord &record : std::as_const(db->records)) {
+        if (isCancelled()) {
+            emit logMessage(QString("Reading cancelled after %1 records").arg(records.size()));
+            return records;
+        }
+        simulateCall(record.size(), 0);
+        records.append(new PilotRecord(record));
+    }
+    simulateCall(0, 0);  // Index past the end terminates the loop
+
+    emit logMessage(QString("Read %1 records").arg(records.size()));
+    return records;
+}
+
+PilotRecord* KPilotMemoryLink::readRecordByIndex(int dbHandle, int index)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return nullptr;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return nullptr;
+    }
+
+    if (index < 0 || index >= db->records.size()) {
+        simulateCall(0, 0);
+        setError(QString("Failed to read record at index: %1").arg(index));
+        return nullptr;
+    }
+
+    const PilotRecord &record = db->records.at(index);
+    simulateCall(record.size(), 0);
+    return new PilotRecord(record);
+}
+
+PilotRecord* KPilotMemoryLink::readRecordById(int dbHandle, int recordId)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return nullptr;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return nullptr;
+    }
+
+    for (const PilotRecord &record : std::as_const(db->records)) {
+        if (record.id() == recordId) {
+            simulateCall(record.size(), 0);
+            return new PilotRecord(record);
+        }
+    }
+
+    simulateCall(0, 0);
+    setError(QString("Failed to read record by ID: %1").arg(recordId));
+    return nullptr;
+}
+
+bool KPilotMemoryLink::writeRecord(int dbHandle, PilotRecord *record)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    if (!record) {
+        setError("Cannot write null record");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    simulateCall(0, record->size());
+
+    // Like dlp_WriteRecord with flags 0: stored clean, attributes not kept
+    PilotRecord stored(record->id(), record->category(), 0, record->data());
+
+    if (record->id() != 0) {
+        for (PilotRecord &existing : db->records) {
+            if (existing.id() == record->id()) {
+                existing = stored;
+                return true;
+            }
+        }
+        db->records.append(stored);
+        return true;
+    }
+
+    stored.setId(db->nextRecordId++);
+    db->records.append(stored);
+    record->setId(stored.id());
+    return true;
+}
+
+bool KPilotMemoryLink::deleteRecord(int dbHandle, int recordId)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    simulateCall(0, 0);
+    for (int i = 0; i < db->records.size(); ++i) {
+        if (db->records.at(i).id() == recordId) {
+            db->records.removeAt(i);
+            return true;
+        }
+    }
+
+    setError(QString("Failed to delete record %1").arg(recordId));
+    return false;
+}
+
+// ========== Database Maintenance ==========
+
+bool KPilotMemoryLink::cleanUpDatabase(int dbHandle)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    simulateCall(0, 0);
+    db->records.removeIf([](const PilotRecord &record) {
+        return record.isDeleted() || record.isArchived();
+    });
+    return true;
+}
+
+bool KPilotMemoryLink::resetSyncFlags(int dbHandle)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    simulateCall(0, 0);
+    for (PilotRecord &record : db->records) {
+        record.setAttributes(record.attributes() & ~PilotRecord::AttrDirty);
+    }
+    return true;
+}
+
+// ========== AppInfo Block ==========
+
+bool KPilotMemoryLink::readAppBlock(int dbHandle, unsigned char *buffer, size_t *size)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    if (db->appBlock.isEmpty()) {
+        simulateCall(0, 0);
+        setError("Failed to read AppInfo block");
+        return false;
+    }
+
+    size_t copied = qMin<size_t>(*size, db->appBlock.size());
+    memcpy(buffer, db->appBlock.constData(), copied);
+    *size = copied;
+
+    simulateCall(copied, 0);
+    return true;
+}
+
+bool KPilotMemoryLink::writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    if (!buffer || size == 0) {
+        setError("Invalid buffer");
+        return false;
+    }
+
+    MemoryDatabase *db = databaseForHandle(dbHandle);
+    if (!db) {
+        return false;
+    }
+
+    db->appBlock = QByteArray(reinterpret_cast<const char*>(buffer), size);
+    simulateCall(0, size);
+    return true;
+}
+
+// ========== Sync Operations ==========
+
+bool KPilotMemoryLink::beginSync()
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    simulateCall(0, 0);
+    return true;
+}
+
+bool KPilotMemoryLink::endSync()
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return false;
+    }
+
+    simulateCall(0, 0);
+    setStatus(SyncDone);
+    return true;
+}
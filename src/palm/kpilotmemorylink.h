@@ -0,0 +1,177 @@
+#ifndef KPILOTMEMORYLINK_H
+#define KPILOTMEMORYLINK_H
+
+#include "kpilotlink.h"
+#include "pilotrecord.h"
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Timing model of a Palm cradle, used by KPilotMemoryLink
+ *
+ * Every DLP call costs a fixed round-trip latency plus its payload size
+ * divided by the link bandwidth.
+ */
+struct LinkProfile
+{
+    QString name;
+    int callLatencyUs = 0;        ///< Round-trip cost of one DLP call (microseconds)
+    qint64 bytesPerSecond = 0;    ///< Payload throughput, 0 = unlimited
+
+    /**
+     * @brief Cost of one call carrying @p payloadBytes, in microseconds
+     */
+    qint64 callCostUs(qint64 payloadBytes) const;
+
+    static LinkProfile instant();   ///< No cost at all (pure algorithm timing)
+    static LinkProfile serial();    ///< 115200 baud serial cradle
+    static LinkProfile usb();       ///< USB cradle / sync cable
+    static LinkProfile network();   ///< Network HotSync over a LAN
+
+    /**
+     * @brief Look up a preset by name ("instant", "serial", "usb", "network")
+     * @return instant() for unknown names
+     */
+    static LinkProfile fromName(const QString &name);
+};
+
+/**
+ * @brief One database held by KPilotMemoryLink
+ */
+struct MemoryDatabase
+{
+    QString name;
+    quint32 creator = 0;
+    quint32 type = 0;
+    QByteArray appBlock;
+    QList<PilotRecord> records;
+    quint32 nextRecordId = 0x100001;   ///< Next ID for records created over the link
+};
+
+/**
+ * @brief In-memory implementation of KPilotLink for tests and benchmarks
+ *
+ * Serves databases that were added programmatically (synthetic data) or
+ * loaded from .pdb files (recorded from a real device), and behaves like
+ * a device for the DLP operations conduits use: new records get IDs,
+ * written records come back clean, cleanUpDatabase() purges deleted and
+ * archived records, resetSyncFlags() clears dirty bits.
+ *
+ * Each call is charged against a LinkProfile. By default the cost is only
+ * accounted (stats().simulatedUs), so benchmarks run at full speed and
+ * report the modelled link time separately; setRealTime(true) sleeps for
+ * the cost instead, to reproduce a slow cradle end to end.
+ */
+class KPilotMemoryLink : public KPilotLink
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Traffic and simulated time accumulated by the link
+     */
+    struct Stats
+    {
+        int calls = 0;              ///< DLP calls made
+        qint64 bytesRead = 0;       ///< Payload bytes from the device
+        qint64 bytesWritten = 0;    ///< Payload bytes to the device
+        qint64 simulatedUs = 0;     ///< Modelled link time (microseconds)
+    };
+
+    explicit KPilotMemoryLink(QObject *parent = nullptr);
+    ~KPilotMemoryLink() override;
+
+    // ========== Configuration ==========
+
+    void setLinkProfile(const LinkProfile &profile) { m_profile = profile; }
+    LinkProfile linkProfile() const { return m_profile; }
+
+    /**
+     * @brief Sleep for the simulated cost of each call (default: account only)
+     */
+    void setRealTime(bool realTime) { m_realTime = realTime; }
+    bool isRealTime() const { return m_realTime; }
+
+    void setUser(const QString &userName, quint32 userId);
+
+    // ========== Database Contents ==========
+
+    /**
+     * @brief Add or replace a database
+     */
+    void addDatabase(const MemoryDatabase &database);
+
+    /**
+     * @brief Load a record database from a .pdb file
+     * @return false if the file cannot be read or is a resource database
+     */
+    bool loadDatabaseFile(const QString &path);
+
+    /**
+     * @brief Current contents of a database (nullptr if unknown)
+     */
+    const MemoryDatabase* database(const QString &name) const;
+
+    void clearDatabases();
+
+    // ========== Statistics ==========
+
+    Stats stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+    // ========== KPilotLink Interface ==========
+
+    bool openConnection() override;
+    void closeConnection() override;
+    LinkStatus status() const override { return m_status; }
+    bool isConnected() const override { return m_connected; }
+
+    bool readUserInfo(struct PilotUser &user) override;
+    bool writeUserInfo(const struct PilotUser &user) override;
+    bool readSysInfo(struct SysInfo &sysInfo) override;
+
+    int openDatabase(const QString &dbName, bool readWrite = false) override;
+    bool closeDatabase(int handle) override;
+    QStringList listDatabases() override;
+
+    QList<PilotRecord*> readAllRecords(int dbHandle) override;
+    PilotRecord* readRecordByIndex(int dbHandle, int index) override;
+    PilotRecord* readRecordById(int dbHandle, int recordId) override;
+    bool writeRecord(int dbHandle, PilotRecord *record) override;
+    bool deleteRecord(int dbHandle, int recordId) override;
+
+    bool cleanUpDatabase(int dbHandle) override;
+    bool resetSyncFlags(int dbHandle) override;
+
+    bool readAppBlock(int dbHandle, unsigned char *buffer, size_t *size) override;
+    bool writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size) override;
+
+    bool beginSync() override;
+    bool endSync() override;
+
+private:
+    /**
+     * @brief Charge one DLP call against the link profile
+     */
+    void simulateCall(qint64 bytesRead, qint64 bytesWritten);
+
+    /**
+     * @brief Database behind an open handle (nullptr if invalid)
+     */
+    MemoryDatabase* databaseForHandle(int dbHandle);
+
+    LinkProfile m_profile = LinkProfile::instant();
+    bool m_realTime = false;
+    bool m_connected = false;
+    Stats m_stats;
+
+    QString m_userName = "Test User";
+    quint32 m_userId = 0;
+
+    QMap<QString, MemoryDatabase> m_databases;
+    QMap<int, QString> m_openHandles;   ///< Handle -> database name
+    int m_nextHandle = 1;
+};
+
+#endif // KPILOTMEMORYLINK_H
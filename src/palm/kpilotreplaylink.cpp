@@ -0,0 +1,336 @@
+#include "kpilotreplaylink.h"
+#include "pilotrecord.h"
+
+// pilot-link headers
+#include <pi-dlp.h>
+
+#include <QDebug>
+#include <QThread>
+#include <cstring>
+
+KPilotReplayLink::KPilotReplayLink(QObject *parent)
+    : KPilotLink(parent)
+{
+}
+
+KPilotReplayLink::~KPilotReplayLink()
+{
+}
+
+// ========== Trace ==========
+
+bool KPilotReplayLink::loadTrace(const QString &path)
+{
+    DlpTraceReader reader;
+    if (!reader.load(path)) {
+        setError(reader.errorString());
+        return false;
+    }
+
+    setTrace(reader.entries(), reader.header());
+    qDebug() << "[KPilotReplayLink] Loaded" << m_entries.size() << "calls from" << path
+             << "recorded" << m_header.recorded.toString(Qt::ISODate)
+             << "on" << m_header.devicePath;
+    return true;
+}
+
+void KPilotReplayLink::setTrace(const QList<DlpTraceEntry> &entries, const DlpTraceHeader &header)
+{
+    m_entries = entries;
+    m_header = header;
+    m_position = 0;
+    m_divergences = 0;
+    m_replayedLatencyUs = 0;
+}
+
+const DlpTraceEntry* KPilotReplayLink::take(DlpCall call)
+{
+    int found = m_position;
+    while (found < m_entries.size() && m_entries.at(found).call != call) {
+        found++;
+    }
+
+    if (found >= m_entries.size()) {
+        qWarning() << "[KPilotReplayLink]" << dlpCallName(call) << "not in the rest of the trace";
+        m_divergences++;
+        setError(QString("Trace has no further %1 call").arg(dlpCallName(call)));
+        return nullptr;
+    }
+
+    int skipped = 0;
+    for (int i = m_position; i < found; ++i) {
+        if (!isOutOfBandCall(m_entries.at(i).call)) {
+            skipped++;
+        }
+    }
+    if (skipped > 0) {
+        qWarning() << "[KPilotReplayLink] Skipped" << skipped
+                   << "recorded calls to reach" << dlpCallName(call);
+        m_divergences += skipped;
+    }
+
+    const DlpTraceEntry *entry = &m_entries.at(found);
+    m_position = found + 1;
+    countCall(entry->bytesSent, entry->bytesReceived);
+    m_replayedLatencyUs += entry->latencyUs;
+    if (m_realTime && entry->latencyUs > 0) {
+        QThread::usleep(entry->latencyUs);
+    }
+    return entry;
+}
+
+const DlpTraceEntry* KPilotReplayLink::takeSucceeded(DlpCall call)
+{
+    if (!m_connected) {
+        setError("Not connected");
+        return nullptr;
+    }
+
+    const DlpTraceEntry *entry = take(call);
+    if (!entry) {
+        return nullptr;
+    }
+    if (entry->failed()) {
+        setError(QString("%1 failed in trace (result: %2)")
+                 .arg(dlpCallName(call)).arg(entry->result));
+        return nullptr;
+    }
+    return entry;
+}
+
+QByteArray KPilotReplayLink::payloadOf(const DlpTraceEntry &entry)
+{
+    if (!entry.payload.isEmpty() || entry.bytesReceived == 0) {
+        return entry.payload;
+    }
+    return QByteArray(entry.bytesReceived, '\0');
+}
+
+PilotRecord* KPilotReplayLink::recordFrom(const DlpTraceEntry &entry)
+{
+    return new PilotRecord(entry.recordId, entry.category, entry.attributes, payloadOf(entry));
+}
+
+// ========== Connection ==========
+
+bool KPilotReplayLink::openConnection()
+{
+    m_connected = true;
+    setStatus(AcceptedDevice);
+    return true;
+}
+
+void KPilotReplayLink::closeConnection()
+{
+    m_connected = false;
+    setStatus(Init);
+}
+
+// ========== User Information ==========
+
+bool KPilotReplayLink::readUserInfo(struct PilotUser &user)
+{
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::ReadUserInfo);
+    if (!entry) {
+        return false;
+    }
+
+    memset(&user, 0, sizeof(user));
+    QByteArray name = entry->payload.isEmpty() ? QByteArray("Replay") : entry->payload;
+    strncpy(user.username, name.constData(), sizeof(user.username) - 1);
+    user.userID = entry->recordId;
+    return true;
+}
+
+bool KPilotReplayLink::writeUserInfo(const struct PilotUser &user)
+{
+    Q_UNUSED(user);
+    return takeSucceeded(DlpCall::WriteUserInfo) != nullptr;
+}
+
+bool KPilotReplayLink::readSysInfo(struct SysInfo &sysInfo)
+{
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::ReadSysInfo);
+    if (!entry) {
+        return false;
+    }
+
+    memset(&sysInfo, 0, sizeof(sysInfo));
+    sysInfo.romVersion = entry->recordId;
+    return true;
+}
+
+// ========== Database Operations ==========
+
+int KPilotReplayLink::openDatabase(const QString &dbName, bool readWrite)
+{
+    Q_UNUSED(readWrite);
+
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::OpenDB);
+    if (!entry) {
+        return -1;
+    }
+
+    if (entry->name != dbName.toUtf8()) {
+        qWarning() << "[KPilotReplayLink] Opening" << dbName << "but trace opened" << entry->name;
+        m_divergences++;
+    }
+    return entry->handle;
+}
+
+bool KPilotReplayLink::closeDatabase(int handle)
+{
+    Q_UNUSED(handle);
+    return takeSucceeded(DlpCall::CloseDB) != nullptr;
+}
+
+QStringList KPilotReplayLink::listDatabases()
+{
+    QStringList databases;
+    if (!m_connected) {
+        setError("Not connected");
+        return databases;
+    }
+
+    // The list ends at the first failing call, which is not an error
+    while (const DlpTraceEntry *entry = take(DlpCall::ReadDBList)) {
+        if (entry->failed()) {
+            break;
+        }
+        databases.append(QString::fromLatin1(entry->name));
+    }
+    return databases;
+}
+
+// ========== Record Operations ==========
+
+QList<PilotRecord*> KPilotReplayLink::readAllRecords(int dbHandle)
+{
+    Q_UNUSED(dbHandle);
+
+    QList<PilotRecord*> records;
+    if (!m_connected) {
+        setError("Not connected");
+        return records;
+    }
+
+    // KPilotDeviceLink reads by index until the first failing call, or
+    // until cancelled
+    while (!isCancelled()) {
+        const DlpTraceEntry *entry = take(DlpCall::ReadRecordByIndex);
+        if (!entry || entry->failed()) {
+            break;
+        }
+        records.append(recordFrom(*entry));
+    }
+
+    emit logMessage(QString("Read %1 records").arg(records.size()));
+    return records;
+}
+
+PilotRecord* KPilotReplayLink::readRecordByIndex(int dbHandle, int index)
+{
+    Q_UNUSED(dbHandle);
+    Q_UNUSED(index);
+
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::ReadRecordByIndex);
+    return entry ? recordFrom(*entry) : nullptr;
+}
+
+PilotRecord* KPilotReplayLink::readRecordById(int dbHandle, int recordId)
+{
+    Q_UNUSED(dbHandle);
+    Q_UNUSED(recordId);
+
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::ReadRecordById);
+    return entry ? recordFrom(*entry) : nullptr;
+}
+
+bool KPilotReplayLink::writeRecord(int dbHandle, PilotRecord *record)
+{
+    Q_UNUSED(dbHandle);
+
+    if (!record) {
+        setError("Cannot write null record");
+        return false;
+    }
+
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::WriteRecord);
+    if (!entry) {
+        return false;
+    }
+
+    if (record->id() == 0) {
+        record->setId(entry->recordId);
+    }
+    return true;
+}
+
+bool KPilotReplayLink::deleteRecord(int dbHandle, int recordId)
+{
+    Q_UNUSED(dbHandle);
+    Q_UNUSED(recordId);
+    return takeSucceeded(DlpCall::DeleteRecord) != nullptr;
+}
+
+// ========== Database Maintenance ==========
+
+bool KPilotReplayLink::cleanUpDatabase(int dbHandle)
+{
+    Q_UNUSED(dbHandle);
+    return takeSucceeded(DlpCall::CleanUpDatabase) != nullptr;
+}
+
+bool KPilotReplayLink::resetSyncFlags(int dbHandle)
+{
+    Q_UNUSED(dbHandle);
+    return takeSucceeded(DlpCall::ResetSyncFlags) != nullptr;
+}
+
+// ========== AppInfo Block ==========
+
+bool KPilotReplayLink::readAppBlock(int dbHandle, unsigned char *buffer, size_t *size)
+{
+    Q_UNUSED(dbHandle);
+
+    const DlpTraceEntry *entry = takeSucceeded(DlpCall::ReadAppBlock);
+    if (!entry) {
+        return false;
+    }
+
+    QByteArray block = payloadOf(*entry);
+    size_t copied = qMin<size_t>(*size, block.size());
+    memcpy(buffer, block.constData(), copied);
+    *size = copied;
+    return true;
+}
+
+bool KPilotReplayLink::writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size)
+{
+    Q_UNUSED(dbHandle);
+    Q_UNUSED(buffer);
+    Q_UNUSED(size);
+    return takeSucceeded(DlpCall::WriteAppBlock) != nullptr;
+}
+
+// ========== Sync Operations ==========
+
+bool KPilotReplayLink::beginSync()
+{
+    return takeSucceeded(DlpCall::OpenConduit) != nullptr;
+}
+
+bool KPilotReplayLink::endSync()
+{
+    if (m_position < m_entries.size()
+        && m_entries.at(m_position).call == DlpCall::AddSyncLogEntry) {
+        take(DlpCall::AddSyncLogEntry);
+    }
+
+    if (!takeSucceeded(DlpCall::EndOfSync)) {
+        return false;
+    }
+
+    setStatus(SyncDone);
+    return true;
+}
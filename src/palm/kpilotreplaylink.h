@@ -0,0 +1,129 @@
+#ifndef KPILOTREPLAYLINK_H
+#define KPILOTREPLAYLINK_H
+
+#include "kpilotlink.h"
+#include "dlptrace.h"
+#include <QStringList>
+
+/**
+ * @brief KPilotLink that plays back a DLP trace recorded by KPilotDeviceLink
+ *
+ * Each interface call consumes the next recorded DLP call of the same kind
+ * and returns its recorded result: database handles, record IDs, categories,
+ * attributes and payloads (zero-filled to the recorded size when the trace
+ * holds no payloads). Running the same sync code against it reproduces the
+ * call sequence of a field sync without the device.
+ *
+ * If the code asks for a different call than the trace has next, the replay
+ * skips ahead to the next matching call and counts the skipped calls as
+ * divergences; a call with no match left fails. Out-of-band calls such as
+ * keep-alives (see isOutOfBandCall()) are skipped without counting.
+ *
+ * With setRealTime(true) every call sleeps for its recorded latency, so a
+ * profiler sees the link time where it happened in the field.
+ */
+class KPilotReplayLink : public KPilotLink
+{
+    Q_OBJECT
+
+public:
+    explicit KPilotReplayLink(QObject *parent = nullptr);
+    ~KPilotReplayLink() override;
+
+    // ========== Trace ==========
+
+    /**
+     * @brief Load a trace file and rewind to its first call
+     */
+    bool loadTrace(const QString &path);
+
+    /**
+     * @brief Replay calls given directly (rewinds)
+     */
+    void setTrace(const QList<DlpTraceEntry> &entries,
+                  const DlpTraceHeader &header = DlpTraceHeader());
+
+    DlpTraceHeader traceHeader() const { return m_header; }
+    QString errorString() const { return m_lastError; }
+
+    /**
+     * @brief Sleep for each call's recorded latency (default: off)
+     */
+    void setRealTime(bool realTime) { m_realTime = realTime; }
+    bool isRealTime() const { return m_realTime; }
+
+    // ========== Progress ==========
+
+    int position() const { return m_position; }
+    int remaining() const { return m_entries.size() - m_position; }
+
+    /**
+     * @brief Recorded calls skipped or requested but missing
+     */
+    int divergences() const { return m_divergences; }
+
+    /**
+     * @brief Recorded latency of the calls replayed so far (microseconds)
+     */
+    qint64 replayedLatencyUs() const { return m_replayedLatencyUs; }
+
+    // ========== KPilotLink Interface ==========
+
+    bool openConnection() override;
+    void closeConnection() override;
+    LinkStatus status() const override { return m_status; }
+    bool isConnected() const override { return m_connected; }
+
+    bool readUserInfo(struct PilotUser &user) override;
+    bool writeUserInfo(const struct PilotUser &user) override;
+    bool readSysInfo(struct SysInfo &sysInfo) override;
+
+    int openDatabase(const QString &dbName, bool readWrite = false) override;
+    bool closeDatabase(int handle) override;
+    QStringList listDatabases() override;
+
+    QList<PilotRecord*> readAllRecords(int dbHandle) override;
+    PilotRecord* readRecordByIndex(int dbHandle, int index) override;
+    PilotRecord* readRecordById(int dbHandle, int recordId) override;
+    bool writeRecord(int dbHandle, PilotRecord *record) override;
+    bool deleteRecord(int dbHandle, int recordId) override;
+
+    bool cleanUpDatabase(int dbHandle) override;
+    bool resetSyncFlags(int dbHandle) override;
+
+    bool readAppBlock(int dbHandle, unsigned char *buffer, size_t *size) override;
+    bool writeAppBlock(int dbHandle, const unsigned char *buffer, size_t size) override;
+
+    bool beginSync() override;
+    bool endSync() override;
+
+private:
+    /**
+     * @brief Consume the next recorded call of kind @p call
+     * @return nullptr if the trace has no such call left
+     */
+    const DlpTraceEntry* take(DlpCall call);
+
+    /**
+     * @brief take() that also fails for a recorded failure
+     */
+    const DlpTraceEntry* takeSucceeded(DlpCall call);
+
+    /**
+     * @brief Recorded payload, or zeros of the recorded size
+     */
+    static QByteArray payloadOf(const DlpTraceEntry &entry);
+
+    static PilotRecord* recordFrom(const DlpTraceEntry &entry);
+
+    QList<DlpTraceEntry> m_entries;
+    DlpTraceHeader m_header;
+    int m_position = 0;
+    int m_divergences = 0;
+    qint64 m_replayedLatencyUs = 0;
+
+    bool m_realTime = false;
+    bool m_connected = false;
+};
+
+#endif // KPILOTREPLAYLINK_H
@@ -0,0 +1,396 @@
+#include "palmdbgenerator.h"
+#include "pilotrecord.h"
+
+// pilot-link headers
+#include <pi-file.h>
+#include <pi-appinfo.h>
+
+#include <QFile>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const QStringList ASCII_WORDS = {
+    "meeting", "lunch", "call", "project", "review", "notes", "weekend", "train",
+    "ticket", "birthday", "phone", "reminder", "draft", "list", "budget", "dentist",
+    "garden", "invoice", "flight", "hotel", "report", "agenda", "pickup", "school",
+    "library", "groceries", "printer", "backup", "sync", "palm", "office", "client"
+};
+
+// Representable in Windows-1252, the Palm's character set
+const QStringList CP1252_WORDS = {
+    "café", "Müller", "déjà", "señor", "naïve", "Zürich", "€20", "crème",
+    "Ångström", "façade", "Straße", "pâté", "São", "½", "résumé", "Œuvre"
+};
+
+// Not representable on the Palm: exercises the lossy encode path
+const QStringList UNENCODABLE_WORDS = {
+    "東京", "会議", "Ωμέγα", "Привет", "✓", "→", "한국", "שלום"
+};
+
+const QStringList FIRST_NAMES = {
+    "Ann", "Bob", "Carla", "Dmitri", "Eve", "Frank", "Grace", "Hiro", "Ines", "Jon"
+};
+
+const QStringList DEFAULT_CATEGORIES = {
+    "Unfiled", "Business", "Personal", "QuickList", "Family", "Travel", "Projects"
+};
+
+// Creation and modification date of written .pdb files (2024-01-01 00:00
+// UTC, where generated dates start), so the same seed gives the same file
+const time_t DATABASE_DATE = 1704067200;
+
+quint32 fourCC(const char *code)
+{
+    return (quint32(quint8(code[0])) << 24) | (quint32(quint8(code[1])) << 16)
+         | (quint32(quint8(code[2])) << 8) | quint32(quint8(code[3]));
+}
+
+} // namespace
+
+PalmDbGenerator::PalmDbGenerator(const GeneratorOptions &options)
+    : m_options(options)
+    , m_rng(options.seed)
+{
+    m_options.categories = qBound(1, m_options.categories, 16);
+    m_options.minTextLength = qMax(1, m_options.minTextLength);
+    m_options.maxTextLength = qMax(m_options.minTextLength, m_options.maxTextLength);
+}
+
+void PalmDbGenerator::reset()
+{
+    m_rng.seed(m_options.seed);
+}
+
+// ========== Kinds ==========
+
+QString PalmDbGenerator::databaseName(Kind kind)
+{
+    switch (kind) {
+        case Memo: return "MemoDB";
+        case Address: return "AddressDB";
+        case Datebook: return "DatebookDB";
+        case Todo: return "ToDoDB";
+    }
+    return QString();
+}
+
+QString PalmDbGenerator::kindName(Kind kind)
+{
+    switch (kind) {
+        case Memo: return "memo";
+        case Address: return "address";
+        case Datebook: return "datebook";
+        case Todo: return "todo";
+    }
+    return QString();
+}
+
+bool PalmDbGenerator::kindFromName(const QString &name, Kind *kind)
+{
+    for (Kind k : allKinds()) {
+        if (name.compare(kindName(k), Qt::CaseInsensitive) == 0
+            || name.compare(databaseName(k), Qt::CaseInsensitive) == 0) {
+            *kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========== Random Helpers ==========
+
+bool PalmDbGenerator::chance(double ratio)
+{
+    return ratio > 0.0 && m_rng.generateDouble() < ratio;
+}
+
+int PalmDbGenerator::category()
+{
+    return m_rng.bounded(m_options.categories);
+}
+
+int PalmDbGenerator::textLength()
+{
+    if (chance(m_options.longRecordRatio)) {
+        return m_options.maxTextLength - m_rng.bounded(qMax(1, m_options.maxTextLength / 10));
+    }
+    double skewed = std::pow(m_rng.generateDouble(), qMax(0.1, m_options.sizeSkew));
+    return m_options.minTextLength
+        + int(skewed * (m_options.maxTextLength - m_options.minTextLength));
+}
+
+QString PalmDbGenerator::word()
+{
+    if (chance(m_options.unencodableRatio)) {
+        return UNENCODABLE_WORDS.at(m_rng.bounded(int(UNENCODABLE_WORDS.size())));
+    }
+    if (chance(m_options.cp1252Ratio)) {
+        return CP1252_WORDS.at(m_rng.bounded(int(CP1252_WORDS.size())));
+    }
+    return ASCII_WORDS.at(m_rng.bounded(int(ASCII_WORDS.size())));
+}
+
+QString PalmDbGenerator::phrase(int minWords, int maxWords)
+{
+    int count = minWords + m_rng.bounded(maxWords - minWords + 1);
+    QStringList words;
+    for (int i = 0; i < count; ++i) {
+        words << word();
+    }
+    return words.join(' ');
+}
+
+QString PalmDbGenerator::text(int length)
+{
+    QString out;
+    out.reserve(length + 16);
+    while (out.size() < length) {
+        if (!out.isEmpty()) {
+            out += (m_rng.bounded(8) == 0) ? '\n' : ' ';
+        }
+        out += word();
+    }
+    out.truncate(length);
+    return out;
+}
+
+void PalmDbGenerator::applyFlags(bool &isPrivate, bool &isDirty, bool &isDeleted)
+{
+    isPrivate = chance(m_options.privateRatio);
+    isDeleted = chance(m_options.deletedRatio);
+    // A deleted record is always pending sync
+    isDirty = isDeleted || chance(m_options.dirtyRatio);
+}
+
+// ========== Single Records ==========
+
+MemoMapper::Memo PalmDbGenerator::memo(int recordId)
+{
+    MemoMapper::Memo memo{};
+    memo.recordId = recordId;
+    memo.category = category();
+    memo.text = phrase(1, 5) + '\n' + text(textLength());
+    applyFlags(memo.isPrivate, memo.isDirty, memo.isDeleted);
+    return memo;
+}
+
+ContactMapper::Contact PalmDbGenerator::contact(int recordId)
+{
+    ContactMapper::Contact contact{};
+    contact.recordId = recordId;
+    contact.category = category();
+
+    contact.firstName = chance(m_options.cp1252Ratio) ? word()
+                      : FIRST_NAMES.at(m_rng.bounded(int(FIRST_NAMES.size())));
+    contact.lastName = word();
+    contact.lastName[0] = contact.lastName[0].toUpper();
+    if (m_rng.bounded(2)) {
+        contact.company = phrase(1, 3);
+        contact.title = phrase(1, 2);
+    }
+
+    // Palm phone labels: 0 Work, 1 Home, 2 Fax, 3 Other, 4 E-mail, 5 Main, 6 Pager, 7 Mobile
+    QString *phones[] = {&contact.phone1, &contact.phone2, &contact.phone3,
+                         &contact.phone4, &contact.phone5};
+    int phoneCount = m_rng.bounded(1, 6);
+    for (int i = 0; i < 5; ++i) {
+        int label = (i == 4) ? 4 : m_rng.bounded(8);
+        contact.phoneLabels << QString::number(label);
+        if (i < phoneCount) {
+            *phones[i] = (label == 4)
+                ? QString("%1@example.org").arg(contact.firstName.toLower())
+                : QString("+1 555 %1").arg(m_rng.bounded(1000000, 9999999));
+        }
+    }
+    contact.showPhone = 0;
+
+    if (m_rng.bounded(3)) {
+        contact.address = QString("%1 %2 St").arg(m_rng.bounded(1, 9999)).arg(word());
+        contact.city = word();
+        contact.state = "CA";
+        contact.zip = QString::number(m_rng.bounded(10000, 99999));
+        contact.country = m_rng.bounded(4) ? QString() : word();
+    }
+    if (m_rng.bounded(3) == 0) {
+        contact.note = text(textLength());
+    }
+
+    applyFlags(contact.isPrivate, contact.isDirty, contact.isDeleted);
+    return contact;
+}
+
+CalendarMapper::Event PalmDbGenerator::event(int recordId)
+{
+    CalendarMapper::Event event{};
+    event.recordId = recordId;
+    event.category = category();
+    event.description = phrase(1, 6);
+    if (m_rng.bounded(4) == 0) {
+        event.note = text(textLength());
+    }
+
+    QDate day = QDate(2024, 1, 1).addDays(m_rng.bounded(3 * 365));
+    event.isUntimed = m_rng.bounded(5) == 0;
+    if (event.isUntimed) {
+        event.begin = QDateTime(day, QTime(0, 0));
+        event.end = event.begin;
+    } else {
+        event.begin = QDateTime(day, QTime(m_rng.bounded(6, 20), m_rng.bounded(4) * 15));
+        event.end = event.begin.addSecs(1800 * m_rng.bounded(1, 6));
+    }
+
+    event.hasAlarm = m_rng.bounded(3) == 0;
+    event.alarmAdvance = event.hasAlarm ? 5 * m_rng.bounded(1, 7) : 0;
+    event.alarmUnits = CalendarMapper::AlarmMinutes;
+
+    event.repeatType = CalendarMapper::RepeatNone;
+    if (chance(m_options.repeatRatio)) {
+        event.repeatType = m_rng.bounded(int(CalendarMapper::RepeatDaily), int(CalendarMapper::RepeatYearly) + 1);
+        event.repeatFrequency = m_rng.bounded(4) ? 1 : m_rng.bounded(2, 4);
+        event.repeatForever = m_rng.bounded(2);
+        if (!event.repeatForever) {
+            event.repeatEnd = QDateTime(day.addDays(m_rng.bounded(30, 720)), QTime(0, 0));
+        }
+        event.repeatDays[day.dayOfWeek() % 7] = true;       // Palm weeks start on Sunday
+        event.repeatDay = ((day.day() - 1) / 7) * 7 + day.dayOfWeek() % 7;
+        event.repeatWeekstart = 0;
+
+        int exceptions = m_rng.bounded(m_options.maxExceptions + 1);
+        for (int i = 0; i < exceptions; ++i) {
+            event.exceptions << QDateTime(day.addDays(7 * m_rng.bounded(1, 52)), QTime(0, 0));
+        }
+    }
+
+    applyFlags(event.isPrivate, event.isDirty, event.isDeleted);
+    return event;
+}
+
+TodoMapper::Todo PalmDbGenerator::todo(int recordId)
+{
+    TodoMapper::Todo todo{};
+    todo.recordId = recordId;
+    todo.category = category();
+    todo.description = phrase(1, 8);
+    if (m_rng.bounded(4) == 0) {
+        todo.note = text(textLength());
+    }
+
+    todo.hasIndefiniteDue = m_rng.bounded(3) == 0;
+    if (!todo.hasIndefiniteDue) {
+        todo.due = QDateTime(QDate(2024, 1, 1).addDays(m_rng.bounded(3 * 365)), QTime(0, 0));
+    }
+    todo.priority = m_rng.bounded(1, 6);
+    todo.isComplete = m_rng.bounded(4) == 0;
+
+    applyFlags(todo.isPrivate, todo.isDirty, todo.isDeleted);
+    return todo;
+}
+
+PilotRecord* PalmDbGenerator::record(Kind kind, int recordId)
+{
+    switch (kind) {
+        case Memo: return MemoMapper::packMemo(memo(recordId));
+        case Address: return ContactMapper::packContact(contact(recordId));
+        case Datebook: return CalendarMapper::packEvent(event(recordId));
+        case Todo: return TodoMapper::packTodo(todo(recordId));
+    }
+    return nullptr;
+}
+
+// ========== Whole Databases ==========
+
+QByteArray PalmDbGenerator::appBlock() const
+{
+    CategoryAppInfo_t info;
+    memset(&info, 0, sizeof(info));
+
+    for (int i = 0; i < m_options.categories; ++i) {
+        QString name = i < DEFAULT_CATEGORIES.size() ? DEFAULT_CATEGORIES.at(i)
+                                                     : QString("Category %1").arg(i);
+        strncpy(info.name[i], name.toLatin1().constData(), sizeof(info.name[i]) - 1);
+        info.ID[i] = i;
+    }
+    info.lastUniqueID = m_options.categories - 1;
+
+    // CategoryInfo::parse() wants at least a full CategoryAppInfo_t
+    QByteArray block(qMax<int>(512, sizeof(CategoryAppInfo_t)), '\0');
+    int size = pack_CategoryAppInfo(&info, reinterpret_cast<unsigned char*>(block.data()), block.size());
+    if (size < 0) {
+        qWarning() << "[PalmDbGenerator] pack_CategoryAppInfo failed:" << size;
+        return QByteArray();
+    }
+    return block;
+}
+
+MemoryDatabase PalmDbGenerator::database(Kind kind)
+{
+    static const char *creators[] = {"memo", "addr", "date", "todo"};
+
+    MemoryDatabase db;
+    db.name = databaseName(kind);
+    db.creator = fourCC(creators[kind]);
+    db.type = fourCC("DATA");
+    db.appBlock = appBlock();
+
+    db.records.reserve(m_options.records);
+    for (int i = 0; i < m_options.records; ++i) {
+        PilotRecord *rec = record(kind, FIRST_RECORD_ID + i);
+        if (rec) {
+            db.records.append(*rec);
+            delete rec;
+        }
+    }
+    db.nextRecordId = FIRST_RECORD_ID + m_options.records;
+
+    qDebug() << "[PalmDbGenerator] Generated" << db.name << "with" << db.records.size()
+             << "records, seed" << m_options.seed;
+    return db;
+}
+
+bool PalmDbGenerator::writePdb(const MemoryDatabase &database, const QString &path, QString *error) const
+{
+    struct DBInfo info;
+    memset(&info, 0, sizeof(info));
+    strncpy(info.name, database.name.toLatin1().constData(), sizeof(info.name) - 1);
+    info.creator = database.creator;
+    info.type = database.type;
+    info.version = 0;
+    info.createDate = info.modifyDate = DATABASE_DATE;
+
+    pi_file_t *pf = pi_file_create(QFile::encodeName(path).constData(), &info);
+    if (!pf) {
+        if (error) {
+            *error = QString("Cannot create %1").arg(path);
+        }
+        return false;
+    }
+
+    if (!database.appBlock.isEmpty()) {
+        QByteArray appBlock = database.appBlock;
+        pi_file_set_app_info(pf, appBlock.data(), appBlock.size());
+    }
+
+    for (const PilotRecord &record : database.records) {
+        QByteArray data = record.data();
+        if (pi_file_append_record(pf, data.data(), data.size(), record.attributes(),
+                                  record.category(), record.id()) < 0) {
+            pi_file_close(pf);
+            if (error) {
+                *error = QString("Failed to write record %1 to %2").arg(record.id()).arg(path);
+            }
+            return false;
+        }
+    }
+
+    if (pi_file_close(pf) < 0) {
+        if (error) {
+            *error = QString("Failed to finish %1").arg(path);
+        }
+        return false;
+    }
+    return true;
+}
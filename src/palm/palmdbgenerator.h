@@ -0,0 +1,136 @@
+#ifndef PALMDBGENERATOR_H
+#define PALMDBGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QRandomGenerator>
+
+#include "kpilotmemorylink.h"
+#include "../mappers/memomapper.h"
+#include "../mappers/contactmapper.h"
+#include "../mappers/calendarmapper.h"
+#include "../mappers/todomapper.h"
+
+class PilotRecord;
+
+/**
+ * @brief Shape of a synthetic dataset
+ *
+ * Ratios are probabilities per record (0.0 - 1.0).
+ */
+struct GeneratorOptions
+{
+    quint32 seed = 1;
+    int records = 1000;
+
+    // Size distribution of free text (memo body, notes, descriptions).
+    // Lengths are drawn between min and max, skewed towards min by
+    // sizeSkew (1.0 = uniform); longRecordRatio of records are near max.
+    int minTextLength = 8;
+    int maxTextLength = 600;
+    double sizeSkew = 3.0;
+    double longRecordRatio = 0.02;
+
+    // Character mix. Words are ASCII unless drawn as CP1252 (accents, €)
+    // or, rarely, as text the Palm cannot encode at all (CJK, Greek).
+    double cp1252Ratio = 0.1;
+    double unencodableRatio = 0.0;
+
+    int categories = 5;               ///< Named categories incl. Unfiled (1-16)
+    double dirtyRatio = 0.0;
+    double deletedRatio = 0.0;
+    double privateRatio = 0.05;
+
+    // Datebook only
+    double repeatRatio = 0.2;         ///< Events that repeat
+    int maxExceptions = 3;            ///< Per repeating event
+};
+
+/**
+ * @brief Seeded generator of realistic Palm databases
+ *
+ * Builds records field by field and packs them with the mappers'
+ * packMemo/packContact/packEvent/packTodo, so the bytes are exactly what
+ * the conduits will read back. The same options and seed always produce
+ * the same database.
+ *
+ * Output is either a MemoryDatabase to feed KPilotMemoryLink, or a .pdb
+ * file (which KPilotMemoryLink::loadDatabaseFile() and real devices read).
+ */
+class PalmDbGenerator
+{
+public:
+    enum Kind {
+        Memo,
+        Address,
+        Datebook,
+        Todo
+    };
+
+    explicit PalmDbGenerator(const GeneratorOptions &options = GeneratorOptions());
+
+    GeneratorOptions options() const { return m_options; }
+
+    /**
+     * @brief Restart the random sequence from the seed
+     */
+    void reset();
+
+    // ========== Kinds ==========
+
+    static QString databaseName(Kind kind);       ///< e.g. "AddressDB"
+    static QString kindName(Kind kind);           ///< e.g. "address"
+
+    /**
+     * @brief Parse a kind name ("memo", "address", "datebook", "todo")
+     */
+    static bool kindFromName(const QString &name, Kind *kind);
+
+    static QList<Kind> allKinds() { return {Memo, Address, Datebook, Todo}; }
+
+    // ========== Single Records ==========
+
+    MemoMapper::Memo memo(int recordId);
+    ContactMapper::Contact contact(int recordId);
+    CalendarMapper::Event event(int recordId);
+    TodoMapper::Todo todo(int recordId);
+
+    /**
+     * @brief Next record of @p kind, packed (caller owns)
+     */
+    PilotRecord* record(Kind kind, int recordId);
+
+    // ========== Whole Databases ==========
+
+    /**
+     * @brief Category AppInfo block naming options().categories categories
+     */
+    QByteArray appBlock() const;
+
+    /**
+     * @brief options().records records of @p kind, ready for KPilotMemoryLink
+     */
+    MemoryDatabase database(Kind kind);
+
+    /**
+     * @brief Write a database as a .pdb file
+     */
+    bool writePdb(const MemoryDatabase &database, const QString &path, QString *error = nullptr) const;
+
+    static const int FIRST_RECORD_ID = 0x500001;
+
+private:
+    QString text(int length);
+    QString word();
+    QString phrase(int minWords, int maxWords);
+    int textLength();
+    int category();
+    bool chance(double ratio);
+    void applyFlags(bool &isPrivate, bool &isDirty, bool &isDeleted);
+
+    GeneratorOptions m_options;
+    QRandomGenerator m_rng;
+};
+
+#endif // PALMDBGENERATOR_H
@@ -1,17 +1,21 @@
 #include "tickleworker.h"
+#include "kpilotdevicelink.h"
 
 #include <QDebug>
 #include <QThread>
 
-// pilot-link headers
-extern "C" {
-#include <pi-dlp.h>
-}
+namespace {
+
+// Don't spin when the link went idle a moment before the timer fired
+const qint64 MIN_RECHECK_MS = 100;
+
+} // namespace
 
 TickleWorker::TickleWorker(QObject *parent)
     : QObject(parent)
 {
     m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
     connect(m_timer, &QTimer::timeout, this, &TickleWorker::sendTickle);
 
     qDebug() << "[TickleWorker] Created on thread:" << QThread::currentThread();
@@ -23,18 +27,15 @@ TickleWorker::~TickleWorker()
     qDebug() << "[TickleWorker] Destroyed";
 }
 
-void TickleWorker::setSocket(int socket)
+void TickleWorker::setLink(KPilotDeviceLink *link)
 {
-    m_socket = socket;
-    qDebug() << "[TickleWorker] Socket set to:" << socket;
+    m_link = link;
+    qDebug() << "[TickleWorker] Link set, socket:" << (link ? link->socketDescriptor() : -1);
 }
 
-void TickleWorker::setInterval(int intervalMs)
+void TickleWorker::setIdleInterval(int intervalMs)
 {
     m_intervalMs = intervalMs;
-    if (m_timer->isActive()) {
-        m_timer->setInterval(intervalMs);
-    }
 }
 
 void TickleWorker::start()
@@ -43,15 +44,15 @@ void TickleWorker::start()
         return;  // Already running
     }
 
-    if (m_socket < 0) {
-        qWarning() << "[TickleWorker] Cannot start - no socket";
+    if (!m_link) {
+        qWarning() << "[TickleWorker] Cannot start - no link";
         return;
     }
 
     m_running = true;
     m_consecutiveFailures = 0;
-    m_timer->start(m_intervalMs);
-    qDebug() << "[TickleWorker] Started with interval:" << m_intervalMs << "ms on socket:" << m_socket;
+    schedule(m_intervalMs - m_link->idleMs());
+    qDebug() << "[TickleWorker] Started with idle interval:" << m_intervalMs << "ms";
 }
 
 void TickleWorker::stop()
@@ -62,35 +63,55 @@ void TickleWorker::stop()
 
     m_running = false;
     m_timer->stop();
-    qDebug() << "[TickleWorker] Stopped";
+    qDebug() << "[TickleWorker] Stopped - sent:" << m_ticklesSent.load()
+             << "skipped:" << m_ticklesSkipped.load();
+}
+
+void TickleWorker::schedule(qint64 delayMs)
+{
+    m_timer->start(int(qBound(MIN_RECHECK_MS, delayMs, qint64(m_intervalMs))));
 }
 
 void TickleWorker::sendTickle()
 {
-    if (!m_running.load() || m_socket < 0) {
-        qDebug() << "[TickleWorker] sendTickle skipped - running:" << m_running.load() << "socket:" << m_socket;
+    if (!m_running.load() || !m_link) {
         return;
     }
 
-    // Use dlp_GetSysDateTime as a lightweight ping
-    // This just reads the Palm's system time, which is fast and harmless
-    time_t palmTime = 0;
-    int result = dlp_GetSysDateTime(m_socket, &palmTime);
-
-    if (result < 0) {
-        qWarning() << "[TickleWorker] Tickle FAILED:" << result;
+    switch (m_link->tickle(m_intervalMs)) {
+    case KPilotDeviceLink::TickleResult::Sent:
+        m_consecutiveFailures = 0;
+        m_ticklesSent++;
+        emit tickleSent();
+        schedule(m_intervalMs);
+        break;
+
+    case KPilotDeviceLink::TickleResult::NotIdle:
+        // Traffic since the last check keeps the Palm awake; wait for the
+        // link to have been idle for a whole interval
+        m_ticklesSkipped++;
+        schedule(m_intervalMs - m_link->idleMs());
+        break;
+
+    case KPilotDeviceLink::TickleResult::Busy:
+        // A DLP call is in flight; it counts as activity once it ends
+        m_ticklesSkipped++;
+        schedule(m_intervalMs);
+        break;
+
+    case KPilotDeviceLink::TickleResult::Failed:
         m_consecutiveFailures++;
-        emit tickleFailed(QString("Tickle failed: %1 (attempt %2)").arg(result).arg(m_consecutiveFailures));
+        qWarning() << "[TickleWorker] Tickle FAILED, attempt" << m_consecutiveFailures;
+        emit tickleFailed(QString("Tickle failed (attempt %1)").arg(m_consecutiveFailures));
 
         // After 3 consecutive failures, connection is likely dead
         if (m_consecutiveFailures >= 3) {
             qWarning() << "[TickleWorker] Too many failures, connection appears dead";
             emit connectionLost();
             stop();
+        } else {
+            schedule(m_intervalMs);
         }
-    } else {
-        m_consecutiveFailures = 0;
-        emit tickleSent();
-        qDebug() << "[TickleWorker] Tickle OK, Palm time:" << palmTime;
+        break;
     }
 }
@@ -5,6 +5,8 @@
 #include <QTimer>
 #include <atomic>
 
+class KPilotDeviceLink;
+
 /**
  * @brief Worker for sending keep-alive signals to Palm device
  *
@@ -16,8 +18,11 @@
  *
  * Implementation notes:
  * - Uses dlp_GetSysDateTime() as a lightweight ping
- * - Sends tickle every 5 seconds by default
- * - Shares socket with DeviceWorker (safe because tickle is atomic)
+ * - Only tickles once the link has been idle for 5 seconds (by default);
+ *   while DLP traffic flows the timer just moves on to the end of the
+ *   next idle period
+ * - Goes through KPilotDeviceLink::tickle(), which skips the tickle
+ *   instead of interleaving it with a DLP call in flight
  */
 class TickleWorker : public QObject
 {
@@ -28,16 +33,23 @@ public:
     ~TickleWorker() override;
 
     /**
-     * @brief Set the socket descriptor for DLP operations
+     * @brief Set the link to keep alive
      */
-    void setSocket(int socket);
+    void setLink(KPilotDeviceLink *link);
 
     /**
-     * @brief Set the tickle interval in milliseconds
+     * @brief Set how long the link must be idle before a tickle goes out
      *
      * Default is 5000ms (5 seconds).
      */
-    void setInterval(int intervalMs);
+    void setIdleInterval(int intervalMs);
+    int idleInterval() const { return m_intervalMs; }
+
+    /**
+     * @brief Tickles sent, and checks that found the link in use
+     */
+    int ticklesSent() const { return m_ticklesSent.load(); }
+    int ticklesSkipped() const { return m_ticklesSkipped.load(); }
 
     /**
      * @brief Check if tickle is currently running
@@ -81,11 +93,18 @@ private slots:
     void sendTickle();
 
 private:
+    /**
+     * @brief Check again in @p delayMs
+     */
+    void schedule(qint64 delayMs);
+
     QTimer *m_timer = nullptr;
-    int m_socket = -1;
+    KPilotDeviceLink *m_link = nullptr;
     int m_intervalMs = 5000;
     int m_consecutiveFailures = 0;
     std::atomic<bool> m_running{false};
+    std::atomic<int> m_ticklesSent{0};
+    std::atomic<int> m_ticklesSkipped{0};
 };
 
 #endif // TICKLEWORKER_H
@@ -339,3 +339,19 @@ QString Profile::installFolderPath() const
     }
     return QDir(m_syncFolderPath).filePath("install");
 }
+
+QString Profile::deviceBackupFolderPath() const
+{
+    if (m_syncFolderPath.isEmpty()) {
+        return QString();
+    }
+    return QDir(m_syncFolderPath).filePath("device-backup");
+}
+
+QString Profile::logDirectoryPath() const
+{
+    if (m_syncFolderPath.isEmpty()) {
+        return QString();
+    }
+    return QDir(stateDirectoryPath()).filePath("logs");
+}
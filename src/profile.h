@@ -5,6 +5,7 @@
 #include <QStringList>
 #include <QMap>
 #include <QJsonObject>
+#include <QMetaType>
 
 /**
  * @brief Connection mode for Palm device
@@ -76,6 +77,8 @@ struct DeviceFingerprint
     }
 };
 
+Q_DECLARE_METATYPE(DeviceFingerprint)
+
 /**
  * @brief Profile represents a sync profile with its settings
  *
@@ -174,6 +177,12 @@ public:
     // Get the path to the install folder (for .prc/.pdb files to install)
     QString installFolderPath() const;
 
+    // Get the path to the device image backup folder (.prc/.pdb per database)
+    QString deviceBackupFolderPath() const;
+
+    // Get the path to the rotating sync logs (sync.log, sync.1.log, ...)
+    QString logDirectoryPath() const;
+
 private:
     QString m_syncFolderPath;
     QString m_name;
@@ -2,6 +2,7 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QStandardPaths>
 
 Settings& Settings::instance()
 {
@@ -179,6 +180,21 @@ void Settings::setDebugLogging(bool enabled)
     m_settings.setValue("advanced/debugLogging", enabled);
 }
 
+bool Settings::dlpTrace() const
+{
+    return m_settings.value("advanced/dlpTrace", false).toBool();
+}
+
+void Settings::setDlpTrace(bool enabled)
+{
+    m_settings.setValue("advanced/dlpTrace", enabled);
+}
+
+QString Settings::dlpTraceDirectory() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/traces";
+}
+
 void Settings::sync()
 {
     m_settings.sync();
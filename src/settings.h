@@ -74,6 +74,11 @@ public:
     bool debugLogging() const;
     void setDebugLogging(bool enabled);
 
+    // Record a DLP wire trace of every device connection (see KPilotDeviceLink::startTrace)
+    bool dlpTrace() const;
+    void setDlpTrace(bool enabled);
+    QString dlpTraceDirectory() const;
+
     // Sync to disk
     void sync();
 
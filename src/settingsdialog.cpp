@@ -168,6 +168,13 @@ QWidget* SettingsDialog::createAdvancedPage()
     m_debugLoggingCheck = new QCheckBox("Enable verbose debug logging");
     debugLayout->addWidget(m_debugLoggingCheck);
 
+    m_dlpTraceCheck = new QCheckBox("Record DLP traces of device connections");
+    m_dlpTraceCheck->setToolTip(
+        QString("Writes the timing and size of every Palm call to %1.\n"
+                "Useful when reporting slow syncs; record contents are not stored.")
+            .arg(Settings::instance().dlpTraceDirectory()));
+    debugLayout->addWidget(m_dlpTraceCheck);
+
     layout->addWidget(debugGroup);
 
     // Config file info
@@ -267,6 +274,7 @@ void SettingsDialog::loadSettings()
 
     // Advanced
     m_debugLoggingCheck->setChecked(s.debugLogging());
+    m_dlpTraceCheck->setChecked(s.dlpTrace());
 }
 
 void SettingsDialog::saveSettings()
@@ -275,6 +283,7 @@ void SettingsDialog::saveSettings()
 
     // Advanced
     s.setDebugLogging(m_debugLoggingCheck->isChecked());
+    s.setDlpTrace(m_dlpTraceCheck->isChecked());
 
     s.sync();
     emit settingsChanged();
@@ -72,6 +72,7 @@ private:
 
     // Advanced page widgets
     QCheckBox *m_debugLoggingCheck;
+    QCheckBox *m_dlpTraceCheck;
     QLabel *m_configFileLabel;
 
     // Dialog buttons
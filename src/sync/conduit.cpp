@@ -1,5 +1,5 @@
 #include "conduit.h"
-#include "../palm/kpilotdevicelink.h"
+#include "../palm/kpilotlink.h"
 #include "../palm/pilotrecord.h"
 
 #include <QDebug>
@@ -31,7 +31,10 @@ SyncResult Conduit::sync(SyncContext *context)
     emit logMessage(QString("Starting %1 sync...").arg(displayName()));
 
     // Open Palm database
-    m_dbHandle = context->deviceLink->openDatabase(palmDatabaseName(), true);
+    {
+        PhaseTimer timer(context->timing, SyncPhase::DatabaseOpen);
+        m_dbHandle = context->deviceLink->openDatabase(palmDatabaseName(), true);
+    }
     if (m_dbHandle < 0) {
         result.success = false;
         result.errorMessage = QString("Failed to open Palm database: %1").arg(palmDatabaseName());
@@ -72,14 +75,31 @@ SyncResult Conduit::sync(SyncContext *context)
         }
     }
 
+    // A cancelled run saw only part of the records: leave the Palm's dirty
+    // flags and the baseline alone so the next sync picks up the rest.
+    // The ID mappings of records it did create are still saved below.
+    bool cancelled = context->cancelled || isCancelled();
+    if (cancelled) {
+        result.success = false;
+        result.errorMessage = "Sync cancelled";
+        emit logMessage(QString("%1 sync cancelled").arg(displayName()));
+    }
+
     // If sync was successful, clean up and reset flags
     // Skip this for Backup mode - backup shouldn't modify Palm state
     if (result.success && context->mode != SyncMode::Backup) {
         // Write modified categories back to Palm (if any were added)
-        if (!writeModifiedCategories(context)) {
+        bool categoriesWritten;
+        {
+            PhaseTimer timer(context->timing, SyncPhase::CategoryWrite);
+            categoriesWritten = writeModifiedCategories(context);
+        }
+        if (!categoriesWritten) {
             emit logMessage("Warning: Failed to write modified categories");
         }
 
+        PhaseTimer timer(context->timing, SyncPhase::Cleanup);
+
         // Clean up deleted records from Palm database
         context->deviceLink->cleanUpDatabase(m_dbHandle);
 
@@ -90,16 +110,25 @@ SyncResult Conduit::sync(SyncContext *context)
     }
 
     // Close Palm database
-    context->deviceLink->closeDatabase(m_dbHandle);
-    m_dbHandle = -1;
+    {
+        PhaseTimer timer(context->timing, SyncPhase::Cleanup);
+        context->deviceLink->closeDatabase(m_dbHandle);
+        m_dbHandle = -1;
+    }
 
     // Update sync state
     if (result.success) {
+        PhaseTimer timer(context->timing, SyncPhase::StateSave);
+
         // Save baseline hashes for all current backend records
         saveBaseline(context);
 
         context->state->setLastSyncTime(QDateTime::currentDateTime());
         context->state->save();
+    } else if (cancelled) {
+        // Otherwise the records created so far are created again next time
+        PhaseTimer timer(context->timing, SyncPhase::StateSave);
+        context->state->save();
     }
 
     result.endTime = QDateTime::currentDateTime();
@@ -123,7 +152,7 @@ SyncResult Conduit::hotSync(SyncContext *context)
     emit logMessage(QString("Found %1 modified Palm records").arg(palmRecords.size()));
 
     // Load all backend records (we need full set for lookups)
-    QList<BackendRecord*> backendRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> backendRecords = loadBackendRecords(context);
     emit logMessage(QString("Loaded %1 backend records").arg(backendRecords.size()));
 
     // Track which backend records we've processed
@@ -169,11 +198,13 @@ SyncResult Conduit::hotSync(SyncContext *context)
         bool isNew = palmId.isEmpty();
         bool isModified = !baselineHash.isEmpty() && (currentHash != baselineHash);
 
-        emit logMessage(QString("  Backend: %1 - palmId=%2 isNew=%3 isModified=%4")
-            .arg(backendRecord->description())
-            .arg(palmId.isEmpty() ? "(none)" : palmId)
-            .arg(isNew ? "yes" : "no")
-            .arg(isModified ? "yes" : "no"));
+        logDetail([&]() {
+            return QString("  Backend: %1 - palmId=%2 isNew=%3 isModified=%4")
+                .arg(backendRecord->description())
+                .arg(palmId.isEmpty() ? "(none)" : palmId)
+                .arg(isNew ? "yes" : "no")
+                .arg(isModified ? "yes" : "no");
+        });
 
         if (isNew || isModified) {
             PilotRecord *palmRecord = nullptr;
@@ -182,7 +213,7 @@ SyncResult Conduit::hotSync(SyncContext *context)
             if (!palmId.isEmpty()) {
                 // palmRecords only contains dirty records, so we need to read
                 // the Palm record directly if we want to update it
-                palmRecord = context->deviceLink->readRecordById(m_dbHandle, palmId.toUInt());
+                palmRecord = readPalmRecordById(palmId, context);
                 ownsPalmRecord = true;
 
                 if (palmRecord) {
@@ -243,7 +274,7 @@ SyncResult Conduit::fullSync(SyncContext *context)
     emit logMessage(QString("Loaded %1 Palm records").arg(palmRecords.size()));
 
     // Load all backend records
-    QList<BackendRecord*> backendRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> backendRecords = loadBackendRecords(context);
     emit logMessage(QString("Loaded %1 backend records").arg(backendRecords.size()));
 
     // Track processed records
@@ -308,7 +339,7 @@ SyncResult Conduit::firstSync(SyncContext *context)
     emit logMessage(QString("Loaded %1 Palm records").arg(palmRecords.size()));
 
     // Load all backend records
-    QList<BackendRecord*> backendRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> backendRecords = loadBackendRecords(context);
     emit logMessage(QString("Loaded %1 backend records").arg(backendRecords.size()));
 
     // Track matched records
@@ -338,18 +369,20 @@ SyncResult Conduit::firstSync(SyncContext *context)
 
         if (match) {
             // Found match - create mapping
-            emit logMessage(QString("Matched: %1 ↔ %2")
-                .arg(palmRecordDescription(palmRecord))
-                .arg(match->description()));
+            logDetail([&]() {
+                return QString("Matched: %1 ↔ %2")
+                    .arg(palmRecordDescription(palmRecord))
+                    .arg(match->description());
+            });
 
             context->state->mapIds(palmId, match->id);
             matchedBackendIds.insert(match->id);
             result.palmStats.unchanged++;
         } else {
             // No match - create new backend record
-            BackendRecord *newRecord = palmToBackend(palmRecord, context);
+            BackendRecord *newRecord = convertToBackend(palmRecord, context);
             if (newRecord) {
-                QString newId = context->backend->createRecord(context->collectionId, *newRecord);
+                QString newId = createBackendRecord(context, *newRecord);
                 if (!newId.isEmpty()) {
                     context->state->mapIds(palmId, newId);
                     result.pcStats.created++;
@@ -371,7 +404,7 @@ SyncResult Conduit::firstSync(SyncContext *context)
         if (backendRecord->isDeleted) continue;
 
         // Create on Palm
-        PilotRecord *palmRecord = backendToPalm(backendRecord, context);
+        PilotRecord *palmRecord = convertToPalm(backendRecord, context);
         if (palmRecord) {
             if (writePalmRecord(palmRecord, context)) {
                 context->state->mapIds(QString::number(palmRecord->id()), backendRecord->id);
@@ -399,7 +432,7 @@ SyncResult Conduit::copyPalmToPC(SyncContext *context)
     QList<PilotRecord*> palmRecords = readPalmRecords(context, false);
 
     // Clear existing backend records in collection (or just overwrite)
-    QList<BackendRecord*> existingRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> existingRecords = loadBackendRecords(context);
 
     int count = 0;
     for (PilotRecord *palmRecord : palmRecords) {
@@ -409,13 +442,13 @@ SyncResult Conduit::copyPalmToPC(SyncContext *context)
         QString palmId = QString::number(palmRecord->id());
 
         // Convert and create/update
-        BackendRecord *backendRecord = palmToBackend(palmRecord, context);
+        BackendRecord *backendRecord = convertToBackend(palmRecord, context);
         if (backendRecord) {
             QString existingId = context->state->pcIdForPalm(palmId);
 
             if (existingId.isEmpty()) {
                 // Create new
-                QString newId = context->backend->createRecord(context->collectionId, *backendRecord);
+                QString newId = createBackendRecord(context, *backendRecord);
                 if (!newId.isEmpty()) {
                     context->state->mapIds(palmId, newId);
                     result.pcStats.created++;
@@ -423,7 +456,7 @@ SyncResult Conduit::copyPalmToPC(SyncContext *context)
             } else {
                 // Update existing
                 backendRecord->id = existingId;
-                if (context->backend->updateRecord(*backendRecord)) {
+                if (updateBackendRecord(context, *backendRecord)) {
                     result.pcStats.updated++;
                 }
             }
@@ -436,18 +469,22 @@ SyncResult Conduit::copyPalmToPC(SyncContext *context)
         }
     }
 
-    // Delete PC records that no longer exist on Palm
-    QStringList palmIds;
-    for (PilotRecord *rec : palmRecords) {
-        palmIds << QString::number(rec->id());
-    }
-
-    for (BackendRecord *existingRec : existingRecords) {
-        QString palmId = context->state->palmIdForPC(existingRec->id);
-        if (!palmId.isEmpty() && !palmIds.contains(palmId)) {
-            context->backend->deleteRecord(existingRec->id);
-            context->state->removePCMapping(existingRec->id);
-            result.pcStats.deleted++;
+    // Delete PC records that no longer exist on Palm. Skipped when
+    // cancelled: the read may have stopped part way, and records not read
+    // yet would look deleted.
+    if (!context->cancelled && !isCancelled()) {
+        QStringList palmIds;
+        for (PilotRecord *rec : palmRecords) {
+            palmIds << QString::number(rec->id());
+        }
+
+        for (BackendRecord *existingRec : existingRecords) {
+            QString palmId = context->state->palmIdForPC(existingRec->id);
+            if (!palmId.isEmpty() && !palmIds.contains(palmId)) {
+                deleteBackendRecord(context, existingRec->id);
+                context->state->removePCMapping(existingRec->id);
+                result.pcStats.deleted++;
+            }
         }
     }
 
@@ -465,7 +502,7 @@ SyncResult Conduit::copyPCToPalm(SyncContext *context)
     result.success = true;
 
     // Load all backend records
-    QList<BackendRecord*> backendRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> backendRecords = loadBackendRecords(context);
 
     int count = 0;
     for (BackendRecord *backendRecord : backendRecords) {
@@ -474,7 +511,7 @@ SyncResult Conduit::copyPCToPalm(SyncContext *context)
 
         QString palmId = context->state->palmIdForPC(backendRecord->id);
 
-        PilotRecord *palmRecord = backendToPalm(backendRecord, context);
+        PilotRecord *palmRecord = convertToPalm(backendRecord, context);
         if (palmRecord) {
             if (!palmId.isEmpty()) {
                 palmRecord->setId(palmId.toUInt());
@@ -523,13 +560,13 @@ SyncResult Conduit::backup(SyncContext *context)
         QString palmId = QString::number(palmRecord->id());
 
         // Convert to backend format
-        BackendRecord *backendRecord = palmToBackend(palmRecord, context);
+        BackendRecord *backendRecord = convertToBackend(palmRecord, context);
         if (backendRecord) {
             QString existingId = context->state->pcIdForPalm(palmId);
 
             if (existingId.isEmpty()) {
                 // Create new backup file
-                QString newId = context->backend->createRecord(context->collectionId, *backendRecord);
+                QString newId = createBackendRecord(context, *backendRecord);
                 if (!newId.isEmpty()) {
                     context->state->mapIds(palmId, newId);
                     result.pcStats.created++;
@@ -537,7 +574,7 @@ SyncResult Conduit::backup(SyncContext *context)
             } else {
                 // Update existing backup file
                 backendRecord->id = existingId;
-                if (context->backend->updateRecord(*backendRecord)) {
+                if (updateBackendRecord(context, *backendRecord)) {
                     result.pcStats.updated++;
                 }
             }
@@ -569,7 +606,7 @@ SyncResult Conduit::restore(SyncContext *context)
     result.success = true;
 
     // Load all backend records
-    QList<BackendRecord*> backendRecords = context->backend->loadRecords(context->collectionId);
+    QList<BackendRecord*> backendRecords = loadBackendRecords(context);
     emit logMessage(QString("Found %1 PC records to restore").arg(backendRecords.size()));
 
     // Load all existing Palm records (to find ones to delete)
@@ -583,7 +620,7 @@ SyncResult Conduit::restore(SyncContext *context)
 
         QString palmId = context->state->palmIdForPC(backendRecord->id);
 
-        PilotRecord *palmRecord = backendToPalm(backendRecord, context);
+        PilotRecord *palmRecord = convertToPalm(backendRecord, context);
         if (palmRecord) {
             if (!palmId.isEmpty()) {
                 palmRecord->setId(palmId.toUInt());
@@ -660,7 +697,7 @@ void Conduit::syncRecord(PilotRecord *palmRecord,
         }
         else if (palmDeleted) {
             // Palm deleted - delete from backend
-            context->backend->deleteRecord(backendRecord->id);
+            deleteBackendRecord(context, backendRecord->id);
             context->state->removePalmMapping(QString::number(palmRecord->id()));
             pcStats.deleted++;
         }
@@ -676,17 +713,17 @@ void Conduit::syncRecord(PilotRecord *palmRecord,
         }
         else if (palmModified) {
             // Palm modified - update backend
-            BackendRecord *updated = palmToBackend(palmRecord, context);
+            BackendRecord *updated = convertToBackend(palmRecord, context);
             if (updated) {
                 updated->id = backendRecord->id;
-                context->backend->updateRecord(*updated);
+                updateBackendRecord(context, *updated);
                 delete updated;
                 pcStats.updated++;
             }
         }
         else if (backendModified) {
             // Backend modified - update Palm
-            PilotRecord *updated = backendToPalm(backendRecord, context);
+            PilotRecord *updated = convertToPalm(backendRecord, context);
             if (updated) {
                 updated->setId(palmRecord->id());
                 writePalmRecord(updated, context);
@@ -706,14 +743,18 @@ void Conduit::syncRecord(PilotRecord *palmRecord,
             palmStats.deleted++;
         } else {
             // New on Palm - create on backend
-            emit logMessage(QString("Creating PC file from Palm record %1: %2")
-                .arg(palmRecord->id()).arg(palmRecordDescription(palmRecord)));
-            BackendRecord *newRecord = palmToBackend(palmRecord, context);
+            logDetail([&]() {
+                return QString("Creating PC file from Palm record %1: %2")
+                    .arg(palmRecord->id()).arg(palmRecordDescription(palmRecord));
+            });
+            BackendRecord *newRecord = convertToBackend(palmRecord, context);
             if (newRecord) {
-                emit logMessage(QString("  Converted to backend record, size=%1 bytes").arg(newRecord->data.size()));
-                QString newId = context->backend->createRecord(context->collectionId, *newRecord);
+                logDetail([&]() {
+                    return QString("  Converted to backend record, size=%1 bytes").arg(newRecord->data.size());
+                });
+                QString newId = createBackendRecord(context, *newRecord);
                 if (!newId.isEmpty()) {
-                    emit logMessage(QString("  Created file: %1").arg(newId));
+                    logDetail([&]() { return QString("  Created file: %1").arg(newId); });
                     context->state->mapIds(QString::number(palmRecord->id()), newId);
                     pcStats.created++;
                 } else {
@@ -732,12 +773,18 @@ void Conduit::syncRecord(PilotRecord *palmRecord,
             pcStats.deleted++;
         } else {
             // New on PC - create on Palm
-            emit logMessage(QString("Creating Palm record from PC: %1").arg(backendRecord->description()));
-            PilotRecord *newRecord = backendToPalm(backendRecord, context);
+            logDetail([&]() {
+                return QString("Creating Palm record from PC: %1").arg(backendRecord->description());
+            });
+            PilotRecord *newRecord = convertToPalm(backendRecord, context);
             if (newRecord) {
-                emit logMessage(QString("  Converted to Palm record, size=%1 bytes").arg(newRecord->size()));
+                logDetail([&]() {
+                    return QString("  Converted to Palm record, size=%1 bytes").arg(newRecord->size());
+                });
                 if (writePalmRecord(newRecord, context)) {
-                    emit logMessage(QString("  Written successfully, new Palm ID: %1").arg(newRecord->id()));
+                    logDetail([&]() {
+                        return QString("  Written successfully, new Palm ID: %1").arg(newRecord->id());
+                    });
                     context->state->mapIds(QString::number(newRecord->id()), backendRecord->id);
                     palmStats.created++;
                 } else {
@@ -764,10 +811,10 @@ bool Conduit::resolveConflict(PilotRecord *palmRecord,
 
     switch (context->conflictPolicy) {
         case ConflictResolution::PalmWins: {
-            BackendRecord *updated = palmToBackend(palmRecord, context);
+            BackendRecord *updated = convertToBackend(palmRecord, context);
             if (updated) {
                 updated->id = backendRecord->id;
-                context->backend->updateRecord(*updated);
+                updateBackendRecord(context, *updated);
                 delete updated;
                 pcStats.updated++;
             }
@@ -775,7 +822,7 @@ bool Conduit::resolveConflict(PilotRecord *palmRecord,
         }
 
         case ConflictResolution::PCWins: {
-            PilotRecord *updated = backendToPalm(backendRecord, context);
+            PilotRecord *updated = convertToPalm(backendRecord, context);
             if (updated) {
                 updated->setId(palmRecord->id());
                 writePalmRecord(updated, context);
@@ -787,9 +834,9 @@ bool Conduit::resolveConflict(PilotRecord *palmRecord,
 
         case ConflictResolution::Duplicate: {
             // Create Palm record on backend (new ID)
-            BackendRecord *newBackend = palmToBackend(palmRecord, context);
+            BackendRecord *newBackend = convertToBackend(palmRecord, context);
             if (newBackend) {
-                QString newId = context->backend->createRecord(context->collectionId, *newBackend);
+                QString newId = createBackendRecord(context, *newBackend);
                 if (!newId.isEmpty()) {
                     // Update mapping to point to new record
                     context->state->mapIds(QString::number(palmRecord->id()), newId);
@@ -799,7 +846,7 @@ bool Conduit::resolveConflict(PilotRecord *palmRecord,
             }
 
             // Create backend record on Palm (new ID)
-            PilotRecord *newPalm = backendToPalm(backendRecord, context);
+            PilotRecord *newPalm = convertToPalm(backendRecord, context);
             if (newPalm) {
                 newPalm->setId(0);  // Force new ID
                 if (writePalmRecord(newPalm, context)) {
@@ -846,6 +893,7 @@ QList<PilotRecord*> Conduit::readPalmRecords(SyncContext *context, bool modified
 {
     if (m_dbHandle < 0) return {};
 
+    PhaseTimer timer(context->timing, SyncPhase::PalmRead);
     QList<PilotRecord*> allRecords = context->deviceLink->readAllRecords(m_dbHandle);
 
     if (!modifiedOnly) {
@@ -867,15 +915,71 @@ QList<PilotRecord*> Conduit::readPalmRecords(SyncContext *context, bool modified
 bool Conduit::writePalmRecord(PilotRecord *record, SyncContext *context)
 {
     if (m_dbHandle < 0) return false;
+    PhaseTimer timer(context->timing, SyncPhase::PalmWrite);
     return context->deviceLink->writeRecord(m_dbHandle, record);
 }
 
 bool Conduit::deletePalmRecord(const QString &palmId, SyncContext *context)
 {
     if (m_dbHandle < 0) return false;
+    PhaseTimer timer(context->timing, SyncPhase::PalmWrite);
     return context->deviceLink->deleteRecord(m_dbHandle, palmId.toUInt());
 }
 
+PilotRecord* Conduit::readPalmRecordById(const QString &palmId, SyncContext *context)
+{
+    if (m_dbHandle < 0) return nullptr;
+    PhaseTimer timer(context->timing, SyncPhase::PalmRead);
+    return context->deviceLink->readRecordById(m_dbHandle, palmId.toUInt());
+}
+
+// ========== Timed Backend Access ==========
+
+QList<BackendRecord*> Conduit::loadBackendRecords(SyncContext *context)
+{
+    PhaseTimer timer(context->timing, SyncPhase::BackendLoad);
+
+    // Loaded while the previous conduit used the link; only valid until
+    // this conduit starts writing, so it is handed out once
+    if (context->prefetchedRecords) {
+        QList<BackendRecord*> records = context->prefetchedRecords->result();
+        context->prefetchedRecords.reset();
+        return records;
+    }
+
+    return context->backend->loadRecords(context->collectionId);
+}
+
+QString Conduit::createBackendRecord(SyncContext *context, const BackendRecord &record)
+{
+    PhaseTimer timer(context->timing, SyncPhase::BackendWrite);
+    return context->backend->createRecord(context->collectionId, record);
+}
+
+bool Conduit::updateBackendRecord(SyncContext *context, const BackendRecord &record)
+{
+    PhaseTimer timer(context->timing, SyncPhase::BackendWrite);
+    return context->backend->updateRecord(record);
+}
+
+bool Conduit::deleteBackendRecord(SyncContext *context, const QString &backendId)
+{
+    PhaseTimer timer(context->timing, SyncPhase::BackendWrite);
+    return context->backend->deleteRecord(backendId);
+}
+
+BackendRecord* Conduit::convertToBackend(PilotRecord *palmRecord, SyncContext *context)
+{
+    PhaseTimer timer(context->timing, SyncPhase::Conversion);
+    return palmToBackend(palmRecord, context);
+}
+
+PilotRecord* Conduit::convertToPalm(BackendRecord *backendRecord, SyncContext *context)
+{
+    PhaseTimer timer(context->timing, SyncPhase::Conversion);
+    return backendToPalm(backendRecord, context);
+}
+
 bool Conduit::checkVolatility(const SyncStats &stats, int totalRecords, int threshold)
 {
     if (totalRecords == 0) return true;
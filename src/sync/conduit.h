@@ -8,15 +8,19 @@
 #include <QIcon>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <functional>
+#include <optional>
 #include "synctypes.h"
 #include "syncstate.h"
 #include "syncbackend.h"
+#include "../synclog.h"
 
 class QWidget;
 
 // Forward declarations
-class KPilotDeviceLink;
+class KPilotLink;
 class PilotRecord;
 
 namespace Sync {
@@ -29,7 +33,7 @@ namespace Sync {
 class SyncContext
 {
 public:
-    KPilotDeviceLink *deviceLink = nullptr;  ///< Connection to Palm device
+    KPilotLink *deviceLink = nullptr;  ///< Connection to Palm device
     SyncBackend *backend = nullptr;          ///< PC-side storage
     SyncState *state = nullptr;              ///< ID mappings and baseline
     SyncMode mode = SyncMode::HotSync;       ///< Current sync mode
@@ -41,6 +45,35 @@ public:
 
     bool isFirstSync = false;
     bool cancelled = false;
+
+    SyncTiming timing;       ///< Filled in by the conduit as it runs
+
+    /// Backend records SyncEngine started loading before the conduit ran.
+    /// Taken by the first loadBackendRecords(); if the conduit never loads
+    /// them, the engine frees them.
+    std::optional<QFuture<QList<BackendRecord*>>> prefetchedRecords;
+};
+
+/**
+ * @brief Adds the lifetime of the enclosing scope to one sync phase
+ */
+class PhaseTimer
+{
+public:
+    PhaseTimer(SyncTiming &timing, SyncPhase phase)
+        : m_timing(timing), m_phase(phase)
+    {
+        m_timer.start();
+    }
+    ~PhaseTimer() { m_timing.add(m_phase, m_timer.nsecsElapsed() / 1000); }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    SyncTiming &m_timing;
+    SyncPhase m_phase;
+    QElapsedTimer m_timer;
 };
 
 /**
@@ -286,6 +319,7 @@ public:
 
 signals:
     void logMessage(const QString &message);
+    void debugMessage(const QString &message);    // Per-record detail
     void errorOccurred(const QString &error);
     void progressUpdated(int current, int total, const QString &message);
     void conflictDetected(const QString &palmDesc, const QString &backendDesc);
@@ -378,6 +412,25 @@ protected:
      */
     bool deletePalmRecord(const QString &palmId, SyncContext *context);
 
+    /**
+     * @brief Read one record from Palm by ID (caller owns)
+     */
+    PilotRecord* readPalmRecordById(const QString &palmId, SyncContext *context);
+
+    // ========== Timed Backend Access ==========
+    //
+    // The sync algorithms go through these rather than calling the backend
+    // and the conversion hooks directly, so each call is charged to its
+    // phase in context->timing.
+
+    QList<BackendRecord*> loadBackendRecords(SyncContext *context);
+    QString createBackendRecord(SyncContext *context, const BackendRecord &record);
+    bool updateBackendRecord(SyncContext *context, const BackendRecord &record);
+    bool deleteBackendRecord(SyncContext *context, const QString &backendId);
+
+    BackendRecord* convertToBackend(PilotRecord *palmRecord, SyncContext *context);
+    PilotRecord* convertToPalm(BackendRecord *backendRecord, SyncContext *context);
+
     /**
      * @brief Check volatility (warn if too many changes)
      *
@@ -412,6 +465,22 @@ protected:
      */
     bool isCancelled() const { return m_cancelCheck && m_cancelCheck(); }
 
+    /**
+     * @brief Log a per-record detail line
+     *
+     * @p format returns the message and is only called when debug output of
+     * the conduit category is on, so skipped lines cost no formatting.
+     */
+    template<typename Format>
+    void logDetail(Format &&format)
+    {
+        if (lcConduit().isDebugEnabled()) {
+            QString message = format();
+            qCDebug(lcConduit).noquote() << message;
+            emit debugMessage(message);
+        }
+    }
+
     int m_dbHandle = -1;  ///< Open Palm database handle
     std::function<bool()> m_cancelCheck;  ///< External cancellation check
     QDateTime m_lastRunTime;  ///< Last successful run time
@@ -0,0 +1,267 @@
+#include "backupconduit.h"
+#include "installconduit.h"
+#include "../../palm/filetransfer.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QDebug>
+
+#include <cstring>
+
+extern "C" {
+#include <pi-dlp.h>
+#include <pi-file.h>
+}
+
+namespace Sync {
+
+namespace {
+
+const char *PART_SUFFIX = ".part";
+
+bool readImageInfo(const QString &imagePath, DBInfo *info)
+{
+    pi_file_t *pf = pi_file_open(QFile::encodeName(imagePath).constData());
+    if (!pf) {
+        return false;
+    }
+    pi_file_get_info(pf, info);
+    pi_file_close(pf);
+    return true;
+}
+
+} // namespace
+
+BackupConduit::BackupConduit(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void BackupConduit::setBackupFolder(const QString &path)
+{
+    m_backupFolder = path;
+    if (!m_backupFolder.isEmpty()) {
+        QDir().mkpath(m_backupFolder);
+    }
+}
+
+QMap<QString, QString> BackupConduit::images() const
+{
+    QMap<QString, QString> images;
+    if (m_backupFolder.isEmpty()) {
+        return images;
+    }
+
+    QDir dir(m_backupFolder);
+    QStringList filters;
+    filters << "*.pdb" << "*.prc" << "*.PDB" << "*.PRC";
+
+    for (const QFileInfo &file : dir.entryInfoList(filters, QDir::Files | QDir::Readable)) {
+        DBInfo info;
+        if (readImageInfo(file.absoluteFilePath(), &info)) {
+            images.insert(QString::fromLatin1(info.name), file.absoluteFilePath());
+        }
+    }
+    return images;
+}
+
+QList<BackupResult> BackupConduit::backupAll(int socket)
+{
+    return backupAll(socket, InstallConduit::readDeviceDatabases(socket));
+}
+
+QList<BackupResult> BackupConduit::backupAll(int socket, const QList<DBInfo> &deviceDatabases)
+{
+    QList<BackupResult> results;
+
+    if (m_backupFolder.isEmpty()) {
+        emit errorOccurred("No backup folder set");
+        return results;
+    }
+
+    if (deviceDatabases.isEmpty()) {
+        emit errorOccurred("Could not read the database list from the Palm");
+        return results;
+    }
+
+    QMap<QString, QString> existing = images();
+    emit logMessage(QString("Backing up %1 database(s), %2 image(s) on file")
+                    .arg(deviceDatabases.size()).arg(existing.size()));
+
+    QSet<QString> onDevice;
+    bool cancelled = false;
+    int current = 0;
+    for (const DBInfo &info : deviceDatabases) {
+        if (isCancelled()) {
+            cancelled = true;
+            break;
+        }
+
+        current++;
+        QString name = QString::fromLatin1(info.name);
+        onDevice.insert(name);
+        emit progressUpdated(current, deviceDatabases.size(), name);
+
+        QString imagePath = existing.value(name);
+        if (!imagePath.isEmpty() && isUnchanged(info, imagePath)) {
+            BackupResult result;
+            result.databaseName = name;
+            result.fileName = QFileInfo(imagePath).fileName();
+            result.success = true;
+            result.skipped = true;
+            results.append(result);
+            continue;
+        }
+
+        BackupResult result = backupDatabase(info, socket, imagePath);
+        results.append(result);
+        if (result.cancelled) {
+            cancelled = true;
+            break;
+        }
+        if (result.success) {
+            emit logMessage(QString("Backed up: %1").arg(result.fileName));
+        } else {
+            emit errorOccurred(QString("Failed to back up %1: %2")
+                               .arg(name, result.errorMessage));
+        }
+    }
+
+    if (cancelled) {
+        emit logMessage(QString("Device backup cancelled after %1 of %2 database(s)")
+                        .arg(current - 1).arg(deviceDatabases.size()));
+    }
+
+    // After a cancel not every database was seen, so none count as removed
+    int removedCount = 0;
+    if (m_pruneRemoved && !cancelled) {
+        for (auto it = existing.cbegin(); it != existing.cend(); ++it) {
+            if (!onDevice.contains(it.key()) && moveToRemoved(it.value())) {
+                removedCount++;
+            }
+        }
+    }
+
+    // Summary
+    int backedUp = 0;
+    int skipped = 0;
+    int failed = 0;
+    for (const BackupResult &r : results) {
+        if (r.skipped) skipped++;
+        else if (r.success) backedUp++;
+        else failed++;
+    }
+
+    emit logMessage(QString("Device backup complete: %1 backed up, %2 unchanged, %3 failed, %4 removed")
+                    .arg(backedUp).arg(skipped).arg(failed).arg(removedCount));
+
+    return results;
+}
+
+BackupResult BackupConduit::backupDatabase(const DBInfo &info, int socket, const QString &existingImage)
+{
+    BackupResult result;
+    result.databaseName = QString::fromLatin1(info.name);
+    result.fileName = imageFileName(info);
+
+    QString imagePath = QDir(m_backupFolder).filePath(result.fileName);
+    QString partPath = imagePath + PART_SUFFIX;
+
+    // The image records the header as the Palm has it, minus transient state
+    DBInfo header = info;
+    header.flags &= ~dlpDBFlagOpen;
+
+    QFile::remove(partPath);
+    pi_file_t *pf = pi_file_create(QFile::encodeName(partPath).constData(), &header);
+    if (!pf) {
+        result.errorMessage = QString("Could not create %1").arg(partPath);
+        return result;
+    }
+
+    int rc = FileTransfer::retrieve(pf, socket, 0, m_cancelCheck);
+    if (rc < 0) {
+        pi_file_close(pf);
+        QFile::remove(partPath);
+        result.cancelled = isCancelled();
+        result.errorMessage = result.cancelled ? QString("Cancelled")
+                                               : QString("pilot-link error code: %1").arg(rc);
+        return result;
+    }
+
+    if (pi_file_close(pf) < 0) {
+        QFile::remove(partPath);
+        result.errorMessage = QString("Could not write %1").arg(partPath);
+        return result;
+    }
+
+    // Replace the previous image only once the new one is complete
+    if (!existingImage.isEmpty() && QFileInfo(existingImage) != QFileInfo(imagePath)) {
+        QFile::remove(existingImage);
+    }
+    QFile::remove(imagePath);
+    if (!QFile::rename(partPath, imagePath)) {
+        result.errorMessage = QString("Could not move %1 into place").arg(partPath);
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
+
+bool BackupConduit::isUnchanged(const DBInfo &deviceInfo, const QString &imagePath)
+{
+    DBInfo image;
+    if (!readImageInfo(imagePath, &image)) {
+        return false;
+    }
+
+    return image.creator == deviceInfo.creator
+        && image.type == deviceInfo.type
+        && image.modnum == deviceInfo.modnum
+        && image.modifyDate == deviceInfo.modifyDate
+        && (image.flags & dlpDBFlagResource) == (deviceInfo.flags & dlpDBFlagResource);
+}
+
+QString BackupConduit::imageFileName(const DBInfo &info)
+{
+    QByteArray name(info.name, strnlen(info.name, sizeof(info.name)));
+
+    QString fileName;
+    for (char c : name) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (u < 0x20 || u == 0x7f || strchr("/\\:*?\"<>|%", c)) {
+            fileName += QString("%%1").arg(u, 2, 16, QChar('0')).toUpper();
+        } else {
+            fileName += QChar::fromLatin1(c);
+        }
+    }
+
+    return fileName + ((info.flags & dlpDBFlagResource) ? ".prc" : ".pdb");
+}
+
+bool BackupConduit::moveToRemoved(const QString &imagePath)
+{
+    QDir backupDir(m_backupFolder);
+    if (!backupDir.mkpath("removed")) {
+        return false;
+    }
+
+    QFileInfo info(imagePath);
+    QString destPath = QDir(backupDir.filePath("removed")).filePath(info.fileName());
+
+    // If destination already exists, remove it first
+    if (QFile::exists(destPath)) {
+        QFile::remove(destPath);
+    }
+
+    if (!QFile::rename(imagePath, destPath)) {
+        return false;
+    }
+
+    emit logMessage(QString("%1 is no longer on the Palm; image moved to removed/").arg(info.fileName()));
+    return true;
+}
+
+} // namespace Sync
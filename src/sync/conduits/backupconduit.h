@@ -0,0 +1,149 @@
+#ifndef BACKUPCONDUIT_H
+#define BACKUPCONDUIT_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <functional>
+
+struct DBInfo;
+
+namespace Sync {
+
+/**
+ * @brief Result of backing up one database
+ */
+struct BackupResult
+{
+    QString databaseName;
+    QString fileName;
+    bool success = false;
+    bool skipped = false;   ///< Image already current; nothing transferred
+    bool cancelled = false; ///< Stopped part way; the previous image is kept
+    QString errorMessage;
+};
+
+/**
+ * @brief Conduit for binary images of every database on the Palm
+ *
+ * Where the record conduits back up the four PIM databases as text, this
+ * one pulls each RAM database byte for byte into a .pdb (records) or
+ * .prc (resources) file with pi_file_retrieve. A wiped handheld can be
+ * restored from the folder by installing the images again.
+ *
+ * Backups are incremental: an image keeps the database header as it was
+ * on the Palm, and a database whose modification date and modification
+ * number still match its image is not transferred again.
+ *
+ * Like InstallConduit this works on the raw pilot-link socket rather
+ * than records, so it is run alongside the engine, not registered in it.
+ *
+ * Usage:
+ * 1. Run Backup
+ * 2. Images are kept current in <sync_folder>/device-backup/
+ * 3. Images of databases deleted from the Palm move to device-backup/removed/
+ */
+class BackupConduit : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BackupConduit(QObject *parent = nullptr);
+    ~BackupConduit() override = default;
+
+    // ========== Conduit Identity ==========
+
+    QString conduitId() const { return "devicebackup"; }
+    QString displayName() const { return "Device Image Backup"; }
+
+    // ========== Configuration ==========
+
+    /**
+     * @brief Set the folder holding the database images
+     */
+    void setBackupFolder(const QString &path);
+    QString backupFolder() const { return m_backupFolder; }
+
+    /**
+     * @brief Set whether images of databases no longer on the Palm are
+     *        moved to the "removed" subfolder (default: true)
+     */
+    void setPruneRemoved(bool prune) { m_pruneRemoved = prune; }
+    bool pruneRemoved() const { return m_pruneRemoved; }
+
+    /**
+     * @brief Set a callback that reports whether to stop the backup
+     *
+     * Checked between databases, and after every record of the database
+     * being retrieved.
+     */
+    void setCancelCheck(std::function<bool()> callback) { m_cancelCheck = std::move(callback); }
+
+    // ========== Operations ==========
+
+    /**
+     * @brief Bring the images up to date with every RAM database on the Palm
+     *
+     * @param socket The pilot-link socket descriptor (from KPilotDeviceLink)
+     * @return One result per database on the Palm
+     */
+    QList<BackupResult> backupAll(int socket);
+
+    /**
+     * @brief Bring the images up to date with the given databases
+     *
+     * @param socket The pilot-link socket descriptor
+     * @param deviceDatabases Databases on the Palm (see InstallConduit::readDeviceDatabases())
+     */
+    QList<BackupResult> backupAll(int socket, const QList<struct DBInfo> &deviceDatabases);
+
+    /**
+     * @brief Map database name to image path for the images in the folder
+     */
+    QMap<QString, QString> images() const;
+
+    /**
+     * @brief Check whether an image still matches the database on the Palm
+     *
+     * @param deviceInfo Header from the Palm's database list
+     * @param imagePath Existing image file
+     * @return true if creator, type, modification date and modification
+     *         number are unchanged
+     */
+    static bool isUnchanged(const struct DBInfo &deviceInfo, const QString &imagePath);
+
+    /**
+     * @brief File name for a database image, e.g. "MemoDB.pdb"
+     *
+     * Characters that are not safe in file names are %-escaped.
+     */
+    static QString imageFileName(const struct DBInfo &info);
+
+signals:
+    void logMessage(const QString &message);
+    void errorOccurred(const QString &error);
+    void progressUpdated(int current, int total, const QString &databaseName);
+
+private:
+    /**
+     * @brief Retrieve one database into its image file
+     */
+    BackupResult backupDatabase(const struct DBInfo &info, int socket, const QString &existingImage);
+
+    /**
+     * @brief Move an image to the "removed" subfolder
+     */
+    bool moveToRemoved(const QString &imagePath);
+
+    bool isCancelled() const { return m_cancelCheck && m_cancelCheck(); }
+
+    QString m_backupFolder;
+    bool m_pruneRemoved = true;
+    std::function<bool()> m_cancelCheck;
+};
+
+} // namespace Sync
+
+#endif // BACKUPCONDUIT_H
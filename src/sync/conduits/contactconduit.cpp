@@ -2,7 +2,7 @@
 #include "../../mappers/contactmapper.h"
 #include "../../palm/pilotrecord.h"
 #include "../../palm/categoryinfo.h"
-#include "../../palm/kpilotdevicelink.h"
+#include "../../palm/kpilotlink.h"
 #include "../localfilebackend.h"
 
 #include <QDebug>
@@ -0,0 +1,197 @@
+#include "icalfeedsplitter.h"
+
+#include <QByteArrayView>
+
+namespace Sync {
+
+namespace {
+
+bool equalsIgnoreCase(QByteArrayView a, const char *b)
+{
+    return a.compare(QByteArrayView(b), Qt::CaseInsensitive) == 0;
+}
+
+bool startsWithIgnoreCase(QByteArrayView line, const char *prefix)
+{
+    size_t len = qstrlen(prefix);
+    return size_t(line.size()) >= len && qstrnicmp(line.data(), prefix, len) == 0;
+}
+
+/**
+ * @brief Parse a DATE or DATE-TIME value (leading digits/'T' only)
+ */
+QDateTime parseDateTime(const QByteArray &value)
+{
+    qsizetype len = 0;
+    while (len < value.size() && ((value[len] >= '0' && value[len] <= '9') || value[len] == 'T')) {
+        len++;
+    }
+    QByteArray digits = value.left(len);
+    if (digits.size() < 8) {
+        return QDateTime();
+    }
+    if (digits.contains('T')) {
+        return QDateTime::fromString(QString::fromLatin1(digits.left(15)), "yyyyMMdd'T'HHmmss");
+    }
+    return QDateTime::fromString(QString::fromLatin1(digits.left(8)), "yyyyMMdd");
+}
+
+} // namespace
+
+// ========== ICalFeedEvent ==========
+
+QDateTime ICalFeedEvent::start() const
+{
+    return parseDateTime(dtstart.trimmed());
+}
+
+QDateTime ICalFeedEvent::recurrenceUntil() const
+{
+    qsizetype pos = rrule.indexOf("UNTIL=");
+    if (pos < 0) {
+        return QDateTime();
+    }
+    return parseDateTime(rrule.mid(pos + 6));
+}
+
+// ========== ICalFeedSplitter ==========
+
+ICalFeedSplitter::ICalFeedSplitter(EventHandler handler)
+    : m_handler(std::move(handler))
+{
+}
+
+void ICalFeedSplitter::addData(const QByteArray &chunk)
+{
+    m_bytesProcessed += chunk.size();
+
+    qsizetype start = 0;
+    while (start < chunk.size()) {
+        qsizetype newline = chunk.indexOf('\n', start);
+        if (newline < 0) {
+            m_partialLine.append(chunk.constData() + start, chunk.size() - start);
+            return;
+        }
+
+        QByteArrayView line(chunk.constData() + start, newline - start + 1);
+        if (m_partialLine.isEmpty()) {
+            processLine(line.toByteArray());
+        } else {
+            // Line started in an earlier chunk
+            m_partialLine.append(line);
+            processLine(m_partialLine);
+            m_partialLine.clear();
+        }
+        start = newline + 1;
+    }
+}
+
+void ICalFeedSplitter::finish()
+{
+    if (!m_partialLine.isEmpty()) {
+        processLine(m_partialLine);
+        m_partialLine.clear();
+    }
+}
+
+void ICalFeedSplitter::processLine(const QByteArray &raw)
+{
+    QByteArrayView line(raw);
+    while (!line.isEmpty() && (line.back() == '\n' || line.back() == '\r')) {
+        line.chop(1);
+    }
+
+    // Folded continuation of the previous line
+    if (!line.isEmpty() && (line.front() == ' ' || line.front() == '\t')) {
+        if (m_depth > 0) {
+            m_event.data.append(raw);
+            if (m_lastValue) {
+                m_lastValue->append(line.mid(1));
+            }
+        } else if (!m_headerDone) {
+            m_header.append(raw);
+        }
+        return;
+    }
+    m_lastValue = nullptr;
+
+    // Inside a VEVENT (possibly in a nested VALARM)
+    if (m_depth > 0) {
+        m_event.data.append(raw);
+        if (startsWithIgnoreCase(line, "BEGIN:")) {
+            m_depth++;
+        } else if (startsWithIgnoreCase(line, "END:")) {
+            if (--m_depth == 0) {
+                m_event.data.chop(raw.size() - line.size());  // Drop the line break
+                m_eventCount++;
+                m_handler(m_event);
+                m_event = ICalFeedEvent();
+            }
+        } else if (m_depth == 1) {
+            captureProperty(raw.left(line.size()));
+        }
+        return;
+    }
+
+    // Top level
+    if (m_inCalendar && equalsIgnoreCase(line, "BEGIN:VEVENT")) {
+        m_headerDone = true;
+        m_depth = 1;
+        m_event.data = raw;
+        return;
+    }
+    if (equalsIgnoreCase(line, "BEGIN:VCALENDAR")) {
+        m_sawCalendar = true;
+        m_inCalendar = true;
+    } else if (equalsIgnoreCase(line, "END:VCALENDAR")) {
+        m_inCalendar = false;
+        return;
+    }
+    if (!m_headerDone) {
+        m_header.append(raw);
+    }
+}
+
+void ICalFeedSplitter::captureProperty(const QByteArray &line)
+{
+    qsizetype nameEnd = 0;
+    while (nameEnd < line.size() && line[nameEnd] != ':' && line[nameEnd] != ';') {
+        nameEnd++;
+    }
+    QByteArrayView name(line.constData(), nameEnd);
+
+    QByteArray *target = nullptr;
+    if (equalsIgnoreCase(name, "UID")) {
+        target = &m_event.uid;
+    } else if (equalsIgnoreCase(name, "SUMMARY")) {
+        target = &m_event.summary;
+    } else if (equalsIgnoreCase(name, "DTSTART")) {
+        target = &m_event.dtstart;
+    } else if (equalsIgnoreCase(name, "RECURRENCE-ID")) {
+        target = &m_event.recurrenceId;
+    } else if (equalsIgnoreCase(name, "RRULE")) {
+        target = &m_event.rrule;
+    }
+    if (!target || !target->isEmpty()) {
+        return;  // Not interesting, or already seen
+    }
+
+    // Value starts at the first ':' outside quoted parameter values
+    bool quoted = false;
+    qsizetype i = nameEnd;
+    for (; i < line.size(); ++i) {
+        if (line[i] == '"') {
+            quoted = !quoted;
+        } else if (line[i] == ':' && !quoted) {
+            break;
+        }
+    }
+    if (i >= line.size()) {
+        return;
+    }
+
+    *target = line.mid(i + 1);
+    m_lastValue = target;
+}
+
+} // namespace Sync
@@ -0,0 +1,103 @@
+#ifndef ICALFEEDSPLITTER_H
+#define ICALFEEDSPLITTER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <functional>
+
+namespace Sync {
+
+/**
+ * @brief One VEVENT cut out of a feed, with the properties we act on
+ *
+ * Property values are raw (still iCalendar-escaped, parameters removed,
+ * folded lines joined) and only cover properties of the VEVENT itself,
+ * not of nested components such as VALARM.
+ */
+struct ICalFeedEvent
+{
+    QByteArray data;          ///< "BEGIN:VEVENT" ... "END:VEVENT", no trailing line break
+    QByteArray uid;
+    QByteArray recurrenceId;
+    QByteArray summary;
+    QByteArray dtstart;
+    QByteArray rrule;         ///< Empty if the event does not recur
+
+    bool isRecurring() const { return !rrule.isEmpty(); }
+
+    /**
+     * @brief DTSTART as local date/time (invalid if missing or unparseable)
+     */
+    QDateTime start() const;
+
+    /**
+     * @brief UNTIL of the RRULE (invalid if not recurring or unbounded)
+     */
+    QDateTime recurrenceUntil() const;
+};
+
+/**
+ * @brief Single-pass, chunk-fed splitter for iCalendar feeds
+ *
+ * Works line by line on raw bytes: feed it the document in chunks of any
+ * size with addData() and it calls the handler once per VEVENT as soon as
+ * the event's END line arrives. Only the current event and a partial line
+ * are buffered, never the whole document.
+ *
+ * Everything before the first VEVENT (VERSION, PRODID, VTIMEZONE, ...) is
+ * kept as the header, so each event can be written as a standalone
+ * calendar. Top-level content after the first VEVENT is ignored.
+ */
+class ICalFeedSplitter
+{
+public:
+    using EventHandler = std::function<void(const ICalFeedEvent &event)>;
+
+    explicit ICalFeedSplitter(EventHandler handler);
+
+    /**
+     * @brief Process the next chunk of the document
+     */
+    void addData(const QByteArray &chunk);
+
+    /**
+     * @brief Flush a final line that has no line break
+     */
+    void finish();
+
+    /**
+     * @brief Calendar header: everything before the first BEGIN:VEVENT
+     */
+    QByteArray header() const { return m_header; }
+
+    /**
+     * @brief Whether a BEGIN:VCALENDAR line was seen
+     */
+    bool sawCalendar() const { return m_sawCalendar; }
+
+    int eventCount() const { return m_eventCount; }
+    qint64 bytesProcessed() const { return m_bytesProcessed; }
+
+private:
+    void processLine(const QByteArray &raw);
+    void captureProperty(const QByteArray &line);
+
+    EventHandler m_handler;
+
+    QByteArray m_partialLine;   ///< Bytes after the last line break seen
+    QByteArray m_header;
+    bool m_headerDone = false;
+    bool m_sawCalendar = false;
+    bool m_inCalendar = false;
+
+    ICalFeedEvent m_event;      ///< Event being assembled
+    int m_depth = 0;            ///< Component nesting inside the VEVENT (0 = outside)
+    QByteArray *m_lastValue = nullptr;  ///< Captured value a folded line continues
+
+    int m_eventCount = 0;
+    qint64 m_bytesProcessed = 0;
+};
+
+} // namespace Sync
+
+#endif // ICALFEEDSPLITTER_H
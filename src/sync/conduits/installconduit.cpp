@@ -1,15 +1,54 @@
 #include "installconduit.h"
+#include "../../palm/filetransfer.h"
+#include "../../palm/kpilotdevicelink.h"
+#include "../../palm/dlptrace.h"
 
 #include <QDir>
 #include <QFileInfo>
+#include <QElapsedTimer>
+#include <QRegularExpression>
 #include <QDebug>
 
+#include <algorithm>
+#include <cstring>
+
 extern "C" {
+#include <pi-dlp.h>
 #include <pi-file.h>
 }
 
 namespace Sync {
 
+namespace {
+
+bool readFileInfo(const QString &filePath, DBInfo *info)
+{
+    pi_file_t *pf = pi_file_open(filePath.toLocal8Bit().constData());
+    if (!pf) {
+        return false;
+    }
+    pi_file_get_info(pf, info);
+    pi_file_close(pf);
+    return true;
+}
+
+bool onDevice(const DBInfo &fileInfo, const QList<DBInfo> &deviceDatabases)
+{
+    for (const DBInfo &device : deviceDatabases) {
+        if (strncmp(device.name, fileInfo.name, sizeof(device.name)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString kilobytes(qint64 bytes)
+{
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+} // namespace
+
 InstallConduit::InstallConduit(QObject *parent)
     : QObject(parent)
 {
@@ -46,31 +85,152 @@ QStringList InstallConduit::pendingFiles() const
     return files;
 }
 
+void InstallConduit::setPriority(const QString &pattern, int priority)
+{
+    for (QPair<QString, int> &entry : m_priorities) {
+        if (entry.first == pattern) {
+            entry.second = priority;
+            return;
+        }
+    }
+    m_priorities.append(qMakePair(pattern, priority));
+}
+
+int InstallConduit::priority(const QString &fileName) const
+{
+    bool matched = false;
+    int best = 0;
+    for (const QPair<QString, int> &entry : m_priorities) {
+        QRegularExpression re(QRegularExpression::wildcardToRegularExpression(entry.first),
+                              QRegularExpression::CaseInsensitiveOption);
+        if (re.match(fileName).hasMatch() && (!matched || entry.second > best)) {
+            best = entry.second;
+            matched = true;
+        }
+    }
+    return best;
+}
+
+QStringList InstallConduit::orderedFiles(const QStringList &files) const
+{
+    if (m_installOrder == InstallOrder::Directory) {
+        return files;
+    }
+
+    struct Entry {
+        QString path;
+        int priority;
+        qint64 size;
+    };
+    QList<Entry> entries;
+    for (const QString &path : files) {
+        QFileInfo info(path);
+        entries.append({path, priority(info.fileName()), info.size()});
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return a.size < b.size;
+    });
+
+    QStringList ordered;
+    for (const Entry &entry : entries) {
+        ordered << entry.path;
+    }
+    return ordered;
+}
+
 QList<InstallResult> InstallConduit::installAll(int socket)
+{
+    if (pendingFiles().isEmpty()) {
+        return installAll(socket, QList<DBInfo>());
+    }
+    return installAll(socket, readDeviceDatabases(socket), readFreeMemory(socket));
+}
+
+QList<InstallResult> InstallConduit::installAll(int socket, const QList<DBInfo> &deviceDatabases,
+                                                qint64 freeBytes)
 {
     QList<InstallResult> results;
-    QStringList files = pendingFiles();
+    QStringList files = orderedFiles(pendingFiles());
 
     if (files.isEmpty()) {
         emit logMessage("No files to install");
         return results;
     }
 
-    emit logMessage(QString("Found %1 file(s) to install").arg(files.size()));
+    // Only files that are not already on the Palm cross the link
+    qint64 bytesToSend = 0;
+    for (const QString &filePath : files) {
+        DBInfo header;
+        if (readFileInfo(filePath, &header)
+            && !(m_skipIdentical && isInstalled(header, deviceDatabases))) {
+            bytesToSend += QFileInfo(filePath).size();
+        }
+    }
+
+    emit logMessage(QString("Found %1 file(s) to install, %2 to send")
+                    .arg(files.size()).arg(kilobytes(bytesToSend)));
+    if (freeBytes >= 0) {
+        emit logMessage(QString("Palm has %1 free").arg(kilobytes(freeBytes)));
+    }
+    qint64 estimateMs = estimateTransferMs(bytesToSend);
+    if (estimateMs >= 0) {
+        emit logMessage(QString("Estimated transfer time: %1 s at %2/s")
+                        .arg(estimateMs / 1000.0, 0, 'f', 1)
+                        .arg(kilobytes(qint64(throughput()))));
+    }
 
     int current = 0;
     for (const QString &filePath : files) {
+        if (isCancelled()) {
+            emit logMessage("Install cancelled");
+            break;
+        }
+
         current++;
         QFileInfo info(filePath);
         emit progressUpdated(current, files.size(), info.fileName());
 
-        InstallResult result = installFile(filePath, socket);
+        // A new database that cannot fit would fail after a full transfer;
+        // replacements free their old copy, so those are always tried
+        DBInfo header;
+        memset(&header, 0, sizeof(header));
+        if (freeBytes >= 0 && readFileInfo(filePath, &header)
+            && !onDevice(header, deviceDatabases) && info.size() > freeBytes) {
+            InstallResult result;
+            result.fileName = info.fileName();
+            result.deferred = true;
+            result.errorMessage = QString("Not enough free memory on the Palm (needs %1, %2 free)")
+                                      .arg(kilobytes(info.size()), kilobytes(freeBytes));
+            results.append(result);
+            emit fileInstalled(result.fileName, false);
+            emit errorOccurred(QString("Not installing %1: %2")
+                               .arg(result.fileName, result.errorMessage));
+            continue;
+        }
+
+        InstallResult result = installFile(filePath, socket, deviceDatabases);
         results.append(result);
+        if (result.cancelled) {
+            // The file stays in the install folder for the next sync
+            emit logMessage(QString("Install cancelled while sending %1").arg(result.fileName));
+            break;
+        }
+
+        if (result.success && !result.skipped && freeBytes >= 0
+            && !onDevice(header, deviceDatabases)) {
+            freeBytes = qMax<qint64>(0, freeBytes - info.size());
+        }
 
         emit fileInstalled(result.fileName, result.success);
 
         if (result.success) {
-            emit logMessage(QString("Installed: %1").arg(result.fileName));
+            if (!result.skipped) {
+                emit logMessage(QString("Installed: %1").arg(result.fileName));
+            }
 
             // Move or delete the installed file
             if (m_keepInstalledFiles) {
@@ -90,17 +250,29 @@ QList<InstallResult> InstallConduit::installAll(int socket)
 
     // Summary
     int successCount = 0;
+    int skippedCount = 0;
+    int deferredCount = 0;
     for (const InstallResult &r : results) {
         if (r.success) successCount++;
+        if (r.skipped) skippedCount++;
+        if (r.deferred) deferredCount++;
     }
 
-    emit logMessage(QString("Install complete: %1 of %2 files installed successfully")
-                    .arg(successCount).arg(results.size()));
+    emit logMessage(QString("Install complete: %1 of %2 files installed successfully (%3 already on the Palm)")
+                    .arg(successCount).arg(results.size()).arg(skippedCount));
+    if (deferredCount > 0) {
+        emit logMessage(QString("%1 file(s) left in the install folder for lack of memory on the Palm")
+                        .arg(deferredCount));
+    }
+    if (throughput() > 0) {
+        emit logMessage(QString("Measured install throughput: %1/s").arg(kilobytes(qint64(throughput()))));
+    }
 
     return results;
 }
 
-InstallResult InstallConduit::installFile(const QString &filePath, int socket)
+InstallResult InstallConduit::installFile(const QString &filePath, int socket,
+                                          const QList<DBInfo> &deviceDatabases)
 {
     InstallResult result;
     QFileInfo info(filePath);
@@ -133,16 +305,42 @@ InstallResult InstallConduit::installFile(const QString &filePath, int socket)
     struct DBInfo dbInfo;
     pi_file_get_info(pf, &dbInfo);
 
+    if (m_skipIdentical && isInstalled(dbInfo, deviceDatabases)) {
+        pi_file_close(pf);
+        emit logMessage(QString("Skipped %1: %2 version %3, modnum %4 is already on the Palm")
+                        .arg(result.fileName)
+                        .arg(QString::fromLatin1(dbInfo.name))
+                        .arg(dbInfo.version)
+                        .arg(dbInfo.modnum));
+        result.success = true;
+        result.skipped = true;
+        return result;
+    }
+
     emit logMessage(QString("Installing database: %1 (type: %2, creator: %3)")
                     .arg(QString::fromLatin1(dbInfo.name))
                     .arg(QString::number(dbInfo.type, 16))
                     .arg(QString::number(dbInfo.creator, 16)));
 
     // Install to Palm (card 0 = internal storage)
-    int rc = pi_file_install(pf, socket, 0, nullptr);
+    QElapsedTimer timer;
+    timer.start();
+    int rc = FileTransfer::install(pf, socket, 0, m_cancelCheck);
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
 
     pi_file_close(pf);
 
+    if (rc < 0 && isCancelled()) {
+        result.cancelled = true;
+        result.errorMessage = "Cancelled";
+        return result;
+    }
+
+    if (rc >= 0) {
+        m_bytesSent += info.size();
+        m_sendUs += elapsedUs;
+    }
+
     if (rc < 0) {
         result.success = false;
         result.errorMessage = QString("pilot-link error code: %1").arg(rc);
@@ -153,6 +351,90 @@ InstallResult InstallConduit::installFile(const QString &filePath, int socket)
     return result;
 }
 
+// ========== Throughput ==========
+
+double InstallConduit::throughput() const
+{
+    return m_sendUs > 0 ? m_bytesSent * 1e6 / m_sendUs : 0.0;
+}
+
+qint64 InstallConduit::estimateTransferMs(qint64 bytes) const
+{
+    double bytesPerSecond = throughput();
+    if (bytesPerSecond <= 0) {
+        return -1;
+    }
+    return qint64(bytes * 1000.0 / bytesPerSecond);
+}
+
+// ========== Device Database List ==========
+
+QList<DBInfo> InstallConduit::readDeviceDatabases(int socket)
+{
+    QList<DBInfo> databases;
+    if (socket < 0) {
+        return databases;
+    }
+
+    pi_buffer_t *buffer = pi_buffer_new(0xffff);
+    int start = 0;
+
+    // Each reply holds one or more DBInfo entries; the list ends with a failed call
+    auto readList = [&]() {
+        return KPilotDeviceLink::traceRaw(DlpCall::ReadDBList, [&]() {
+            return dlp_ReadDBList(socket, 0, dlpDBListRAM | dlpDBListMultiple, start, buffer);
+        }, start);
+    };
+    while (readList() >= 0) {
+        int count = buffer->used / sizeof(struct DBInfo);
+        if (count == 0) {
+            break;
+        }
+        const DBInfo *entries = reinterpret_cast<const DBInfo*>(buffer->data);
+        for (int i = 0; i < count; ++i) {
+            databases.append(entries[i]);
+        }
+        start = entries[count - 1].index + 1;
+    }
+
+    pi_buffer_free(buffer);
+
+    qDebug() << "[InstallConduit] Databases on device:" << databases.size();
+    return databases;
+}
+
+bool InstallConduit::isInstalled(const DBInfo &fileInfo, const QList<DBInfo> &deviceDatabases)
+{
+    for (const DBInfo &device : deviceDatabases) {
+        if (strncmp(device.name, fileInfo.name, sizeof(device.name)) == 0) {
+            return device.creator == fileInfo.creator
+                && device.type == fileInfo.type
+                && device.version == fileInfo.version
+                && device.modnum == fileInfo.modnum;
+        }
+    }
+    return false;
+}
+
+qint64 InstallConduit::readFreeMemory(int socket)
+{
+    if (socket < 0) {
+        return -1;
+    }
+
+    struct CardInfo card;
+    memset(&card, 0, sizeof(card));
+    int result = KPilotDeviceLink::traceRaw(DlpCall::ReadStorageInfo, [&]() {
+        return dlp_ReadStorageInfo(socket, 0, &card);
+    });
+    if (result < 0) {
+        return -1;
+    }
+
+    qDebug() << "[InstallConduit] Card 0 RAM:" << card.ramSize << "free:" << card.ramFree;
+    return card.ramFree;
+}
+
 bool InstallConduit::moveToInstalled(const QString &filePath)
 {
     if (m_installFolder.isEmpty()) {
@@ -5,8 +5,12 @@
 #include <QString>
 #include <QStringList>
 #include <QDir>
+#include <QList>
+#include <QPair>
+#include <functional>
 
 class KPilotDeviceLink;
+struct DBInfo;
 
 namespace Sync {
 
@@ -17,9 +21,21 @@ struct InstallResult
 {
     QString fileName;
     bool success = false;
+    bool skipped = false;   ///< Identical database already on the Palm; nothing sent
+    bool deferred = false;  ///< Did not fit in the Palm's free memory; left for the next sync
+    bool cancelled = false; ///< Stopped part way; pilot-link removed the partial copy
     QString errorMessage;
 };
 
+/**
+ * @brief Order in which installAll() sends pending files
+ */
+enum class InstallOrder
+{
+    Directory,          ///< Install folder listing order
+    PriorityThenSize    ///< Highest priority first, smallest first within a priority
+};
+
 /**
  * @brief Conduit for installing .prc/.pdb files to Palm devices
  *
@@ -31,6 +47,15 @@ struct InstallResult
  * Unlike regular conduits, this doesn't sync records - it just
  * transfers complete database files to the Palm.
  *
+ * Files whose database is already on the Palm with the same name,
+ * creator, type, version and modification number are not sent again;
+ * they count as installed and are moved like the others.
+ *
+ * By default files go out by priority, then smallest first, so that when
+ * the handheld's RAM runs short the small, important databases are on it
+ * and only large ones wait. New databases larger than the remaining free
+ * memory are not attempted at all.
+ *
  * Usage:
  * 1. Drop .prc/.pdb files into <sync_folder>/install/
  * 2. Run HotSync
@@ -71,6 +96,43 @@ public:
     void setKeepInstalledFiles(bool keep) { m_keepInstalledFiles = keep; }
     bool keepInstalledFiles() const { return m_keepInstalledFiles; }
 
+    /**
+     * @brief Set whether to skip files already on the Palm (default: true)
+     */
+    void setSkipIdentical(bool skip) { m_skipIdentical = skip; }
+    bool skipIdentical() const { return m_skipIdentical; }
+
+    /**
+     * @brief Set the install order (default: InstallOrder::PriorityThenSize)
+     */
+    void setInstallOrder(InstallOrder order) { m_installOrder = order; }
+    InstallOrder installOrder() const { return m_installOrder; }
+
+    /**
+     * @brief Set a callback that reports whether to stop installing
+     *
+     * Checked between files, and after every record of the file being sent.
+     */
+    void setCancelCheck(std::function<bool()> callback) { m_cancelCheck = std::move(callback); }
+
+    /**
+     * @brief Give files matching a wildcard pattern a priority
+     *
+     * @param pattern File name pattern, e.g. "*Lib*.prc"
+     * @param priority Higher installs first; unmatched files have 0
+     */
+    void setPriority(const QString &pattern, int priority);
+
+    /**
+     * @brief Priority of a file: the highest of its matching patterns, or 0
+     */
+    int priority(const QString &fileName) const;
+
+    /**
+     * @brief Sort files into install order
+     */
+    QStringList orderedFiles(const QStringList &files) const;
+
     // ========== Operations ==========
 
     /**
@@ -93,14 +155,66 @@ public:
      */
     QList<InstallResult> installAll(int socket);
 
+    /**
+     * @brief Install all pending files, given the state of the Palm
+     *
+     * @param socket The pilot-link socket descriptor
+     * @param deviceDatabases Databases on the Palm (see readDeviceDatabases());
+     *        files matching one of them are skipped
+     * @param freeBytes Free RAM on the Palm (see readFreeMemory()), -1 if unknown
+     */
+    QList<InstallResult> installAll(int socket, const QList<struct DBInfo> &deviceDatabases,
+                                    qint64 freeBytes = -1);
+
     /**
      * @brief Install a single file to the Palm device
      *
      * @param filePath Path to the .prc/.pdb file
      * @param socket The pilot-link socket descriptor
+     * @param deviceDatabases Databases on the Palm; skip the file if it matches one
      * @return Result of the installation
      */
-    InstallResult installFile(const QString &filePath, int socket);
+    InstallResult installFile(const QString &filePath, int socket,
+                              const QList<struct DBInfo> &deviceDatabases = {});
+
+    // ========== Device Database List ==========
+
+    /**
+     * @brief Read the header of every RAM database on the Palm
+     *
+     * Asks for several entries per dlp_ReadDBList where the handheld
+     * supports it (DLP 1.2+), one per call otherwise.
+     */
+    static QList<struct DBInfo> readDeviceDatabases(int socket);
+
+    /**
+     * @brief Check whether a file's database is already on the Palm
+     *
+     * @param fileInfo Header of the file (from pi_file_get_info)
+     * @param deviceDatabases Databases on the Palm
+     * @return true if one has the same name, creator, type, version and
+     *         modification number
+     */
+    static bool isInstalled(const struct DBInfo &fileInfo,
+                            const QList<struct DBInfo> &deviceDatabases);
+
+    /**
+     * @brief Free RAM on the Palm's internal card (dlp_ReadStorageInfo)
+     * @return Bytes free, or -1 if the handheld did not say
+     */
+    static qint64 readFreeMemory(int socket);
+
+    // ========== Throughput ==========
+
+    /**
+     * @brief Install throughput measured so far, in bytes per second (0 = none yet)
+     */
+    double throughput() const;
+
+    /**
+     * @brief Estimated time to send @p bytes at the measured throughput, -1 if unknown
+     */
+    qint64 estimateTransferMs(qint64 bytes) const;
 
 signals:
     void logMessage(const QString &message);
@@ -119,8 +233,18 @@ private:
      */
     void ensureFoldersExist();
 
+    bool isCancelled() const { return m_cancelCheck && m_cancelCheck(); }
+
     QString m_installFolder;
     bool m_keepInstalledFiles = true;
+    bool m_skipIdentical = true;
+    InstallOrder m_installOrder = InstallOrder::PriorityThenSize;
+    QList<QPair<QString, int>> m_priorities;   ///< Wildcard pattern, priority
+    std::function<bool()> m_cancelCheck;
+
+    // Measured over every file sent by this conduit
+    qint64 m_bytesSent = 0;
+    qint64 m_sendUs = 0;
 };
 
 } // namespace Sync
@@ -1,4 +1,6 @@
 #include "webcalendarconduit.h"
+#include "icalfeedsplitter.h"
+#include "../localfilebackend.h"
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -9,11 +11,70 @@
 #include <QFile>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QMutexLocker>
 #include <QDebug>
 #include <QRegularExpression>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+
 namespace Sync {
 
+// Per-feed index of written events; not matched by the backend's "*.ics" scan
+static const char *FEED_INDEX_FILE = ".feed-index.json";
+
+// Present in the staging directory while it holds changes sync() has not copied
+static const char *STAGED_MARKER_FILE = ".staged";
+
+// Unread reply data QNetworkAccessManager may buffer before it stops
+// reading from the socket; keeps memory bounded for very large feeds
+static const qint64 FEED_READ_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * @brief In-flight download of one feed
+ */
+struct WebCalendarConduit::FeedFetch
+{
+    WebCalendarFeed *feed = nullptr;
+    QString outputDir;              ///< This feed's subdirectory
+    bool conditional = false;       ///< Request carried If-None-Match / If-Modified-Since
+    QNetworkReply *reply = nullptr;
+    QTimer *timeout = nullptr;      ///< Inactivity timer, owned by reply
+    bool timedOut = false;
+
+    // Incremental write state (see beginFeedWrite)
+    QMap<QString, WebCalendarFeedEntry> previous;   ///< Index entries not yet seen in this download
+    QMap<QString, WebCalendarFeedEntry> current;    ///< Index after this download
+    QSet<QString> takenFileNames;
+    int created = 0;
+    int updated = 0;
+    int unchanged = 0;
+    int failed = 0;
+
+    // Streaming state: events are split and written while the download runs
+    std::unique_ptr<ICalFeedSplitter> splitter;     ///< Created on the first 2xx data
+    bool discardBody = false;                       ///< Non-2xx response, body not an iCalendar
+    QDateTime now;                                  ///< Reference time for the date filter
+    int filtered = 0;
+};
+
+/**
+ * @brief Name of a date filter as stored in the settings
+ */
+static QString dateFilterName(WebCalendarConduit::DateFilter filter)
+{
+    switch (filter) {
+    case WebCalendarConduit::DateFilter::All: return "all";
+    case WebCalendarConduit::DateFilter::RecurringAndFuture: return "recurring_and_future";
+    case WebCalendarConduit::DateFilter::FutureOnly: return "future";
+    }
+    return QString();
+}
+
 // ========== WebCalendarFeed ==========
 
 QJsonObject WebCalendarFeed::toJson() const
@@ -23,6 +84,15 @@ QJsonObject WebCalendarFeed::toJson() const
     obj["url"] = url.toString();
     obj["category"] = category;
     obj["enabled"] = enabled;
+    if (!etag.isEmpty()) {
+        obj["etag"] = etag;
+    }
+    if (!lastModified.isEmpty()) {
+        obj["last_modified"] = lastModified;
+    }
+    if (!dateFilter.isEmpty()) {
+        obj["date_filter"] = dateFilter;
+    }
     return obj;
 }
 
@@ -33,6 +103,9 @@ WebCalendarFeed WebCalendarFeed::fromJson(const QJsonObject &obj)
     feed.url = QUrl(obj["url"].toString());
     feed.category = obj["category"].toString();
     feed.enabled = obj["enabled"].toBool(true);
+    feed.etag = obj["etag"].toString();
+    feed.lastModified = obj["last_modified"].toString();
+    feed.dateFilter = obj["date_filter"].toString();
     return feed;
 }
 
@@ -41,21 +114,17 @@ WebCalendarFeed WebCalendarFeed::fromJson(const QJsonObject &obj)
 WebCalendarConduit::WebCalendarConduit(QObject *parent)
     : Conduit(parent)
 {
-    // Note: QNetworkAccessManager is created lazily in sync() to ensure
-    // it's created on the worker thread where it will be used
+    // Note: QNetworkAccessManager is created per fetch, on the thread
+    // (sync worker or background refresh) that uses it
 }
 
-WebCalendarConduit::~WebCalendarConduit()
-{
-    // m_networkManager is deleted after each sync, but clean up if needed
-    delete m_networkManager;
-    m_networkManager = nullptr;
-}
+WebCalendarConduit::~WebCalendarConduit() = default;
 
 // ========== Settings ==========
 
 void WebCalendarConduit::loadSettings(const QJsonObject &settings)
 {
+    QMutexLocker locker(&m_mutex);
     m_feeds.clear();
 
     // Load feeds
@@ -86,6 +155,9 @@ void WebCalendarConduit::loadSettings(const QJsonObject &settings)
         m_dateFilter = DateFilter::FutureOnly;
     }
 
+    m_maxConcurrentFetches = qMax(1, settings["max_concurrent_fetches"].toInt(4));
+    m_fetchTimeout = qMax(1, settings["fetch_timeout"].toInt(30));
+
     // Load last fetch time
     QString lastFetchStr = settings["last_fetch"].toString();
     if (!lastFetchStr.isEmpty()) {
@@ -95,6 +167,7 @@ void WebCalendarConduit::loadSettings(const QJsonObject &settings)
 
 QJsonObject WebCalendarConduit::saveSettings() const
 {
+    QMutexLocker locker(&m_mutex);
     QJsonObject settings;
 
     // Save feeds
@@ -115,13 +188,10 @@ QJsonObject WebCalendarConduit::saveSettings() const
     settings["fetch_interval"] = intervalStr;
 
     // Save date filter
-    QString filterStr;
-    switch (m_dateFilter) {
-    case DateFilter::All: filterStr = "all"; break;
-    case DateFilter::RecurringAndFuture: filterStr = "recurring_and_future"; break;
-    case DateFilter::FutureOnly: filterStr = "future"; break;
-    }
-    settings["date_filter"] = filterStr;
+    settings["date_filter"] = dateFilterName(m_dateFilter);
+
+    settings["max_concurrent_fetches"] = m_maxConcurrentFetches;
+    settings["fetch_timeout"] = m_fetchTimeout;
 
     // Save last fetch time
     if (m_lastFetchTime.isValid()) {
@@ -141,13 +211,27 @@ QWidget* WebCalendarConduit::createSettingsWidget(QWidget *parent)
 
 // ========== Feed Management ==========
 
+QList<WebCalendarFeed> WebCalendarConduit::feeds() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_feeds;
+}
+
+void WebCalendarConduit::setFeeds(const QList<WebCalendarFeed> &feeds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_feeds = feeds;
+}
+
 void WebCalendarConduit::addFeed(const WebCalendarFeed &feed)
 {
+    QMutexLocker locker(&m_mutex);
     m_feeds.append(feed);
 }
 
 void WebCalendarConduit::removeFeed(int index)
 {
+    QMutexLocker locker(&m_mutex);
     if (index >= 0 && index < m_feeds.size()) {
         m_feeds.removeAt(index);
     }
@@ -160,15 +244,22 @@ bool WebCalendarConduit::shouldRun(SyncContext *context) const
     Q_UNUSED(context);
 
     // No feeds configured? Skip
-    if (m_feeds.isEmpty()) {
+    if (feeds().isEmpty()) {
         return false;
     }
 
+    // Background refresh decides when to download; sync only has to run
+    // if something was staged
+    if (!stagingDirectory().isEmpty()) {
+        return hasStagedChanges();
+    }
+
     return shouldFetchNow();
 }
 
 bool WebCalendarConduit::shouldFetchNow() const
 {
+    QMutexLocker locker(&m_mutex);
     if (!m_lastFetchTime.isValid()) {
         return true;  // Never fetched before
     }
@@ -198,19 +289,12 @@ SyncResult WebCalendarConduit::sync(SyncContext *context)
     result.startTime = QDateTime::currentDateTime();
     result.success = true;
 
-    if (m_feeds.isEmpty()) {
+    if (feeds().isEmpty()) {
         emit logMessage("No calendar feeds configured");
         result.endTime = QDateTime::currentDateTime();
         return result;
     }
 
-    // Create network manager on the current thread (worker thread)
-    // This avoids "Cannot create children for a parent in a different thread" errors
-    delete m_networkManager;
-    m_networkManager = new QNetworkAccessManager();  // No parent - we manage lifetime
-
-    emit logMessage(QString("Fetching %1 calendar feed(s)...").arg(m_feeds.size()));
-
     // Determine base output directory: profile_path/calendar/
     // Each feed gets its own subdirectory for organization
     QString baseOutputDir;
@@ -235,33 +319,111 @@ SyncResult WebCalendarConduit::sync(SyncContext *context)
         return result;
     }
 
+    QString stagingDir = stagingDirectory();
+    if (!stagingDir.isEmpty()) {
+        // Feeds were downloaded in the background; only local copying
+        // happens while the Palm is in the cradle
+        promoteStagedFeeds(stagingDir, baseOutputDir, result);
+    } else {
+        fetchFeeds(baseOutputDir, result, [this]() { return isCancelled(); });
+    }
+
+    result.endTime = QDateTime::currentDateTime();
+    return result;
+}
+
+void WebCalendarConduit::fetchFeeds(const QString &outputDir, SyncResult &result,
+                                    const std::function<bool()> &cancel)
+{
+    // Network manager lives on the calling thread for the duration of the fetch
+    QNetworkAccessManager network;
+
+    QList<WebCalendarFeed> feedList = feeds();
+    emit logMessage(QString("Fetching %1 calendar feed(s)...").arg(feedList.size()));
+
+    QList<WebCalendarFeed*> pending;
+    for (WebCalendarFeed &feed : feedList) {
+        if (feed.enabled) {
+            pending.append(&feed);
+        }
+    }
+
+    int enabledCount = pending.size();
     int successCount = 0;
     int failCount = 0;
+    bool cancelled = false;
 
-    for (const WebCalendarFeed &feed : m_feeds) {
-        if (isCancelled()) {
-            emit logMessage("Fetch cancelled");
-            break;
-        }
+    // Keep up to m_maxConcurrentFetches requests in flight on the shared
+    // network manager; each response is processed as soon as it finishes
+    QEventLoop loop;
+    QList<FeedFetch*> active;
+    std::function<void()> startMore = [&]() {
+        while (!cancelled && !pending.isEmpty() && active.size() < m_maxConcurrentFetches) {
+            WebCalendarFeed *feed = pending.takeFirst();
+            emit progressUpdated(successCount + failCount, enabledCount,
+                QString("Fetching %1...").arg(feed->name));
+
+            FeedFetch *fetch = startFetch(network, *feed, outputDir);
+            if (!fetch) {
+                failCount++;
+                continue;
+            }
+            active.append(fetch);
 
-        if (!feed.enabled) {
-            continue;
-        }
+            connect(fetch->reply, &QNetworkReply::finished, &loop, [&, fetch]() {
+                active.removeOne(fetch);
+                if (finishFetch(fetch, result)) {
+                    successCount++;
+                } else {
+                    failCount++;
+                }
+                delete fetch;
 
-        emit progressUpdated(successCount + failCount, m_feeds.size(),
-            QString("Fetching %1...").arg(feed.name));
+                startMore();
+                if (active.isEmpty()) {
+                    loop.quit();
+                }
+            });
+        }
+    };
 
-        if (fetchFeed(feed, baseOutputDir, result)) {
-            successCount++;
-        } else {
-            failCount++;
+    // Cancellation is polled; aborting a reply still runs its finished handler
+    QTimer cancelPoll;
+    connect(&cancelPoll, &QTimer::timeout, &loop, [&]() {
+        if (!cancelled && cancel && cancel()) {
+            cancelled = true;
+            emit logMessage("Fetch cancelled");
+            const QList<FeedFetch*> inFlight = active;
+            for (FeedFetch *fetch : inFlight) {
+                fetch->reply->abort();
+            }
         }
+    });
+
+    startMore();
+    if (!active.isEmpty()) {
+        cancelPoll.start(100);
+        loop.exec();
+        cancelPoll.stop();
     }
 
-    // Update last fetch time on success
-    if (successCount > 0) {
-        // Cast away const-ness to update last fetch time
-        const_cast<WebCalendarConduit*>(this)->m_lastFetchTime = QDateTime::currentDateTime();
+    // Keep the new validators (matched by name and URL, in case the list was edited
+    // meanwhile) and update last fetch time on success
+    {
+        QMutexLocker locker(&m_mutex);
+        for (WebCalendarFeed &feed : m_feeds) {
+            for (const WebCalendarFeed &fetched : std::as_const(feedList)) {
+                if (fetched.url == feed.url && fetched.name == feed.name) {
+                    feed.etag = fetched.etag;
+                    feed.lastModified = fetched.lastModified;
+                    feed.dateFilter = fetched.dateFilter;
+                    break;
+                }
+            }
+        }
+        if (successCount > 0) {
+            m_lastFetchTime = QDateTime::currentDateTime();
+        }
     }
 
     // Report results
@@ -272,323 +434,746 @@ SyncResult WebCalendarConduit::sync(SyncContext *context)
         warning.category = WarningCategory::Unsupported;
         warning.field = "feed";
         warning.message = QString("%1 of %2 feeds failed to fetch")
-            .arg(failCount).arg(m_feeds.size());
+            .arg(failCount).arg(enabledCount);
         result.warnings.append(warning);
         emit logMessage(QString("Warning: %1 feed(s) failed to fetch").arg(failCount));
     }
 
     emit logMessage(QString("Fetched %1 calendar feed(s)").arg(successCount));
-
-    // Clean up network manager
-    delete m_networkManager;
-    m_networkManager = nullptr;
-
-    result.endTime = QDateTime::currentDateTime();
-    return result;
 }
 
-bool WebCalendarConduit::fetchFeed(const WebCalendarFeed &feed, const QString &outputDir,
-                                    SyncResult &result)
+WebCalendarConduit::FeedFetch* WebCalendarConduit::startFetch(QNetworkAccessManager &network,
+                                                              WebCalendarFeed &feed,
+                                                              const QString &outputDir)
 {
     if (!feed.url.isValid()) {
         emit logMessage(QString("Invalid URL for feed '%1'").arg(feed.name));
-        return false;
+        return nullptr;
+    }
+
+    // Create subdirectory for this feed
+    QString feedOutputDir = outputDir + "/" + feedDirectoryName(feed);
+    QDir dir;
+    if (!dir.mkpath(feedOutputDir)) {
+        emit logMessage(QString("Failed to create directory: %1").arg(feedOutputDir));
+        return nullptr;
     }
 
     emit logMessage(QString("Fetching: %1 (%2)").arg(feed.name).arg(feed.url.toString()));
 
-    // Synchronous HTTP fetch using event loop
     QNetworkRequest request(feed.url);
     request.setHeader(QNetworkRequest::UserAgentHeader, "QPilotSync/1.0");
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
                          QNetworkRequest::NoLessSafeRedirectPolicy);
 
+    // Conditional request - only if the files from the last download are
+    // still on disk, otherwise a 304 would leave the feed directory empty,
+    // and were written with the current date filter, otherwise a 304 would
+    // keep the old filter's selection
+    bool haveLocalCopy = QFile::exists(feedOutputDir + "/" + FEED_INDEX_FILE)
+        && feed.dateFilter == dateFilterName(m_dateFilter);
+    if (haveLocalCopy) {
+        if (!feed.etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", feed.etag.toUtf8());
+        }
+        if (!feed.lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", feed.lastModified.toUtf8());
+        }
+    }
+
     qDebug() << "[WebCalendarConduit] Starting fetch for URL:" << feed.url.toString();
 
-    QNetworkReply *reply = m_networkManager->get(request);
+    FeedFetch *fetch = new FeedFetch;
+    fetch->feed = &feed;
+    fetch->outputDir = feedOutputDir;
+    fetch->conditional = haveLocalCopy;
+    fetch->reply = network.get(request);
+    fetch->reply->setReadBufferSize(FEED_READ_BUFFER_SIZE);
+
+    // Process data as it arrives rather than buffering the whole feed
+    connect(fetch->reply, &QNetworkReply::readyRead, fetch->reply, [this, fetch]() {
+        consumeFetchData(fetch);
+    });
+
+    // Inactivity timeout: restarted whenever data arrives, so a large feed
+    // on a slow link is not cut off while a stalled one is
+    QTimer *timeout = new QTimer(fetch->reply);
+    fetch->timeout = timeout;
+    timeout->setSingleShot(true);
+    timeout->setInterval(m_fetchTimeout * 1000);
+    connect(timeout, &QTimer::timeout, fetch->reply, [fetch]() {
+        fetch->timedOut = true;
+        fetch->reply->abort();
+    });
+    connect(fetch->reply, &QNetworkReply::downloadProgress, timeout,
+            qOverload<>(&QTimer::start));
+    timeout->start();
+
+    return fetch;
+}
 
-    // Wait for completion with timeout
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
+void WebCalendarConduit::consumeFetchData(FeedFetch *fetch)
+{
+    QNetworkReply *reply = fetch->reply;
+
+    if (!fetch->splitter && !fetch->discardBody) {
+        // First data: only a successful response carries the feed
+        // (file:// and similar report no HTTP status at all)
+        int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (httpStatus != 0 && (httpStatus < 200 || httpStatus >= 300)) {
+            fetch->discardBody = true;
+        } else {
+            // Split into individual event files (CalendarConduit expects one
+            // event per .ics file), filtering by date in the same pass
+            beginFeedWrite(fetch);
+            fetch->now = currentTime();
+            fetch->splitter = std::make_unique<ICalFeedSplitter>(
+                [this, fetch](const ICalFeedEvent &event) {
+                    if (!passesDateFilter(event, fetch->now)) {
+                        fetch->filtered++;
+                        return;
+                    }
+                    writeFeedEvent(fetch, fetch->splitter->header(), event);
+                });
+        }
+    }
+
+    QByteArray chunk = reply->readAll();
+    if (fetch->splitter) {
+        fetch->splitter->addData(chunk);
+    }
+}
 
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+bool WebCalendarConduit::finishFetch(FeedFetch *fetch, SyncResult &result)
+{
+    WebCalendarFeed &feed = *fetch->feed;
+    QNetworkReply *reply = fetch->reply;
+    const QString &feedOutputDir = fetch->outputDir;
+    fetch->timeout->stop();
+    disconnect(reply, &QNetworkReply::readyRead, nullptr, nullptr);
+    reply->deleteLater();
 
-    qDebug() << "[WebCalendarConduit] Waiting for response...";
-    timeout.start(30000);  // 30 second timeout
-    loop.exec();
-    qDebug() << "[WebCalendarConduit] Event loop finished, reply finished:" << reply->isFinished();
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (!fetch->timedOut && httpStatus == 304 && fetch->conditional) {
+        // Nothing changed since the last download, but some events may
+        // have moved into the past since they were written
+        QMap<QString, WebCalendarFeedEntry> index = loadFeedIndex(feedOutputDir);
+        int expired = pruneExpiredEvents(feedOutputDir, index);
+        result.pcStats.unchanged += index.size();
+        result.pcStats.deleted += expired;
+        emit logMessage(QString("  → '%1' not modified (%2 events unchanged, %3 expired)")
+            .arg(feed.name).arg(index.size()).arg(expired));
+        return true;
+    }
 
-    if (timeout.isActive()) {
-        timeout.stop();
-    } else {
-        // Timeout occurred
-        reply->abort();
-        reply->deleteLater();
-        emit logMessage(QString("Timeout fetching '%1'").arg(feed.name));
+    if (fetch->timedOut || reply->error() != QNetworkReply::NoError) {
+        if (fetch->timedOut) {
+            emit logMessage(QString("Timeout fetching '%1'").arg(feed.name));
+        } else {
+            emit logMessage(QString("Failed to fetch '%1': %2")
+                .arg(feed.name).arg(reply->errorString()));
+        }
+        abandonFeedWrite(fetch, result);
         return false;
     }
 
-    if (reply->error() != QNetworkReply::NoError) {
-        emit logMessage(QString("Failed to fetch '%1': %2")
-            .arg(feed.name).arg(reply->errorString()));
-        reply->deleteLater();
-        return false;
+    // Whatever arrived after the last readyRead
+    if (reply->bytesAvailable() > 0) {
+        consumeFetchData(fetch);
     }
 
-    QByteArray data = reply->readAll();
-    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+    qint64 size = fetch->splitter ? fetch->splitter->bytesProcessed() : 0;
     qDebug() << "[WebCalendarConduit] Response: HTTP" << httpStatus
              << "Content-Type:" << contentType
-             << "Size:" << data.size() << "bytes";
-    if (data.size() > 0 && data.size() < 500) {
-        qDebug() << "[WebCalendarConduit] Full response:" << data;
-    } else if (data.size() >= 500) {
-        qDebug() << "[WebCalendarConduit] First 500 bytes:" << data.left(500);
-    }
-    reply->deleteLater();
+             << "Size:" << size << "bytes";
 
-    if (data.isEmpty()) {
+    if (!fetch->splitter || size == 0) {
         emit logMessage(QString("Empty response for '%1'").arg(feed.name));
+        abandonFeedWrite(fetch, result);
         return false;
     }
 
-    // Validate it looks like iCalendar data
-    if (!data.contains("BEGIN:VCALENDAR")) {
+    ICalFeedSplitter *splitter = fetch->splitter.get();
+    splitter->finish();
+
+    // Validate it looks like iCalendar data (nothing is written otherwise)
+    if (!splitter->sawCalendar()) {
         emit logMessage(QString("Invalid iCalendar data from '%1' (got %2 bytes, Content-Type: %3)")
-            .arg(feed.name).arg(data.size()).arg(contentType));
+            .arg(feed.name).arg(size).arg(contentType));
+        abandonFeedWrite(fetch, result);
         return false;
     }
 
-    // Filter events by date if configured
-    if (m_dateFilter != DateFilter::All) {
-        data = filterEventsByDate(data);
+    if (splitter->eventCount() == 0) {
+        // Not an error - but any events we wrote earlier have left the feed
+        emit logMessage(QString("No events found in '%1'").arg(feed.name));
+    } else if (fetch->filtered > 0) {
+        qDebug() << "[WebCalendarConduit] Filtered" << fetch->filtered << "past events, kept"
+                 << splitter->eventCount() - fetch->filtered;
     }
 
-    // Parse the iCalendar and split into individual event files
-    // This is necessary because CalendarConduit expects one event per .ics file
-    QString content = QString::fromUtf8(data);
+    if (!finishFeedWrite(fetch, result)) {
+        return false;
+    }
 
-    // Extract the VCALENDAR header (PRODID, VERSION, CALSCALE, VTIMEZONE, etc.)
-    int firstEvent = content.indexOf("BEGIN:VEVENT");
-    if (firstEvent < 0) {
-        emit logMessage(QString("No events found in '%1'").arg(feed.name));
-        return true;  // Not an error, just no events
+    // Only remember the validators once the files fully match this response,
+    // so events that failed to write are retried on the next fetch
+    bool complete = fetch->failed == 0;
+    feed.etag = complete ? QString::fromUtf8(reply->rawHeader("ETag")) : QString();
+    feed.lastModified = complete ? QString::fromUtf8(reply->rawHeader("Last-Modified")) : QString();
+    feed.dateFilter = complete ? dateFilterName(m_dateFilter) : QString();
+    return true;
+}
+
+// ========== Background Refresh ==========
+
+QString WebCalendarConduit::stagingDirectory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stagingDirectory;
+}
+
+void WebCalendarConduit::setStagingDirectory(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stagingDirectory = path;
+}
+
+bool WebCalendarConduit::hasStagedChanges() const
+{
+    QString stagingDir = stagingDirectory();
+    return !stagingDir.isEmpty() && QFile::exists(QDir(stagingDir).filePath(STAGED_MARKER_FILE));
+}
+
+SyncResult WebCalendarConduit::refreshStaged(const std::function<bool()> &cancel)
+{
+    SyncResult result;
+    result.startTime = QDateTime::currentDateTime();
+    result.success = true;
+
+    QString stagingDir = stagingDirectory();
+    if (stagingDir.isEmpty() || !QDir().mkpath(stagingDir)) {
+        result.success = false;
+        result.errorMessage = "No staging directory for calendar feeds";
+        result.endTime = QDateTime::currentDateTime();
+        return result;
+    }
+
+    QMutexLocker staging(&m_stagingMutex);
+    fetchFeeds(stagingDir, result, cancel);
+
+    // Tell the next sync there is something to copy (a 304 leaves the
+    // marker as it was)
+    const SyncStats &stats = result.pcStats;
+    if (stats.created + stats.updated + stats.deleted > 0) {
+        QFile marker(QDir(stagingDir).filePath(STAGED_MARKER_FILE));
+        if (!marker.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            result.success = false;
+            result.errorMessage = QString("Failed to write %1").arg(marker.fileName());
+        }
     }
 
-    QString calHeader = content.left(firstEvent);
+    result.endTime = QDateTime::currentDateTime();
+    return result;
+}
 
-    // Create subdirectory for this feed
-    QString feedDirName = feed.name;
-    feedDirName.replace(QRegularExpression("[^a-zA-Z0-9_ -]"), "_");
-    if (feedDirName.isEmpty()) {
-        feedDirName = "webcal";
+void WebCalendarConduit::promoteStagedFeeds(const QString &stagingDir, const QString &outputDir,
+                                            SyncResult &result)
+{
+    // A refresh is writing the staging directory; its changes are picked
+    // up by the next sync instead of waiting on the network here
+    std::unique_lock<QMutex> staging(m_stagingMutex, std::try_to_lock);
+    if (!staging.owns_lock()) {
+        emit logMessage("Calendar feeds are being refreshed; using the events from the last refresh");
+        return;
     }
 
-    QString feedOutputDir = outputDir + "/" + feedDirName;
-    QDir dir;
-    if (!dir.mkpath(feedOutputDir)) {
+    QDir stagingRoot(stagingDir);
+    if (!stagingRoot.exists(STAGED_MARKER_FILE)) {
+        emit logMessage("No new calendar feed data staged");
+        return;
+    }
+
+    emit logMessage("Copying staged calendar feeds...");
+
+    bool complete = true;
+    for (const WebCalendarFeed &feed : feeds()) {
+        QString dirName = feedDirectoryName(feed);
+        if (!feed.enabled || !stagingRoot.exists(dirName)) {
+            continue;  // Disabled or never downloaded
+        }
+        if (!promoteFeed(stagingRoot.filePath(dirName), outputDir + "/" + dirName, result)) {
+            complete = false;
+        }
+    }
+
+    // Anything that failed to copy is retried by the next sync
+    if (complete && !stagingRoot.remove(STAGED_MARKER_FILE)) {
+        qDebug() << "[WebCalendarConduit] Failed to remove staging marker in" << stagingDir;
+    }
+}
+
+bool WebCalendarConduit::promoteFeed(const QString &stagedDir, const QString &feedOutputDir,
+                                     SyncResult &result)
+{
+    QDir source(stagedDir);
+    QDir target(feedOutputDir);
+    if (!target.mkpath(".")) {
         emit logMessage(QString("Failed to create directory: %1").arg(feedOutputDir));
         return false;
     }
 
-    // Extract each VEVENT and write as individual file
-    QRegularExpression eventRe("BEGIN:VEVENT.*?END:VEVENT",
-                               QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpressionMatchIterator eventIter = eventRe.globalMatch(content);
+    QMap<QString, WebCalendarFeedEntry> staged = loadFeedIndex(stagedDir);
+    QMap<QString, WebCalendarFeedEntry> previous = loadFeedIndex(feedOutputDir);
+    QMap<QString, WebCalendarFeedEntry> current;
 
-    int eventCount = 0;
-    int written = 0;
-
-    while (eventIter.hasNext()) {
-        QRegularExpressionMatch match = eventIter.next();
-        QString event = match.captured();
-        eventCount++;
+    QSet<QString> takenFileNames;
+    for (const WebCalendarFeedEntry &entry : std::as_const(previous)) {
+        takenFileNames.insert(entry.fileName);
+    }
 
-        // Extract UID for filename (or use index if no UID)
-        QString uid;
-        QRegularExpression uidRe("UID:([^\r\n]+)");
-        QRegularExpressionMatch uidMatch = uidRe.match(event);
-        if (uidMatch.hasMatch()) {
-            uid = uidMatch.captured(1).trimmed();
-            // Make UID safe for filename
-            uid.replace(QRegularExpression("[^a-zA-Z0-9_@.-]"), "_");
+    int created = 0;
+    int updated = 0;
+    int unchanged = 0;
+    int failed = 0;
+    for (auto it = staged.constBegin(); it != staged.constEnd(); ++it) {
+        WebCalendarFeedEntry entry;
+        bool isNew = !previous.contains(it.key());
+        if (!isNew) {
+            entry = previous.take(it.key());
+            if (entry.contentHash == it->contentHash && target.exists(entry.fileName)) {
+                current.insert(it.key(), entry);
+                unchanged++;
+                continue;
+            }
+        } else {
+            entry.fileName = it->fileName;
+            QString stem = it->fileName.chopped(4);  // strip ".ics"
+            for (int n = 1; takenFileNames.contains(entry.fileName)
+                            || target.exists(entry.fileName); ++n) {
+                entry.fileName = QString("%1_%2.ics").arg(stem).arg(n);
+            }
+            takenFileNames.insert(entry.fileName);
         }
 
-        // Extract SUMMARY for a human-readable filename
-        QString summary;
-        QRegularExpression summaryRe("SUMMARY:([^\r\n]+)");
-        QRegularExpressionMatch summaryMatch = summaryRe.match(event);
-        if (summaryMatch.hasMatch()) {
-            summary = summaryMatch.captured(1).trimmed();
-            summary.replace(QRegularExpression("[^a-zA-Z0-9_ -]"), "_");
-            summary = summary.left(40);  // Limit length
+        // Existing events keep their file name so the CalendarConduit
+        // mapping stays valid
+        QString targetPath = target.filePath(entry.fileName);
+        QFile::remove(targetPath);
+        if (!QFile::copy(source.filePath(it->fileName), targetPath)) {
+            qDebug() << "[WebCalendarConduit] Failed to copy:" << source.filePath(it->fileName);
+            if (!isNew) {
+                current.insert(it.key(), entry);  // Old hash: retried next time
+            }
+            failed++;
+            continue;
         }
 
-        // Extract DTSTART for filename
-        QString dateStr;
-        QRegularExpression dtstartRe("DTSTART[^:]*:([0-9T]+)");
-        QRegularExpressionMatch dtstartMatch = dtstartRe.match(event);
-        if (dtstartMatch.hasMatch()) {
-            dateStr = dtstartMatch.captured(1).left(8);  // YYYYMMDD
-            if (dateStr.length() == 8) {
-                dateStr = dateStr.left(4) + "-" + dateStr.mid(4, 2) + "-" + dateStr.mid(6, 2);
-            }
+        entry.contentHash = it->contentHash;
+        current.insert(it.key(), entry);
+        if (isNew) {
+            created++;
+        } else {
+            updated++;
         }
+    }
 
-        // Generate filename: "Summary YYYY-MM-DD.ics" or "UID.ics"
-        QString fileName;
-        if (!summary.isEmpty() && !dateStr.isEmpty()) {
-            fileName = QString("%1 %2.ics").arg(summary).arg(dateStr);
-        } else if (!uid.isEmpty()) {
-            fileName = QString("%1.ics").arg(uid);
+    // Events no longer staged
+    int deleted = 0;
+    for (auto it = previous.constBegin(); it != previous.constEnd(); ++it) {
+        if (!target.exists(it->fileName) || target.remove(it->fileName)) {
+            deleted++;
         } else {
-            fileName = QString("event_%1.ics").arg(eventCount);
+            current.insert(it.key(), it.value());
+            failed++;
         }
+    }
 
-        QString filePath = feedOutputDir + "/" + fileName;
+    emit logMessage(QString("  → %1: %2 new, %3 changed, %4 removed, %5 unchanged")
+        .arg(target.dirName())
+        .arg(created).arg(updated).arg(deleted).arg(unchanged));
 
-        // Build complete iCalendar for this single event
-        QString singleEventIcs = calHeader + event + "\r\nEND:VCALENDAR\r\n";
+    result.pcStats.created += created;
+    result.pcStats.updated += updated;
+    result.pcStats.deleted += deleted;
+    result.pcStats.unchanged += unchanged;
+    result.pcStats.errors += failed;
 
-        // Write to file
-        QFile file(filePath);
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(singleEventIcs.toUtf8());
-            file.close();
-            written++;
-        } else {
-            qDebug() << "[WebCalendarConduit] Failed to write:" << filePath << file.errorString();
+    if (!saveFeedIndex(feedOutputDir, current)) {
+        emit logMessage(QString("Failed to save feed index in %1").arg(feedOutputDir));
+        return false;
+    }
+    return failed == 0;
+}
+
+// ========== Feed Files ==========
+
+int WebCalendarConduit::pruneExpiredEvents(const QString &feedOutputDir,
+                                           QMap<QString, WebCalendarFeedEntry> &index)
+{
+    if (m_dateFilter == DateFilter::All) {
+        return 0;  // Nothing expires
+    }
+
+    QDir feedDir(feedOutputDir);
+    QDateTime now = currentTime();
+    int deleted = 0;
+    for (auto it = index.begin(); it != index.end(); ) {
+        QFile file(feedDir.filePath(it->fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            ++it;
+            continue;
         }
+
+        bool keep = true;
+        ICalFeedSplitter splitter([this, &keep, &now](const ICalFeedEvent &event) {
+            keep = keep && passesDateFilter(event, now);
+        });
+        splitter.addData(file.readAll());
+        splitter.finish();
+        file.close();
+
+        if (keep || !file.remove()) {
+            ++it;
+            continue;
+        }
+        it = index.erase(it);
+        deleted++;
     }
 
-    emit logMessage(QString("  → %1 events written as individual .ics files").arg(written));
-    result.pcStats.created += written;
-    return true;
+    if (deleted > 0 && !saveFeedIndex(feedOutputDir, index)) {
+        emit logMessage(QString("Failed to save feed index in %1").arg(feedOutputDir));
+    }
+    return deleted;
 }
 
-QByteArray WebCalendarConduit::filterEventsByDate(const QByteArray &icsContent) const
+void WebCalendarConduit::beginFeedWrite(FeedFetch *fetch)
 {
-    // Filter events based on date and recurrence rules
-    // This is a basic implementation - for production use KCalendarCore
+    // Whatever is left in 'previous' at the end has dropped out of the feed
+    fetch->previous = loadFeedIndex(fetch->outputDir);
+    fetch->current.clear();
+
+    // File names already claimed, so new events never overwrite another event's file
+    fetch->takenFileNames.clear();
+    for (const WebCalendarFeedEntry &entry : std::as_const(fetch->previous)) {
+        fetch->takenFileNames.insert(entry.fileName);
+    }
+}
 
-    QByteArray result;
-    QDateTime now = QDateTime::currentDateTime();
+void WebCalendarConduit::writeFeedEvent(FeedFetch *fetch, const QByteArray &calHeader,
+                                        const ICalFeedEvent &event)
+{
+    // Build complete iCalendar for this single event
+    QByteArray singleEventIcs;
+    singleEventIcs.reserve(calHeader.size() + event.data.size() + 17);
+    singleEventIcs += calHeader;
+    singleEventIcs += event.data;
+    singleEventIcs += "\r\nEND:VCALENDAR\r\n";
+    QString hash = LocalFileBackend::calculateHash(singleEventIcs);
+
+    // Events without a UID can only be identified by their content
+    QString key = eventKey(event);
+    if (key.isEmpty()) {
+        key = "hash:" + hash;
+    }
+    // Some feeds repeat a UID; keep each copy rather than letting them collide
+    QString baseKey = key;
+    for (int n = 2; fetch->current.contains(key); ++n) {
+        key = QString("%1#%2").arg(baseKey).arg(n);
+    }
 
-    if (m_dateFilter == DateFilter::All) {
-        return icsContent;  // No filtering
+    QDir feedDir(fetch->outputDir);
+    WebCalendarFeedEntry entry;
+    bool isNew = !fetch->previous.contains(key);
+    if (!isNew) {
+        entry = fetch->previous.take(key);
+        if (entry.contentHash == hash && feedDir.exists(entry.fileName)) {
+            fetch->current.insert(key, entry);
+            fetch->unchanged++;
+            return;
+        }
+    } else {
+        QString preferred = eventFileName(event);
+        if (preferred.isEmpty()) {
+            preferred = QString("event_%1.ics").arg(hash);
+        }
+        entry.fileName = preferred;
+        QString stem = preferred.chopped(4);  // strip ".ics"
+        for (int n = 1; fetch->takenFileNames.contains(entry.fileName)
+                        || feedDir.exists(entry.fileName); ++n) {
+            entry.fileName = QString("%1_%2.ics").arg(stem).arg(n);
+        }
+        fetch->takenFileNames.insert(entry.fileName);
     }
 
-    // Split by events and filter
-    // This is a simplistic approach - proper parsing would use KCalendarCore
-    QString content = QString::fromUtf8(icsContent);
+    // Write to file - existing events keep their file so CalendarConduit's
+    // mapping stays valid and the Palm record is updated, not recreated
+    QFile file(feedDir.filePath(entry.fileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "[WebCalendarConduit] Failed to write:" << file.fileName() << file.errorString();
+        fetch->failed++;
+        return;
+    }
+    file.write(singleEventIcs);
+    file.close();
 
-    // Find header (before first VEVENT)
-    int firstEvent = content.indexOf("BEGIN:VEVENT");
-    if (firstEvent < 0) {
-        return icsContent;  // No events, return as-is
+    entry.contentHash = hash;
+    fetch->current.insert(key, entry);
+    if (isNew) {
+        fetch->created++;
+    } else {
+        fetch->updated++;
     }
+}
 
-    QString header = content.left(firstEvent);
-    result = header.toUtf8();
+bool WebCalendarConduit::finishFeedWrite(FeedFetch *fetch, SyncResult &result)
+{
+    // Events no longer in the feed (or filtered out by date)
+    QDir feedDir(fetch->outputDir);
+    int deleted = 0;
+    for (const WebCalendarFeedEntry &entry : std::as_const(fetch->previous)) {
+        if (!feedDir.exists(entry.fileName) || feedDir.remove(entry.fileName)) {
+            deleted++;
+        } else {
+            qDebug() << "[WebCalendarConduit] Failed to delete:" << feedDir.filePath(entry.fileName);
+            fetch->failed++;
+        }
+    }
+    fetch->previous.clear();
 
-    // Extract and filter each event
-    QRegularExpression eventRe("BEGIN:VEVENT.*?END:VEVENT",
-                               QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpressionMatchIterator i = eventRe.globalMatch(content);
+    emit logMessage(QString("  → %1: %2 new, %3 changed, %4 removed, %5 unchanged")
+        .arg(feedDir.dirName())
+        .arg(fetch->created).arg(fetch->updated).arg(deleted).arg(fetch->unchanged));
 
-    int kept = 0;
-    int filtered = 0;
+    result.pcStats.created += fetch->created;
+    result.pcStats.updated += fetch->updated;
+    result.pcStats.deleted += deleted;
+    result.pcStats.unchanged += fetch->unchanged;
+    result.pcStats.errors += fetch->failed;
 
-    while (i.hasNext()) {
-        QRegularExpressionMatch match = i.next();
-        QString event = match.captured();
-
-        bool keep = false;
-
-        // Check if event has RRULE (recurring event)
-        bool hasRrule = event.contains("RRULE:");
-        bool rruleHasUntil = false;
-        QDateTime rruleUntil;
-
-        if (hasRrule) {
-            // Check for UNTIL in RRULE
-            QRegularExpression untilRe("RRULE:.*UNTIL=([0-9T]+)");
-            QRegularExpressionMatch untilMatch = untilRe.match(event);
-            if (untilMatch.hasMatch()) {
-                rruleHasUntil = true;
-                QString untilStr = untilMatch.captured(1);
-                if (untilStr.contains('T')) {
-                    rruleUntil = QDateTime::fromString(untilStr.left(15), "yyyyMMdd'T'HHmmss");
-                } else {
-                    rruleUntil = QDateTime::fromString(untilStr.left(8), "yyyyMMdd");
-                }
-            }
+    if (!saveFeedIndex(fetch->outputDir, fetch->current)) {
+        emit logMessage(QString("Failed to save feed index in %1").arg(fetch->outputDir));
+        return false;
+    }
+    return true;
+}
+
+void WebCalendarConduit::abandonFeedWrite(FeedFetch *fetch, SyncResult &result)
+{
+    if (!fetch->splitter) {
+        return;  // Nothing was written
+    }
+
+    // Events already written stay tracked; the rest of the old index is
+    // kept as-is since those events may simply not have arrived yet
+    for (auto it = fetch->previous.constBegin(); it != fetch->previous.constEnd(); ++it) {
+        if (!fetch->current.contains(it.key())) {
+            fetch->current.insert(it.key(), it.value());
         }
+    }
+    fetch->previous.clear();
 
-        // Extract DTSTART
-        QRegularExpression dtstartRe("DTSTART[^:]*:([0-9T]+)");
-        QRegularExpressionMatch dtstartMatch = dtstartRe.match(event);
+    result.pcStats.created += fetch->created;
+    result.pcStats.updated += fetch->updated;
+    result.pcStats.unchanged += fetch->unchanged;
+    result.pcStats.errors += fetch->failed;
 
-        QDateTime eventDate;
-        if (dtstartMatch.hasMatch()) {
-            QString dateStr = dtstartMatch.captured(1);
-            if (dateStr.length() >= 8) {
-                if (dateStr.contains('T')) {
-                    eventDate = QDateTime::fromString(dateStr.left(15), "yyyyMMdd'T'HHmmss");
-                } else {
-                    eventDate = QDateTime::fromString(dateStr.left(8), "yyyyMMdd");
-                }
+    if (!saveFeedIndex(fetch->outputDir, fetch->current)) {
+        emit logMessage(QString("Failed to save feed index in %1").arg(fetch->outputDir));
+    }
+
+    // A partial download leaves the files out of step with the validators
+    fetch->feed->etag.clear();
+    fetch->feed->lastModified.clear();
+}
+
+QMap<QString, WebCalendarFeedEntry> WebCalendarConduit::loadFeedIndex(const QString &feedOutputDir) const
+{
+    QMap<QString, WebCalendarFeedEntry> index;
+    QDir feedDir(feedOutputDir);
+
+    QFile file(feedDir.filePath(FEED_INDEX_FILE));
+    if (file.open(QIODevice::ReadOnly)) {
+        QJsonObject events = QJsonDocument::fromJson(file.readAll()).object()["events"].toObject();
+        for (auto it = events.constBegin(); it != events.constEnd(); ++it) {
+            QJsonObject obj = it.value().toObject();
+            WebCalendarFeedEntry entry;
+            entry.fileName = obj["file"].toString();
+            entry.contentHash = obj["hash"].toString();
+            if (!entry.fileName.isEmpty()) {
+                index.insert(it.key(), entry);
             }
         }
+        return index;
+    }
 
-        // Apply filter logic
-        switch (m_dateFilter) {
-        case DateFilter::All:
-            keep = true;
-            break;
-
-        case DateFilter::RecurringAndFuture:
-            // Keep if:
-            // 1. Event is in the future, OR
-            // 2. Event has RRULE without UNTIL (infinite recurrence), OR
-            // 3. Event has RRULE with UNTIL that's in the future
-            if (eventDate.isValid() && eventDate >= now) {
-                keep = true;  // Future event
-            } else if (hasRrule) {
-                if (!rruleHasUntil) {
-                    keep = true;  // Infinite recurrence
-                } else if (rruleUntil.isValid() && rruleUntil >= now) {
-                    keep = true;  // Recurrence extends into future
-                }
+    // No index yet (first fetch, or files written by an older version):
+    // rebuild it from the .ics files already in the feed directory
+    const QStringList files = feedDir.entryList({"*.ics"}, QDir::Files);
+    for (const QString &fileName : files) {
+        QFile icsFile(feedDir.filePath(fileName));
+        if (!icsFile.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray data = icsFile.readAll();
+        WebCalendarFeedEntry entry;
+        entry.fileName = fileName;
+        entry.contentHash = LocalFileBackend::calculateHash(data);
+
+        QString key;
+        ICalFeedSplitter splitter([&key](const ICalFeedEvent &event) {
+            if (key.isEmpty()) {
+                key = eventKey(event);
             }
-            break;
-
-        case DateFilter::FutureOnly:
-            // Strict: only keep events with DTSTART in the future
-            keep = eventDate.isValid() && eventDate >= now;
-            break;
+        });
+        splitter.addData(data);
+        splitter.finish();
+        if (key.isEmpty()) {
+            key = "hash:" + entry.contentHash;
         }
-
-        if (keep) {
-            result += event.toUtf8();
-            result += "\r\n";
-            kept++;
-        } else {
-            filtered++;
+        QString baseKey = key;
+        for (int n = 2; index.contains(key); ++n) {
+            key = QString("%1#%2").arg(baseKey).arg(n);
         }
+        index.insert(key, entry);
     }
 
-    // Add footer
-    result += "END:VCALENDAR\r\n";
+    return index;
+}
 
-    if (filtered > 0) {
-        qDebug() << "Filtered" << filtered << "past events, kept" << kept;
+bool WebCalendarConduit::saveFeedIndex(const QString &feedOutputDir,
+                                        const QMap<QString, WebCalendarFeedEntry> &index) const
+{
+    QJsonObject events;
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        QJsonObject obj;
+        obj["file"] = it.value().fileName;
+        obj["hash"] = it.value().contentHash;
+        events[it.key()] = obj;
     }
 
+    QJsonObject root;
+    root["events"] = events;
+
+    QFile file(QDir(feedOutputDir).filePath(FEED_INDEX_FILE));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+QString WebCalendarConduit::eventKey(const ICalFeedEvent &event)
+{
+    QByteArray uid = event.uid.trimmed();
+    if (uid.isEmpty()) {
+        return QString();
+    }
+
+    // Overridden instances of a recurring event share the master's UID
+    QString key = QString::fromUtf8(uid);
+    QByteArray recurrenceId = event.recurrenceId.trimmed();
+    if (!recurrenceId.isEmpty()) {
+        key += "|" + QString::fromUtf8(recurrenceId);
+    }
+    return key;
+}
+
+/**
+ * @brief Replace characters outside [A-Za-z0-9] and @p allowed with '_'
+ */
+static QString sanitizeFileName(const QByteArray &value, const char *allowed)
+{
+    QString result = QString::fromUtf8(value.trimmed());
+    for (QChar &c : result) {
+        char ch = c.toLatin1();
+        bool ok = c.unicode() < 0x80
+            && ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')
+                || (ch >= '0' && ch <= '9') || qstrchr(allowed, ch));
+        if (!ok) {
+            c = QLatin1Char('_');
+        }
+    }
     return result;
 }
 
+QString WebCalendarConduit::feedDirectoryName(const WebCalendarFeed &feed)
+{
+    QString dirName = feed.name;
+    dirName.replace(QRegularExpression("[^a-zA-Z0-9_ -]"), "_");
+    if (dirName.isEmpty()) {
+        dirName = "webcal";
+    }
+    return dirName;
+}
+
+QString WebCalendarConduit::eventFileName(const ICalFeedEvent &event)
+{
+    // Make UID safe for filename
+    QString uid = sanitizeFileName(event.uid, "_@.-");
+
+    // Human-readable part from SUMMARY
+    QString summary = sanitizeFileName(event.summary, "_ -").left(40);  // Limit length
+
+    // Date part from DTSTART (YYYYMMDD -> YYYY-MM-DD)
+    QString dateStr;
+    QByteArray dtstart = event.dtstart.trimmed().left(8);
+    if (dtstart.size() == 8 && std::all_of(dtstart.begin(), dtstart.end(),
+                                           [](char ch) { return ch >= '0' && ch <= '9'; })) {
+        dateStr = QString::fromLatin1(dtstart.left(4) + "-" + dtstart.mid(4, 2) + "-" + dtstart.mid(6, 2));
+    }
+
+    // Generate filename: "Summary YYYY-MM-DD.ics" or "UID.ics"
+    if (!summary.isEmpty() && !dateStr.isEmpty()) {
+        return QString("%1 %2.ics").arg(summary).arg(dateStr);
+    } else if (!uid.isEmpty()) {
+        return QString("%1.ics").arg(uid);
+    }
+    return QString();
+}
+
+QDateTime WebCalendarConduit::currentTime() const
+{
+    return m_clock ? m_clock() : QDateTime::currentDateTime();
+}
+
+bool WebCalendarConduit::passesDateFilter(const ICalFeedEvent &event, const QDateTime &now) const
+{
+    // This is a basic implementation - for production use KCalendarCore
+    if (m_dateFilter == DateFilter::All) {
+        return true;  // No filtering
+    }
+
+    QDateTime eventDate = event.start();
+
+    switch (m_dateFilter) {
+    case DateFilter::All:
+        return true;
+
+    case DateFilter::RecurringAndFuture:
+        // Keep if:
+        // 1. Event is in the future, OR
+        // 2. Event has RRULE without UNTIL (infinite recurrence), OR
+        // 3. Event has RRULE with UNTIL that's in the future
+        if (eventDate.isValid() && eventDate >= now) {
+            return true;  // Future event
+        }
+        if (event.isRecurring()) {
+            if (!event.rrule.contains("UNTIL=")) {
+                return true;  // Infinite recurrence
+            }
+            QDateTime until = event.recurrenceUntil();
+            return until.isValid() && until >= now;  // Recurrence extends into future
+        }
+        return false;
+
+    case DateFilter::FutureOnly:
+        // Strict: only keep events with DTSTART in the future
+        return eventDate.isValid() && eventDate >= now;
+    }
+
+    return true;
+}
+
 } // namespace Sync
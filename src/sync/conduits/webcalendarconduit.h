@@ -5,12 +5,17 @@
 #include <QUrl>
 #include <QDateTime>
 #include <QJsonArray>
+#include <QMap>
+#include <QMutex>
+#include <functional>
 
 class QNetworkAccessManager;
 class QNetworkReply;
 
 namespace Sync {
 
+struct ICalFeedEvent;
+
 /**
  * @brief Feed configuration for web calendar subscriptions
  */
@@ -21,16 +26,34 @@ struct WebCalendarFeed
     QString category;       ///< Palm category to assign events to
     bool enabled = true;    ///< Whether this feed is active
 
+    // HTTP validators from the last successful download, sent back as
+    // If-None-Match / If-Modified-Since so an unchanged feed costs a 304
+    QString etag;           ///< ETag response header, verbatim
+    QString lastModified;   ///< Last-Modified response header, verbatim
+    QString dateFilter;     ///< date_filter the files were written with; validators only apply to it
+
     QJsonObject toJson() const;
     static WebCalendarFeed fromJson(const QJsonObject &obj);
 };
 
+/**
+ * @brief One event previously written for a feed
+ *
+ * Stored in the per-feed index so the next fetch can tell new,
+ * changed and vanished events apart without rewriting every file.
+ */
+struct WebCalendarFeedEntry
+{
+    QString fileName;       ///< File name inside the feed directory
+    QString contentHash;    ///< LocalFileBackend::calculateHash() of the file
+};
+
 /**
  * @brief Fetch interval for web calendar updates
  */
 enum class FetchInterval
 {
-    EverySync,      ///< Fetch on every HotSync
+    EverySync,      ///< Fetch on every HotSync (every check when refreshed in the background)
     Daily,          ///< Once per day
     Weekly,         ///< Once per week
     Monthly         ///< Once per month
@@ -48,6 +71,18 @@ enum class FetchInterval
  *   - Configurable fetch interval (skip if recently fetched)
  *   - Date filtering (future events only, next 90 days, etc.)
  *   - Offline-tolerant (warns but continues if fetch fails)
+ *   - Conditional requests (ETag / Last-Modified): a 304 skips parsing
+ *     and writing entirely
+ *   - Concurrent downloads (up to maxConcurrentFetches), each response
+ *     processed as it arrives with its own inactivity timeout
+ *   - Streaming: events are split and written while the download runs,
+ *     so memory stays bounded however large the feed is
+ *   - Incremental: events are keyed by UID (+ RECURRENCE-ID) and a
+ *     content hash, so only new or changed events are rewritten and
+ *     events that left the feed are deleted
+ *   - Background refresh: with a staging directory set, feeds are
+ *     downloaded outside of HotSync (see WebFeedRefresher) and a sync
+ *     only copies the staged changes into the calendar collection
  *
  * This conduit does NOT require a Palm device connection.
  * It runs BEFORE CalendarConduit to provide fresh data.
@@ -101,14 +136,26 @@ public:
 
     // ========== Feed Management ==========
 
-    QList<WebCalendarFeed> feeds() const { return m_feeds; }
-    void setFeeds(const QList<WebCalendarFeed> &feeds) { m_feeds = feeds; }
+    QList<WebCalendarFeed> feeds() const;
+    void setFeeds(const QList<WebCalendarFeed> &feeds);
     void addFeed(const WebCalendarFeed &feed);
     void removeFeed(int index);
 
     FetchInterval fetchInterval() const { return m_fetchInterval; }
     void setFetchInterval(FetchInterval interval) { m_fetchInterval = interval; }
 
+    /**
+     * @brief Maximum number of feeds downloaded at the same time
+     */
+    int maxConcurrentFetches() const { return m_maxConcurrentFetches; }
+    void setMaxConcurrentFetches(int count) { m_maxConcurrentFetches = qMax(1, count); }
+
+    /**
+     * @brief Seconds a feed may go without receiving data before it is abandoned
+     */
+    int fetchTimeout() const { return m_fetchTimeout; }
+    void setFetchTimeout(int seconds) { m_fetchTimeout = qMax(1, seconds); }
+
     /**
      * @brief Date filtering options for imported events
      */
@@ -121,6 +168,46 @@ public:
     DateFilter dateFilter() const { return m_dateFilter; }
     void setDateFilter(DateFilter filter) { m_dateFilter = filter; }
 
+    /**
+     * @brief Replace the clock the date filter compares events against
+     *
+     * Defaults to QDateTime::currentDateTime(); tests set a fixed time.
+     * An empty function restores the default.
+     */
+    void setClock(std::function<QDateTime()> clock) { m_clock = std::move(clock); }
+
+    // ========== Background Refresh ==========
+
+    /**
+     * @brief Directory feeds are downloaded into outside of a sync
+     *
+     * When set, sync() does no network I/O: it only copies what
+     * refreshStaged() left here into the calendar collection. Empty
+     * (the default) downloads during sync.
+     */
+    QString stagingDirectory() const;
+    void setStagingDirectory(const QString &path);
+
+    /**
+     * @brief Download all enabled feeds into the staging directory
+     *
+     * Blocks until every feed has finished, so call it from a worker
+     * thread. Updates the HTTP validators and last fetch time like a sync.
+     *
+     * @param cancel Polled while downloading; may be empty
+     */
+    SyncResult refreshStaged(const std::function<bool()> &cancel = {});
+
+    /**
+     * @brief Whether refreshStaged() left changes sync() has not copied yet
+     */
+    bool hasStagedChanges() const;
+
+    /**
+     * @brief Check if enough time has passed since last fetch
+     */
+    bool shouldFetchNow() const;
+
     // ========== Record Conversion (not used) ==========
 
     BackendRecord* palmToBackend(PilotRecord *palmRecord,
@@ -146,32 +233,151 @@ public:
     }
 
 private:
+    struct FeedFetch;
+
     /**
-     * @brief Fetch a single calendar feed
-     * @return true if fetch succeeded
+     * @brief Start downloading a single calendar feed
+     *
+     * Creates the feed's output directory and issues the request
+     * (conditional if validators and a local copy exist).
+     *
+     * @return In-flight fetch, or nullptr if the feed cannot be fetched
      */
-    bool fetchFeed(const WebCalendarFeed &feed, const QString &outputDir,
-                   SyncResult &result);
+    FeedFetch* startFetch(QNetworkAccessManager &network, WebCalendarFeed &feed,
+                          const QString &outputDir);
 
     /**
-     * @brief Filter events by date range
-     * @param icsContent Raw .ics file content
-     * @return Filtered .ics content
+     * @brief Download every enabled feed into @p outputDir
+     *
+     * Works on a copy of the feed list and merges the new HTTP validators
+     * back afterwards, so settings may be edited meanwhile.
      */
-    QByteArray filterEventsByDate(const QByteArray &icsContent) const;
+    void fetchFeeds(const QString &outputDir, SyncResult &result,
+                    const std::function<bool()> &cancel);
 
     /**
-     * @brief Check if enough time has passed since last fetch
+     * @brief Copy staged feeds into the calendar collection
+     *
+     * Skipped (nothing copied, staged changes kept) while a refresh is
+     * writing to the staging directory.
      */
-    bool shouldFetchNow() const;
+    void promoteStagedFeeds(const QString &stagingDir, const QString &outputDir,
+                            SyncResult &result);
+
+    /**
+     * @brief Make one feed directory match its staged copy
+     *
+     * Existing events keep their file names, so CalendarConduit's
+     * mappings stay valid.
+     */
+    bool promoteFeed(const QString &stagedDir, const QString &feedOutputDir,
+                     SyncResult &result);
+
+    /**
+     * @brief Subdirectory name for a feed: its name with unsafe characters replaced
+     */
+    static QString feedDirectoryName(const WebCalendarFeed &feed);
+
+    /**
+     * @brief Feed newly arrived reply data through the splitter
+     *
+     * Called on every readyRead, so events are filtered and written while
+     * the download is still running and memory stays bounded.
+     */
+    void consumeFetchData(FeedFetch *fetch);
+
+    /**
+     * @brief Finish a download and complete its incremental write
+     *
+     * Updates the feed's HTTP validators after a successful download.
+     *
+     * @return true if fetch succeeded (including 304 Not Modified)
+     */
+    bool finishFetch(FeedFetch *fetch, SyncResult &result);
+
+    /**
+     * @brief Check an event against the configured date filter
+     */
+    bool passesDateFilter(const ICalFeedEvent &event, const QDateTime &now) const;
+
+    /**
+     * @brief The time the date filter treats as now
+     */
+    QDateTime currentTime() const;
+
+    /**
+     * @brief Delete indexed events the date filter no longer keeps
+     *
+     * A 304 means the feed is unchanged, but events written earlier may
+     * have moved into the past since. Removes them from @p index too.
+     *
+     * @return Number of events deleted
+     */
+    int pruneExpiredEvents(const QString &feedOutputDir,
+                           QMap<QString, WebCalendarFeedEntry> &index);
+
+    /**
+     * @brief Start an incremental write of one feed's events
+     *
+     * Loads the feed index (UID + content hash per event) into @p fetch.
+     */
+    void beginFeedWrite(FeedFetch *fetch);
+
+    /**
+     * @brief Write one event if it is new or changed since the last fetch
+     * @param calHeader VCALENDAR header (everything before the first VEVENT)
+     */
+    void writeFeedEvent(FeedFetch *fetch, const QByteArray &calHeader,
+                        const ICalFeedEvent &event);
+
+    /**
+     * @brief Delete events that left the feed, save the index, update pcStats
+     * @return false if the feed index could not be saved
+     */
+    bool finishFeedWrite(FeedFetch *fetch, SyncResult &result);
+
+    /**
+     * @brief Stop a write after a failed or truncated download
+     *
+     * Keeps the events already written in the index but deletes nothing,
+     * and clears the feed's HTTP validators so the next fetch is complete.
+     */
+    void abandonFeedWrite(FeedFetch *fetch, SyncResult &result);
+
+    /**
+     * @brief Load the feed index, rebuilding it from disk if missing
+     */
+    QMap<QString, WebCalendarFeedEntry> loadFeedIndex(const QString &feedOutputDir) const;
+
+    /**
+     * @brief Persist the feed index next to the feed's .ics files
+     */
+    bool saveFeedIndex(const QString &feedOutputDir,
+                       const QMap<QString, WebCalendarFeedEntry> &index) const;
+
+    /**
+     * @brief Identity of an event within a feed: UID plus RECURRENCE-ID
+     * @return Empty string if the event has no UID
+     */
+    static QString eventKey(const ICalFeedEvent &event);
+
+    /**
+     * @brief Human-readable file name: "Summary YYYY-MM-DD.ics" or "UID.ics"
+     */
+    static QString eventFileName(const ICalFeedEvent &event);
 
+    mutable QMutex m_mutex;     ///< Guards the feed list, last fetch time and staging path
     QList<WebCalendarFeed> m_feeds;
     FetchInterval m_fetchInterval = FetchInterval::Weekly;
     QDateTime m_lastFetchTime;
+    int m_maxConcurrentFetches = 4;
+    int m_fetchTimeout = 30;
 
     DateFilter m_dateFilter = DateFilter::RecurringAndFuture;
+    std::function<QDateTime()> m_clock;
 
-    QNetworkAccessManager *m_networkManager = nullptr;
+    QString m_stagingDirectory;
+    QMutex m_stagingMutex;      ///< Held while the staging directory is written or copied
 };
 
 } // namespace Sync
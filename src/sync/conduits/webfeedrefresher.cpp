@@ -0,0 +1,109 @@
+#include "webfeedrefresher.h"
+#include "webcalendarconduit.h"
+
+#include <QThread>
+#include <QDebug>
+
+#include <memory>
+
+namespace Sync {
+
+WebFeedRefresher::WebFeedRefresher(WebCalendarConduit *conduit, QObject *parent)
+    : QObject(parent)
+    , m_conduit(conduit)
+{
+    m_timer.setInterval(600 * 1000);
+    connect(&m_timer, &QTimer::timeout, this, &WebFeedRefresher::checkDue);
+}
+
+WebFeedRefresher::~WebFeedRefresher()
+{
+    cancelAndWait();
+}
+
+void WebFeedRefresher::setCheckInterval(int seconds)
+{
+    m_timer.setInterval(qMax(1, seconds) * 1000);
+}
+
+void WebFeedRefresher::start()
+{
+    m_timer.start();
+    QTimer::singleShot(0, this, &WebFeedRefresher::checkDue);
+}
+
+void WebFeedRefresher::stop()
+{
+    m_timer.stop();
+    cancelAndWait();
+}
+
+void WebFeedRefresher::checkDue()
+{
+    if (!m_timer.isActive() || m_thread) {
+        return;
+    }
+    if (m_idleCheck && !m_idleCheck()) {
+        return;  // Try again on the next tick
+    }
+    if (m_conduit->shouldFetchNow()) {
+        refreshNow();
+    }
+}
+
+bool WebFeedRefresher::refreshNow()
+{
+    if (m_thread || m_conduit->stagingDirectory().isEmpty() || m_conduit->feeds().isEmpty()) {
+        return false;
+    }
+
+    emit logMessage("Refreshing calendar feeds in the background...");
+    emit refreshStarted();
+
+    // The conduit blocks on a local event loop while downloading, so it
+    // gets a thread of its own rather than a slot on this one
+    m_cancel = false;
+    int run = ++m_run;
+    auto result = std::make_shared<SyncResult>();
+    WebCalendarConduit *conduit = m_conduit;
+    m_thread = QThread::create([this, conduit, result]() {
+        *result = conduit->refreshStaged([this]() { return m_cancel.load(); });
+    });
+
+    connect(m_thread, &QThread::finished, this, [this, run, result]() {
+        if (run != m_run || !m_thread) {
+            return;  // Cancelled by stop(), which already cleaned up
+        }
+        m_thread->deleteLater();
+        m_thread = nullptr;
+
+        if (result->success) {
+            emit logMessage(QString("Calendar feeds refreshed: %1").arg(result->pcStats.summary()));
+        } else {
+            emit logMessage(QString("Calendar feed refresh failed: %1").arg(result->errorMessage));
+        }
+        emit refreshFinished(*result);
+    });
+
+    m_thread->start();
+    return true;
+}
+
+void WebFeedRefresher::cancelAndWait()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    qDebug() << "[WebFeedRefresher] Cancelling running refresh";
+    m_cancel = true;
+    m_thread->wait();
+
+    // A finished() notification may still be queued; it sees the new run
+    // number and ignores itself
+    ++m_run;
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+} // namespace Sync
@@ -0,0 +1,101 @@
+#ifndef WEBFEEDREFRESHER_H
+#define WEBFEEDREFRESHER_H
+
+#include <QObject>
+#include <QTimer>
+#include <atomic>
+#include <functional>
+#include "../synctypes.h"
+
+class QThread;
+
+namespace Sync {
+
+class WebCalendarConduit;
+
+/**
+ * @brief Downloads web calendar feeds in the background, between syncs
+ *
+ * Checks on a timer whether the conduit's fetch interval has elapsed and,
+ * if the application is idle, runs WebCalendarConduit::refreshStaged() on
+ * a worker thread. The next HotSync then only copies the staged files, so
+ * feed downloads no longer add to the time the Palm sits in the cradle.
+ *
+ * Requires the conduit to have a staging directory; without one it does
+ * nothing and the conduit keeps fetching during sync.
+ *
+ * @code
+ * conduit->setStagingDirectory(profile->stateDirectoryPath() + "/webcal-staging");
+ * auto *refresher = new WebFeedRefresher(conduit, this);
+ * refresher->setIdleCheck([engine]() { return !engine->isSyncing(); });
+ * refresher->start();
+ * @endcode
+ */
+class WebFeedRefresher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WebFeedRefresher(WebCalendarConduit *conduit, QObject *parent = nullptr);
+
+    /**
+     * @brief Cancels and waits for a running refresh
+     */
+    ~WebFeedRefresher() override;
+
+    /**
+     * @brief Seconds between checks whether feeds are due (default: 600)
+     */
+    int checkInterval() const { return m_timer.interval() / 1000; }
+    void setCheckInterval(int seconds);
+
+    /**
+     * @brief Refresh only while this returns true (e.g. no sync running)
+     */
+    void setIdleCheck(std::function<bool()> check) { m_idleCheck = std::move(check); }
+
+    /**
+     * @brief Start checking; the first check happens right away
+     */
+    void start();
+
+    /**
+     * @brief Stop checking and cancel a running refresh
+     */
+    void stop();
+
+    bool isActive() const { return m_timer.isActive(); }
+    bool isRefreshing() const { return m_thread != nullptr; }
+
+public slots:
+    /**
+     * @brief Refresh now, regardless of the fetch interval
+     * @return false if a refresh is already running or nothing is configured
+     */
+    bool refreshNow();
+
+signals:
+    void refreshStarted();
+    void refreshFinished(const Sync::SyncResult &result);
+    void logMessage(const QString &message);
+
+private slots:
+    void checkDue();
+
+private:
+    /**
+     * @brief Cancel a running refresh and wait for its thread
+     */
+    void cancelAndWait();
+
+    WebCalendarConduit *m_conduit;
+    QTimer m_timer;
+    QThread *m_thread = nullptr;
+    int m_run = 0;              ///< Identifies the refresh a finished() belongs to
+    std::atomic<bool> m_cancel{false};
+    std::function<bool()> m_idleCheck;
+};
+
+} // namespace Sync
+
+#endif // WEBFEEDREFRESHER_H
@@ -1,4 +1,5 @@
 #include "localfilebackend.h"
+#include "../synclog.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -69,7 +70,7 @@ QString LocalFileBackend::createCollection(const CollectionInfo &info)
     }
 
     if (dir.mkpath(".")) {
-        qDebug() << "[LocalFileBackend] Created collection directory:" << path;
+        qCDebug(lcBackend) << "[LocalFileBackend] Created collection directory:" << path;
         return info.id;
     }
 
@@ -112,7 +113,7 @@ QList<BackendRecord*> LocalFileBackend::loadRecords(const QString &collectionId)
         }
     }
 
-    qDebug() << "[LocalFileBackend] Loaded" << records.size()
+    qCDebug(lcBackend) << "[LocalFileBackend] Loaded" << records.size()
              << "records from" << collectionId;
     return records;
 }
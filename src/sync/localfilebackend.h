@@ -66,6 +66,9 @@ public:
     QStringList deletedSince(const QString &collectionId,
                               const QDateTime &since) override;
 
+    /// Collections are separate directories and loading only reads files
+    bool supportsConcurrentLoad() const override { return true; }
+
     // ========== Configuration ==========
 
     /**
@@ -0,0 +1,154 @@
+#include "multidevicesync.h"
+#include "syncengine.h"
+#include "../palm/kpilotlink.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <cstring>
+
+#include <pi-dlp.h>
+
+namespace Sync {
+
+MultiDeviceSync::MultiDeviceSync(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(4);
+}
+
+MultiDeviceSync::~MultiDeviceSync()
+{
+    m_pool.waitForDone();
+    qDeleteAll(m_engines);
+}
+
+// ========== Configuration ==========
+
+void MultiDeviceSync::setEngineFactory(EngineFactory factory)
+{
+    QMutexLocker locker(&m_mutex);
+    m_factory = std::move(factory);
+}
+
+void MultiDeviceSync::setMaxConcurrentDevices(int count)
+{
+    m_pool.setMaxThreadCount(qMax(1, count));
+}
+
+int MultiDeviceSync::maxConcurrentDevices() const
+{
+    return m_pool.maxThreadCount();
+}
+
+// ========== State ==========
+
+SyncEngine* MultiDeviceSync::engine(const DeviceFingerprint &fingerprint) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_engines.value(fingerprint.registryKey());
+}
+
+QList<DeviceFingerprint> MultiDeviceSync::activeDevices() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_active.values();
+}
+
+bool MultiDeviceSync::waitForDone(int msecs)
+{
+    return m_pool.waitForDone(msecs);
+}
+
+// ========== Sessions ==========
+
+void MultiDeviceSync::handleLink(KPilotLink *link)
+{
+    if (!link) {
+        return;
+    }
+    m_pool.start([this, link]() { runDevice(link); });
+}
+
+void MultiDeviceSync::runDevice(KPilotLink *link)
+{
+    struct PilotUser user;
+    memset(&user, 0, sizeof(user));
+    if (!link->readUserInfo(user)) {
+        reject(link, DeviceFingerprint(), "Could not read user info");
+        return;
+    }
+
+    DeviceFingerprint fingerprint;
+    fingerprint.userId = user.userID;
+    fingerprint.userName = QString::fromLatin1(user.username);
+    QString key = fingerprint.registryKey();
+
+    SyncEngine *engine = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_active.contains(key)) {
+            locker.unlock();
+            reject(link, fingerprint, "A sync for this handheld is already running");
+            return;
+        }
+
+        engine = m_engines.value(key);
+        if (!engine && m_factory) {
+            engine = m_factory(fingerprint);
+            if (engine) {
+                // Created on this pool thread; keep it with us like other engines
+                engine->moveToThread(thread());
+                m_engines.insert(key, engine);
+            }
+        }
+        if (!engine) {
+            locker.unlock();
+            reject(link, fingerprint, "No profile for this handheld");
+            return;
+        }
+        m_active.insert(key, fingerprint);
+    }
+
+    qDebug() << "[MultiDeviceSync] Syncing" << fingerprint.displayString()
+             << "on" << QThread::currentThread();
+    emit deviceConnected(fingerprint);
+    emit logMessage(QString("%1 connected").arg(fingerprint.displayString()));
+
+    SyncResult result;
+    if (link->beginSync()) {
+        engine->setDeviceLink(link);
+        result = engine->syncAll(m_mode);
+        engine->setDeviceLink(nullptr);
+        link->endSync();
+    } else {
+        result.success = false;
+        result.errorMessage = "Could not open the sync conduit on the Palm";
+    }
+    link->closeConnection();
+    link->deleteLater();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_active.remove(key);
+    }
+
+    emit logMessage(QString("%1 finished: %2")
+                    .arg(fingerprint.displayString(), result.success ? "success" : result.errorMessage));
+    emit deviceFinished(fingerprint, result);
+}
+
+void MultiDeviceSync::reject(KPilotLink *link, const DeviceFingerprint &fingerprint,
+                             const QString &reason)
+{
+    qDebug() << "[MultiDeviceSync] Rejected" << fingerprint.displayString() << reason;
+    link->closeConnection();
+    link->deleteLater();
+
+    emit logMessage(QString("Rejected %1: %2")
+                    .arg(fingerprint.isEmpty() ? QString("handheld") : fingerprint.displayString(), reason));
+    emit deviceRejected(fingerprint, reason);
+}
+
+} // namespace Sync
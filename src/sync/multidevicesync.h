@@ -0,0 +1,126 @@
+#ifndef MULTIDEVICESYNC_H
+#define MULTIDEVICESYNC_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QThreadPool>
+#include <functional>
+#include "synctypes.h"
+#include "../profile.h"
+
+class KPilotLink;
+
+namespace Sync {
+
+class SyncEngine;
+
+/**
+ * @brief Runs one isolated sync per connected handheld
+ *
+ * DeviceSession drives a single interactive handheld. MultiDeviceSync is
+ * the unattended counterpart for a HotSyncListener: every accepted link
+ * is identified by its DeviceFingerprint and synced on its own pool
+ * thread with its own SyncEngine, so handhelds on the network do not
+ * wait for each other.
+ *
+ * Engines come from the factory (typically one per profile, see
+ * Settings::findProfileForDevice()) and are kept per fingerprint, so a
+ * handheld that syncs again reuses its engine and sync state. A second
+ * connection from a handheld that is still syncing is turned away.
+ *
+ * Usage, as in qpilotsync-cli --listen (createEngineForProfile() is the
+ * CLI's helper that registers the conduits and applies the profile):
+ * @code
+ * MultiDeviceSync dispatcher;
+ * dispatcher.setEngineFactory([](const DeviceFingerprint &fp) -> SyncEngine* {
+ *     Profile profile(Settings::instance().findProfileForDevice(fp));
+ *     if (!profile.load()) {
+ *         return nullptr;
+ *     }
+ *     return createEngineForProfile(profile, ConflictResolution::NewestWins);
+ * });
+ * connect(&listener, &HotSyncListener::linkAccepted,
+ *         &dispatcher, &MultiDeviceSync::handleLink);
+ * @endcode
+ */
+class MultiDeviceSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates the engine for a handheld seen for the first time
+     *
+     * Called on a pool thread. Return nullptr to refuse the handheld. The
+     * engine must not have a parent; MultiDeviceSync takes ownership.
+     */
+    using EngineFactory = std::function<SyncEngine*(const DeviceFingerprint &fingerprint)>;
+
+    explicit MultiDeviceSync(QObject *parent = nullptr);
+    ~MultiDeviceSync() override;
+
+    // ========== Configuration ==========
+
+    void setEngineFactory(EngineFactory factory);
+
+    void setSyncMode(SyncMode mode) { m_mode = mode; }
+    SyncMode syncMode() const { return m_mode; }
+
+    /**
+     * @brief Limit how many handhelds sync at the same time (default: 4)
+     *
+     * Further handhelds wait connected until a slot is free.
+     */
+    void setMaxConcurrentDevices(int count);
+    int maxConcurrentDevices() const;
+
+    // ========== State ==========
+
+    /**
+     * @brief Engine used for a handheld, or nullptr if it has not synced yet
+     */
+    SyncEngine* engine(const DeviceFingerprint &fingerprint) const;
+
+    /**
+     * @brief Handhelds whose sync is running
+     */
+    QList<DeviceFingerprint> activeDevices() const;
+
+    /**
+     * @brief Wait for all running syncs to finish
+     *
+     * @return false if @p msecs elapsed first
+     */
+    bool waitForDone(int msecs = -1);
+
+public slots:
+    /**
+     * @brief Sync a connected handheld; takes ownership of @p link
+     */
+    void handleLink(KPilotLink *link);
+
+signals:
+    void deviceConnected(const DeviceFingerprint &fingerprint);
+    void deviceFinished(const DeviceFingerprint &fingerprint, const Sync::SyncResult &result);
+    void deviceRejected(const DeviceFingerprint &fingerprint, const QString &reason);
+    void logMessage(const QString &message);
+
+private:
+    void runDevice(KPilotLink *link);
+    void reject(KPilotLink *link, const DeviceFingerprint &fingerprint, const QString &reason);
+
+    QThreadPool m_pool;
+    EngineFactory m_factory;
+    SyncMode m_mode = SyncMode::HotSync;
+
+    mutable QMutex m_mutex;              // protects m_engines and m_active
+    QMap<QString, SyncEngine*> m_engines; // by DeviceFingerprint::registryKey()
+    QMap<QString, DeviceFingerprint> m_active;
+};
+
+} // namespace Sync
+
+#endif // MULTIDEVICESYNC_H
@@ -156,6 +156,14 @@ public:
      */
     virtual bool supportsDeleteTracking() const { return false; }
 
+    /**
+     * @brief Check if loadRecords() may run on another thread while the
+     *        sync thread writes to a different collection
+     *
+     * Lets SyncEngine load the next conduit's records ahead of time.
+     */
+    virtual bool supportsConcurrentLoad() const { return false; }
+
     // ========== Batch Operations ==========
 
     /**
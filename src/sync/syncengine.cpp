@@ -1,9 +1,17 @@
 #include "syncengine.h"
-#include "../palm/kpilotdevicelink.h"
+#include "../palm/kpilotlink.h"
+#include "../synclog.h"
 
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QPromise>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <memory>
 
 #include <pi-dlp.h>
 
@@ -14,10 +22,16 @@ SyncEngine::SyncEngine(QObject *parent)
 {
     // Default state directory
     m_stateDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+
+    m_backgroundPool.setMaxThreadCount(4);
+    m_prefetchPool.setMaxThreadCount(1);
 }
 
 SyncEngine::~SyncEngine()
 {
+    m_backgroundPool.waitForDone();
+    discardPrefetch();
+
     // Clean up owned objects
     qDeleteAll(m_conduits);
     qDeleteAll(m_states);
@@ -27,7 +41,7 @@ SyncEngine::~SyncEngine()
 
 // ========== Device Management ==========
 
-void SyncEngine::setDeviceLink(KPilotDeviceLink *link)
+void SyncEngine::setDeviceLink(KPilotLink *link)
 {
     m_deviceLink = link;
 
@@ -71,7 +85,7 @@ void SyncEngine::registerConduit(Conduit *conduit)
 
     connectConduitSignals(conduit);
 
-    emit logMessage(QString("Registered conduit: %1").arg(conduit->displayName()));
+    log(QString("Registered conduit: %1").arg(conduit->displayName()));
 }
 
 void SyncEngine::unregisterConduit(const QString &conduitId)
@@ -140,7 +154,7 @@ SyncResult SyncEngine::syncAll(SyncMode mode)
     m_syncing = true;
     m_cancelled = false;
     emit syncStarted();
-    emit logMessage(QString("Starting sync for user: %1").arg(m_palmUserName));
+    log(QString("Starting sync for user: %1").arg(m_palmUserName));
 
     // Get enabled conduits
     QStringList enabledConduits;
@@ -162,69 +176,154 @@ SyncResult SyncEngine::syncAll(SyncMode mode)
     }
 
     QStringList orderedConduits = resolveConduitOrder(enabledConduits);
-    emit logMessage(QString("Conduit order: %1").arg(orderedConduits.join(" → ")));
+    log(QString("Conduit order: %1").arg(orderedConduits.join(" → ")));
 
-    int conduitIndex = 0;
+    // Sync states are created up front: stateForConduit() must not run
+    // concurrently with itself
     for (const QString &id : orderedConduits) {
-        // Check both internal flag and external cancel callback
-        if (m_cancelled || (m_cancelCheck && m_cancelCheck())) {
-            emit logMessage("Sync cancelled by user");
-            break;
+        stateForConduit(id);
+    }
+
+    // A conduit becomes ready once every conduit it waits for has finished
+    // (or was skipped)
+    QMap<QString, QStringList> successors;
+    QMap<QString, int> waitingFor;
+    buildDependencyGraph(orderedConduits, successors, waitingFor);
+
+    QStringList readyDevice;   // Need the DLP link: run here, one at a time
+    QStringList readyFree;     // Device-free: run on the pool
+    auto makeReady = [&](const QString &id) {
+        QStringList &ready = m_conduits[id]->requiresDevice() ? readyDevice : readyFree;
+        ready.append(id);
+        // Among ready conduits keep the resolved order
+        std::sort(ready.begin(), ready.end(), [&](const QString &a, const QString &b) {
+            return orderedConduits.indexOf(a) < orderedConduits.indexOf(b);
+        });
+    };
+    for (const QString &id : orderedConduits) {
+        if (waitingFor.value(id) == 0) {
+            makeReady(id);
         }
+    }
 
-        Conduit *cond = m_conduits[id];
+    int finishedCount = 0;
+    auto finish = [&](const QString &id, const SyncResult *conduitResult) {
+        if (conduitResult) {
+            // Update conduit's last run time on success
+            if (conduitResult->success) {
+                m_conduits[id]->setLastRunTime(QDateTime::currentDateTime());
+            }
+            accumulateResult(totalResult, *conduitResult);
+        }
+        finishedCount++;
+        for (const QString &next : successors.value(id)) {
+            if (--waitingFor[next] == 0) {
+                makeReady(next);
+            }
+        }
+    };
 
-        // Check if conduit should run (interval-based conduits may skip)
+    // Check if conduit should run (interval-based conduits may skip)
+    auto shouldRun = [&](const QString &id) {
+        Conduit *cond = m_conduits[id];
         SyncContext preCheckContext;
         preCheckContext.mode = mode;
         if (!cond->shouldRun(&preCheckContext)) {
-            emit logMessage(QString("Skipping %1 (not due yet)").arg(cond->displayName()));
-            conduitIndex++;
-            continue;
+            log(QString("Skipping %1 (not due yet)").arg(cond->displayName()));
+            return false;
         }
+        return true;
+    };
 
-        emit progressUpdated(conduitIndex, orderedConduits.size(),
-            QString("Syncing %1...").arg(cond->displayName()));
+    // Background conduits hand their results back through here
+    struct Completions {
+        QMutex mutex;
+        QWaitCondition finished;
+        QList<QPair<QString, SyncResult>> results;
+    } completions;
+    int running = 0;
+    bool stopping = false;
+
+    while (true) {
+        // Check both internal flag and external cancel callback
+        if (!stopping && isCancelRequested()) {
+            log(running > 0 ? "Sync cancelled by user, waiting for background conduits"
+                            : "Sync cancelled by user");
+            stopping = true;
+            totalResult.success = false;
+            totalResult.errorMessage = "Sync cancelled";
+        }
 
-        SyncResult conduitResult = syncConduit(id, mode);
+        // Start every device-free conduit that is ready
+        while (!stopping && !readyFree.isEmpty()) {
+            QString id = readyFree.takeFirst();
+            if (!shouldRun(id)) {
+                finish(id, nullptr);
+                continue;
+            }
 
-        // Update conduit's last run time on success
-        if (conduitResult.success) {
-            cond->setLastRunTime(QDateTime::currentDateTime());
+            log(QString("Starting %1 in the background")
+                .arg(m_conduits[id]->displayName()));
+            running++;
+            m_backgroundPool.start([this, id, mode, &completions]() {
+                SyncResult conduitResult = syncConduit(id, mode);
+                QMutexLocker locker(&completions.mutex);
+                completions.results.append({id, conduitResult});
+                completions.finished.wakeAll();
+            });
         }
 
-        // Accumulate results
-        totalResult.palmStats.created += conduitResult.palmStats.created;
-        totalResult.palmStats.updated += conduitResult.palmStats.updated;
-        totalResult.palmStats.deleted += conduitResult.palmStats.deleted;
-        totalResult.palmStats.unchanged += conduitResult.palmStats.unchanged;
-        totalResult.palmStats.conflicts += conduitResult.palmStats.conflicts;
-        totalResult.palmStats.errors += conduitResult.palmStats.errors;
+        if (!stopping && !readyDevice.isEmpty()) {
+            // Next conduit that needs the Palm
+            QString id = readyDevice.takeFirst();
+            if (!shouldRun(id)) {
+                if (m_prefetchConduit == id) {
+                    discardPrefetch();
+                }
+                finish(id, nullptr);
+                continue;
+            }
 
-        totalResult.pcStats.created += conduitResult.pcStats.created;
-        totalResult.pcStats.updated += conduitResult.pcStats.updated;
-        totalResult.pcStats.deleted += conduitResult.pcStats.deleted;
-        totalResult.pcStats.unchanged += conduitResult.pcStats.unchanged;
-        totalResult.pcStats.conflicts += conduitResult.pcStats.conflicts;
-        totalResult.pcStats.errors += conduitResult.pcStats.errors;
+            emit progressUpdated(finishedCount, orderedConduits.size(),
+                QString("Syncing %1...").arg(m_conduits[id]->displayName()));
 
-        totalResult.warnings.append(conduitResult.warnings);
+            // Read the next conduit's files while this one uses the link
+            if (!readyDevice.isEmpty()) {
+                startPrefetch(readyDevice.first(), mode);
+            }
 
-        if (!conduitResult.success) {
-            totalResult.success = false;
-            if (totalResult.errorMessage.isEmpty()) {
-                totalResult.errorMessage = conduitResult.errorMessage;
+            SyncResult conduitResult = syncConduit(id, mode);
+            finish(id, &conduitResult);
+        } else if (running > 0) {
+            // Nothing for the link to do until a background conduit finishes
+            QMutexLocker locker(&completions.mutex);
+            while (completions.results.isEmpty()) {
+                completions.finished.wait(&completions.mutex);
             }
+        } else {
+            break;   // All done, or cancelled with nothing left running
         }
 
-        conduitIndex++;
+        // Collect background conduits that finished meanwhile
+        QList<QPair<QString, SyncResult>> done;
+        {
+            QMutexLocker locker(&completions.mutex);
+            done.swap(completions.results);
+        }
+        for (const auto &entry : done) {
+            running--;
+            finish(entry.first, &entry.second);
+        }
     }
 
+    // Next conduit was skipped or the sync was cancelled
+    discardPrefetch();
+
     totalResult.endTime = QDateTime::currentDateTime();
     m_syncing = false;
 
     emit syncFinished(totalResult);
-    emit logMessage(QString("Sync complete. Palm: %1. PC: %2. Duration: %3ms")
+    log(QString("Sync complete. Palm: %1. PC: %2. Duration: %3ms")
         .arg(totalResult.palmStats.summary())
         .arg(totalResult.pcStats.summary())
         .arg(totalResult.durationMs()));
@@ -232,6 +331,70 @@ SyncResult SyncEngine::syncAll(SyncMode mode)
     return totalResult;
 }
 
+void SyncEngine::accumulateResult(SyncResult &total, const SyncResult &conduitResult)
+{
+    total.palmStats.created += conduitResult.palmStats.created;
+    total.palmStats.updated += conduitResult.palmStats.updated;
+    total.palmStats.deleted += conduitResult.palmStats.deleted;
+    total.palmStats.unchanged += conduitResult.palmStats.unchanged;
+    total.palmStats.conflicts += conduitResult.palmStats.conflicts;
+    total.palmStats.errors += conduitResult.palmStats.errors;
+
+    total.pcStats.created += conduitResult.pcStats.created;
+    total.pcStats.updated += conduitResult.pcStats.updated;
+    total.pcStats.deleted += conduitResult.pcStats.deleted;
+    total.pcStats.unchanged += conduitResult.pcStats.unchanged;
+    total.pcStats.conflicts += conduitResult.pcStats.conflicts;
+    total.pcStats.errors += conduitResult.pcStats.errors;
+
+    total.warnings.append(conduitResult.warnings);
+    total.timings.append(conduitResult.timings);
+
+    if (!conduitResult.success) {
+        total.success = false;
+        if (total.errorMessage.isEmpty()) {
+            total.errorMessage = conduitResult.errorMessage;
+        }
+    }
+}
+
+bool SyncEngine::isCancelRequested() const
+{
+    return m_cancelled || (m_cancelCheck && m_cancelCheck());
+}
+
+void SyncEngine::startPrefetch(const QString &conduitId, SyncMode mode)
+{
+    // Backup never reads the backend
+    if (!m_prefetchConduit.isEmpty() || mode == SyncMode::Backup
+        || !m_backend || !m_backend->supportsConcurrentLoad()) {
+        return;
+    }
+
+    // Collection ID is the conduit ID (see syncConduit)
+    auto promise = std::make_shared<QPromise<QList<BackendRecord*>>>();
+    m_prefetchConduit = conduitId;
+    m_prefetchRecords = promise->future();
+    promise->start();
+
+    SyncBackend *backend = m_backend;
+    m_prefetchPool.start([promise, backend, conduitId]() {
+        promise->addResult(backend->loadRecords(conduitId));
+        promise->finish();
+    });
+}
+
+void SyncEngine::discardPrefetch()
+{
+    if (m_prefetchConduit.isEmpty()) {
+        return;
+    }
+
+    qDeleteAll(m_prefetchRecords.result());
+    m_prefetchConduit.clear();
+    m_prefetchRecords = QFuture<QList<BackendRecord*>>();
+}
+
 SyncResult SyncEngine::syncConduit(const QString &conduitId, SyncMode mode)
 {
     SyncResult result;
@@ -245,9 +408,8 @@ SyncResult SyncEngine::syncConduit(const QString &conduitId, SyncMode mode)
         return result;
     }
 
-    m_currentConduit = conduitId;
     emit conduitStarted(conduitId);
-    emit logMessage(QString("=== %1 ===").arg(cond->displayName()));
+    log(QString("=== %1 ===").arg(cond->displayName()));
 
     // Get or create sync state for this conduit
     SyncState *state = stateForConduit(conduitId);
@@ -266,19 +428,58 @@ SyncResult SyncEngine::syncConduit(const QString &conduitId, SyncMode mode)
     // For now, use conduit ID as collection ID
     context.collectionId = conduitId;
 
-    // Pass cancellation check to conduit
-    if (m_cancelCheck) {
-        cond->setCancelCheck(m_cancelCheck);
+    // Hand over records loaded while the previous conduit ran. Only device
+    // conduits are prefetched, and they run on this thread.
+    if (cond->requiresDevice() && m_prefetchConduit == conduitId) {
+        context.prefetchedRecords = m_prefetchRecords;
+        m_prefetchConduit.clear();
+        m_prefetchRecords = QFuture<QList<BackendRecord*>>();
+        log("Using backend records loaded in the background");
+    }
+
+    // Pass cancellation check to conduit, and to the link so bulk reads
+    // stop within one record. Covers cancelSync() as well as the external
+    // check.
+    cond->setCancelCheck([this]() { return isCancelRequested(); });
+    if (cond->requiresDevice()) {
+        m_deviceLink->setCancelCheck([this]() { return isCancelRequested(); });
     }
 
-    // Run the sync
+    // Run the sync. DLP traffic is only attributed to conduits that use the
+    // link, since a background conduit overlaps with one that does
+    KPilotLink::Traffic trafficBefore;
+    if (cond->requiresDevice()) {
+        trafficBefore = m_deviceLink->traffic();
+    }
+    QElapsedTimer timer;
+    timer.start();
+
     result = cond->sync(&context);
 
     // Clear cancellation check
     cond->setCancelCheck(nullptr);
+    if (cond->requiresDevice()) {
+        m_deviceLink->setCancelCheck(nullptr);
+    }
+
+    // Failed or cancelled before loading the backend
+    if (context.prefetchedRecords) {
+        qDeleteAll(context.prefetchedRecords->result());
+    }
+
+    context.timing.conduitId = conduitId;
+    context.timing.totalUs = timer.nsecsElapsed() / 1000;
+    if (cond->requiresDevice()) {
+        KPilotLink::Traffic trafficAfter = m_deviceLink->traffic();
+        context.timing.dlpCalls = trafficAfter.calls - trafficBefore.calls;
+        context.timing.dlpBytesSent = trafficAfter.bytesSent - trafficBefore.bytesSent;
+        context.timing.dlpBytesReceived = trafficAfter.bytesReceived - trafficBefore.bytesReceived;
+    }
+    result.timings = {context.timing};
+
+    log(QString("Timing: %1").arg(context.timing.summary()));
 
     result.endTime = QDateTime::currentDateTime();
-    m_currentConduit.clear();
 
     emit conduitFinished(conduitId, result);
 
@@ -288,11 +489,12 @@ SyncResult SyncEngine::syncConduit(const QString &conduitId, SyncMode mode)
 void SyncEngine::cancelSync()
 {
     m_cancelled = true;
-    emit logMessage("Cancel requested...");
+    log("Cancel requested...");
 }
 
 void SyncEngine::setProgressCallback(std::function<void(int, int, const QString&)> callback)
 {
+    QMutexLocker locker(&m_callbackMutex);
     m_progressCallback = callback;
 }
 
@@ -315,33 +517,44 @@ void SyncEngine::setStateDirectory(const QString &path)
 
 SyncState* SyncEngine::stateForConduit(const QString &conduitId)
 {
-    if (!m_states.contains(conduitId)) {
-        QString userName = m_palmUserName.isEmpty() ? "default" : m_palmUserName;
-        SyncState *state = new SyncState(userName, conduitId, this);
+    auto it = m_states.constFind(conduitId);
+    if (it != m_states.constEnd()) {
+        return it.value();
+    }
 
-        // Use the configured state directory (within PalmSync/.state/)
-        if (!m_stateDirectory.isEmpty()) {
-            state->setStateDirectory(m_stateDirectory);
-        }
+    QString userName = m_palmUserName.isEmpty() ? "default" : m_palmUserName;
+    SyncState *state = new SyncState(userName, conduitId, this);
 
-        state->load();
-        m_states[conduitId] = state;
+    // Use the configured state directory (within PalmSync/.state/)
+    if (!m_stateDirectory.isEmpty()) {
+        state->setStateDirectory(m_stateDirectory);
     }
-    return m_states[conduitId];
+
+    state->load();
+    m_states[conduitId] = state;
+    return state;
 }
 
 // ========== Private Slots ==========
 
 void SyncEngine::connectConduitSignals(Conduit *conduit)
 {
+    // Direct: background conduits emit from pool threads while syncAll()
+    // blocks this object's thread, so queued delivery would arrive after
+    // the sync. The slots only re-emit, which is thread-safe.
     connect(conduit, &Conduit::progressUpdated,
-            this, &SyncEngine::onConduitProgress);
+            this, &SyncEngine::onConduitProgress, Qt::DirectConnection);
     connect(conduit, &Conduit::logMessage,
-            this, &SyncEngine::onConduitLog);
+            this, &SyncEngine::onConduitLog, Qt::DirectConnection);
+    connect(conduit, &Conduit::debugMessage,
+            this, &SyncEngine::debugMessage, Qt::DirectConnection);
     connect(conduit, &Conduit::errorOccurred,
-            this, &SyncEngine::onConduitError);
-    connect(conduit, &Conduit::conflictDetected,
-            this, &SyncEngine::onConduitConflict);
+            this, &SyncEngine::onConduitError, Qt::DirectConnection);
+    // sender() is not reliable across threads, so the conduit is captured
+    connect(conduit, &Conduit::conflictDetected, this,
+            [this, conduit](const QString &palmDesc, const QString &pcDesc) {
+                emit conflictDetected(conduit->conduitId(), palmDesc, pcDesc);
+            }, Qt::DirectConnection);
 }
 
 void SyncEngine::onConduitProgress(int current, int total, const QString &message)
@@ -349,6 +562,7 @@ void SyncEngine::onConduitProgress(int current, int total, const QString &messag
     emit progressUpdated(current, total, message);
 
     // Also call external callback if set (for worker thread integration)
+    QMutexLocker locker(&m_callbackMutex);
     if (m_progressCallback) {
         m_progressCallback(current, total, message);
     }
@@ -356,29 +570,28 @@ void SyncEngine::onConduitProgress(int current, int total, const QString &messag
 
 void SyncEngine::onConduitLog(const QString &message)
 {
-    emit logMessage(message);
+    log(message);
 }
 
-void SyncEngine::onConduitError(const QString &error)
+void SyncEngine::log(const QString &message)
 {
-    emit errorOccurred(error);
+    qCInfo(lcConduit).noquote() << message;
+    emit logMessage(message);
 }
 
-void SyncEngine::onConduitConflict(const QString &palmDesc, const QString &pcDesc)
+void SyncEngine::onConduitError(const QString &error)
 {
-    emit conflictDetected(m_currentConduit, palmDesc, pcDesc);
+    qCWarning(lcConduit).noquote() << error;
+    emit errorOccurred(error);
 }
 
 // ========== Dependency Resolution ==========
 
-QStringList SyncEngine::resolveConduitOrder(const QStringList &conduitIds)
+void SyncEngine::buildDependencyGraph(const QStringList &conduitIds,
+                                      QMap<QString, QStringList> &mustRunBefore,
+                                      QMap<QString, int> &inDegree) const
 {
-    // Build dependency graph
     // Edge A -> B means "A must run before B"
-    QMap<QString, QStringList> mustRunBefore;  // conduit -> list of conduits it must run before
-    QMap<QString, int> inDegree;               // how many conduits must run before this one
-
-    // Initialize
     for (const QString &id : conduitIds) {
         inDegree[id] = 0;
         mustRunBefore[id] = QStringList();
@@ -405,6 +618,13 @@ QStringList SyncEngine::resolveConduitOrder(const QStringList &conduitIds)
             }
         }
     }
+}
+
+QStringList SyncEngine::resolveConduitOrder(const QStringList &conduitIds)
+{
+    QMap<QString, QStringList> mustRunBefore;  // conduit -> list of conduits it must run before
+    QMap<QString, int> inDegree;               // how many conduits must run before this one
+    buildDependencyGraph(conduitIds, mustRunBefore, inDegree);
 
     // Kahn's algorithm for topological sort
     QStringList result;
@@ -435,7 +655,7 @@ QStringList SyncEngine::resolveConduitOrder(const QStringList &conduitIds)
     // If we didn't process all conduits, there's a cycle
     // (This shouldn't happen if checkCircularDependencies was called first)
     if (result.size() != conduitIds.size()) {
-        emit logMessage("Warning: Could not resolve all conduit dependencies");
+        log("Warning: Could not resolve all conduit dependencies");
         // Return whatever we have plus the remaining ones
         for (const QString &id : conduitIds) {
             if (!result.contains(id)) {
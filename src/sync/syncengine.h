@@ -5,13 +5,17 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QFuture>
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
 #include <functional>
 #include "synctypes.h"
 #include "syncstate.h"
 #include "syncbackend.h"
 #include "conduit.h"
 
-class KPilotDeviceLink;
+class KPilotLink;
 
 namespace Sync {
 
@@ -58,12 +62,12 @@ public:
      *
      * The engine takes ownership of the device link.
      */
-    void setDeviceLink(KPilotDeviceLink *link);
+    void setDeviceLink(KPilotLink *link);
 
     /**
      * @brief Get the current device link
      */
-    KPilotDeviceLink* deviceLink() const { return m_deviceLink; }
+    KPilotLink* deviceLink() const { return m_deviceLink; }
 
     /**
      * @brief Get the Palm username (after connection)
@@ -123,7 +127,16 @@ public:
     /**
      * @brief Sync all enabled conduits
      *
-     * Runs each conduit in order, collecting results.
+     * Conduits run as a dependency graph built from runBefore()/runAfter().
+     * Conduits that need the Palm run one at a time on the calling thread,
+     * since there is only one DLP link. Device-free conduits (e.g. web
+     * calendars) start on a thread pool as soon as their dependencies have
+     * finished, so network waits overlap with device work. Results are
+     * collected in completion order.
+     *
+     * While a conduit talks to the Palm, the backend records of the next
+     * ready device conduit are loaded in the background (if the backend
+     * supportsConcurrentLoad()), hiding disk time behind link time.
      */
     SyncResult syncAll(SyncMode mode = SyncMode::HotSync);
 
@@ -162,6 +175,12 @@ public:
 
     // ========== Configuration ==========
 
+    /**
+     * @brief Maximum number of device-free conduits running at once (default: 4)
+     */
+    void setMaxBackgroundConduits(int count) { m_backgroundPool.setMaxThreadCount(qMax(1, count)); }
+    int maxBackgroundConduits() const { return m_backgroundPool.maxThreadCount(); }
+
     /**
      * @brief Set the conflict resolution policy
      */
@@ -191,6 +210,7 @@ signals:
     void conduitFinished(const QString &conduitId, const SyncResult &result);
     void progressUpdated(int current, int total, const QString &message);
     void logMessage(const QString &message);
+    void debugMessage(const QString &message);
     void errorOccurred(const QString &error);
     void conflictDetected(const QString &conduitId, const QString &palmDesc, const QString &pcDesc);
 
@@ -198,11 +218,45 @@ private slots:
     void onConduitProgress(int current, int total, const QString &message);
     void onConduitLog(const QString &message);
     void onConduitError(const QString &error);
-    void onConduitConflict(const QString &palmDesc, const QString &pcDesc);
 
 private:
     void connectConduitSignals(Conduit *conduit);
 
+    /**
+     * @brief Emit logMessage() and write the line to the sync log
+     */
+    void log(const QString &message);
+
+    /**
+     * @brief Build the runBefore()/runAfter() graph
+     *
+     * @param successors Conduit -> conduits that must wait for it
+     * @param inDegree Conduit -> number of conduits it waits for
+     */
+    void buildDependencyGraph(const QStringList &conduitIds,
+                              QMap<QString, QStringList> &successors,
+                              QMap<QString, int> &inDegree) const;
+
+    /**
+     * @brief Add one conduit's stats, warnings and timings to the total
+     */
+    static void accumulateResult(SyncResult &total, const SyncResult &conduitResult);
+
+    bool isCancelRequested() const;
+
+    /**
+     * @brief Start loading a conduit's backend records on m_prefetchPool
+     *
+     * Does nothing if a prefetch is already pending or the backend
+     * cannot load concurrently.
+     */
+    void startPrefetch(const QString &conduitId, SyncMode mode);
+
+    /**
+     * @brief Wait for and free a prefetch nobody took
+     */
+    void discardPrefetch();
+
     /**
      * @brief Get conduits in dependency-resolved order
      *
@@ -221,7 +275,7 @@ private:
      */
     QString checkCircularDependencies(const QStringList &conduitIds);
 
-    KPilotDeviceLink *m_deviceLink = nullptr;
+    KPilotLink *m_deviceLink = nullptr;
     SyncBackend *m_backend = nullptr;
 
     QMap<QString, Conduit*> m_conduits;
@@ -233,12 +287,19 @@ private:
     ConflictResolution m_conflictPolicy = ConflictResolution::AskUser;
 
     bool m_syncing = false;
-    bool m_cancelled = false;
-    QString m_currentConduit;
+    std::atomic<bool> m_cancelled{false};
 
     // External callbacks for worker thread integration
     std::function<void(int, int, const QString&)> m_progressCallback;
     std::function<bool()> m_cancelCheck;
+    QMutex m_callbackMutex;  ///< Conduits on the pool report progress concurrently
+
+    // Backend records of the next device conduit, loading in the background
+    QThreadPool m_prefetchPool;
+    QString m_prefetchConduit;
+    QFuture<QList<BackendRecord*>> m_prefetchRecords;
+
+    QThreadPool m_backgroundPool;  ///< Runs device-free conduits
 };
 
 } // namespace Sync
@@ -1,4 +1,5 @@
 #include "syncstate.h"
+#include "../synclog.h"
 
 #include <QDir>
 #include <QFile>
@@ -257,7 +258,7 @@ bool SyncState::load()
         m_baselineHashes[it.key()] = it.value().toString();
     }
 
-    qDebug() << "[SyncState] Loaded" << m_mappings.size() << "mappings for" << m_conduitId;
+    qCDebug(lcState) << "[SyncState] Loaded" << m_mappings.size() << "mappings for" << m_conduitId;
     return true;
 }
 
@@ -301,7 +302,7 @@ bool SyncState::save()
     file.write(doc.toJson(QJsonDocument::Indented));
     file.close();
 
-    qDebug() << "[SyncState] Saved" << m_mappings.size() << "mappings for" << m_conduitId;
+    qCDebug(lcState) << "[SyncState] Saved" << m_mappings.size() << "mappings for" << m_conduitId;
     return true;
 }
 
@@ -4,6 +4,7 @@
 #include <QString>
 #include <QDateTime>
 #include <QList>
+#include <QStringList>
 #include <QVariant>
 
 /**
@@ -132,6 +133,89 @@ struct SyncStats {
     }
 };
 
+/**
+ * @brief Phases of a conduit sync, for the timing breakdown
+ */
+enum class SyncPhase {
+    DatabaseOpen,   ///< Opening the Palm database
+    PalmRead,       ///< Reading records over DLP
+    BackendLoad,    ///< Loading PC records
+    Conversion,     ///< Palm <-> PC record conversion (incl. lazy category load)
+    PalmWrite,      ///< Writing and deleting records over DLP
+    BackendWrite,   ///< Creating, updating and deleting PC records
+    CategoryWrite,  ///< Writing modified categories back to the Palm
+    Cleanup,        ///< Purging deleted records, resetting flags, closing the DB
+    StateSave       ///< Saving baseline hashes and sync state
+};
+
+constexpr int SyncPhaseCount = 9;
+
+inline QString syncPhaseName(SyncPhase phase)
+{
+    switch (phase) {
+        case SyncPhase::DatabaseOpen: return "DB open";
+        case SyncPhase::PalmRead: return "Palm read";
+        case SyncPhase::BackendLoad: return "backend load";
+        case SyncPhase::Conversion: return "conversion";
+        case SyncPhase::PalmWrite: return "Palm write";
+        case SyncPhase::BackendWrite: return "backend write";
+        case SyncPhase::CategoryWrite: return "categories";
+        case SyncPhase::Cleanup: return "cleanup";
+        case SyncPhase::StateSave: return "state save";
+    }
+    return QString();
+}
+
+/**
+ * @brief Where one conduit's sync time went
+ *
+ * Phase times are measured around the individual operations, so they do
+ * not overlap; what is left of the total (comparisons, logging, ...) is
+ * otherUs(). DLP figures are the link traffic during the conduit's run.
+ */
+struct SyncTiming {
+    QString conduitId;
+    qint64 phaseUs[SyncPhaseCount] = {};   ///< Indexed by SyncPhase
+    qint64 totalUs = 0;
+
+    int dlpCalls = 0;
+    qint64 dlpBytesSent = 0;        ///< Payload bytes to the Palm
+    qint64 dlpBytesReceived = 0;    ///< Payload bytes from the Palm
+
+    qint64 phase(SyncPhase p) const { return phaseUs[static_cast<int>(p)]; }
+    void add(SyncPhase p, qint64 us) { phaseUs[static_cast<int>(p)] += us; }
+
+    qint64 otherUs() const {
+        qint64 measured = 0;
+        for (qint64 us : phaseUs) {
+            measured += us;
+        }
+        return qMax<qint64>(0, totalUs - measured);
+    }
+
+    /**
+     * @brief One-line breakdown, e.g. "memos 812 ms: Palm read 640, ... | DLP 214 calls, 48.2 KB in, 1.1 KB out"
+     */
+    QString summary() const {
+        QStringList parts;
+        for (int i = 0; i < SyncPhaseCount; ++i) {
+            if (phaseUs[i] >= 1000) {
+                parts << QString("%1 %2").arg(syncPhaseName(static_cast<SyncPhase>(i))).arg(phaseUs[i] / 1000);
+            }
+        }
+        if (otherUs() >= 1000) {
+            parts << QString("other %1").arg(otherUs() / 1000);
+        }
+        return QString("%1 %2 ms: %3 | DLP %4 calls, %5 KB in, %6 KB out")
+            .arg(conduitId)
+            .arg(totalUs / 1000)
+            .arg(parts.isEmpty() ? QString("-") : parts.join(", "))
+            .arg(dlpCalls)
+            .arg(dlpBytesReceived / 1024.0, 0, 'f', 1)
+            .arg(dlpBytesSent / 1024.0, 0, 'f', 1);
+    }
+};
+
 /**
  * @brief Result of a complete sync operation
  */
@@ -141,6 +225,7 @@ struct SyncResult {
     SyncStats palmStats;    ///< Changes made to Palm
     SyncStats pcStats;      ///< Changes made to PC
     QList<DataLossWarning> warnings;
+    QList<SyncTiming> timings;  ///< One per conduit that ran
     QDateTime startTime;
     QDateTime endTime;
 
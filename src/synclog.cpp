@@ -0,0 +1,237 @@
+#include "synclog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <QDebug>
+#include <atomic>
+#include <memory>
+
+Q_LOGGING_CATEGORY(lcLink, "qpilotsync.link", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcConduit, "qpilotsync.conduit", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcBackend, "qpilotsync.backend", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcState, "qpilotsync.state", QtInfoMsg)
+
+namespace {
+
+// Beyond this the disk can't keep up; drop rather than grow without bound
+const int MAX_QUEUED_LINES = 10000;
+
+const char CATEGORY_PREFIX[] = "qpilotsync.";
+
+QtMessageHandler s_previousHandler = nullptr;
+QMutex s_writerMutex;                       // protects s_writer
+std::unique_ptr<SyncLogWriter> s_writer;
+std::atomic<bool> s_hasWriter{false};
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    const char *category = context.category ? context.category : "default";
+    bool ours = qstrncmp(category, CATEGORY_PREFIX, sizeof(CATEGORY_PREFIX) - 1) == 0;
+
+    if (s_hasWriter.load() && (ours || (type != QtDebugMsg && type != QtInfoMsg))) {
+        QString line = SyncLog::formatLine(type, category, message);
+        QMutexLocker locker(&s_writerMutex);
+        if (s_writer) {
+            s_writer->write(line);
+        }
+    }
+
+    s_previousHandler(type, context, message);
+}
+
+} // namespace
+
+// ========== SyncLogWriter ==========
+
+SyncLogWriter::SyncLogWriter(const QString &filePath, qint64 maxFileSize, int maxFiles)
+    : m_filePath(filePath)
+    , m_maxFileSize(maxFileSize)
+    , m_maxFiles(qMax(1, maxFiles))
+{
+    m_thread = QThread::create([this]() { loop(); });
+    m_thread->setObjectName("SyncLogWriter");
+    m_thread->start();
+}
+
+SyncLogWriter::~SyncLogWriter()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+void SyncLogWriter::write(const QString &line)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.size() >= MAX_QUEUED_LINES) {
+        m_dropped++;
+        return;
+    }
+    m_queue.append(line);
+    m_queuedCount++;
+    m_wake.wakeOne();
+}
+
+void SyncLogWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 target = m_queuedCount;
+    while (m_writtenCount < target) {
+        m_written.wait(&m_mutex);
+    }
+}
+
+int SyncLogWriter::droppedLines() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+QString SyncLogWriter::rotatedFilePath(int index) const
+{
+    if (index == 0) {
+        return m_filePath;
+    }
+    QFileInfo info(m_filePath);
+    return info.dir().filePath(QString("%1.%2.%3")
+        .arg(info.completeBaseName()).arg(index).arg(info.suffix()));
+}
+
+bool SyncLogWriter::openFile()
+{
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "[SyncLogWriter] Cannot open" << m_filePath << ":" << m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void SyncLogWriter::rotate()
+{
+    m_file.close();
+
+    QFile::remove(rotatedFilePath(m_maxFiles - 1));
+    for (int i = m_maxFiles - 2; i >= 0; --i) {
+        QFile::rename(rotatedFilePath(i), rotatedFilePath(i + 1));
+    }
+
+    openFile();
+}
+
+void SyncLogWriter::loop()
+{
+    openFile();
+
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (!m_stopping && m_queue.isEmpty()) {
+            m_wake.wait(&m_mutex);
+        }
+        if (m_queue.isEmpty()) {
+            break;  // Stopping, and everything queued is written
+        }
+
+        QStringList lines;
+        lines.swap(m_queue);
+        locker.unlock();
+
+        for (const QString &line : std::as_const(lines)) {
+            QByteArray data = line.toUtf8();
+            data.append('\n');
+            if (m_file.isOpen() && m_file.size() > 0
+                && m_file.size() + data.size() > m_maxFileSize) {
+                rotate();
+            }
+            if (m_file.isOpen()) {
+                m_file.write(data);
+            }
+        }
+        m_file.flush();
+
+        locker.relock();
+        m_writtenCount += lines.size();
+        m_written.wakeAll();
+    }
+
+    m_file.close();
+}
+
+// ========== SyncLog ==========
+
+namespace SyncLog {
+
+void install()
+{
+    if (s_previousHandler) {
+        return;  // Already installed
+    }
+    s_previousHandler = qInstallMessageHandler(messageHandler);
+}
+
+bool openProfileLog(const QString &directory)
+{
+    closeProfileLog();
+    if (directory.isEmpty()) {
+        return false;
+    }
+
+    auto writer = std::make_unique<SyncLogWriter>(QDir(directory).filePath("sync.log"));
+    QMutexLocker locker(&s_writerMutex);
+    s_writer = std::move(writer);
+    s_hasWriter = true;
+    return true;
+}
+
+void closeProfileLog()
+{
+    std::unique_ptr<SyncLogWriter> writer;
+    {
+        QMutexLocker locker(&s_writerMutex);
+        s_hasWriter = false;
+        writer = std::move(s_writer);
+    }
+    // Destroyed unlocked: the writer thread may log while it finishes
+}
+
+QString currentLogFile()
+{
+    QMutexLocker locker(&s_writerMutex);
+    return s_writer ? s_writer->filePath() : QString();
+}
+
+void setDebugEnabled(bool enabled)
+{
+    QLoggingCategory::setFilterRules(enabled ? "qpilotsync.*.debug=true"
+                                             : "qpilotsync.*.debug=false");
+}
+
+QString formatLine(QtMsgType type, const char *category, const QString &message)
+{
+    const char *level = "I";
+    switch (type) {
+    case QtDebugMsg:    level = "D"; break;
+    case QtInfoMsg:     level = "I"; break;
+    case QtWarningMsg:  level = "W"; break;
+    case QtCriticalMsg: level = "E"; break;
+    case QtFatalMsg:    level = "F"; break;
+    }
+
+    QString name = QString::fromLatin1(category);
+    if (name.startsWith(QLatin1String(CATEGORY_PREFIX))) {
+        name.remove(0, sizeof(CATEGORY_PREFIX) - 1);
+    }
+
+    return QString("%1 %2 %3: %4")
+        .arg(QDateTime::currentDateTime().toString(Qt::ISODateWithMs),
+             QString::fromLatin1(level), name, message);
+}
+
+} // namespace SyncLog
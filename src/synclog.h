@@ -0,0 +1,115 @@
+#ifndef SYNCLOG_H
+#define SYNCLOG_H
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+
+class QThread;
+
+// Logging categories. Debug output is off unless enabled (see
+// SyncLog::setDebugEnabled()); qCDebug() then skips formatting entirely.
+Q_DECLARE_LOGGING_CATEGORY(lcLink)      // qpilotsync.link - DLP traffic
+Q_DECLARE_LOGGING_CATEGORY(lcConduit)   // qpilotsync.conduit - per-conduit sync
+Q_DECLARE_LOGGING_CATEGORY(lcBackend)   // qpilotsync.backend - PC-side storage
+Q_DECLARE_LOGGING_CATEGORY(lcState)     // qpilotsync.state - ID mappings, baselines
+
+/**
+ * @brief Appends lines to a size-rotated log file from a background thread
+ *
+ * write() only queues the line, so logging from a sync thread never waits
+ * for the disk. When the file would grow past the size limit it is renamed
+ * to name.1.log (shifting older ones up) and a new file is started; at
+ * most maxFiles files are kept.
+ */
+class SyncLogWriter
+{
+public:
+    explicit SyncLogWriter(const QString &filePath,
+                           qint64 maxFileSize = 1024 * 1024, int maxFiles = 5);
+
+    /**
+     * @brief Writes what is queued, then stops the thread
+     */
+    ~SyncLogWriter();
+
+    SyncLogWriter(const SyncLogWriter &) = delete;
+    SyncLogWriter &operator=(const SyncLogWriter &) = delete;
+
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Queue a line (thread-safe, does not block on I/O)
+     */
+    void write(const QString &line);
+
+    /**
+     * @brief Wait until everything queued so far is on disk
+     */
+    void flush();
+
+    /**
+     * @brief Lines dropped because the queue was full
+     */
+    int droppedLines() const;
+
+    /**
+     * @brief Path of rotated file @p index (0 is the current file)
+     */
+    QString rotatedFilePath(int index) const;
+
+private:
+    void loop();
+    bool openFile();
+    void rotate();
+
+    QString m_filePath;
+    qint64 m_maxFileSize;
+    int m_maxFiles;
+    QFile m_file;                   // only used on the writer thread
+    QThread *m_thread = nullptr;
+
+    mutable QMutex m_mutex;         // protects everything below
+    QWaitCondition m_wake;
+    QWaitCondition m_written;
+    QStringList m_queue;
+    int m_dropped = 0;
+    qint64 m_queuedCount = 0;
+    qint64 m_writtenCount = 0;
+    bool m_stopping = false;
+};
+
+/**
+ * @brief Routes categorized log output to the current profile's log file
+ *
+ * install() adds a Qt message handler in front of the existing one. It
+ * writes qpilotsync.* messages, and warnings from anywhere, to the open
+ * profile log. Everything is still passed on to the previous handler.
+ */
+namespace SyncLog {
+
+void install();
+
+/**
+ * @brief Start writing to sync.log in @p directory (closes any previous log)
+ */
+bool openProfileLog(const QString &directory);
+void closeProfileLog();
+QString currentLogFile();
+
+/**
+ * @brief Turn debug output of the qpilotsync.* categories on or off
+ */
+void setDebugEnabled(bool enabled);
+
+/**
+ * @brief Format a message as written to the log file
+ */
+QString formatLine(QtMsgType type, const char *category, const QString &message);
+
+} // namespace SyncLog
+
+#endif // SYNCLOG_H
@@ -0,0 +1,615 @@
+/**
+ * @file cli.cpp
+ * @brief qpilotsync-cli: headless HotSync for cron and server use
+ *
+ *   qpilotsync-cli --profile ~/PalmSync
+ *   qpilotsync-cli --profile ~/PalmSync --device /dev/ttyUSB0 --mode fullsync --json
+ *   qpilotsync-cli --mode backup --wait 300 --conflict palm
+ *   qpilotsync-cli --listen net:any --max-devices 8
+ *
+ * Loads a sync profile (default: the one set as default in the GUI),
+ * waits for the Palm on the profile's port, runs one sync and prints the
+ * result with per-conduit timings. Runs on QCoreApplication; no window
+ * or display is needed.
+ *
+ * With --listen it instead keeps accepting handhelds on the address and
+ * syncs each one into the profile registered for it (see
+ * Settings::findProfileForDevice()), several at a time, printing one
+ * result per sync until it is killed. Unregistered handhelds are turned
+ * away.
+ *
+ * Exit status: 0 sync succeeded, 1 sync failed, 2 bad arguments or
+ * profile, 3 connection failed or wrong device, 4 timed out waiting.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QScopeGuard>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <pi-dlp.h>
+
+#include "profile.h"
+#include "settings.h"
+#include "synclog.h"
+#include "palm/devicesession.h"
+#include "palm/devicewatcher.h"
+#include "palm/hotsynclistener.h"
+#include "palm/kpilotdevicelink.h"
+#include "sync/multidevicesync.h"
+#include "sync/syncengine.h"
+#include "sync/localfilebackend.h"
+#include "sync/conduits/memoconduit.h"
+#include "sync/conduits/contactconduit.h"
+#include "sync/conduits/calendarconduit.h"
+#include "sync/conduits/todoconduit.h"
+#include "sync/conduits/webcalendarconduit.h"
+
+using namespace Sync;
+
+namespace {
+
+enum ExitCode {
+    ExitSuccess = 0,
+    ExitSyncFailed = 1,
+    ExitUsage = 2,
+    ExitConnection = 3,
+    ExitTimeout = 4
+};
+
+struct Mode
+{
+    QString name;
+    SyncMode mode;
+};
+
+const QList<Mode> MODES = {
+    {"hotsync", SyncMode::HotSync},
+    {"fullsync", SyncMode::FullSync},
+    {"palmtopc", SyncMode::CopyPalmToPC},
+    {"pctopalm", SyncMode::CopyPCToPalm},
+    {"backup", SyncMode::Backup},
+    {"restore", SyncMode::Restore},
+};
+
+struct Policy
+{
+    QString name;
+    ConflictResolution policy;
+};
+
+// "ask" has nobody to ask here; the conduits skip and count those conflicts
+const QList<Policy> POLICIES = {
+    {"ask", ConflictResolution::AskUser},
+    {"palm", ConflictResolution::PalmWins},
+    {"pc", ConflictResolution::PCWins},
+    {"duplicate", ConflictResolution::Duplicate},
+    {"newest", ConflictResolution::NewestWins},
+    {"skip", ConflictResolution::Skip},
+};
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+QStringList names(const QList<Mode> &modes)
+{
+    QStringList list;
+    for (const Mode &mode : modes) {
+        list << mode.name;
+    }
+    return list;
+}
+
+QStringList names(const QList<Policy> &policies)
+{
+    QStringList list;
+    for (const Policy &policy : policies) {
+        list << policy.name;
+    }
+    return list;
+}
+
+/**
+ * @brief Send engine and device chatter to stderr only with --verbose,
+ *        so stdout carries nothing but the result
+ *
+ * --verbose also turns on debug output of the qpilotsync.* categories,
+ * which then goes to the profile's sync log as well.
+ */
+void setVerbose(bool verbose)
+{
+    static bool s_verbose = false;
+    s_verbose = verbose;
+    qInstallMessageHandler([](QtMsgType type, const QMessageLogContext &, const QString &msg) {
+        if (s_verbose || (type != QtDebugMsg && type != QtInfoMsg)) {
+            fprintf(stderr, "%s\n", qPrintable(msg));
+        }
+    });
+    SyncLog::install();
+    SyncLog::setDebugEnabled(verbose);
+}
+
+QJsonObject toJson(const SyncStats &stats)
+{
+    QJsonObject obj;
+    obj["created"] = stats.created;
+    obj["updated"] = stats.updated;
+    obj["deleted"] = stats.deleted;
+    obj["unchanged"] = stats.unchanged;
+    obj["conflicts"] = stats.conflicts;
+    obj["errors"] = stats.errors;
+    return obj;
+}
+
+QJsonObject toJson(const SyncTiming &timing)
+{
+    QJsonObject phases;
+    for (int i = 0; i < SyncPhaseCount; ++i) {
+        phases[syncPhaseName(static_cast<SyncPhase>(i))] = timing.phaseUs[i];
+    }
+
+    QJsonObject obj;
+    obj["conduit"] = timing.conduitId;
+    obj["totalUs"] = timing.totalUs;
+    obj["otherUs"] = timing.otherUs();
+    obj["phaseUs"] = phases;
+    obj["dlpCalls"] = timing.dlpCalls;
+    obj["dlpBytesSent"] = timing.dlpBytesSent;
+    obj["dlpBytesReceived"] = timing.dlpBytesReceived;
+    return obj;
+}
+
+QJsonObject toJson(const DlpExecutor::Stats &stats)
+{
+    QJsonObject obj;
+    obj["commands"] = stats.commands;
+    obj["keepAlives"] = stats.perPriority[int(DlpExecutor::Priority::KeepAlive)];
+    obj["busyUs"] = stats.busyUs;
+    obj["queueWaitUs"] = stats.queueWaitUs;
+    obj["maxQueueWaitUs"] = stats.maxQueueWaitUs;
+    obj["utilization"] = stats.utilization();
+    return obj;
+}
+
+/**
+ * @brief Build an engine with every conduit, configured from @p profile
+ *
+ * The engine has no parent and no device link yet.
+ */
+SyncEngine *createEngineForProfile(const Profile &profile, ConflictResolution policy)
+{
+    SyncEngine *engine = new SyncEngine();
+    engine->registerConduit(new MemoConduit());
+    engine->registerConduit(new ContactConduit());
+    engine->registerConduit(new CalendarConduit());
+    engine->registerConduit(new TodoConduit());
+    engine->registerConduit(new WebCalendarConduit());
+
+    engine->setStateDirectory(profile.stateDirectoryPath());
+    engine->setBackend(new LocalFileBackend(profile.syncFolderPath()));
+    engine->setConflictPolicy(policy);
+
+    // No background refresher here: without a staging directory the web
+    // calendar conduit downloads its feeds during the sync itself
+    for (const QString &conduitId : engine->registeredConduits()) {
+        engine->setConduitEnabled(conduitId, profile.conduitEnabled(conduitId));
+        QJsonObject conduitSettings = profile.conduitSettings(conduitId);
+        if (!conduitSettings.isEmpty()) {
+            engine->conduit(conduitId)->loadSettings(conduitSettings);
+        }
+    }
+    return engine;
+}
+
+const Policy *findPolicy(const QString &name)
+{
+    auto policy = std::find_if(POLICIES.cbegin(), POLICIES.cend(),
+                               [&](const Policy &p) { return p.name == name; });
+    return policy == POLICIES.cend() ? nullptr : &*policy;
+}
+
+/**
+ * @brief Persist conduit settings changed by the sync (e.g. web calendar
+ *        HTTP validators), as the GUI does after every sync
+ */
+void saveConduitSettings(SyncEngine &engine, Profile &profile)
+{
+    bool changed = false;
+    for (const QString &conduitId : engine.registeredConduits()) {
+        Conduit *conduit = engine.conduit(conduitId);
+        if (!conduit || !conduit->hasSettings()) {
+            continue;
+        }
+        QJsonObject settings = conduit->saveSettings();
+        if (settings != profile.conduitSettings(conduitId)) {
+            profile.setConduitSettings(conduitId, settings);
+            changed = true;
+        }
+    }
+    if (changed) {
+        profile.save();
+    }
+}
+
+/**
+ * @brief Serve HotSyncs on @p address until killed (--listen)
+ *
+ * @param conflictOverride Policy for every handheld; empty uses each
+ *        profile's own
+ */
+int serveHotSyncs(QCoreApplication &app, const QString &address, int maxDevices, const Mode &mode,
+                  const QString &conflictOverride, bool json, bool verbose)
+{
+    // Profile of every handheld that has an engine, by registry key
+    QMutex profilesMutex;
+    QMap<QString, QString> profilePaths;
+
+    MultiDeviceSync dispatcher;
+    dispatcher.setSyncMode(mode.mode);
+    dispatcher.setMaxConcurrentDevices(maxDevices);
+    dispatcher.setEngineFactory([&](const DeviceFingerprint &fingerprint) -> SyncEngine* {
+        QString profilePath = Settings::instance().findProfileForDevice(fingerprint);
+        if (profilePath.isEmpty()) {
+            return nullptr;
+        }
+        Profile profile(profilePath);
+        if (!profile.exists() || !profile.load()) {
+            err() << "Not a QPilotSync profile: " << profilePath << Qt::endl;
+            return nullptr;
+        }
+        const Policy *policy = findPolicy(conflictOverride.isEmpty()
+                                          ? profile.conflictPolicy() : conflictOverride);
+        if (!policy) {
+            err() << "Unknown conflict policy in " << profilePath << Qt::endl;
+            return nullptr;
+        }
+
+        SyncEngine *engine = createEngineForProfile(profile, policy->policy);
+        if (verbose) {
+            QObject::connect(engine, &SyncEngine::logMessage, [](const QString &message) {
+                err() << message << Qt::endl;
+            });
+        }
+        QMutexLocker locker(&profilesMutex);
+        profilePaths.insert(fingerprint.registryKey(), profilePath);
+        return engine;
+    });
+
+    HotSyncListener listener(new PilotLinkAcceptor(address));
+    QObject::connect(&listener, &HotSyncListener::linkAccepted,
+                     &dispatcher, &MultiDeviceSync::handleLink);
+    QObject::connect(&listener, &HotSyncListener::stopped, &app, [&]() {
+        err() << "Stopped listening on " << address << Qt::endl;
+        app.exit(ExitConnection);
+    });
+
+    if (verbose) {
+        QObject::connect(&listener, &HotSyncListener::logMessage, [](const QString &message) {
+            err() << message << Qt::endl;
+        });
+        QObject::connect(&dispatcher, &MultiDeviceSync::logMessage, [](const QString &message) {
+            err() << message << Qt::endl;
+        });
+    }
+    QObject::connect(&dispatcher, &MultiDeviceSync::deviceRejected, &app,
+                     [](const DeviceFingerprint &fingerprint, const QString &reason) {
+        err() << "Rejected " << fingerprint.displayString() << ": " << reason << Qt::endl;
+    });
+
+    // One result per sync: a line of text, or one JSON object per line
+    QObject::connect(&dispatcher, &MultiDeviceSync::deviceFinished, &app,
+                     [&](const DeviceFingerprint &fingerprint, const SyncResult &result) {
+        QString profilePath;
+        {
+            QMutexLocker locker(&profilesMutex);
+            profilePath = profilePaths.value(fingerprint.registryKey());
+        }
+        Profile profile(profilePath);
+        SyncEngine *engine = dispatcher.engine(fingerprint);
+        if (engine && profile.load()) {
+            saveConduitSettings(*engine, profile);
+        }
+
+        QTextStream out(stdout);
+        if (json) {
+            QJsonObject root;
+            root["profile"] = profilePath;
+            root["user"] = fingerprint.userName;
+            root["userId"] = qint64(fingerprint.userId);
+            root["mode"] = mode.name;
+            root["success"] = result.success;
+            root["error"] = result.errorMessage;
+            root["durationMs"] = result.durationMs();
+            root["palm"] = toJson(result.palmStats);
+            root["pc"] = toJson(result.pcStats);
+            out << QJsonDocument(root).toJson(QJsonDocument::Compact) << "\n";
+        } else {
+            out << fingerprint.displayString() << ": "
+                << (result.success ? "success" : "failed: " + result.errorMessage)
+                << " in " << result.durationMs() << " ms; palm "
+                << result.palmStats.summary() << "; pc " << result.pcStats.summary() << "\n";
+        }
+        out.flush();
+    });
+
+    if (!listener.start()) {
+        err() << "Cannot listen on " << address << Qt::endl;
+        return ExitConnection;
+    }
+    if (!json) {
+        err() << "Listening for HotSyncs on " << address << " ("
+              << maxDevices << " at a time)..." << Qt::endl;
+    }
+
+    int exitCode = app.exec();
+    listener.stop();
+    dispatcher.waitForDone();
+    return exitCode;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Same names as the GUI, so both read one Settings store
+    app.setApplicationName("QPilotSync");
+    app.setOrganizationName("QPilotSync");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Run one HotSync without the GUI");
+    parser.addHelpOption();
+
+    QCommandLineOption profileOption({"p", "profile"}, "Sync folder of the profile (default: the GUI's default profile)", "dir");
+    QCommandLineOption deviceOption({"d", "device"}, "Device port, e.g. /dev/ttyUSB0, usb: or net: (default: the profile's)", "port");
+    QCommandLineOption modeOption({"m", "mode"}, "Sync mode: " + names(MODES).join(", ") + " (default: the profile's)", "mode");
+    QCommandLineOption conflictOption("conflict", "Conflict policy: " + names(POLICIES).join(", ") + " (default: the profile's)", "policy");
+    QCommandLineOption waitOption("wait", "Seconds to wait for the Palm, 0 = forever (default: 0)", "seconds", "0");
+    QCommandLineOption jsonOption("json", "Print the result as JSON");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Log progress to stderr");
+    QCommandLineOption listenOption("listen", "Keep syncing handhelds that connect on the address, e.g. net:any, "
+                                    "each into its registered profile", "address");
+    QCommandLineOption maxDevicesOption("max-devices", "With --listen: handhelds synced at the same time (default: 4)",
+                                        "count", "4");
+    parser.addOptions({profileOption, deviceOption, modeOption, conflictOption,
+                       waitOption, jsonOption, verboseOption, listenOption, maxDevicesOption});
+    parser.process(app);
+
+    setVerbose(parser.isSet(verboseOption));
+    bool json = parser.isSet(jsonOption);
+
+    // ========== Listener ==========
+
+    if (parser.isSet(listenOption)) {
+        QString modeName = parser.isSet(modeOption) ? parser.value(modeOption) : QString("hotsync");
+        auto mode = std::find_if(MODES.cbegin(), MODES.cend(),
+                                 [&](const Mode &m) { return m.name == modeName; });
+        if (mode == MODES.cend()) {
+            err() << "Unknown sync mode: " << modeName << Qt::endl;
+            return ExitUsage;
+        }
+        QString conflict = parser.value(conflictOption);
+        if (!conflict.isEmpty() && !findPolicy(conflict)) {
+            err() << "Unknown conflict policy: " << conflict << Qt::endl;
+            return ExitUsage;
+        }
+        bool ok = false;
+        int maxDevices = parser.value(maxDevicesOption).toInt(&ok);
+        if (!ok || maxDevices < 1) {
+            err() << "--max-devices needs a positive count" << Qt::endl;
+            return ExitUsage;
+        }
+        return serveHotSyncs(app, parser.value(listenOption), maxDevices, *mode, conflict,
+                             json, parser.isSet(verboseOption));
+    }
+
+    // ========== Profile ==========
+
+    QString profilePath = parser.isSet(profileOption)
+        ? parser.value(profileOption) : Settings::instance().defaultProfilePath();
+    if (profilePath.isEmpty()) {
+        err() << "No profile given and no default profile set" << Qt::endl;
+        return ExitUsage;
+    }
+
+    Profile profile(profilePath);
+    if (!profile.exists() || !profile.load()) {
+        err() << "Not a QPilotSync profile: " << profilePath << Qt::endl;
+        return ExitUsage;
+    }
+
+    SyncLog::openProfileLog(profile.logDirectoryPath());
+    auto closeLog = qScopeGuard([]() { SyncLog::closeProfileLog(); });
+
+    QString devicePath = parser.isSet(deviceOption) ? parser.value(deviceOption) : profile.devicePath();
+    if (devicePath.isEmpty()) {
+        err() << "No device port given and none stored in the profile" << Qt::endl;
+        return ExitUsage;
+    }
+
+    QString modeName = parser.isSet(modeOption) ? parser.value(modeOption) : profile.defaultSyncType();
+    auto mode = std::find_if(MODES.cbegin(), MODES.cend(),
+                             [&](const Mode &m) { return m.name == modeName; });
+    if (mode == MODES.cend()) {
+        err() << "Unknown sync mode: " << modeName << Qt::endl;
+        return ExitUsage;
+    }
+
+    QString policyName = parser.isSet(conflictOption) ? parser.value(conflictOption) : profile.conflictPolicy();
+    const Policy *policy = findPolicy(policyName);
+    if (!policy) {
+        err() << "Unknown conflict policy: " << policyName << Qt::endl;
+        return ExitUsage;
+    }
+
+    // ========== Sync Engine ==========
+
+    std::unique_ptr<SyncEngine> enginePtr(createEngineForProfile(profile, policy->policy));
+    SyncEngine &engine = *enginePtr;
+
+    if (parser.isSet(verboseOption)) {
+        QObject::connect(&engine, &SyncEngine::logMessage, [](const QString &message) {
+            err() << message << Qt::endl;
+        });
+        QObject::connect(&engine, &SyncEngine::debugMessage, [](const QString &message) {
+            err() << message << Qt::endl;
+        });
+    }
+
+    // ========== Device ==========
+
+    // One sync per run: let the Palm show "HotSync complete" and hang up
+    DeviceSession session;
+    session.setConnectionMode(ConnectionMode::DisconnectAfterSync);
+    if (Settings::instance().dlpTrace()) {
+        session.setTraceDirectory(Settings::instance().dlpTraceDirectory());
+    }
+
+    if (parser.isSet(verboseOption)) {
+        QObject::connect(&session, &DeviceSession::logMessage, [](const QString &message) {
+            err() << message << Qt::endl;
+        });
+    }
+    QObject::connect(&session, &DeviceSession::errorOccurred, [](const QString &error) {
+        err() << "Error: " << error << Qt::endl;
+    });
+
+    DeviceFingerprint connected;
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    qint64 waitMs = 0;
+    SyncResult result;
+    DlpExecutor::Stats linkStats;
+
+    QObject::connect(&session, &DeviceSession::connectionComplete, [&](bool success) {
+        if (!success) {
+            err() << "Connection to " << devicePath << " failed" << Qt::endl;
+            app.exit(ExitConnection);
+            return;
+        }
+
+        struct PilotUser user;
+        memset(&user, 0, sizeof(user));
+        if (session.deviceLink()->readUserInfo(user)) {
+            connected.userId = user.userID;
+            connected.userName = QString::fromLatin1(user.username);
+        }
+
+        // Never sync a profile's data into somebody else's Palm
+        if (profile.hasRegisteredDevice() && !profile.deviceFingerprint().matches(connected)) {
+            err() << "Connected device " << connected.displayString()
+                  << " does not belong to this profile ("
+                  << profile.deviceFingerprint().displayString() << ")" << Qt::endl;
+            session.disconnectDevice();
+            app.exit(ExitConnection);
+        }
+    });
+
+    QObject::connect(&session, &DeviceSession::readyForSync, [&]() {
+        waitMs = waitTimer.elapsed();
+        engine.setDeviceLink(session.deviceLink());
+        session.requestSync(mode->mode, &engine);
+    });
+
+    QObject::connect(&session, &DeviceSession::syncResultReady, [&](const SyncResult &syncResult) {
+        result = syncResult;
+        if (session.deviceLink()) {
+            linkStats = session.deviceLink()->executorStats();
+        }
+        saveConduitSettings(engine, profile);
+        app.exit(result.success ? ExitSuccess : ExitSyncFailed);
+    });
+
+    // Serial ports only appear once the cradle button is pressed; usb: and
+    // net: are listened on directly by pilot-link
+    DeviceWatcher watcher;
+    QObject::connect(&watcher, &DeviceWatcher::deviceAppeared, [&]() {
+        watcher.stop();
+        session.connectDevice(devicePath);
+    });
+    watcher.watch(devicePath);
+    if (watcher.isPresent()) {
+        watcher.stop();
+        QTimer::singleShot(0, &app, [&]() { session.connectDevice(devicePath); });
+    }
+
+    int waitSeconds = parser.value(waitOption).toInt();
+    if (waitSeconds > 0) {
+        QTimer::singleShot(waitSeconds * 1000, &app, [&]() {
+            if (!session.isBusy() && !session.isConnected()) {
+                err() << "No Palm on " << devicePath << " after " << waitSeconds << " s" << Qt::endl;
+                watcher.stop();
+                app.exit(ExitTimeout);
+            }
+        });
+    }
+
+    if (!json) {
+        err() << "Waiting for HotSync on " << devicePath << "..." << Qt::endl;
+    }
+
+    int exitCode = app.exec();
+    engine.setDeviceLink(nullptr);
+    if (exitCode == ExitConnection || exitCode == ExitTimeout) {
+        return exitCode;
+    }
+
+    // ========== Result ==========
+
+    QTextStream out(stdout);
+    if (json) {
+        QJsonArray timings;
+        for (const SyncTiming &timing : result.timings) {
+            timings.append(toJson(timing));
+        }
+
+        QJsonObject root;
+        root["profile"] = profile.syncFolderPath();
+        root["device"] = devicePath;
+        root["user"] = connected.userName;
+        root["userId"] = qint64(connected.userId);
+        root["mode"] = mode->name;
+        root["success"] = result.success;
+        root["error"] = result.errorMessage;
+        root["startTime"] = result.startTime.toString(Qt::ISODateWithMs);
+        root["endTime"] = result.endTime.toString(Qt::ISODateWithMs);
+        root["waitMs"] = waitMs;
+        root["durationMs"] = result.durationMs();
+        root["palm"] = toJson(result.palmStats);
+        root["pc"] = toJson(result.pcStats);
+        root["warnings"] = result.warnings.size();
+        root["conduits"] = timings;
+        root["link"] = toJson(linkStats);
+        out << QJsonDocument(root).toJson(QJsonDocument::Indented);
+    } else {
+        out << "device   " << connected.displayString() << " on " << devicePath << "\n"
+            << "mode     " << mode->name << "\n"
+            << "result   " << (result.success ? "success" : "failed: " + result.errorMessage) << "\n"
+            << "duration " << result.durationMs() << " ms (waited " << waitMs << " ms for the Palm)\n"
+            << "palm     " << result.palmStats.summary() << "\n"
+            << "pc       " << result.pcStats.summary() << "\n"
+            << "warnings " << result.warnings.size() << "\n"
+            << "link     " << linkStats.commands << " DLP commands, "
+            << QString::number(linkStats.utilization() * 100, 'f', 1) << "% busy, max queue wait "
+            << linkStats.maxQueueWaitUs / 1000 << " ms\n";
+        for (const SyncTiming &timing : result.timings) {
+            out << "timing   " << timing.summary() << "\n";
+        }
+    }
+    out.flush();
+
+    return exitCode;
+}
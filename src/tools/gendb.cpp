@@ -0,0 +1,102 @@
+/**
+ * @file gendb.cpp
+ * @brief qpilotsync-gendb: write synthetic Palm databases as .pdb files
+ *
+ *   qpilotsync-gendb --kind address --records 10000 --seed 7 -o /tmp/palm
+ *   qpilotsync-gendb --kind datebook --repeat 0.6 --exceptions 12 -o /tmp/palm
+ *
+ * The files load into KPilotMemoryLink (or install onto a device) for
+ * scale and stress testing.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTextStream>
+
+#include "palm/palmdbgenerator.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("qpilotsync-gendb");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate synthetic Palm databases (.pdb) for testing");
+    parser.addHelpOption();
+
+    QCommandLineOption kindOption("kind", "memo, address, datebook, todo or all (default: all)", "kind", "all");
+    QCommandLineOption recordsOption("records", "Records per database (default: 1000)", "n", "1000");
+    QCommandLineOption seedOption("seed", "Random seed (default: 1)", "seed", "1");
+    QCommandLineOption outputOption({"o", "output"}, "Output directory (default: .)", "dir", ".");
+    QCommandLineOption minTextOption("min-text", "Minimum free-text length", "chars");
+    QCommandLineOption maxTextOption("max-text", "Maximum free-text length", "chars");
+    QCommandLineOption cp1252Option("cp1252", "Ratio of accented (CP1252) words", "ratio");
+    QCommandLineOption unencodableOption("unencodable", "Ratio of words the Palm cannot encode", "ratio");
+    QCommandLineOption categoriesOption("categories", "Named categories, 1-16", "n");
+    QCommandLineOption dirtyOption("dirty", "Ratio of dirty records", "ratio");
+    QCommandLineOption deletedOption("deleted", "Ratio of deleted records", "ratio");
+    QCommandLineOption repeatOption("repeat", "Ratio of repeating events", "ratio");
+    QCommandLineOption exceptionsOption("exceptions", "Maximum exceptions per repeating event", "n");
+
+    parser.addOptions({kindOption, recordsOption, seedOption, outputOption,
+                       minTextOption, maxTextOption, cp1252Option, unencodableOption,
+                       categoriesOption, dirtyOption, deletedOption,
+                       repeatOption, exceptionsOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+    QTextStream out(stdout);
+
+    GeneratorOptions options;
+    options.records = parser.value(recordsOption).toInt();
+    options.seed = parser.value(seedOption).toUInt();
+    if (parser.isSet(minTextOption)) options.minTextLength = parser.value(minTextOption).toInt();
+    if (parser.isSet(maxTextOption)) options.maxTextLength = parser.value(maxTextOption).toInt();
+    if (parser.isSet(cp1252Option)) options.cp1252Ratio = parser.value(cp1252Option).toDouble();
+    if (parser.isSet(unencodableOption)) options.unencodableRatio = parser.value(unencodableOption).toDouble();
+    if (parser.isSet(categoriesOption)) options.categories = parser.value(categoriesOption).toInt();
+    if (parser.isSet(dirtyOption)) options.dirtyRatio = parser.value(dirtyOption).toDouble();
+    if (parser.isSet(deletedOption)) options.deletedRatio = parser.value(deletedOption).toDouble();
+    if (parser.isSet(repeatOption)) options.repeatRatio = parser.value(repeatOption).toDouble();
+    if (parser.isSet(exceptionsOption)) options.maxExceptions = parser.value(exceptionsOption).toInt();
+
+    QList<PalmDbGenerator::Kind> kinds;
+    QString kindName = parser.value(kindOption);
+    if (kindName == "all") {
+        kinds = PalmDbGenerator::allKinds();
+    } else {
+        PalmDbGenerator::Kind kind;
+        if (!PalmDbGenerator::kindFromName(kindName, &kind)) {
+            err << "Unknown database kind: " << kindName << Qt::endl;
+            return 2;
+        }
+        kinds << kind;
+    }
+
+    QDir outputDir(parser.value(outputOption));
+    if (!outputDir.mkpath(".")) {
+        err << "Cannot create output directory: " << outputDir.path() << Qt::endl;
+        return 1;
+    }
+
+    for (PalmDbGenerator::Kind kind : kinds) {
+        PalmDbGenerator generator(options);
+        MemoryDatabase db = generator.database(kind);
+
+        QString path = outputDir.filePath(db.name + ".pdb");
+        QString error;
+        if (!generator.writePdb(db, path, &error)) {
+            err << error << Qt::endl;
+            return 1;
+        }
+
+        qint64 bytes = 0;
+        for (const PilotRecord &record : db.records) {
+            bytes += record.size();
+        }
+        out << path << ": " << db.records.size() << " records, " << bytes << " bytes" << Qt::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file bench_categoryinfo.cpp
+ * @brief Benchmarks for CategoryInfo
+ *
+ * Conduits parse the category AppInfo block once per sync and look names
+ * up for every record, so lookups are measured alongside parse and pack.
+ */
+
+#include <QtTest/QtTest>
+#include "benchdata.h"
+#include "palm/categoryinfo.h"
+
+class BenchCategoryInfo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchParse();
+    void benchPack();
+    void benchNameLookup();
+    void benchIndexLookup();
+
+private:
+    static constexpr int BATCH = 1000;   ///< Operations per benchmark iteration
+
+    QByteArray m_block;
+};
+
+void BenchCategoryInfo::initTestCase()
+{
+    BenchData::silenceDebugOutput();
+    GeneratorOptions options = BenchData::options();
+    options.categories = 12;
+    m_block = PalmDbGenerator(options).appBlock();
+    QVERIFY(!m_block.isEmpty());
+}
+
+void BenchCategoryInfo::benchParse()
+{
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(m_block.constData());
+
+    QBENCHMARK {
+        for (int i = 0; i < BATCH; ++i) {
+            CategoryInfo info;
+            info.parse(data, m_block.size());
+        }
+    }
+}
+
+void BenchCategoryInfo::benchPack()
+{
+    CategoryInfo info;
+    QVERIFY(info.parse(reinterpret_cast<const unsigned char*>(m_block.constData()), m_block.size()));
+    QByteArray buffer(m_block.size(), '\0');
+
+    QBENCHMARK {
+        for (int i = 0; i < BATCH; ++i) {
+            info.pack(reinterpret_cast<unsigned char*>(buffer.data()), buffer.size());
+        }
+    }
+}
+
+void BenchCategoryInfo::benchNameLookup()
+{
+    CategoryInfo info;
+    QVERIFY(info.parse(reinterpret_cast<const unsigned char*>(m_block.constData()), m_block.size()));
+
+    QBENCHMARK {
+        for (int i = 0; i < BATCH; ++i) {
+            QString name = info.categoryName(i % CategoryInfo::MAX_CATEGORIES);
+            Q_UNUSED(name);
+        }
+    }
+}
+
+void BenchCategoryInfo::benchIndexLookup()
+{
+    CategoryInfo info;
+    QVERIFY(info.parse(reinterpret_cast<const unsigned char*>(m_block.constData()), m_block.size()));
+    const QStringList names = info.usedCategories();
+
+    QBENCHMARK {
+        for (int i = 0; i < BATCH; ++i) {
+            int index = info.categoryIndex(names.at(i % names.size()));
+            Q_UNUSED(index);
+        }
+    }
+}
+
+QTEST_MAIN(BenchCategoryInfo)
+#include "bench_categoryinfo.moc"
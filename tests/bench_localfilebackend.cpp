@@ -0,0 +1,96 @@
+/**
+ * @file bench_localfilebackend.cpp
+ * @brief Benchmarks for LocalFileBackend collection scans
+ *
+ * Measures loadRecords() (directory walk, read, hash) over collections of
+ * 1k, 10k and 100k Markdown memos. Each collection is written once and
+ * reused across iterations, so the numbers are for a warm page cache.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "benchdata.h"
+#include "sync/localfilebackend.h"
+
+using namespace Sync;
+
+class BenchLocalFileBackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchLoadRecords_data();
+    void benchLoadRecords();
+
+private:
+    /**
+     * @brief Base path of a backend whose "memos" collection holds @p count files
+     */
+    QString populatedBackend(int count);
+
+    QTemporaryDir *m_tempDir = nullptr;
+};
+
+void BenchLocalFileBackend::initTestCase()
+{
+    BenchData::silenceDebugOutput();
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void BenchLocalFileBackend::cleanupTestCase()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString BenchLocalFileBackend::populatedBackend(int count)
+{
+    QString basePath = m_tempDir->filePath(QString("files-%1").arg(count));
+    QDir memos(basePath + "/memos");
+    if (memos.exists()) {
+        return basePath;
+    }
+    memos.mkpath(".");
+
+    PalmDbGenerator generator(BenchData::options(count));
+    for (int i = 0; i < count; ++i) {
+        MemoMapper::Memo memo = generator.memo(i + 1);
+        QFile file(memos.filePath(QString("memo-%1.md").arg(i, 6, 10, QChar('0'))));
+        if (!file.open(QIODevice::WriteOnly)) {
+            return QString();
+        }
+        file.write(MemoMapper::memoToMarkdown(memo).toUtf8());
+    }
+    return basePath;
+}
+
+void BenchLocalFileBackend::benchLoadRecords_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchLocalFileBackend::benchLoadRecords()
+{
+    QFETCH(int, count);
+
+    QString basePath = populatedBackend(count);
+    QVERIFY(!basePath.isEmpty());
+    LocalFileBackend backend(basePath);
+
+    QBENCHMARK {
+        QList<BackendRecord*> records = backend.loadRecords("memos");
+        QCOMPARE(records.size(), count);
+        qDeleteAll(records);
+    }
+}
+
+QTEST_MAIN(BenchLocalFileBackend)
+#include "bench_localfilebackend.moc"
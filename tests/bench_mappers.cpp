@@ -0,0 +1,250 @@
+/**
+ * @file bench_mappers.cpp
+ * @brief Benchmarks for the four record mappers
+ *
+ * Measures packing to and unpacking from Palm records, and the text
+ * round trip (Markdown, vCard, iCalendar) for a fixed batch of synthetic
+ * records per iteration.
+ */
+
+#include <QtTest/QtTest>
+#include "benchdata.h"
+
+class BenchMappers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // ========== Memo ==========
+    void benchMemoPack();
+    void benchMemoUnpack();
+    void benchMemoMarkdownRoundTrip();
+
+    // ========== Contact ==========
+    void benchContactPack();
+    void benchContactUnpack();
+    void benchContactVCardRoundTrip();
+
+    // ========== Calendar ==========
+    void benchEventPack();
+    void benchEventUnpack();
+    void benchEventICalRoundTrip();
+
+    // ========== Todo ==========
+    void benchTodoPack();
+    void benchTodoUnpack();
+    void benchTodoICalRoundTrip();
+
+private:
+    static constexpr int BATCH = 200;   ///< Records per benchmark iteration
+};
+
+void BenchMappers::initTestCase()
+{
+    BenchData::silenceDebugOutput();
+}
+
+// ========== Memo ==========
+
+void BenchMappers::benchMemoPack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<MemoMapper::Memo> memos;
+    for (int i = 0; i < BATCH; ++i) {
+        memos << generator.memo(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const MemoMapper::Memo &memo : memos) {
+            delete MemoMapper::packMemo(memo);
+        }
+    }
+}
+
+void BenchMappers::benchMemoUnpack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<PilotRecord*> records;
+    for (int i = 0; i < BATCH; ++i) {
+        records << MemoMapper::packMemo(generator.memo(i + 1));
+    }
+
+    QBENCHMARK {
+        for (const PilotRecord *record : records) {
+            MemoMapper::Memo memo = MemoMapper::unpackMemo(record);
+            Q_UNUSED(memo);
+        }
+    }
+    qDeleteAll(records);
+}
+
+void BenchMappers::benchMemoMarkdownRoundTrip()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<MemoMapper::Memo> memos;
+    for (int i = 0; i < BATCH; ++i) {
+        memos << generator.memo(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const MemoMapper::Memo &memo : memos) {
+            MemoMapper::Memo parsed = MemoMapper::markdownToMemo(MemoMapper::memoToMarkdown(memo, "Business"));
+            Q_UNUSED(parsed);
+        }
+    }
+}
+
+// ========== Contact ==========
+
+void BenchMappers::benchContactPack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<ContactMapper::Contact> contacts;
+    for (int i = 0; i < BATCH; ++i) {
+        contacts << generator.contact(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const ContactMapper::Contact &contact : contacts) {
+            delete ContactMapper::packContact(contact);
+        }
+    }
+}
+
+void BenchMappers::benchContactUnpack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<PilotRecord*> records;
+    for (int i = 0; i < BATCH; ++i) {
+        records << ContactMapper::packContact(generator.contact(i + 1));
+    }
+
+    QBENCHMARK {
+        for (const PilotRecord *record : records) {
+            ContactMapper::Contact contact = ContactMapper::unpackContact(record);
+            Q_UNUSED(contact);
+        }
+    }
+    qDeleteAll(records);
+}
+
+void BenchMappers::benchContactVCardRoundTrip()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<ContactMapper::Contact> contacts;
+    for (int i = 0; i < BATCH; ++i) {
+        contacts << generator.contact(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const ContactMapper::Contact &contact : contacts) {
+            ContactMapper::Contact parsed = ContactMapper::vCardToContact(ContactMapper::contactToVCard(contact, "Business"));
+            Q_UNUSED(parsed);
+        }
+    }
+}
+
+// ========== Calendar ==========
+
+void BenchMappers::benchEventPack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<CalendarMapper::Event> events;
+    for (int i = 0; i < BATCH; ++i) {
+        events << generator.event(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const CalendarMapper::Event &event : events) {
+            delete CalendarMapper::packEvent(event);
+        }
+    }
+}
+
+void BenchMappers::benchEventUnpack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<PilotRecord*> records;
+    for (int i = 0; i < BATCH; ++i) {
+        records << CalendarMapper::packEvent(generator.event(i + 1));
+    }
+
+    QBENCHMARK {
+        for (const PilotRecord *record : records) {
+            CalendarMapper::Event event = CalendarMapper::unpackEvent(record);
+            Q_UNUSED(event);
+        }
+    }
+    qDeleteAll(records);
+}
+
+void BenchMappers::benchEventICalRoundTrip()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<CalendarMapper::Event> events;
+    for (int i = 0; i < BATCH; ++i) {
+        events << generator.event(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const CalendarMapper::Event &event : events) {
+            CalendarMapper::Event parsed = CalendarMapper::iCalToEvent(CalendarMapper::eventToICal(event, "Business"));
+            Q_UNUSED(parsed);
+        }
+    }
+}
+
+// ========== Todo ==========
+
+void BenchMappers::benchTodoPack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<TodoMapper::Todo> todos;
+    for (int i = 0; i < BATCH; ++i) {
+        todos << generator.todo(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const TodoMapper::Todo &todo : todos) {
+            delete TodoMapper::packTodo(todo);
+        }
+    }
+}
+
+void BenchMappers::benchTodoUnpack()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<PilotRecord*> records;
+    for (int i = 0; i < BATCH; ++i) {
+        records << TodoMapper::packTodo(generator.todo(i + 1));
+    }
+
+    QBENCHMARK {
+        for (const PilotRecord *record : records) {
+            TodoMapper::Todo todo = TodoMapper::unpackTodo(record);
+            Q_UNUSED(todo);
+        }
+    }
+    qDeleteAll(records);
+}
+
+void BenchMappers::benchTodoICalRoundTrip()
+{
+    PalmDbGenerator generator(BenchData::options());
+    QList<TodoMapper::Todo> todos;
+    for (int i = 0; i < BATCH; ++i) {
+        todos << generator.todo(i + 1);
+    }
+
+    QBENCHMARK {
+        for (const TodoMapper::Todo &todo : todos) {
+            TodoMapper::Todo parsed = TodoMapper::iCalToTodo(TodoMapper::todoToICal(todo, "Business"));
+            Q_UNUSED(parsed);
+        }
+    }
+}
+
+QTEST_MAIN(BenchMappers)
+#include "bench_mappers.moc"
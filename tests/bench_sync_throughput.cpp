@@ -0,0 +1,366 @@
+/**
+ * @file bench_sync_throughput.cpp
+ * @brief End-to-end sync throughput benchmark
+ *
+ * Runs SyncEngine::syncAll with the memo, contact, calendar and to-do
+ * conduits over KPilotMemoryLink (generated databases) and a temporary
+ * LocalFileBackend, for every SyncMode and several dataset sizes, and
+ * reports per run:
+ *
+ *   - records/s   Palm records in the synced databases per wall second
+ *   - bytes/s     DLP payload bytes (both directions) per wall second
+ *   - peak RSS    high-water mark of resident memory during the run
+ *   - allocs/rec  malloc/calloc/realloc calls per Palm record; Qt's
+ *                 strings and containers allocate there, not through
+ *                 operator new (operator new calls where glibc's
+ *                 allocator cannot be wrapped)
+ *
+ * Every run after "first" starts from a completed first sync, with a
+ * tenth of the Palm records dirty again. Comparing the same mode across
+ * sizes shows whether its cost grows linearly.
+ *
+ *   bench_sync_throughput [--sizes 100,1000,5000] [--modes first,hotsync,...]
+ *                         [--profile usb] [--json results.json]
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+
+#include "benchdata.h"
+#include "sync/syncengine.h"
+#include "sync/localfilebackend.h"
+#include "sync/conduits/memoconduit.h"
+#include "sync/conduits/contactconduit.h"
+#include "sync/conduits/calendarconduit.h"
+#include "sync/conduits/todoconduit.h"
+
+using namespace Sync;
+
+// ========== Allocation Counting ==========
+
+namespace {
+std::atomic<quint64> g_allocations{0};
+}
+
+#ifdef __GLIBC__
+
+// Defined here, these replace glibc's allocator entry points for the whole
+// process, Qt included; operator new ends up in malloc() as well
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *p, size_t size);
+
+void *malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+}
+
+namespace {
+const char *const ALLOCATION_COUNTER = "malloc";
+}
+
+#else
+
+namespace {
+const char *const ALLOCATION_COUNTER = "operator new";
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+#endif
+
+namespace {
+
+// ========== Memory ==========
+
+/**
+ * @brief Reset the kernel's peak RSS counter (Linux 4.0+), so each run
+ *        reports its own high-water mark
+ */
+void resetPeakRss()
+{
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+}
+
+qint64 peakRssKb()
+{
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray &line : status.readAll().split('\n')) {
+            if (line.startsWith("VmHWM:")) {
+                return line.mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+
+    // No procfs: process-lifetime peak
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// ========== Runs ==========
+
+struct Mode
+{
+    QString name;
+    SyncMode mode;
+    bool firstSync;   ///< Run on empty state instead of after a first sync
+};
+
+const QList<Mode> MODES = {
+    {"first", SyncMode::HotSync, true},
+    {"hotsync", SyncMode::HotSync, false},
+    {"fullsync", SyncMode::FullSync, false},
+    {"palmtopc", SyncMode::CopyPalmToPC, false},
+    {"pctopalm", SyncMode::CopyPCToPalm, false},
+    {"backup", SyncMode::Backup, false},
+    {"restore", SyncMode::Restore, false},
+};
+
+struct RunResult
+{
+    QString mode;
+    int size = 0;
+    int records = 0;
+    bool success = false;
+    qint64 wallUs = 0;
+    qint64 dlpBytes = 0;
+    int dlpCalls = 0;
+    qint64 simulatedLinkUs = 0;
+    qint64 peakRssKb = 0;
+    quint64 allocations = 0;
+    QList<SyncTiming> timings;
+
+    double recordsPerSecond() const { return wallUs > 0 ? records * 1e6 / wallUs : 0.0; }
+    double bytesPerSecond() const { return wallUs > 0 ? dlpBytes * 1e6 / wallUs : 0.0; }
+    double allocationsPerRecord() const { return records > 0 ? double(allocations) / records : 0.0; }
+};
+
+/**
+ * @brief Load the generated databases, with every @p dirtyEvery-th record dirty
+ *
+ * Contents only depend on the size, so reloading after a first sync
+ * presents the same records with some of them edited on the handheld.
+ */
+void addDatabases(KPilotMemoryLink &link, int size, int dirtyEvery)
+{
+    for (PalmDbGenerator::Kind kind : PalmDbGenerator::allKinds()) {
+        MemoryDatabase db = PalmDbGenerator(BenchData::options(size)).database(kind);
+        if (dirtyEvery > 0) {
+            for (int i = 0; i < db.records.size(); i += dirtyEvery) {
+                db.records[i].setAttributes(db.records[i].attributes() | PilotRecord::AttrDirty);
+            }
+        }
+        link.addDatabase(db);
+    }
+}
+
+void setUpEngine(SyncEngine &engine, KPilotMemoryLink &link, const QString &root)
+{
+    engine.setStateDirectory(root + "/state");
+    engine.setBackend(new LocalFileBackend(root + "/data"));
+    engine.setConflictPolicy(ConflictResolution::PalmWins);
+    engine.registerConduit(new MemoConduit());
+    engine.registerConduit(new ContactConduit());
+    engine.registerConduit(new CalendarConduit());
+    engine.registerConduit(new TodoConduit());
+    engine.setDeviceLink(&link);
+}
+
+RunResult runOnce(const Mode &mode, int size, const LinkProfile &profile)
+{
+    QTemporaryDir dir;
+    KPilotMemoryLink link;
+    link.setLinkProfile(profile);
+    link.openConnection();
+
+    SyncEngine engine;
+    setUpEngine(engine, link, dir.path());
+
+    // Every Palm record is new on a first sync, so start clean; later
+    // modes run on top of a completed first sync with fresh edits
+    addDatabases(link, size, 0);
+    if (!mode.firstSync) {
+        engine.syncAll(SyncMode::HotSync);
+        addDatabases(link, size, 10);
+    }
+
+    RunResult result;
+    result.mode = mode.name;
+    result.size = size;
+    result.records = size * PalmDbGenerator::allKinds().size();
+
+    KPilotLink::Traffic before = link.traffic();
+    qint64 simulatedBefore = link.stats().simulatedUs;
+    resetPeakRss();
+    quint64 allocationsBefore = g_allocations.load();
+    QElapsedTimer timer;
+    timer.start();
+
+    SyncResult sync = engine.syncAll(mode.mode);
+
+    result.wallUs = timer.nsecsElapsed() / 1000;
+    result.allocations = g_allocations.load() - allocationsBefore;
+    result.peakRssKb = peakRssKb();
+
+    KPilotLink::Traffic after = link.traffic();
+    result.dlpCalls = after.calls - before.calls;
+    result.dlpBytes = (after.bytesSent - before.bytesSent) + (after.bytesReceived - before.bytesReceived);
+    result.simulatedLinkUs = link.stats().simulatedUs - simulatedBefore;
+    result.success = sync.success;
+    result.timings = sync.timings;
+    return result;
+}
+
+QJsonObject toJson(const RunResult &run)
+{
+    QJsonObject phases;
+    for (int i = 0; i < SyncPhaseCount; ++i) {
+        qint64 us = 0;
+        for (const SyncTiming &timing : run.timings) {
+            us += timing.phaseUs[i];
+        }
+        phases[syncPhaseName(static_cast<SyncPhase>(i))] = us;
+    }
+
+    QJsonObject obj;
+    obj["mode"] = run.mode;
+    obj["size"] = run.size;
+    obj["records"] = run.records;
+    obj["success"] = run.success;
+    obj["wallUs"] = run.wallUs;
+    obj["recordsPerSecond"] = run.recordsPerSecond();
+    obj["dlpCalls"] = run.dlpCalls;
+    obj["dlpBytes"] = run.dlpBytes;
+    obj["bytesPerSecond"] = run.bytesPerSecond();
+    obj["simulatedLinkUs"] = run.simulatedLinkUs;
+    obj["peakRssKb"] = run.peakRssKb;
+    obj["allocations"] = qint64(run.allocations);
+    obj["allocationsPerRecord"] = run.allocationsPerRecord();
+    obj["phaseUs"] = phases;
+    return obj;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("bench_sync_throughput");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end SyncEngine throughput over a simulated device");
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Records per database, comma separated", "list", "100,1000,5000");
+    QCommandLineOption modesOption("modes", "Modes to run, comma separated (default: all)", "list");
+    QCommandLineOption profileOption("profile", "Link profile: instant, serial, usb, network", "name", "instant");
+    QCommandLineOption jsonOption("json", "Also write results as JSON to <file>", "file");
+    parser.addOptions({sizesOption, modesOption, profileOption, jsonOption});
+    parser.process(app);
+
+    BenchData::silenceDebugOutput();
+
+    QList<int> sizes;
+    for (const QString &size : parser.value(sizesOption).split(',', Qt::SkipEmptyParts)) {
+        sizes << size.toInt();
+    }
+    QStringList modeNames = parser.value(modesOption).split(',', Qt::SkipEmptyParts);
+    LinkProfile profile = LinkProfile::fromName(parser.value(profileOption));
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+        .arg("mode", -9).arg("size", 6).arg("records", 8).arg("wall ms", 9)
+        .arg("rec/s", 10).arg("KB/s", 9).arg("peak MB", 8).arg("allocs/rec", 10);
+    out.flush();
+
+    QJsonArray runs;
+    bool allSucceeded = true;
+    for (const Mode &mode : MODES) {
+        if (!modeNames.isEmpty() && !modeNames.contains(mode.name)) {
+            continue;
+        }
+        for (int size : sizes) {
+            RunResult run = runOnce(mode, size, profile);
+            allSucceeded = allSucceeded && run.success;
+            runs.append(toJson(run));
+
+            out << QString("%1 %2 %3 %4 %5 %6 %7 %8%9\n")
+                .arg(run.mode, -9)
+                .arg(run.size, 6)
+                .arg(run.records, 8)
+                .arg(run.wallUs / 1000.0, 9, 'f', 1)
+                .arg(run.recordsPerSecond(), 10, 'f', 0)
+                .arg(run.bytesPerSecond() / 1024.0, 9, 'f', 1)
+                .arg(run.peakRssKb / 1024.0, 8, 'f', 1)
+                .arg(run.allocationsPerRecord(), 10, 'f', 0)
+                .arg(run.success ? "" : "  FAILED");
+            out.flush();
+        }
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject root;
+        root["benchmark"] = "sync_throughput";
+        root["seed"] = qint64(BenchData::SEED);
+        root["linkProfile"] = profile.name;
+        root["allocationCounter"] = ALLOCATION_COUNTER;
+        root["runs"] = runs;
+
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly)) {
+            QTextStream(stderr) << "Cannot write " << file.fileName() << Qt::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    }
+
+    return allSucceeded ? 0 : 1;
+}
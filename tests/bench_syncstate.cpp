@@ -0,0 +1,113 @@
+/**
+ * @file bench_syncstate.cpp
+ * @brief Benchmarks for SyncState persistence
+ *
+ * Measures save() and load() of mappings.json holding 10k and 100k ID
+ * mappings with a baseline hash for each.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include "benchdata.h"
+#include "sync/syncstate.h"
+
+using namespace Sync;
+
+class BenchSyncState : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchSave_data();
+    void benchSave();
+    void benchLoad_data();
+    void benchLoad();
+
+private:
+    /**
+     * @brief Fill @p state with @p count mappings and baseline hashes
+     */
+    static void populate(SyncState &state, int count);
+
+    QTemporaryDir *m_tempDir = nullptr;
+};
+
+void BenchSyncState::initTestCase()
+{
+    BenchData::silenceDebugOutput();
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void BenchSyncState::cleanupTestCase()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+void BenchSyncState::populate(SyncState &state, int count)
+{
+    QMap<QString, QString> hashes;
+    for (int i = 0; i < count; ++i) {
+        QString palmId = QString::number(0x100000 + i);
+        QString pcId = QString("/home/user/PalmSync/memos/memo-%1.md").arg(i, 6, 10, QChar('0'));
+        state.mapIds(palmId, pcId);
+        state.updateCategories(palmId, "Business", {"Business"});
+        hashes[pcId] = QString::fromLatin1(QCryptographicHash::hash(pcId.toUtf8(), QCryptographicHash::Sha256).toHex());
+    }
+    state.saveBaseline(hashes);
+}
+
+void BenchSyncState::benchSave_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchSyncState::benchSave()
+{
+    QFETCH(int, count);
+
+    SyncState state("bench", QString("save-%1").arg(count));
+    state.setStateDirectory(m_tempDir->path());
+    populate(state, count);
+
+    QBENCHMARK {
+        QVERIFY(state.save());
+    }
+}
+
+void BenchSyncState::benchLoad_data()
+{
+    benchSave_data();
+}
+
+void BenchSyncState::benchLoad()
+{
+    QFETCH(int, count);
+
+    QString conduitId = QString("load-%1").arg(count);
+    {
+        SyncState state("bench", conduitId);
+        state.setStateDirectory(m_tempDir->path());
+        populate(state, count);
+        QVERIFY(state.save());
+    }
+
+    SyncState state("bench", conduitId);
+    state.setStateDirectory(m_tempDir->path());
+
+    QBENCHMARK {
+        QVERIFY(state.load());
+    }
+    QCOMPARE(state.allPalmIds().size(), count);
+}
+
+QTEST_MAIN(BenchSyncState)
+#include "bench_syncstate.moc"
@@ -0,0 +1,49 @@
+/**
+ * @file benchdata.h
+ * @brief Shared setup for the bench_* benchmarks
+ *
+ * Benchmark data comes from PalmDbGenerator with a fixed seed, so every
+ * run works on the same records and results stay comparable over time.
+ */
+
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QtGlobal>
+#include <QString>
+#include <cstdio>
+
+#include "palm/palmdbgenerator.h"
+
+namespace BenchData {
+
+constexpr quint32 SEED = 0x51505331;   // "QPS1"
+
+/**
+ * @brief Generator options every benchmark starts from
+ */
+inline GeneratorOptions options(int records = 1000)
+{
+    GeneratorOptions options;
+    options.seed = SEED;
+    options.records = records;
+    options.cp1252Ratio = 0.1;
+    options.repeatRatio = 0.3;
+    return options;
+}
+
+/**
+ * @brief Drop qDebug() output; per-record tracing would dominate the timings
+ */
+inline void silenceDebugOutput()
+{
+    qInstallMessageHandler([](QtMsgType type, const QMessageLogContext &, const QString &msg) {
+        if (type != QtDebugMsg && type != QtInfoMsg) {
+            fprintf(stderr, "%s\n", qPrintable(msg));
+        }
+    });
+}
+
+} // namespace BenchData
+
+#endif // BENCHDATA_H
@@ -0,0 +1,233 @@
+/**
+ * @file test_backupconduit.cpp
+ * @brief Unit tests for BackupConduit
+ *
+ * Tests image naming, the incremental check against the Palm's database
+ * headers, pruning of databases deleted from the Palm and cancelling.
+ * Current images are skipped before the socket is touched, so no device
+ * is needed.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryDir>
+#include <pi-dlp.h>
+#include <pi-file.h>
+#include "palm/palmdbgenerator.h"
+#include "sync/conduits/backupconduit.h"
+
+using namespace Sync;
+
+class TestBackupConduit : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Naming Tests ==========
+    void testImageFileName();
+    void testImagesIndexedByDatabaseName();
+
+    // ========== Incremental Tests ==========
+    void testUnchangedImage();
+    void testChangedDatabaseNotUnchanged();
+    void testCurrentImageSkipped();
+
+    // ========== Pruning Tests ==========
+    void testRemovedDatabasePruned();
+    void testPruneDisabled();
+
+    // ========== Cancellation Tests ==========
+    void testCancelStopsBeforeNextDatabase();
+
+private:
+    QString writeImage(const QString &fileName, PalmDbGenerator::Kind kind) const;
+    DBInfo imageInfo(const QString &path) const;
+    DBInfo namedInfo(const char *name, bool resource) const;
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestBackupConduit::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestBackupConduit::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestBackupConduit::writeImage(const QString &fileName, PalmDbGenerator::Kind kind) const
+{
+    GeneratorOptions options;
+    options.records = 20;
+    PalmDbGenerator generator(options);
+
+    QDir().mkpath(m_tempDir->filePath("device-backup"));
+    QString path = m_tempDir->filePath("device-backup/" + fileName);
+    QString error;
+    if (!generator.writePdb(generator.database(kind), path, &error)) {
+        qWarning() << error;
+    }
+    return path;
+}
+
+DBInfo TestBackupConduit::imageInfo(const QString &path) const
+{
+    DBInfo info;
+    memset(&info, 0, sizeof(info));
+    pi_file_t *pf = pi_file_open(QFile::encodeName(path).constData());
+    if (pf) {
+        pi_file_get_info(pf, &info);
+        pi_file_close(pf);
+    }
+    return info;
+}
+
+DBInfo TestBackupConduit::namedInfo(const char *name, bool resource) const
+{
+    DBInfo info;
+    memset(&info, 0, sizeof(info));
+    strncpy(info.name, name, sizeof(info.name) - 1);
+    if (resource) {
+        info.flags = dlpDBFlagResource;
+    }
+    return info;
+}
+
+// ========== Naming Tests ==========
+
+void TestBackupConduit::testImageFileName()
+{
+    QCOMPARE(BackupConduit::imageFileName(namedInfo("MemoDB", false)), QString("MemoDB.pdb"));
+    QCOMPARE(BackupConduit::imageFileName(namedInfo("Graffiti ShortCuts", false)),
+             QString("Graffiti ShortCuts.pdb"));
+    QCOMPARE(BackupConduit::imageFileName(namedInfo("AvantGo", true)), QString("AvantGo.prc"));
+    QCOMPARE(BackupConduit::imageFileName(namedInfo("Saved/Prefs", false)), QString("Saved%2FPrefs.pdb"));
+    QCOMPARE(BackupConduit::imageFileName(namedInfo("100%", false)), QString("100%25.pdb"));
+}
+
+void TestBackupConduit::testImagesIndexedByDatabaseName()
+{
+    QString memo = writeImage("a.pdb", PalmDbGenerator::Memo);
+    QString todo = writeImage("b.pdb", PalmDbGenerator::Todo);
+
+    BackupConduit conduit;
+    conduit.setBackupFolder(m_tempDir->filePath("device-backup"));
+
+    QMap<QString, QString> images = conduit.images();
+    QCOMPARE(images.size(), 2);
+    QCOMPARE(QFileInfo(images.value("MemoDB")), QFileInfo(memo));
+    QCOMPARE(QFileInfo(images.value("ToDoDB")), QFileInfo(todo));
+}
+
+// ========== Incremental Tests ==========
+
+void TestBackupConduit::testUnchangedImage()
+{
+    QString path = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    DBInfo device = imageInfo(path);
+    device.index = 12;   // Position on the Palm does not matter
+
+    QVERIFY(BackupConduit::isUnchanged(device, path));
+    QVERIFY(!BackupConduit::isUnchanged(device, m_tempDir->filePath("missing.pdb")));
+}
+
+void TestBackupConduit::testChangedDatabaseNotUnchanged()
+{
+    QString path = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    DBInfo image = imageInfo(path);
+
+    DBInfo device = image;
+    device.modnum = image.modnum + 1;
+    QVERIFY(!BackupConduit::isUnchanged(device, path));
+
+    device = image;
+    device.modifyDate = image.modifyDate + 60;
+    QVERIFY(!BackupConduit::isUnchanged(device, path));
+
+    device = image;
+    device.flags |= dlpDBFlagResource;
+    QVERIFY(!BackupConduit::isUnchanged(device, path));
+}
+
+void TestBackupConduit::testCurrentImageSkipped()
+{
+    QString path = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    QDateTime written = QFileInfo(path).lastModified();
+
+    BackupConduit conduit;
+    conduit.setBackupFolder(m_tempDir->filePath("device-backup"));
+
+    // No socket: a current image must not be retrieved again
+    QList<BackupResult> results = conduit.backupAll(-1, {imageInfo(path)});
+    QCOMPARE(results.size(), 1);
+    QVERIFY(results.first().success);
+    QVERIFY(results.first().skipped);
+    QCOMPARE(results.first().databaseName, QString("MemoDB"));
+    QCOMPARE(QFileInfo(path).lastModified(), written);
+}
+
+// ========== Pruning Tests ==========
+
+void TestBackupConduit::testRemovedDatabasePruned()
+{
+    QString memo = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    QString todo = writeImage("ToDoDB.pdb", PalmDbGenerator::Todo);
+
+    BackupConduit conduit;
+    conduit.setBackupFolder(m_tempDir->filePath("device-backup"));
+
+    // ToDoDB is gone from the Palm
+    QList<BackupResult> results = conduit.backupAll(-1, {imageInfo(memo)});
+    QCOMPARE(results.size(), 1);
+    QVERIFY(QFile::exists(memo));
+    QVERIFY(!QFile::exists(todo));
+    QVERIFY(QFile::exists(m_tempDir->filePath("device-backup/removed/ToDoDB.pdb")));
+}
+
+void TestBackupConduit::testPruneDisabled()
+{
+    QString memo = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    QString todo = writeImage("ToDoDB.pdb", PalmDbGenerator::Todo);
+
+    BackupConduit conduit;
+    conduit.setBackupFolder(m_tempDir->filePath("device-backup"));
+    conduit.setPruneRemoved(false);
+
+    conduit.backupAll(-1, {imageInfo(memo)});
+    QVERIFY(QFile::exists(todo));
+}
+
+// ========== Cancellation Tests ==========
+
+void TestBackupConduit::testCancelStopsBeforeNextDatabase()
+{
+    QString memo = writeImage("MemoDB.pdb", PalmDbGenerator::Memo);
+    QString todo = writeImage("ToDoDB.pdb", PalmDbGenerator::Todo);
+    QString address = writeImage("AddressDB.pdb", PalmDbGenerator::Address);
+
+    BackupConduit conduit;
+    conduit.setBackupFolder(m_tempDir->filePath("device-backup"));
+
+    // Cancelled once the first database is done
+    int checks = 0;
+    conduit.setCancelCheck([&checks]() { return ++checks > 1; });
+
+    QList<BackupResult> results = conduit.backupAll(-1, {imageInfo(memo), imageInfo(todo)});
+    QCOMPARE(results.size(), 1);
+    QCOMPARE(results.first().databaseName, QString("MemoDB"));
+
+    // Not every database was listed, so none is taken as removed
+    QVERIFY(QFile::exists(todo));
+    QVERIFY(QFile::exists(address));
+}
+
+QTEST_MAIN(TestBackupConduit)
+#include "test_backupconduit.moc"
@@ -0,0 +1,170 @@
+/**
+ * @file test_devicewatcher.cpp
+ * @brief Unit tests for DeviceWatcher
+ *
+ * Tests that nodes are reported when they are created and removed,
+ * including below directories that do not exist yet. Plain files in a
+ * temporary directory stand in for /dev nodes.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "palm/devicewatcher.h"
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+class TestDeviceWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testPseudoDevices();
+    void testExistingNodeIsPresent();
+    void testAppearAndRemove();
+    void testNodeBelowMissingDirectory();
+    void testNodeAppearsOncePermitted();
+    void testStopSilencesWatcher();
+
+private:
+    bool touch(const QString &path) const;
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestDeviceWatcher::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestDeviceWatcher::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+bool TestDeviceWatcher::touch(const QString &path) const
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly);
+}
+
+void TestDeviceWatcher::testPseudoDevices()
+{
+    QVERIFY(DeviceWatcher::isPseudoDevice("usb:"));
+    QVERIFY(DeviceWatcher::isPseudoDevice("net:any"));
+    QVERIFY(!DeviceWatcher::isPseudoDevice("/dev/ttyUSB0"));
+
+    DeviceWatcher watcher;
+    watcher.watch("usb:");
+    QVERIFY(watcher.isPresent());
+}
+
+void TestDeviceWatcher::testExistingNodeIsPresent()
+{
+    QString node = m_tempDir->filePath("ttyUSB0");
+    QVERIFY(touch(node));
+
+    DeviceWatcher watcher;
+    QSignalSpy appearedSpy(&watcher, &DeviceWatcher::deviceAppeared);
+    watcher.watch(node);
+
+    QVERIFY(watcher.isWatching());
+    QVERIFY(watcher.isPresent());
+    QTest::qWait(50);
+    QCOMPARE(appearedSpy.count(), 0);
+}
+
+void TestDeviceWatcher::testAppearAndRemove()
+{
+    QString node = m_tempDir->filePath("ttyUSB1");
+
+    DeviceWatcher watcher;
+    QSignalSpy appearedSpy(&watcher, &DeviceWatcher::deviceAppeared);
+    QSignalSpy removedSpy(&watcher, &DeviceWatcher::deviceRemoved);
+    watcher.watch(node);
+    QVERIFY(!watcher.isPresent());
+#ifdef Q_OS_LINUX
+    QVERIFY(watcher.isEventDriven());
+#endif
+
+    // Unrelated nodes do not count
+    QVERIFY(touch(m_tempDir->filePath("ttyS0")));
+    QTest::qWait(50);
+    QCOMPARE(appearedSpy.count(), 0);
+
+    QVERIFY(touch(node));
+    QTRY_COMPARE(appearedSpy.count(), 1);
+    QCOMPARE(appearedSpy.at(0).at(0).toString(), node);
+    QVERIFY(watcher.isPresent());
+
+    QVERIFY(QFile::remove(node));
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QVERIFY(!watcher.isPresent());
+}
+
+void TestDeviceWatcher::testNodeBelowMissingDirectory()
+{
+    // Like /dev/serial/by-id/..., which udev creates with the first adapter
+    QString node = m_tempDir->filePath("serial/by-id/usb-Palm_Handheld-if00");
+
+    DeviceWatcher watcher;
+    QSignalSpy appearedSpy(&watcher, &DeviceWatcher::deviceAppeared);
+    watcher.watch(node);
+
+    QVERIFY(QDir(m_tempDir->path()).mkpath("serial/by-id"));
+    QTest::qWait(50);
+    QVERIFY(touch(node));
+    QTRY_COMPARE(appearedSpy.count(), 1);
+}
+
+void TestDeviceWatcher::testNodeAppearsOncePermitted()
+{
+#ifdef Q_OS_UNIX
+    if (geteuid() == 0) {
+        QSKIP("root may open any node");
+    }
+#endif
+    QString node = m_tempDir->filePath("ttyUSB3");
+
+    DeviceWatcher watcher;
+    QSignalSpy appearedSpy(&watcher, &DeviceWatcher::deviceAppeared);
+    watcher.watch(node);
+
+    // udev creates the node root-only, then fixes its mode
+    QVERIFY(touch(node));
+    QVERIFY(QFile::setPermissions(node, QFileDevice::Permissions()));
+    QTest::qWait(100);
+    QCOMPARE(appearedSpy.count(), 0);
+    QVERIFY(!watcher.isPresent());
+
+    QVERIFY(QFile::setPermissions(node, QFileDevice::ReadOwner | QFileDevice::WriteOwner));
+    QTRY_COMPARE(appearedSpy.count(), 1);
+    QVERIFY(watcher.isPresent());
+}
+
+void TestDeviceWatcher::testStopSilencesWatcher()
+{
+    QString node = m_tempDir->filePath("ttyUSB2");
+
+    DeviceWatcher watcher;
+    QSignalSpy appearedSpy(&watcher, &DeviceWatcher::deviceAppeared);
+    watcher.watch(node);
+    watcher.stop();
+    QVERIFY(!watcher.isWatching());
+
+    QVERIFY(touch(node));
+    QTest::qWait(100);
+    QCOMPARE(appearedSpy.count(), 0);
+}
+
+QTEST_MAIN(TestDeviceWatcher)
+#include "test_devicewatcher.moc"
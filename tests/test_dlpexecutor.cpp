@@ -0,0 +1,171 @@
+/**
+ * @file test_dlpexecutor.cpp
+ * @brief Unit tests for DlpExecutor
+ *
+ * Tests that commands run one at a time on a single thread, that queued
+ * commands are taken by priority, and that utilization is measured.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QSemaphore>
+#include <QThread>
+#include "palm/dlpexecutor.h"
+
+class TestDlpExecutor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSubmitReturnsResult();
+    void testRunWaitsForResult();
+    void testCommandsShareOneThread();
+    void testNestedRunExecutesInline();
+    void testPriorityOrder();
+    void testIdleWhileNothingQueued();
+    void testStatsMeasureUtilization();
+    void testDestructorDrainsQueue();
+};
+
+void TestDlpExecutor::testSubmitReturnsResult()
+{
+    DlpExecutor executor;
+    QFuture<int> future = executor.submit(DlpExecutor::Priority::Sync, []() { return 42; });
+    QCOMPARE(future.result(), 42);
+}
+
+void TestDlpExecutor::testRunWaitsForResult()
+{
+    DlpExecutor executor;
+    QString result = executor.run(DlpExecutor::Priority::Sync, []() {
+        QThread::msleep(20);
+        return QString("done");
+    });
+    QCOMPARE(result, QString("done"));
+
+    bool ran = false;
+    executor.run(DlpExecutor::Priority::KeepAlive, [&ran]() { ran = true; });
+    QVERIFY(ran);
+}
+
+void TestDlpExecutor::testCommandsShareOneThread()
+{
+    DlpExecutor executor;
+    QSet<QThread*> threads;
+    QMutex mutex;
+
+    // Callers on several threads still end up on the executor's thread
+    QList<QThread*> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.append(QThread::create([&]() {
+            for (int j = 0; j < 10; ++j) {
+                executor.run(DlpExecutor::Priority::Sync, [&]() {
+                    QMutexLocker locker(&mutex);
+                    threads.insert(QThread::currentThread());
+                });
+            }
+        }));
+        callers.last()->start();
+    }
+    for (QThread *caller : callers) {
+        QVERIFY(caller->wait(5000));
+        delete caller;
+    }
+
+    QCOMPARE(threads.size(), 1);
+    QVERIFY(!threads.contains(QThread::currentThread()));
+    QCOMPARE(executor.stats().commands, 40);
+}
+
+void TestDlpExecutor::testNestedRunExecutesInline()
+{
+    DlpExecutor executor;
+    bool onExecutor = false;
+    int result = executor.run(DlpExecutor::Priority::Sync, [&]() {
+        onExecutor = executor.isExecutorThread();
+        // Would deadlock if it were queued behind the running command
+        return executor.run(DlpExecutor::Priority::KeepAlive, []() { return 7; }) + 1;
+    });
+    QVERIFY(onExecutor);
+    QCOMPARE(result, 8);
+    QVERIFY(!executor.isExecutorThread());
+}
+
+void TestDlpExecutor::testPriorityOrder()
+{
+    DlpExecutor executor;
+    QSemaphore held;
+    QSemaphore release;
+
+    // Keep the executor busy while the others queue up
+    QFuture<void> blocker = executor.submit(DlpExecutor::Priority::Sync, [&]() {
+        held.release();
+        release.acquire();
+    });
+    QVERIFY(held.tryAcquire(1, 5000));
+
+    QStringList order;
+    QFuture<void> keepAlive = executor.submit(DlpExecutor::Priority::KeepAlive,
+                                              [&order]() { order << "keepalive"; });
+    QFuture<void> install = executor.submit(DlpExecutor::Priority::Install,
+                                            [&order]() { order << "install"; });
+    QFuture<void> sync = executor.submit(DlpExecutor::Priority::Sync,
+                                         [&order]() { order << "sync"; });
+    QVERIFY(!executor.isIdle());
+
+    release.release();
+    blocker.waitForFinished();
+    keepAlive.waitForFinished();
+    install.waitForFinished();
+    sync.waitForFinished();
+
+    QCOMPARE(order, QStringList({"sync", "install", "keepalive"}));
+}
+
+void TestDlpExecutor::testIdleWhileNothingQueued()
+{
+    DlpExecutor executor;
+    QVERIFY(executor.isIdle());
+
+    executor.run(DlpExecutor::Priority::Sync, []() {});
+    QVERIFY(executor.isIdle());
+    QVERIFY(executor.idleMs() < 1000);
+}
+
+void TestDlpExecutor::testStatsMeasureUtilization()
+{
+    DlpExecutor executor;
+    executor.run(DlpExecutor::Priority::Sync, []() { QThread::msleep(30); });
+    executor.run(DlpExecutor::Priority::Install, []() { QThread::msleep(30); });
+    executor.run(DlpExecutor::Priority::KeepAlive, []() {});
+
+    DlpExecutor::Stats stats = executor.stats();
+    QCOMPARE(stats.commands, 3);
+    QCOMPARE(stats.perPriority[int(DlpExecutor::Priority::Sync)], 1);
+    QCOMPARE(stats.perPriority[int(DlpExecutor::Priority::Install)], 1);
+    QCOMPARE(stats.perPriority[int(DlpExecutor::Priority::KeepAlive)], 1);
+    QVERIFY(stats.busyUs >= 60000);
+    QVERIFY(stats.utilization() > 0.0);
+    QVERIFY(stats.utilization() <= 1.0);
+
+    executor.resetStats();
+    QCOMPARE(executor.stats().commands, 0);
+}
+
+void TestDlpExecutor::testDestructorDrainsQueue()
+{
+    int ran = 0;
+    {
+        DlpExecutor executor;
+        for (int i = 0; i < 5; ++i) {
+            executor.submit(DlpExecutor::Priority::KeepAlive, [&ran]() {
+                QThread::msleep(5);
+                ++ran;
+            });
+        }
+    }
+    QCOMPARE(ran, 5);
+}
+
+QTEST_MAIN(TestDlpExecutor)
+#include "test_dlpexecutor.moc"
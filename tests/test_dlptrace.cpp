@@ -0,0 +1,356 @@
+/**
+ * @file test_dlptrace.cpp
+ * @brief Unit tests for DLP wire traces and KPilotReplayLink
+ *
+ * Tests the binary trace format round trip and replaying a recorded
+ * call sequence through the KPilotLink interface.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+#include <pi-dlp.h>
+#include "palm/dlptrace.h"
+#include "palm/kpilotdevicelink.h"
+#include "palm/kpilotreplaylink.h"
+#include "palm/pilotrecord.h"
+
+class TestDlpTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Trace File Tests ==========
+    void testRoundTrip();
+    void testPayloadsDroppedByDefault();
+    void testPayloadsKeptWhenRequested();
+    void testRejectsNonTrace();
+    void testTruncatedTraceKeepsCompleteCalls();
+    void testRawCallsRecorded();
+
+    // ========== Replay Tests ==========
+    void testReplayReadAllRecords();
+    void testReplayZeroFillsMissingPayloads();
+    void testReplayWriteRecordAssignsRecordedId();
+    void testReplayFailedCall();
+    void testReplayCountsDivergences();
+    void testReplaySkipsOutOfBandCalls();
+    void testReplayLatencyTotal();
+    void testReplayFromFile();
+
+private:
+    /**
+     * @brief Calls KPilotDeviceLink makes to read a two-record MemoDB
+     */
+    QList<DlpTraceEntry> memoReadTrace() const;
+    QString writeTrace(const QList<DlpTraceEntry> &entries, bool payloads);
+
+    QTemporaryDir *m_tempDir;
+};
+
+QList<DlpTraceEntry> TestDlpTrace::memoReadTrace() const
+{
+    QList<DlpTraceEntry> entries;
+
+    DlpTraceEntry user(DlpCall::ReadUserInfo, 0);
+    user.recordId = 1234;
+    user.payload = "Jane Palm";
+    user.latencyUs = 4000;
+    entries << user;
+
+    DlpTraceEntry open(DlpCall::OpenDB, 0);
+    open.name = "MemoDB";
+    open.handle = 3;
+    open.latencyUs = 6000;
+    entries << open;
+
+    for (int i = 0; i < 2; ++i) {
+        DlpTraceEntry read(DlpCall::ReadRecordByIndex, 0);
+        read.handle = 3;
+        read.index = i;
+        read.recordId = 0x5000 + i;
+        read.category = 1;
+        read.attributes = PilotRecord::AttrDirty;
+        read.payload = QByteArray("memo text\0", 10);
+        read.bytesReceived = read.payload.size();
+        read.latencyUs = 9000;
+        entries << read;
+    }
+
+    DlpTraceEntry end(DlpCall::ReadRecordByIndex, -5);
+    end.handle = 3;
+    end.index = 2;
+    end.latencyUs = 3000;
+    entries << end;
+
+    DlpTraceEntry close(DlpCall::CloseDB, 0);
+    close.handle = 3;
+    close.latencyUs = 2000;
+    entries << close;
+
+    return entries;
+}
+
+QString TestDlpTrace::writeTrace(const QList<DlpTraceEntry> &entries, bool payloads)
+{
+    QString path = m_tempDir->filePath(payloads ? "full.qpdt" : "sizes.qpdt");
+
+    DlpTraceHeader header;
+    header.recorded = QDateTime(QDate(2026, 3, 1), QTime(12, 0));
+    header.devicePath = "usb:";
+    header.includesPayloads = payloads;
+
+    DlpTraceWriter writer;
+    if (!writer.open(path, header)) {
+        return QString();
+    }
+    for (const DlpTraceEntry &entry : entries) {
+        writer.record(entry);
+    }
+    writer.close();
+    return path;
+}
+
+void TestDlpTrace::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestDlpTrace::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+// ========== Trace File Tests ==========
+
+void TestDlpTrace::testRoundTrip()
+{
+    QList<DlpTraceEntry> entries = memoReadTrace();
+    QString path = writeTrace(entries, true);
+    QVERIFY(!path.isEmpty());
+
+    DlpTraceReader reader;
+    QVERIFY(reader.load(path));
+    QCOMPARE(reader.header().devicePath, QString("usb:"));
+    QCOMPARE(reader.header().recorded, QDateTime(QDate(2026, 3, 1), QTime(12, 0)));
+    QCOMPARE(reader.entries().size(), entries.size());
+
+    DlpTraceEntry read = reader.entries().at(2);
+    QCOMPARE(read.call, DlpCall::ReadRecordByIndex);
+    QCOMPARE(read.handle, 3);
+    QCOMPARE(read.recordId, 0x5000u);
+    QCOMPARE(read.category, quint8(1));
+    QCOMPARE(read.attributes, quint8(PilotRecord::AttrDirty));
+    QCOMPARE(read.bytesReceived, 10u);
+    QCOMPARE(read.latencyUs, 9000u);
+
+    QCOMPARE(reader.entries().at(1).name, QByteArray("MemoDB"));
+    QVERIFY(reader.entries().at(4).failed());
+}
+
+void TestDlpTrace::testPayloadsDroppedByDefault()
+{
+    DlpTraceReader reader;
+    QVERIFY(reader.load(writeTrace(memoReadTrace(), false)));
+    QVERIFY(!reader.header().includesPayloads);
+
+    DlpTraceEntry read = reader.entries().at(2);
+    QVERIFY(read.payload.isEmpty());
+    QCOMPARE(read.bytesReceived, 10u);          // Size survives
+    QVERIFY(reader.entries().at(0).payload.isEmpty());  // User name is personal data too
+}
+
+void TestDlpTrace::testPayloadsKeptWhenRequested()
+{
+    DlpTraceReader reader;
+    QVERIFY(reader.load(writeTrace(memoReadTrace(), true)));
+    QVERIFY(reader.header().includesPayloads);
+    QCOMPARE(reader.entries().at(2).payload, QByteArray("memo text\0", 10));
+}
+
+void TestDlpTrace::testRejectsNonTrace()
+{
+    QString path = m_tempDir->filePath("bogus.qpdt");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("BEGIN:VCALENDAR\r\n");
+    file.close();
+
+    DlpTraceReader reader;
+    QVERIFY(!reader.load(path));
+    QVERIFY(!reader.errorString().isEmpty());
+    QVERIFY(!reader.load(m_tempDir->filePath("missing.qpdt")));
+}
+
+void TestDlpTrace::testTruncatedTraceKeepsCompleteCalls()
+{
+    QString path = writeTrace(memoReadTrace(), true);
+    QFile file(path);
+    QVERIFY(file.resize(file.size() - 3));   // Cut into the last call
+
+    DlpTraceReader reader;
+    QVERIFY(reader.load(path));
+    QCOMPARE(reader.entries().size(), memoReadTrace().size() - 1);
+}
+
+// ========== Replay Tests ==========
+
+void TestDlpTrace::testReplayReadAllRecords()
+{
+    KPilotReplayLink link;
+    link.setTrace(memoReadTrace());
+    QVERIFY(link.openConnection());
+
+    struct PilotUser user;
+    QVERIFY(link.readUserInfo(user));
+    QCOMPARE(QString::fromUtf8(user.username), QString("Jane Palm"));
+    QCOMPARE(user.userID, 1234ul);
+
+    int handle = link.openDatabase("MemoDB", true);
+    QCOMPARE(handle, 3);
+
+    QList<PilotRecord*> records = link.readAllRecords(handle);
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records.at(1)->id(), 0x5001);
+    QCOMPARE(records.at(1)->category(), 1);
+    QVERIFY(records.at(1)->isDirty());
+    QCOMPARE(records.at(1)->data(), QByteArray("memo text\0", 10));
+    qDeleteAll(records);
+
+    QVERIFY(link.closeDatabase(handle));
+    QCOMPARE(link.remaining(), 0);
+    QCOMPARE(link.divergences(), 0);
+    QVERIFY(link.status() != KPilotLink::PilotLinkError);
+}
+
+void TestDlpTrace::testReplayZeroFillsMissingPayloads()
+{
+    KPilotReplayLink link;
+    QVERIFY(link.loadTrace(writeTrace(memoReadTrace(), false)));
+    QVERIFY(link.openConnection());
+
+    struct PilotUser user;
+    QVERIFY(link.readUserInfo(user));
+    int handle = link.openDatabase("MemoDB");
+
+    QList<PilotRecord*> records = link.readAllRecords(handle);
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records.first()->data(), QByteArray(10, '\0'));
+    qDeleteAll(records);
+}
+
+void TestDlpTrace::testReplayWriteRecordAssignsRecordedId()
+{
+    DlpTraceEntry write(DlpCall::WriteRecord, 0);
+    write.handle = 3;
+    write.recordId = 0x7777;
+    write.bytesSent = 4;
+
+    KPilotReplayLink link;
+    link.setTrace({write});
+    QVERIFY(link.openConnection());
+
+    PilotRecord record(0, 0, 0, QByteArray("abc\0", 4));
+    QVERIFY(link.writeRecord(3, &record));
+    QCOMPARE(record.id(), 0x7777);
+}
+
+void TestDlpTrace::testReplayFailedCall()
+{
+    KPilotReplayLink link;
+    link.setTrace({DlpTraceEntry(DlpCall::OpenDB, -2)});
+    QVERIFY(link.openConnection());
+
+    QCOMPARE(link.openDatabase("MemoDB"), -1);
+    QCOMPARE(link.divergences(), 0);
+}
+
+void TestDlpTrace::testRawCallsRecorded()
+{
+    QString path = m_tempDir->filePath("raw.qpdt");
+    KPilotDeviceLink link("usb:");
+    QVERIFY(link.startTrace(path));
+
+    // Inside execute() the call lands in the link's trace and traffic
+    int result = link.execute([]() {
+        return KPilotDeviceLink::traceRaw(DlpCall::ReadDBList, []() { return -5; }, 7);
+    });
+    QCOMPARE(result, -5);
+
+    // Outside it just runs
+    QCOMPARE(KPilotDeviceLink::traceRaw(DlpCall::OpenConduit, []() { return 0; }), 0);
+    link.stopTrace();
+
+    DlpTraceReader reader;
+    QVERIFY(reader.load(path));
+    QCOMPARE(reader.entries().size(), 1);
+    QCOMPARE(reader.entries().at(0).call, DlpCall::ReadDBList);
+    QCOMPARE(reader.entries().at(0).result, -5);
+    QCOMPARE(reader.entries().at(0).index, 7);
+    QCOMPARE(link.traffic().calls, 1);
+    QCOMPARE(dlpCallName(DlpCall::FileInstall), QString("pi_file_install"));
+}
+
+void TestDlpTrace::testReplayCountsDivergences()
+{
+    KPilotReplayLink link;
+    link.setTrace(memoReadTrace());
+    QVERIFY(link.openConnection());
+
+    // Skip the user info read: one recorded call passed over
+    QCOMPARE(link.openDatabase("MemoDB"), 3);
+    QCOMPARE(link.divergences(), 1);
+
+    // A call the trace never made
+    QVERIFY(!link.deleteRecord(3, 1));
+    QCOMPARE(link.divergences(), 2);
+}
+
+void TestDlpTrace::testReplaySkipsOutOfBandCalls()
+{
+    QList<DlpTraceEntry> entries = memoReadTrace();
+    entries.insert(1, DlpTraceEntry(DlpCall::GetSysDateTime, 0));
+    entries.insert(1, DlpTraceEntry(DlpCall::FileInstall, 0));
+
+    KPilotReplayLink link;
+    link.setTrace(entries);
+    QVERIFY(link.openConnection());
+
+    struct PilotUser user;
+    QVERIFY(link.readUserInfo(user));
+    QCOMPARE(link.openDatabase("MemoDB"), 3);
+    QCOMPARE(link.divergences(), 0);
+}
+
+void TestDlpTrace::testReplayLatencyTotal()
+{
+    KPilotReplayLink link;
+    link.setTrace(memoReadTrace());
+    QVERIFY(link.openConnection());
+
+    struct PilotUser user;
+    link.readUserInfo(user);
+    int handle = link.openDatabase("MemoDB");
+    qDeleteAll(link.readAllRecords(handle));
+    link.closeDatabase(handle);
+
+    QCOMPARE(link.replayedLatencyUs(), qint64(4000 + 6000 + 9000 * 2 + 3000 + 2000));
+}
+
+void TestDlpTrace::testReplayFromFile()
+{
+    KPilotReplayLink link;
+    QVERIFY(link.loadTrace(writeTrace(memoReadTrace(), true)));
+    QCOMPARE(link.traceHeader().devicePath, QString("usb:"));
+    QCOMPARE(link.remaining(), memoReadTrace().size());
+
+    QVERIFY(!link.loadTrace(m_tempDir->filePath("missing.qpdt")));
+}
+
+QTEST_MAIN(TestDlpTrace)
+#include "test_dlptrace.moc"
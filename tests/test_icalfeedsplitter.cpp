@@ -0,0 +1,283 @@
+/**
+ * @file test_icalfeedsplitter.cpp
+ * @brief Unit tests for ICalFeedSplitter
+ *
+ * Tests single-pass splitting of iCalendar feeds fed in arbitrary chunks.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include "sync/conduits/icalfeedsplitter.h"
+
+using namespace Sync;
+
+class TestICalFeedSplitter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // ========== Splitting Tests ==========
+    void testSplitsEvents();
+    void testHeaderBeforeFirstEvent();
+    void testEventDataExact();
+    void testChunkBoundaries();
+    void testLfLineEndings();
+    void testNoTrailingNewline();
+
+    // ========== Property Tests ==========
+    void testProperties();
+    void testFoldedProperty();
+    void testParametersAndQuotedColon();
+    void testNestedAlarmIgnored();
+
+    // ========== Validation Tests ==========
+    void testNotACalendar();
+    void testEventOutsideCalendarIgnored();
+
+    // ========== Date Tests ==========
+    void testStartDateTime();
+    void testStartDateOnly();
+    void testRecurrenceUntil();
+
+private:
+    static QByteArray sampleFeed();
+    QList<ICalFeedEvent> split(const QByteArray &data, int chunkSize = 0,
+                               QByteArray *header = nullptr);
+};
+
+void TestICalFeedSplitter::initTestCase()
+{
+    qDebug() << "Starting ICalFeedSplitter tests";
+}
+
+void TestICalFeedSplitter::cleanupTestCase()
+{
+    qDebug() << "ICalFeedSplitter tests complete";
+}
+
+QByteArray TestICalFeedSplitter::sampleFeed()
+{
+    return "BEGIN:VCALENDAR\r\n"
+           "VERSION:2.0\r\n"
+           "PRODID:-//Test//EN\r\n"
+           "BEGIN:VTIMEZONE\r\n"
+           "TZID:Europe/Berlin\r\n"
+           "END:VTIMEZONE\r\n"
+           "BEGIN:VEVENT\r\n"
+           "UID:one@test\r\n"
+           "DTSTART;TZID=Europe/Berlin:20300101T100000\r\n"
+           "SUMMARY:First\r\n"
+           "END:VEVENT\r\n"
+           "BEGIN:VEVENT\r\n"
+           "UID:two@test\r\n"
+           "DTSTART;VALUE=DATE:20300202\r\n"
+           "SUMMARY:Second\r\n"
+           "RRULE:FREQ=WEEKLY;UNTIL=20301231T000000Z\r\n"
+           "END:VEVENT\r\n"
+           "END:VCALENDAR\r\n";
+}
+
+QList<ICalFeedEvent> TestICalFeedSplitter::split(const QByteArray &data, int chunkSize,
+                                                  QByteArray *header)
+{
+    QList<ICalFeedEvent> events;
+    ICalFeedSplitter splitter([&events](const ICalFeedEvent &event) {
+        events.append(event);
+    });
+
+    if (chunkSize <= 0) {
+        splitter.addData(data);
+    } else {
+        for (int i = 0; i < data.size(); i += chunkSize) {
+            splitter.addData(data.mid(i, chunkSize));
+        }
+    }
+    splitter.finish();
+
+    if (header) {
+        *header = splitter.header();
+    }
+    return events;
+}
+
+// ========== Splitting Tests ==========
+
+void TestICalFeedSplitter::testSplitsEvents()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events[0].uid, QByteArray("one@test"));
+    QCOMPARE(events[1].uid, QByteArray("two@test"));
+}
+
+void TestICalFeedSplitter::testHeaderBeforeFirstEvent()
+{
+    QByteArray header;
+    split(sampleFeed(), 0, &header);
+    QVERIFY(header.startsWith("BEGIN:VCALENDAR\r\n"));
+    QVERIFY(header.endsWith("END:VTIMEZONE\r\n"));
+    QVERIFY(!header.contains("VEVENT"));
+}
+
+void TestICalFeedSplitter::testEventDataExact()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QCOMPARE(events[0].data, QByteArray("BEGIN:VEVENT\r\n"
+                                        "UID:one@test\r\n"
+                                        "DTSTART;TZID=Europe/Berlin:20300101T100000\r\n"
+                                        "SUMMARY:First\r\n"
+                                        "END:VEVENT"));
+}
+
+void TestICalFeedSplitter::testChunkBoundaries()
+{
+    QByteArray wholeHeader;
+    QList<ICalFeedEvent> whole = split(sampleFeed(), 0, &wholeHeader);
+
+    // Every chunk size, down to a byte at a time, must give identical output
+    for (int chunkSize : {1, 2, 3, 7, 16, 64}) {
+        QByteArray header;
+        QList<ICalFeedEvent> chunked = split(sampleFeed(), chunkSize, &header);
+        QCOMPARE(header, wholeHeader);
+        QCOMPARE(chunked.size(), whole.size());
+        for (int i = 0; i < whole.size(); ++i) {
+            QCOMPARE(chunked[i].data, whole[i].data);
+            QCOMPARE(chunked[i].summary, whole[i].summary);
+        }
+    }
+}
+
+void TestICalFeedSplitter::testLfLineEndings()
+{
+    QByteArray feed = sampleFeed();
+    feed.replace("\r\n", "\n");
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events[0].summary, QByteArray("First"));
+    QVERIFY(events[0].data.endsWith("END:VEVENT"));
+}
+
+void TestICalFeedSplitter::testNoTrailingNewline()
+{
+    QByteArray feed = sampleFeed();
+    feed.chop(2);  // "END:VCALENDAR" without line break
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 2);
+}
+
+// ========== Property Tests ==========
+
+void TestICalFeedSplitter::testProperties()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QCOMPARE(events[0].dtstart, QByteArray("20300101T100000"));
+    QCOMPARE(events[0].summary, QByteArray("First"));
+    QVERIFY(!events[0].isRecurring());
+    QVERIFY(events[1].isRecurring());
+    QCOMPARE(events[1].rrule, QByteArray("FREQ=WEEKLY;UNTIL=20301231T000000Z"));
+}
+
+void TestICalFeedSplitter::testFoldedProperty()
+{
+    QByteArray feed = "BEGIN:VCALENDAR\r\n"
+                      "BEGIN:VEVENT\r\n"
+                      "UID:very-long-uid\r\n"
+                      " -continued@test\r\n"
+                      "SUMMARY:Folded\r\n"
+                      "\t title\r\n"
+                      "END:VEVENT\r\n"
+                      "END:VCALENDAR\r\n";
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].uid, QByteArray("very-long-uid-continued@test"));
+    QCOMPARE(events[0].summary, QByteArray("Folded title"));
+    QVERIFY(events[0].data.contains(" -continued@test\r\n"));
+}
+
+void TestICalFeedSplitter::testParametersAndQuotedColon()
+{
+    QByteArray feed = "BEGIN:VCALENDAR\r\n"
+                      "BEGIN:VEVENT\r\n"
+                      "uid:lower@test\r\n"
+                      "SUMMARY;ALTREP=\"http://example.com/a:b\";LANGUAGE=en:Talk\r\n"
+                      "RECURRENCE-ID;TZID=UTC:20300101T100000\r\n"
+                      "END:VEVENT\r\n"
+                      "END:VCALENDAR\r\n";
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].uid, QByteArray("lower@test"));
+    QCOMPARE(events[0].summary, QByteArray("Talk"));
+    QCOMPARE(events[0].recurrenceId, QByteArray("20300101T100000"));
+}
+
+void TestICalFeedSplitter::testNestedAlarmIgnored()
+{
+    QByteArray feed = "BEGIN:VCALENDAR\r\n"
+                      "BEGIN:VEVENT\r\n"
+                      "BEGIN:VALARM\r\n"
+                      "ACTION:EMAIL\r\n"
+                      "SUMMARY:Alarm text\r\n"
+                      "END:VALARM\r\n"
+                      "UID:alarm@test\r\n"
+                      "SUMMARY:Meeting\r\n"
+                      "END:VEVENT\r\n"
+                      "END:VCALENDAR\r\n";
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events[0].summary, QByteArray("Meeting"));
+    QVERIFY(events[0].data.contains("END:VALARM"));
+    QVERIFY(events[0].data.endsWith("END:VEVENT"));
+}
+
+// ========== Validation Tests ==========
+
+void TestICalFeedSplitter::testNotACalendar()
+{
+    ICalFeedSplitter splitter([](const ICalFeedEvent &) {});
+    splitter.addData("<html><body>Not found</body></html>\n");
+    splitter.finish();
+    QVERIFY(!splitter.sawCalendar());
+    QCOMPARE(splitter.eventCount(), 0);
+}
+
+void TestICalFeedSplitter::testEventOutsideCalendarIgnored()
+{
+    QByteArray feed = "BEGIN:VEVENT\r\nUID:stray@test\r\nEND:VEVENT\r\n";
+    feed += sampleFeed();
+
+    QList<ICalFeedEvent> events = split(feed);
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(events[0].uid, QByteArray("one@test"));
+}
+
+// ========== Date Tests ==========
+
+void TestICalFeedSplitter::testStartDateTime()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QCOMPARE(events[0].start(), QDateTime(QDate(2030, 1, 1), QTime(10, 0, 0)));
+}
+
+void TestICalFeedSplitter::testStartDateOnly()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QCOMPARE(events[1].start(), QDateTime(QDate(2030, 2, 2), QTime(0, 0, 0)));
+}
+
+void TestICalFeedSplitter::testRecurrenceUntil()
+{
+    QList<ICalFeedEvent> events = split(sampleFeed());
+    QVERIFY(!events[0].recurrenceUntil().isValid());
+    QCOMPARE(events[1].recurrenceUntil(), QDateTime(QDate(2030, 12, 31), QTime(0, 0, 0)));
+}
+
+QTEST_MAIN(TestICalFeedSplitter)
+#include "test_icalfeedsplitter.moc"
@@ -0,0 +1,280 @@
+/**
+ * @file test_installconduit.cpp
+ * @brief Unit tests for InstallConduit
+ *
+ * Tests the pending file scan, install ordering, the skip-if-identical
+ * check against the Palm's database list and the free memory check.
+ * Nothing here needs a device: skipped and deferred files never touch
+ * the socket.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryDir>
+#include <pi-dlp.h>
+#include <pi-file.h>
+#include "palm/palmdbgenerator.h"
+#include "sync/conduits/installconduit.h"
+
+using namespace Sync;
+
+class TestInstallConduit : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Pending File Tests ==========
+    void testPendingFiles();
+
+    // ========== Skip-If-Identical Tests ==========
+    void testIdenticalIsInstalled();
+    void testChangedDatabaseNotInstalled();
+    void testMissingDatabaseNotInstalled();
+    void testIdenticalFileSkipped();
+
+    // ========== Scheduling Tests ==========
+    void testSmallestFirst();
+    void testPriorityBeforeSize();
+    void testDirectoryOrder();
+    void testNewDatabaseDeferredWhenPalmFull();
+    void testNoEstimateBeforeMeasurement();
+
+    // ========== Cancellation Tests ==========
+    void testCancelLeavesRemainingFilesQueued();
+
+private:
+    QString writeMemoDb(const QString &fileName, int records = 20,
+                        const QString &dbName = QString()) const;
+    DBInfo fileInfo(const QString &path) const;
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestInstallConduit::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestInstallConduit::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestInstallConduit::writeMemoDb(const QString &fileName, int records,
+                                        const QString &dbName) const
+{
+    GeneratorOptions options;
+    options.records = records;
+    PalmDbGenerator generator(options);
+    MemoryDatabase db = generator.database(PalmDbGenerator::Memo);
+    if (!dbName.isEmpty()) {
+        db.name = dbName;
+    }
+
+    QString path = QDir(m_tempDir->filePath("install")).filePath(fileName);
+    QDir().mkpath(QFileInfo(path).path());
+    QString error;
+    if (!generator.writePdb(db, path, &error)) {
+        qWarning() << error;
+    }
+    return path;
+}
+
+DBInfo TestInstallConduit::fileInfo(const QString &path) const
+{
+    DBInfo info;
+    memset(&info, 0, sizeof(info));
+    pi_file_t *pf = pi_file_open(QFile::encodeName(path).constData());
+    if (pf) {
+        pi_file_get_info(pf, &info);
+        pi_file_close(pf);
+    }
+    return info;
+}
+
+// ========== Pending File Tests ==========
+
+void TestInstallConduit::testPendingFiles()
+{
+    writeMemoDb("MemoDB.pdb");
+    QFile other(m_tempDir->filePath("install/readme.txt"));
+    QVERIFY(other.open(QIODevice::WriteOnly));
+    other.close();
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+    QCOMPARE(conduit.pendingFiles().size(), 1);
+    QVERIFY(conduit.pendingFiles().first().endsWith("MemoDB.pdb"));
+}
+
+// ========== Skip-If-Identical Tests ==========
+
+void TestInstallConduit::testIdenticalIsInstalled()
+{
+    DBInfo file = fileInfo(writeMemoDb("MemoDB.pdb"));
+    QCOMPARE(QString::fromLatin1(file.name), QString("MemoDB"));
+
+    DBInfo other;
+    memset(&other, 0, sizeof(other));
+    strncpy(other.name, "AddressDB", sizeof(other.name) - 1);
+
+    DBInfo device = file;
+    device.index = 7;   // Position on the Palm does not matter
+    QVERIFY(InstallConduit::isInstalled(file, {other, device}));
+}
+
+void TestInstallConduit::testChangedDatabaseNotInstalled()
+{
+    DBInfo file = fileInfo(writeMemoDb("MemoDB.pdb"));
+
+    DBInfo device = file;
+    device.modnum = file.modnum + 1;
+    QVERIFY(!InstallConduit::isInstalled(file, {device}));
+
+    device = file;
+    device.version = file.version + 1;
+    QVERIFY(!InstallConduit::isInstalled(file, {device}));
+
+    device = file;
+    device.creator = file.creator ^ 1;
+    QVERIFY(!InstallConduit::isInstalled(file, {device}));
+
+    device = file;
+    device.type = file.type ^ 1;
+    QVERIFY(!InstallConduit::isInstalled(file, {device}));
+}
+
+void TestInstallConduit::testMissingDatabaseNotInstalled()
+{
+    DBInfo file = fileInfo(writeMemoDb("MemoDB.pdb"));
+    QVERIFY(!InstallConduit::isInstalled(file, {}));
+
+    DBInfo device = file;
+    strncpy(device.name, "MemoDB-copy", sizeof(device.name) - 1);
+    QVERIFY(!InstallConduit::isInstalled(file, {device}));
+}
+
+void TestInstallConduit::testIdenticalFileSkipped()
+{
+    QString path = writeMemoDb("MemoDB.pdb");
+    DBInfo device = fileInfo(path);
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+    QSignalSpy logSpy(&conduit, &InstallConduit::logMessage);
+
+    // No socket: the file must be skipped without any transfer
+    QList<InstallResult> results = conduit.installAll(-1, {device});
+    QCOMPARE(results.size(), 1);
+    QVERIFY(results.first().success);
+    QVERIFY(results.first().skipped);
+
+    // Skipped files leave the queue like installed ones
+    QVERIFY(!QFile::exists(path));
+    QVERIFY(QFile::exists(m_tempDir->filePath("install/installed/MemoDB.pdb")));
+
+    bool logged = false;
+    for (const QList<QVariant> &args : logSpy) {
+        logged = logged || args.first().toString().startsWith("Skipped MemoDB.pdb");
+    }
+    QVERIFY(logged);
+}
+
+// ========== Scheduling Tests ==========
+
+void TestInstallConduit::testSmallestFirst()
+{
+    QString large = writeMemoDb("a-large.pdb", 400);
+    QString small = writeMemoDb("b-small.pdb", 5);
+    QString medium = writeMemoDb("c-medium.pdb", 100);
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+    QCOMPARE(conduit.orderedFiles(conduit.pendingFiles()), QStringList({small, medium, large}));
+}
+
+void TestInstallConduit::testPriorityBeforeSize()
+{
+    QString large = writeMemoDb("SysLib.prc", 400);
+    QString small = writeMemoDb("game.pdb", 5);
+    QString medium = writeMemoDb("notes.pdb", 100);
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+    conduit.setPriority("*lib*", 10);
+    conduit.setPriority("game*", -1);
+
+    QCOMPARE(conduit.priority("SysLib.prc"), 10);
+    QCOMPARE(conduit.priority("notes.pdb"), 0);
+    QCOMPARE(conduit.orderedFiles(conduit.pendingFiles()), QStringList({large, medium, small}));
+}
+
+void TestInstallConduit::testDirectoryOrder()
+{
+    QString large = writeMemoDb("a-large.pdb", 400);
+    QString small = writeMemoDb("b-small.pdb", 5);
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+    conduit.setInstallOrder(InstallOrder::Directory);
+    QCOMPARE(conduit.orderedFiles(conduit.pendingFiles()), QStringList({large, small}));
+}
+
+void TestInstallConduit::testNewDatabaseDeferredWhenPalmFull()
+{
+    QString present = writeMemoDb("a-present.pdb", 5);
+    QString large = writeMemoDb("b-large.pdb", 400, "BigDB");
+    DBInfo device = fileInfo(present);
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+
+    qint64 freeBytes = QFileInfo(large).size() / 2;
+    QList<InstallResult> results = conduit.installAll(-1, {device}, freeBytes);
+    QCOMPARE(results.size(), 2);
+
+    // Smallest first: the identical one is skipped, the big new one waits
+    QVERIFY(results.at(0).skipped);
+    QVERIFY(!results.at(1).success);
+    QVERIFY(results.at(1).deferred);
+    QVERIFY(results.at(1).errorMessage.contains("free memory"));
+    QVERIFY(QFile::exists(large));
+}
+
+void TestInstallConduit::testNoEstimateBeforeMeasurement()
+{
+    InstallConduit conduit;
+    QCOMPARE(conduit.throughput(), 0.0);
+    QCOMPARE(conduit.estimateTransferMs(100000), qint64(-1));
+}
+
+// ========== Cancellation Tests ==========
+
+void TestInstallConduit::testCancelLeavesRemainingFilesQueued()
+{
+    QString small = writeMemoDb("a-small.pdb", 5);
+    QString large = writeMemoDb("b-large.pdb", 100, "OtherDB");
+    QList<DBInfo> device = {fileInfo(small), fileInfo(large)};
+
+    InstallConduit conduit;
+    conduit.setInstallFolder(m_tempDir->filePath("install"));
+
+    // Cancelled once the first file is done
+    int checks = 0;
+    conduit.setCancelCheck([&checks]() { return ++checks > 1; });
+
+    QList<InstallResult> results = conduit.installAll(-1, device);
+    QCOMPARE(results.size(), 1);
+    QVERIFY(results.first().skipped);
+    QVERIFY(!QFile::exists(small));
+    QVERIFY(QFile::exists(large));
+}
+
+QTEST_MAIN(TestInstallConduit)
+#include "test_installconduit.moc"
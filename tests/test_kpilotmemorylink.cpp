@@ -0,0 +1,530 @@
+/**
+ * @file test_kpilotmemorylink.cpp
+ * @brief Unit tests for KPilotMemoryLink
+ *
+ * Tests the in-memory device link: DLP record semantics, link cost
+ * accounting, cancelling bulk reads, and a full SyncEngine run against it.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryDir>
+#include <pi-dlp.h>
+#include "palm/kpilotmemorylink.h"
+#include "mappers/memomapper.h"
+#include "sync/syncengine.h"
+#include "sync/localfilebackend.h"
+#include "sync/conduits/memoconduit.h"
+
+using namespace Sync;
+
+class TestKPilotMemoryLink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Connection Tests ==========
+    void testNotConnectedByDefault();
+    void testOpenConnection();
+    void testReadUserInfo();
+
+    // ========== Database Tests ==========
+    void testOpenUnknownDatabase();
+    void testListDatabases();
+
+    // ========== Record Tests ==========
+    void testReadAllRecords();
+    void testWriteNewRecordAssignsId();
+    void testWriteExistingRecordReplaces();
+    void testDeleteRecord();
+    void testCleanUpDatabase();
+    void testResetSyncFlags();
+    void testAppBlock();
+
+    // ========== Link Profile Tests ==========
+    void testInstantProfileCostsNothing();
+    void testSerialSlowerThanUsb();
+    void testStatsCountTraffic();
+
+    // ========== Cancellation Tests ==========
+    void testCancelStopsReadAllRecords();
+    void testCancelledSyncKeepsDirtyFlags();
+    void testCancelledCopyPalmToPCKeepsPCFiles();
+    void testCancelledHotSyncKeepsMappings();
+
+    // ========== SyncEngine Tests ==========
+    void testEngineFirstSync();
+    void testEngineHotSyncPicksUpDirtyRecord();
+    void testEngineReportsTimings();
+
+private:
+    MemoryDatabase memoDatabase(int count) const;
+
+    QTemporaryDir *m_tempDir;
+    KPilotMemoryLink *m_link;
+};
+
+MemoryDatabase TestKPilotMemoryLink::memoDatabase(int count) const
+{
+    MemoryDatabase db;
+    db.name = "MemoDB";
+    db.creator = 0x6d656d6f;  // 'memo'
+    db.type = 0x44415441;     // 'DATA'
+
+    for (int i = 0; i < count; ++i) {
+        MemoMapper::Memo memo;
+        memo.recordId = 0x1000 + i;
+        memo.category = 0;
+        memo.text = QString("Memo %1\nBody of memo %1").arg(i);
+        memo.isPrivate = false;
+        memo.isDirty = true;
+        memo.isDeleted = false;
+
+        PilotRecord *record = MemoMapper::packMemo(memo);
+        record->setAttributes(PilotRecord::AttrDirty);
+        db.records.append(*record);
+        delete record;
+    }
+    return db;
+}
+
+void TestKPilotMemoryLink::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+
+    m_link = new KPilotMemoryLink();
+    m_link->addDatabase(memoDatabase(3));
+}
+
+void TestKPilotMemoryLink::cleanup()
+{
+    delete m_link;
+    delete m_tempDir;
+    m_link = nullptr;
+    m_tempDir = nullptr;
+}
+
+// ========== Connection Tests ==========
+
+void TestKPilotMemoryLink::testNotConnectedByDefault()
+{
+    QVERIFY(!m_link->isConnected());
+    QCOMPARE(m_link->openDatabase("MemoDB"), -1);
+}
+
+void TestKPilotMemoryLink::testOpenConnection()
+{
+    QVERIFY(m_link->openConnection());
+    QVERIFY(m_link->isConnected());
+    QCOMPARE(m_link->status(), KPilotLink::AcceptedDevice);
+
+    m_link->closeConnection();
+    QVERIFY(!m_link->isConnected());
+}
+
+void TestKPilotMemoryLink::testReadUserInfo()
+{
+    m_link->setUser("Jane Palm", 4242);
+    QVERIFY(m_link->openConnection());
+
+    struct PilotUser user;
+    QVERIFY(m_link->readUserInfo(user));
+    QCOMPARE(QString::fromUtf8(user.username), QString("Jane Palm"));
+    QCOMPARE(user.userID, 4242ul);
+}
+
+// ========== Database Tests ==========
+
+void TestKPilotMemoryLink::testOpenUnknownDatabase()
+{
+    QVERIFY(m_link->openConnection());
+    QCOMPARE(m_link->openDatabase("NoSuchDB"), -1);
+}
+
+void TestKPilotMemoryLink::testListDatabases()
+{
+    MemoryDatabase todo;
+    todo.name = "ToDoDB";
+    m_link->addDatabase(todo);
+    QVERIFY(m_link->openConnection());
+
+    QStringList names = m_link->listDatabases();
+    QCOMPARE(names.size(), 2);
+    QVERIFY(names.contains("MemoDB"));
+    QVERIFY(names.contains("ToDoDB"));
+}
+
+// ========== Record Tests ==========
+
+void TestKPilotMemoryLink::testReadAllRecords()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB");
+    QVERIFY(handle >= 0);
+
+    QList<PilotRecord*> records = m_link->readAllRecords(handle);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records.first()->id(), 0x1000);
+    QVERIFY(records.first()->isDirty());
+    qDeleteAll(records);
+
+    QVERIFY(m_link->closeDatabase(handle));
+    QVERIFY(!m_link->closeDatabase(handle));
+}
+
+void TestKPilotMemoryLink::testWriteNewRecordAssignsId()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+
+    PilotRecord record(0, 2, PilotRecord::AttrDirty, QByteArray("New memo\0", 9));
+    QVERIFY(m_link->writeRecord(handle, &record));
+    QVERIFY(record.id() != 0);
+
+    PilotRecord *stored = m_link->readRecordById(handle, record.id());
+    QVERIFY(stored);
+    QCOMPARE(stored->category(), 2);
+    QCOMPARE(stored->data(), record.data());
+    QVERIFY(!stored->isDirty());  // Written over DLP = clean
+    delete stored;
+
+    QCOMPARE(m_link->database("MemoDB")->records.size(), 4);
+}
+
+void TestKPilotMemoryLink::testWriteExistingRecordReplaces()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+
+    PilotRecord record(0x1001, 0, 0, QByteArray("Changed\0", 8));
+    QVERIFY(m_link->writeRecord(handle, &record));
+    QCOMPARE(record.id(), 0x1001);
+
+    const MemoryDatabase *db = m_link->database("MemoDB");
+    QCOMPARE(db->records.size(), 3);
+    QCOMPARE(db->records.at(1).data(), record.data());
+}
+
+void TestKPilotMemoryLink::testDeleteRecord()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+
+    QVERIFY(m_link->deleteRecord(handle, 0x1000));
+    QVERIFY(!m_link->deleteRecord(handle, 0x1000));
+    QCOMPARE(m_link->database("MemoDB")->records.size(), 2);
+    QVERIFY(!m_link->readRecordById(handle, 0x1000));
+}
+
+void TestKPilotMemoryLink::testCleanUpDatabase()
+{
+    MemoryDatabase db = memoDatabase(3);
+    db.records[0].setAttributes(PilotRecord::AttrDeleted);
+    db.records[1].setAttributes(PilotRecord::AttrArchived | PilotRecord::AttrDeleted);
+    m_link->addDatabase(db);
+
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+    QVERIFY(m_link->cleanUpDatabase(handle));
+
+    const MemoryDatabase *cleaned = m_link->database("MemoDB");
+    QCOMPARE(cleaned->records.size(), 1);
+    QCOMPARE(cleaned->records.first().id(), 0x1002);
+}
+
+void TestKPilotMemoryLink::testResetSyncFlags()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+    QVERIFY(m_link->resetSyncFlags(handle));
+
+    for (const PilotRecord &record : m_link->database("MemoDB")->records) {
+        QVERIFY(!record.isDirty());
+    }
+}
+
+void TestKPilotMemoryLink::testAppBlock()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+
+    unsigned char buffer[64];
+    size_t size = sizeof(buffer);
+    QVERIFY(!m_link->readAppBlock(handle, buffer, &size));  // None yet
+
+    const unsigned char block[] = {1, 2, 3, 4};
+    QVERIFY(m_link->writeAppBlock(handle, block, sizeof(block)));
+
+    size = sizeof(buffer);
+    QVERIFY(m_link->readAppBlock(handle, buffer, &size));
+    QCOMPARE(size, sizeof(block));
+    QCOMPARE(buffer[3], static_cast<unsigned char>(4));
+}
+
+// ========== Link Profile Tests ==========
+
+void TestKPilotMemoryLink::testInstantProfileCostsNothing()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB");
+    qDeleteAll(m_link->readAllRecords(handle));
+
+    QVERIFY(m_link->stats().calls > 0);
+    QCOMPARE(m_link->stats().simulatedUs, qint64(0));
+}
+
+void TestKPilotMemoryLink::testSerialSlowerThanUsb()
+{
+    QCOMPARE(LinkProfile::fromName("serial").name, QString("serial"));
+    QCOMPARE(LinkProfile::fromName("bogus").name, QString("instant"));
+
+    qint64 serialUs = 0;
+    qint64 usbUs = 0;
+    for (const QString &profile : {QString("serial"), QString("usb")}) {
+        m_link->setLinkProfile(LinkProfile::fromName(profile));
+        m_link->resetStats();
+        QVERIFY(m_link->openConnection());
+        int handle = m_link->openDatabase("MemoDB");
+        qDeleteAll(m_link->readAllRecords(handle));
+        m_link->closeDatabase(handle);
+        (profile == "serial" ? serialUs : usbUs) = m_link->stats().simulatedUs;
+    }
+
+    QVERIFY(usbUs > 0);
+    QVERIFY(serialUs > usbUs);
+}
+
+void TestKPilotMemoryLink::testStatsCountTraffic()
+{
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB", true);
+    m_link->resetStats();
+
+    PilotRecord record(0, 0, 0, QByteArray(100, 'x'));
+    QVERIFY(m_link->writeRecord(handle, &record));
+    PilotRecord *read = m_link->readRecordById(handle, record.id());
+    delete read;
+
+    QCOMPARE(m_link->stats().calls, 2);
+    QCOMPARE(m_link->stats().bytesWritten, qint64(100));
+    QCOMPARE(m_link->stats().bytesRead, qint64(100));
+}
+
+// ========== Cancellation Tests ==========
+
+void TestKPilotMemoryLink::testCancelStopsReadAllRecords()
+{
+    m_link->addDatabase(memoDatabase(100));
+    QVERIFY(m_link->openConnection());
+    int handle = m_link->openDatabase("MemoDB");
+    m_link->resetStats();
+
+    // Cancel arrives while the fifth record is being read
+    m_link->setCancelCheck([this]() { return m_link->stats().calls >= 5; });
+    QList<PilotRecord*> records = m_link->readAllRecords(handle);
+    QCOMPARE(records.size(), 5);
+    QCOMPARE(m_link->stats().calls, 5);
+    qDeleteAll(records);
+
+    // Cleared: the next read is complete again
+    m_link->setCancelCheck(nullptr);
+    records = m_link->readAllRecords(handle);
+    QCOMPARE(records.size(), 100);
+    qDeleteAll(records);
+}
+
+void TestKPilotMemoryLink::testCancelledSyncKeepsDirtyFlags()
+{
+    QVERIFY(m_link->openConnection());
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(m_link);
+
+    bool cancelled = true;
+    engine.setCancelCheck([&cancelled]() { return cancelled; });
+    QVERIFY(!engine.syncAll(SyncMode::HotSync).success);
+    for (const PilotRecord &record : m_link->database("MemoDB")->records) {
+        QVERIFY(record.isDirty());
+    }
+
+    // Nothing was lost: the next sync copies every memo
+    cancelled = false;
+    SyncResult result = engine.syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 3);
+}
+
+void TestKPilotMemoryLink::testCancelledCopyPalmToPCKeepsPCFiles()
+{
+    m_link->addDatabase(memoDatabase(100));
+    QVERIFY(m_link->openConnection());
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(m_link);
+
+    QVERIFY(engine.syncAll(SyncMode::HotSync).success);
+    QDir memos(m_tempDir->filePath("data/memos"));
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 100);
+
+    // Cancel arrives part way through reading the Palm's records
+    m_link->resetStats();
+    engine.setCancelCheck([this]() { return m_link->stats().calls >= 50; });
+    SyncResult result = engine.syncAll(SyncMode::CopyPalmToPC);
+    QVERIFY(!result.success);
+    QVERIFY(m_link->stats().calls < 100);
+
+    // Records not read yet must not be taken as deleted on the Palm
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 100);
+}
+
+void TestKPilotMemoryLink::testCancelledHotSyncKeepsMappings()
+{
+    QVERIFY(m_link->openConnection());
+    QDir memos(m_tempDir->filePath("data/memos"));
+    {
+        SyncEngine engine;
+        engine.setStateDirectory(m_tempDir->filePath("state"));
+        engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+        engine.registerConduit(new MemoConduit());
+        engine.setDeviceLink(m_link);
+        QVERIFY(engine.syncAll(SyncMode::HotSync).success);
+    }
+
+    // 100 new memos on the Palm
+    MemoryDatabase db = memoDatabase(100);
+    for (PilotRecord &record : db.records) {
+        record.setId(record.id() + 0x1000);
+    }
+    db.records = m_link->database("MemoDB")->records + db.records;
+    m_link->addDatabase(db);
+
+    // Cancelled part way through copying them to the PC
+    {
+        SyncEngine engine;
+        engine.setStateDirectory(m_tempDir->filePath("state"));
+        engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+        engine.registerConduit(new MemoConduit());
+        engine.setDeviceLink(m_link);
+        engine.setCancelCheck([&memos]() {
+            return memos.entryList({"*.md"}, QDir::Files).size() >= 50;
+        });
+        QVERIFY(!engine.syncAll(SyncMode::HotSync).success);
+    }
+    int copied = memos.entryList({"*.md"}, QDir::Files).size();
+    QVERIFY(copied >= 50 && copied < 103);
+
+    // A fresh engine, as after a restart, must not copy them again
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(m_link);
+    SyncResult result = engine.syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 103 - copied);
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 103);
+    QCOMPARE(m_link->database("MemoDB")->records.size(), 103);
+}
+
+// ========== SyncEngine Tests ==========
+
+void TestKPilotMemoryLink::testEngineFirstSync()
+{
+    QVERIFY(m_link->openConnection());
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(m_link);
+
+    SyncResult result = engine.syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 3);
+
+    QDir memos(m_tempDir->filePath("data/memos"));
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 3);
+}
+
+void TestKPilotMemoryLink::testEngineHotSyncPicksUpDirtyRecord()
+{
+    QVERIFY(m_link->openConnection());
+    KPilotMemoryLink *link = m_link;
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(link);
+
+    QVERIFY(engine.syncAll(SyncMode::HotSync).success);
+    for (const PilotRecord &record : link->database("MemoDB")->records) {
+        QVERIFY(!record.isDirty());
+    }
+
+    // Edit on the "handheld": one new dirty memo
+    MemoryDatabase db = *link->database("MemoDB");
+    MemoMapper::Memo memo;
+    memo.recordId = 0x2000;
+    memo.category = 0;
+    memo.text = "Written on the Palm";
+    memo.isPrivate = false;
+    memo.isDirty = true;
+    memo.isDeleted = false;
+    PilotRecord *record = MemoMapper::packMemo(memo);
+    record->setAttributes(PilotRecord::AttrDirty);
+    db.records.append(*record);
+    delete record;
+    link->addDatabase(db);
+
+    SyncResult result = engine.syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 1);
+
+    QDir memos(m_tempDir->filePath("data/memos"));
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 4);
+}
+
+void TestKPilotMemoryLink::testEngineReportsTimings()
+{
+    QVERIFY(m_link->openConnection());
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(m_link);
+
+    SyncResult result = engine.syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.timings.size(), 1);
+
+    const SyncTiming &timing = result.timings.first();
+    QCOMPARE(timing.conduitId, QString("memos"));
+    QVERIFY(timing.dlpCalls > 0);
+    QVERIFY(timing.dlpBytesReceived > 0);       // Three memos read
+    QVERIFY(timing.totalUs > 0);
+
+    qint64 phases = 0;
+    for (qint64 us : timing.phaseUs) {
+        QVERIFY(us >= 0);
+        phases += us;
+    }
+    QVERIFY(phases <= timing.totalUs);
+    QVERIFY(timing.summary().startsWith("memos "));
+}
+
+QTEST_MAIN(TestKPilotMemoryLink)
+#include "test_kpilotmemorylink.moc"
@@ -0,0 +1,177 @@
+/**
+ * @file test_logbatcher.cpp
+ * @brief Unit tests for LogBatcher and LogWidget batch delivery
+ *
+ * Tests that messages posted from any thread arrive in order as one batch
+ * per interval, that levels below the minimum are dropped, and that only
+ * the latest progress update is delivered.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QThread>
+#include "app/logbatcher.h"
+#include "app/logwidget.h"
+
+class TestLogBatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ========== Batching Tests ==========
+    void testMessagesArriveAsOneBatch();
+    void testMessagesFromWorkerThreads();
+    void testLevelFiltering();
+    void testProgressCoalesced();
+    void testOverflowDropsOldest();
+    void testEmptyFlushEmitsNothing();
+
+    // ========== Widget Tests ==========
+    void testWidgetAppendsBatch();
+    void testWidgetClearDropsPending();
+};
+
+// ========== Batching Tests ==========
+
+void TestLogBatcher::testMessagesArriveAsOneBatch()
+{
+    LogBatcher batcher;
+    QSignalSpy spy(&batcher, &LogBatcher::entriesReady);
+
+    for (int i = 0; i < 500; ++i) {
+        batcher.logInfo(QString("Record %1").arg(i));
+    }
+    QCOMPARE(spy.count(), 0);   // Nothing until the interval has passed
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 2000);
+    QList<LogEntry> entries = spy.at(0).at(0).value<QList<LogEntry>>();
+    QCOMPARE(entries.size(), 500);
+    QCOMPARE(entries.first().message, QString("Record 0"));
+    QCOMPARE(entries.last().message, QString("Record 499"));
+    QCOMPARE(batcher.pendingCount(), 0);
+    QCOMPARE(batcher.batchesDelivered(), 1);
+}
+
+void TestLogBatcher::testMessagesFromWorkerThreads()
+{
+    LogBatcher batcher;
+    int received = 0;
+    connect(&batcher, &LogBatcher::entriesReady, this, [&](const QList<LogEntry> &entries) {
+        QCOMPARE(QThread::currentThread(), batcher.thread());
+        received += entries.size();
+    });
+
+    QList<QThread*> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.append(QThread::create([&batcher]() {
+            for (int i = 0; i < 250; ++i) {
+                batcher.logInfo("worker message");
+            }
+        }));
+        workers.last()->start();
+    }
+    for (QThread *worker : workers) {
+        QVERIFY(worker->wait(5000));
+        delete worker;
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(received, 1000, 2000);
+    QVERIFY(batcher.batchesDelivered() < 1000);
+}
+
+void TestLogBatcher::testLevelFiltering()
+{
+    LogBatcher batcher;
+    QSignalSpy spy(&batcher, &LogBatcher::entriesReady);
+
+    QCOMPARE(batcher.minimumLevel(), LogLevel::Info);
+    batcher.logDebug("hidden");
+    batcher.logInfo("info");
+    batcher.setMinimumLevel(LogLevel::Warning);
+    batcher.logInfo("hidden too");
+    batcher.logWarning("warning");
+    batcher.logError("error");
+    batcher.flush();
+
+    QCOMPARE(spy.count(), 1);
+    QList<LogEntry> entries = spy.at(0).at(0).value<QList<LogEntry>>();
+    QCOMPARE(entries.size(), 3);
+    QCOMPARE(entries.at(0).message, QString("info"));
+    QCOMPARE(entries.at(1).level, LogLevel::Warning);
+    QCOMPARE(entries.at(2).level, LogLevel::Error);
+}
+
+void TestLogBatcher::testProgressCoalesced()
+{
+    LogBatcher batcher;
+    QSignalSpy spy(&batcher, &LogBatcher::progressUpdated);
+
+    for (int i = 1; i <= 100; ++i) {
+        batcher.updateProgress(i, 100, "Copying to PC...");
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 2000);
+    QCOMPARE(spy.at(0).at(0).toInt(), 100);
+    QCOMPARE(spy.at(0).at(1).toInt(), 100);
+}
+
+void TestLogBatcher::testOverflowDropsOldest()
+{
+    LogBatcher batcher;
+    batcher.setMaxBatchSize(10);
+    QSignalSpy spy(&batcher, &LogBatcher::entriesReady);
+
+    for (int i = 0; i < 25; ++i) {
+        batcher.logInfo(QString::number(i));
+    }
+    batcher.flush();
+
+    QList<LogEntry> entries = spy.at(0).at(0).value<QList<LogEntry>>();
+    QCOMPARE(entries.size(), 11);
+    QCOMPARE(entries.first().level, LogLevel::Warning);
+    QVERIFY(entries.first().message.startsWith("15 "));
+    QCOMPARE(entries.at(1).message, QString("15"));
+    QCOMPARE(entries.last().message, QString("24"));
+}
+
+void TestLogBatcher::testEmptyFlushEmitsNothing()
+{
+    LogBatcher batcher;
+    QSignalSpy entriesSpy(&batcher, &LogBatcher::entriesReady);
+    QSignalSpy progressSpy(&batcher, &LogBatcher::progressUpdated);
+
+    batcher.flush();
+    QTest::qWait(100);
+    QCOMPARE(entriesSpy.count(), 0);
+    QCOMPARE(progressSpy.count(), 0);
+}
+
+// ========== Widget Tests ==========
+
+void TestLogBatcher::testWidgetAppendsBatch()
+{
+    LogWidget widget;
+    widget.logInfo("first");
+    widget.logWarning("second");
+    widget.logError("third");
+    QVERIFY(widget.toPlainText().isEmpty());
+
+    QTRY_VERIFY_WITH_TIMEOUT(!widget.toPlainText().isEmpty(), 2000);
+    QCOMPARE(widget.toPlainText(),
+             QString("[INFO] first\n[WARNING] second\n[ERROR] third"));
+    QCOMPARE(widget.document()->blockCount(), 3);
+}
+
+void TestLogBatcher::testWidgetClearDropsPending()
+{
+    LogWidget widget;
+    widget.logInfo("before clear");
+    widget.clear();
+    widget.logInfo("after clear");
+
+    QTRY_VERIFY_WITH_TIMEOUT(!widget.toPlainText().isEmpty(), 2000);
+    QCOMPARE(widget.toPlainText(), QString("[INFO] after clear"));
+}
+
+QTEST_MAIN(TestLogBatcher)
+#include "test_logbatcher.moc"
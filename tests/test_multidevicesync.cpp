@@ -0,0 +1,312 @@
+/**
+ * @file test_multidevicesync.cpp
+ * @brief Unit tests for HotSyncListener and MultiDeviceSync
+ *
+ * A loopback acceptor stands in for pilot-link: "connecting" a client
+ * hands the listener a KPilotMemoryLink with that client's user and
+ * memos, so several handhelds can HotSync at once without hardware.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QMutex>
+#include <QSemaphore>
+#include <QTemporaryDir>
+#include <QWaitCondition>
+#include "palm/hotsynclistener.h"
+#include "palm/kpilotmemorylink.h"
+#include "palm/palmdbgenerator.h"
+#include "sync/multidevicesync.h"
+#include "sync/syncengine.h"
+#include "sync/localfilebackend.h"
+#include "sync/conduits/memoconduit.h"
+
+using namespace Sync;
+
+/**
+ * @brief In-process acceptor; each connectClient() is one HotSync
+ */
+class LoopbackAcceptor : public LinkAcceptor
+{
+public:
+    struct Client
+    {
+        QString userName;
+        quint32 userId = 0;
+        int memos = 0;
+    };
+
+    void connectClient(const QString &userName, quint32 userId, int memos) {
+        QMutexLocker locker(&m_mutex);
+        m_pending.append({userName, userId, memos});
+        m_wake.wakeAll();
+    }
+
+    KPilotLink *accept() override {
+        QMutexLocker locker(&m_mutex);
+        while (!m_closed && m_pending.isEmpty()) {
+            m_wake.wait(&m_mutex);
+        }
+        if (m_closed) {
+            return nullptr;
+        }
+        Client client = m_pending.takeFirst();
+        locker.unlock();
+
+        return createLink(client);
+    }
+
+    void close() override {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_wake.wakeAll();
+    }
+
+    QString address() const override { return "loopback:"; }
+
+    static KPilotMemoryLink *createLink(const Client &client) {
+        GeneratorOptions options;
+        options.seed = client.userId;
+        options.records = client.memos;
+
+        KPilotMemoryLink *link = new KPilotMemoryLink();
+        link->setUser(client.userName, client.userId);
+        link->addDatabase(PalmDbGenerator(options).database(PalmDbGenerator::Memo));
+        link->openConnection();
+        return link;
+    }
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QList<Client> m_pending;
+    bool m_closed = false;
+};
+
+/**
+ * @brief Device conduit that runs a test hook instead of syncing
+ */
+class HookConduit : public Conduit
+{
+public:
+    explicit HookConduit(std::function<bool()> hook) : m_hook(std::move(hook)) {}
+
+    QString conduitId() const override { return "hook"; }
+    QString displayName() const override { return "Hook"; }
+    QString palmDatabaseName() const override { return QString(); }
+    QString fileExtension() const override { return QString(); }
+
+    SyncResult sync(SyncContext *) override {
+        SyncResult result;
+        result.success = m_hook();
+        return result;
+    }
+
+    BackendRecord* palmToBackend(PilotRecord *, SyncContext *) override { return nullptr; }
+    PilotRecord* backendToPalm(BackendRecord *, SyncContext *) override { return nullptr; }
+    bool recordsEqual(PilotRecord *, BackendRecord *) const override { return false; }
+    QString palmRecordDescription(PilotRecord *) const override { return QString(); }
+
+private:
+    std::function<bool()> m_hook;
+};
+
+class TestMultiDeviceSync : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Listener Tests ==========
+    void testListenerAcceptsSeveralHandhelds();
+    void testStopWakesPendingAccept();
+
+    // ========== Dispatch Tests ==========
+    void testHandheldsSyncConcurrently();
+    void testSecondConnectionFromSameHandheldRejected();
+    void testUnknownHandheldRejected();
+
+private:
+    SyncEngine *createMemoEngine(const DeviceFingerprint &fingerprint) const;
+    SyncEngine *createHookEngine(const DeviceFingerprint &fingerprint, std::function<bool()> hook) const;
+    int memoCount(quint32 userId) const;
+
+    QTemporaryDir *m_tempDir;
+};
+
+void TestMultiDeviceSync::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestMultiDeviceSync::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+SyncEngine *TestMultiDeviceSync::createMemoEngine(const DeviceFingerprint &fingerprint) const
+{
+    QString root = m_tempDir->filePath(QString::number(fingerprint.userId));
+    SyncEngine *engine = new SyncEngine();
+    engine->setStateDirectory(root + "/state");
+    engine->setBackend(new LocalFileBackend(root + "/data"));
+    engine->registerConduit(new MemoConduit());
+    return engine;
+}
+
+SyncEngine *TestMultiDeviceSync::createHookEngine(const DeviceFingerprint &fingerprint,
+                                                  std::function<bool()> hook) const
+{
+    QString root = m_tempDir->filePath(QString::number(fingerprint.userId));
+    SyncEngine *engine = new SyncEngine();
+    engine->setStateDirectory(root + "/state");
+    engine->setBackend(new LocalFileBackend(root + "/data"));
+    engine->registerConduit(new HookConduit(std::move(hook)));
+    return engine;
+}
+
+int TestMultiDeviceSync::memoCount(quint32 userId) const
+{
+    QDir memos(m_tempDir->filePath(QString("%1/data/memos").arg(userId)));
+    return memos.entryList({"*.md"}, QDir::Files).size();
+}
+
+// ========== Listener Tests ==========
+
+void TestMultiDeviceSync::testListenerAcceptsSeveralHandhelds()
+{
+    MultiDeviceSync dispatcher;
+    dispatcher.setSyncMode(SyncMode::FullSync);
+    dispatcher.setEngineFactory([this](const DeviceFingerprint &fp) { return createMemoEngine(fp); });
+    QSignalSpy finishedSpy(&dispatcher, &MultiDeviceSync::deviceFinished);
+
+    LoopbackAcceptor *acceptor = new LoopbackAcceptor();
+    HotSyncListener listener(acceptor);
+    connect(&listener, &HotSyncListener::linkAccepted, &dispatcher, &MultiDeviceSync::handleLink);
+    QVERIFY(listener.start());
+    QVERIFY(listener.isListening());
+
+    acceptor->connectClient("Alice", 1, 20);
+    acceptor->connectClient("Bob", 2, 30);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 2, 10000);
+
+    for (const QList<QVariant> &args : finishedSpy) {
+        QVERIFY(args.at(1).value<SyncResult>().success);
+    }
+    QCOMPARE(listener.acceptedCount(), 2);
+
+    // Each handheld synced into its own engine and folder
+    DeviceFingerprint alice{1, "Alice"};
+    DeviceFingerprint bob{2, "Bob"};
+    QVERIFY(dispatcher.engine(alice));
+    QVERIFY(dispatcher.engine(bob));
+    QVERIFY(dispatcher.engine(alice) != dispatcher.engine(bob));
+    QCOMPARE(memoCount(1), 20);
+    QCOMPARE(memoCount(2), 30);
+
+    listener.stop();
+    QVERIFY(!listener.isListening());
+}
+
+void TestMultiDeviceSync::testStopWakesPendingAccept()
+{
+    HotSyncListener listener(new LoopbackAcceptor());
+    QSignalSpy stoppedSpy(&listener, &HotSyncListener::stopped);
+    QVERIFY(listener.start());
+
+    QElapsedTimer timer;
+    timer.start();
+    listener.stop();
+    QVERIFY(timer.elapsed() < 2000);
+    QCOMPARE(stoppedSpy.count(), 1);
+    QCOMPARE(listener.acceptedCount(), 0);
+}
+
+// ========== Dispatch Tests ==========
+
+void TestMultiDeviceSync::testHandheldsSyncConcurrently()
+{
+    // Each sync waits for the other one to start; run one after the
+    // other, the first would give up waiting and fail
+    QAtomicInt started;
+    auto rendezvous = [&started]() {
+        started.fetchAndAddOrdered(1);
+        QDeadlineTimer deadline(5000);
+        while (started.loadAcquire() < 2) {
+            if (deadline.hasExpired()) {
+                return false;
+            }
+            QThread::msleep(5);
+        }
+        return true;
+    };
+
+    MultiDeviceSync dispatcher;
+    dispatcher.setEngineFactory([this, rendezvous](const DeviceFingerprint &fp) {
+        return createHookEngine(fp, rendezvous);
+    });
+    QSignalSpy finishedSpy(&dispatcher, &MultiDeviceSync::deviceFinished);
+
+    dispatcher.handleLink(LoopbackAcceptor::createLink({"Alice", 1, 5}));
+    dispatcher.handleLink(LoopbackAcceptor::createLink({"Bob", 2, 5}));
+    QVERIFY(dispatcher.waitForDone(10000));
+
+    QCOMPARE(finishedSpy.count(), 2);
+    for (const QList<QVariant> &args : finishedSpy) {
+        QVERIFY(args.at(1).value<SyncResult>().success);
+    }
+    QVERIFY(dispatcher.activeDevices().isEmpty());
+}
+
+void TestMultiDeviceSync::testSecondConnectionFromSameHandheldRejected()
+{
+    QSemaphore entered;
+    QSemaphore gate;
+    MultiDeviceSync dispatcher;
+    dispatcher.setEngineFactory([this, &entered, &gate](const DeviceFingerprint &fp) {
+        return createHookEngine(fp, [&entered, &gate]() {
+            entered.release();
+            return gate.tryAcquire(1, 10000);
+        });
+    });
+    QSignalSpy finishedSpy(&dispatcher, &MultiDeviceSync::deviceFinished);
+    QSignalSpy rejectedSpy(&dispatcher, &MultiDeviceSync::deviceRejected);
+
+    dispatcher.handleLink(LoopbackAcceptor::createLink({"Alice", 1, 5}));
+    QVERIFY(entered.tryAcquire(1, 5000));
+    QCOMPARE(dispatcher.activeDevices().size(), 1);
+
+    dispatcher.handleLink(LoopbackAcceptor::createLink({"Alice", 1, 5}));
+    QTRY_COMPARE(rejectedSpy.count(), 1);
+    QCOMPARE(rejectedSpy.at(0).at(0).value<DeviceFingerprint>().userId, quint32(1));
+
+    gate.release();
+    QVERIFY(dispatcher.waitForDone(5000));
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(finishedSpy.at(0).at(1).value<SyncResult>().success);
+}
+
+void TestMultiDeviceSync::testUnknownHandheldRejected()
+{
+    MultiDeviceSync dispatcher;
+    dispatcher.setEngineFactory([this](const DeviceFingerprint &fp) -> SyncEngine* {
+        return fp.userId == 99 ? nullptr : createMemoEngine(fp);
+    });
+    QSignalSpy finishedSpy(&dispatcher, &MultiDeviceSync::deviceFinished);
+    QSignalSpy rejectedSpy(&dispatcher, &MultiDeviceSync::deviceRejected);
+
+    dispatcher.handleLink(LoopbackAcceptor::createLink({"Mallory", 99, 5}));
+    QVERIFY(dispatcher.waitForDone(5000));
+
+    QCOMPARE(rejectedSpy.count(), 1);
+    QCOMPARE(finishedSpy.count(), 0);
+    QVERIFY(!dispatcher.engine(DeviceFingerprint{99, "Mallory"}));
+}
+
+QTEST_MAIN(TestMultiDeviceSync)
+#include "test_multidevicesync.moc"
@@ -0,0 +1,363 @@
+/**
+ * @file test_palmdbgenerator.cpp
+ * @brief Unit tests for PalmDbGenerator
+ *
+ * Tests that synthetic databases are reproducible, follow the requested
+ * shape, survive a .pdb round trip and sync like device data.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include "palm/palmdbgenerator.h"
+#include "palm/categoryinfo.h"
+#include "sync/syncengine.h"
+#include "sync/localfilebackend.h"
+#include "sync/conduits/memoconduit.h"
+
+using namespace Sync;
+
+class TestPalmDbGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // ========== Reproducibility Tests ==========
+    void testSameSeedSameDatabase();
+    void testDifferentSeedDifferentDatabase();
+    void testResetRestartsSequence();
+
+    // ========== Shape Tests ==========
+    void testRecordCountAndIds();
+    void testCategoriesInRange();
+    void testAppBlockNamesCategories();
+    void testDirtyAndDeletedRatios();
+    void testTextLengthBounds();
+    void testCp1252Mix();
+    void testRepeatingEventsWithExceptions();
+    void testKindNames();
+
+    // ========== Output Tests ==========
+    void testAllKindsUnpack();
+    void testPdbRoundTrip();
+    void testPdbIsReproducible();
+    void testGeneratedDatabaseSyncs();
+
+private:
+    QTemporaryDir *m_tempDir;
+};
+
+void TestPalmDbGenerator::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestPalmDbGenerator::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+// ========== Reproducibility Tests ==========
+
+void TestPalmDbGenerator::testSameSeedSameDatabase()
+{
+    GeneratorOptions options;
+    options.seed = 42;
+    options.records = 200;
+
+    MemoryDatabase a = PalmDbGenerator(options).database(PalmDbGenerator::Address);
+    MemoryDatabase b = PalmDbGenerator(options).database(PalmDbGenerator::Address);
+
+    QCOMPARE(a.records.size(), b.records.size());
+    for (int i = 0; i < a.records.size(); ++i) {
+        QCOMPARE(a.records.at(i).data(), b.records.at(i).data());
+        QCOMPARE(a.records.at(i).attributes(), b.records.at(i).attributes());
+        QCOMPARE(a.records.at(i).category(), b.records.at(i).category());
+    }
+}
+
+void TestPalmDbGenerator::testDifferentSeedDifferentDatabase()
+{
+    GeneratorOptions options;
+    options.records = 50;
+    options.seed = 1;
+    MemoryDatabase a = PalmDbGenerator(options).database(PalmDbGenerator::Memo);
+    options.seed = 2;
+    MemoryDatabase b = PalmDbGenerator(options).database(PalmDbGenerator::Memo);
+
+    int same = 0;
+    for (int i = 0; i < a.records.size(); ++i) {
+        if (a.records.at(i).data() == b.records.at(i).data()) {
+            same++;
+        }
+    }
+    QVERIFY(same < a.records.size());
+}
+
+void TestPalmDbGenerator::testResetRestartsSequence()
+{
+    PalmDbGenerator generator;
+    QString first = generator.memo(1).text;
+    generator.memo(2);
+    generator.reset();
+    QCOMPARE(generator.memo(1).text, first);
+}
+
+// ========== Shape Tests ==========
+
+void TestPalmDbGenerator::testRecordCountAndIds()
+{
+    GeneratorOptions options;
+    options.records = 300;
+    MemoryDatabase db = PalmDbGenerator(options).database(PalmDbGenerator::Todo);
+
+    QCOMPARE(db.name, QString("ToDoDB"));
+    QCOMPARE(db.records.size(), 300);
+    QCOMPARE(db.records.first().id(), PalmDbGenerator::FIRST_RECORD_ID);
+    QCOMPARE(db.records.last().id(), PalmDbGenerator::FIRST_RECORD_ID + 299);
+    QCOMPARE(db.nextRecordId, quint32(PalmDbGenerator::FIRST_RECORD_ID + 300));
+    QCOMPARE(db.creator, quint32(0x746f646f));   // 'todo'
+}
+
+void TestPalmDbGenerator::testCategoriesInRange()
+{
+    GeneratorOptions options;
+    options.records = 500;
+    options.categories = 3;
+    MemoryDatabase db = PalmDbGenerator(options).database(PalmDbGenerator::Memo);
+
+    QSet<int> seen;
+    for (const PilotRecord &record : db.records) {
+        QVERIFY(record.category() >= 0 && record.category() < 3);
+        seen.insert(record.category());
+    }
+    QCOMPARE(seen.size(), 3);
+}
+
+void TestPalmDbGenerator::testAppBlockNamesCategories()
+{
+    GeneratorOptions options;
+    options.categories = 9;
+    QByteArray block = PalmDbGenerator(options).appBlock();
+
+    CategoryInfo info;
+    QVERIFY(info.parse(reinterpret_cast<const unsigned char*>(block.constData()), block.size()));
+    QCOMPARE(info.categoryName(0), QString("Unfiled"));
+    QCOMPARE(info.categoryName(1), QString("Business"));
+    QCOMPARE(info.categoryName(8), QString("Category 8"));
+    QVERIFY(info.categoryName(9).isEmpty());
+}
+
+void TestPalmDbGenerator::testDirtyAndDeletedRatios()
+{
+    GeneratorOptions options;
+    options.records = 2000;
+    options.dirtyRatio = 0.25;
+    options.deletedRatio = 0.1;
+    MemoryDatabase db = PalmDbGenerator(options).database(PalmDbGenerator::Datebook);
+
+    int dirty = 0;
+    int deleted = 0;
+    for (const PilotRecord &record : db.records) {
+        if (record.isDeleted()) {
+            deleted++;
+            QVERIFY(record.isDirty());
+        }
+        if (record.isDirty()) {
+            dirty++;
+        }
+    }
+
+    // Deleted records count as dirty: about 10% + 90% * 25%
+    QVERIFY2(deleted > 140 && deleted < 260, qPrintable(QString::number(deleted)));
+    QVERIFY2(dirty > 560 && dirty < 740, qPrintable(QString::number(dirty)));
+
+    options.dirtyRatio = 0.0;
+    options.deletedRatio = 0.0;
+    for (const PilotRecord &record : PalmDbGenerator(options).database(PalmDbGenerator::Memo).records) {
+        QVERIFY(!record.isDirty());
+        QVERIFY(!record.isDeleted());
+    }
+}
+
+void TestPalmDbGenerator::testTextLengthBounds()
+{
+    GeneratorOptions options;
+    options.minTextLength = 50;
+    options.maxTextLength = 60;
+
+    PalmDbGenerator generator(options);
+    for (int i = 0; i < 100; ++i) {
+        QString text = generator.memo(i + 1).text;
+        QString body = text.mid(text.indexOf('\n') + 1);
+        QVERIFY(body.size() >= 50);
+        QVERIFY(body.size() <= 60);
+    }
+}
+
+void TestPalmDbGenerator::testCp1252Mix()
+{
+    GeneratorOptions options;
+    options.cp1252Ratio = 1.0;
+    PalmDbGenerator generator(options);
+
+    // Every word is accented but representable, so the Palm round trip is lossless
+    MemoMapper::Memo memo = generator.memo(1);
+    QVERIFY(memo.text.contains(QRegularExpression("[^\\x00-\\x7f]")));
+
+    PilotRecord *record = MemoMapper::packMemo(memo);
+    QCOMPARE(MemoMapper::unpackMemo(record).text, memo.text);
+    delete record;
+
+    options.cp1252Ratio = 0.0;
+    options.unencodableRatio = 1.0;
+    MemoMapper::Memo lossy = PalmDbGenerator(options).memo(1);
+    record = MemoMapper::packMemo(lossy);
+    QVERIFY(MemoMapper::unpackMemo(record).text != lossy.text);
+    delete record;
+}
+
+void TestPalmDbGenerator::testRepeatingEventsWithExceptions()
+{
+    GeneratorOptions options;
+    options.repeatRatio = 1.0;
+    options.maxExceptions = 5;
+    PalmDbGenerator generator(options);
+
+    int withExceptions = 0;
+    for (int i = 0; i < 100; ++i) {
+        CalendarMapper::Event event = generator.event(i + 1);
+        QVERIFY(event.repeatType != CalendarMapper::RepeatNone);
+        QVERIFY(event.exceptions.size() <= 5);
+        if (!event.exceptions.isEmpty()) {
+            withExceptions++;
+        }
+
+        PilotRecord *record = CalendarMapper::packEvent(event);
+        QVERIFY(record);
+        CalendarMapper::Event unpacked = CalendarMapper::unpackEvent(record);
+        QCOMPARE(unpacked.repeatType, event.repeatType);
+        QCOMPARE(unpacked.exceptions.size(), event.exceptions.size());
+        delete record;
+    }
+    QVERIFY(withExceptions > 50);
+}
+
+void TestPalmDbGenerator::testKindNames()
+{
+    PalmDbGenerator::Kind kind;
+    QVERIFY(PalmDbGenerator::kindFromName("address", &kind));
+    QCOMPARE(kind, PalmDbGenerator::Address);
+    QVERIFY(PalmDbGenerator::kindFromName("DatebookDB", &kind));
+    QCOMPARE(kind, PalmDbGenerator::Datebook);
+    QVERIFY(!PalmDbGenerator::kindFromName("expenses", &kind));
+}
+
+// ========== Output Tests ==========
+
+void TestPalmDbGenerator::testAllKindsUnpack()
+{
+    GeneratorOptions options;
+    options.records = 100;
+    options.cp1252Ratio = 0.3;
+
+    for (PalmDbGenerator::Kind kind : PalmDbGenerator::allKinds()) {
+        MemoryDatabase db = PalmDbGenerator(options).database(kind);
+        QCOMPARE(db.records.size(), 100);
+        for (const PilotRecord &record : db.records) {
+            QVERIFY(record.size() > 0);
+        }
+    }
+
+    PalmDbGenerator generator(options);
+    ContactMapper::Contact contact = generator.contact(1);
+    PilotRecord *record = ContactMapper::packContact(contact);
+    ContactMapper::Contact unpacked = ContactMapper::unpackContact(record);
+    QCOMPARE(unpacked.lastName, contact.lastName);
+    QCOMPARE(unpacked.phone1, contact.phone1);
+    delete record;
+}
+
+void TestPalmDbGenerator::testPdbRoundTrip()
+{
+    GeneratorOptions options;
+    options.records = 250;
+    options.dirtyRatio = 0.5;
+    PalmDbGenerator generator(options);
+    MemoryDatabase db = generator.database(PalmDbGenerator::Address);
+
+    QString path = m_tempDir->filePath("AddressDB.pdb");
+    QString error;
+    QVERIFY2(generator.writePdb(db, path, &error), qPrintable(error));
+
+    KPilotMemoryLink link;
+    QVERIFY(link.loadDatabaseFile(path));
+    const MemoryDatabase *loaded = link.database("AddressDB");
+    QVERIFY(loaded);
+    QCOMPARE(loaded->creator, db.creator);
+    QCOMPARE(loaded->records.size(), db.records.size());
+    QCOMPARE(loaded->appBlock.left(64), db.appBlock.left(64));
+    for (int i = 0; i < db.records.size(); ++i) {
+        QCOMPARE(loaded->records.at(i).id(), db.records.at(i).id());
+        QCOMPARE(loaded->records.at(i).data(), db.records.at(i).data());
+        QCOMPARE(loaded->records.at(i).isDirty(), db.records.at(i).isDirty());
+    }
+}
+
+void TestPalmDbGenerator::testPdbIsReproducible()
+{
+    GeneratorOptions options;
+    options.records = 50;
+    PalmDbGenerator generator(options);
+    MemoryDatabase db = generator.database(PalmDbGenerator::Memo);
+
+    QString first = m_tempDir->filePath("first.pdb");
+    QString second = m_tempDir->filePath("second.pdb");
+    QVERIFY(generator.writePdb(db, first));
+    QVERIFY(generator.writePdb(db, second));
+
+    QFile firstFile(first);
+    QFile secondFile(second);
+    QVERIFY(firstFile.open(QIODevice::ReadOnly));
+    QVERIFY(secondFile.open(QIODevice::ReadOnly));
+    QByteArray data = firstFile.readAll();
+    QCOMPARE(data, secondFile.readAll());
+
+    // Creation date in the header: seconds since 1904, not the current time
+    QVERIFY(data.size() > 40);
+    QCOMPARE(qFromBigEndian<quint32>(data.constData() + 36), 3786912000u);
+}
+
+void TestPalmDbGenerator::testGeneratedDatabaseSyncs()
+{
+    GeneratorOptions options;
+    options.records = 400;
+    options.cp1252Ratio = 0.2;
+
+    KPilotMemoryLink link;
+    link.addDatabase(PalmDbGenerator(options).database(PalmDbGenerator::Memo));
+    QVERIFY(link.openConnection());
+
+    SyncEngine engine;
+    engine.setStateDirectory(m_tempDir->filePath("state"));
+    engine.setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    engine.registerConduit(new MemoConduit());
+    engine.setDeviceLink(&link);
+
+    SyncResult result = engine.syncAll(SyncMode::FullSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 400);
+
+    QDir memos(m_tempDir->filePath("data/memos"));
+    QCOMPARE(memos.entryList({"*.md"}, QDir::Files).size(), 400);
+}
+
+QTEST_MAIN(TestPalmDbGenerator)
+#include "test_palmdbgenerator.moc"
@@ -9,11 +9,83 @@
 #include <QtTest/QtTest>
 #include <QDebug>
 #include <QTemporaryDir>
+#include <QSemaphore>
+#include <QThread>
+#include <QMutex>
 #include "sync/syncengine.h"
 #include "sync/localfilebackend.h"
+#include "palm/kpilotmemorylink.h"
+#include "palm/palmdbgenerator.h"
+#include "sync/conduits/memoconduit.h"
+#include "sync/conduits/contactconduit.h"
 
 using namespace Sync;
 
+/**
+ * @brief Conduit that records when it ran and runs a hook instead of syncing
+ */
+class ScriptedConduit : public Conduit
+{
+public:
+    ScriptedConduit(const QString &id, bool device, QStringList *log, QMutex *logMutex)
+        : m_id(id), m_device(device), m_log(log), m_logMutex(logMutex) {}
+
+    QString conduitId() const override { return m_id; }
+    QString displayName() const override { return m_id; }
+    QString palmDatabaseName() const override { return QString(); }
+    QString fileExtension() const override { return QString(); }
+    bool requiresDevice() const override { return m_device; }
+    QStringList runBefore() const override { return before; }
+
+    SyncResult sync(SyncContext *) override {
+        record("start:" + m_id);
+        SyncResult result;
+        result.success = hook ? hook() : true;
+        result.pcStats.created = 1;
+        record("end:" + m_id);
+        return result;
+    }
+
+    BackendRecord* palmToBackend(PilotRecord *, SyncContext *) override { return nullptr; }
+    PilotRecord* backendToPalm(BackendRecord *, SyncContext *) override { return nullptr; }
+    bool recordsEqual(PilotRecord *, BackendRecord *) const override { return false; }
+    QString palmRecordDescription(PilotRecord *) const override { return QString(); }
+
+    std::function<bool()> hook;
+    QStringList before;
+
+private:
+    void record(const QString &event) {
+        QMutexLocker locker(m_logMutex);
+        m_log->append(event);
+    }
+
+    QString m_id;
+    bool m_device;
+    QStringList *m_log;
+    QMutex *m_logMutex;
+};
+
+/**
+ * @brief LocalFileBackend that remembers which threads loaded each collection
+ */
+class ThreadTrackingBackend : public LocalFileBackend
+{
+public:
+    using LocalFileBackend::LocalFileBackend;
+
+    QList<BackendRecord*> loadRecords(const QString &collectionId) override {
+        {
+            QMutexLocker locker(&mutex);
+            loadThreads[collectionId].append(QThread::currentThread());
+        }
+        return LocalFileBackend::loadRecords(collectionId);
+    }
+
+    QMutex mutex;
+    QMap<QString, QList<QThread*>> loadThreads;
+};
+
 class TestSyncEngine : public QObject
 {
     Q_OBJECT
@@ -45,6 +117,12 @@ private slots:
     void testSetProgressCallback();
     void testSetCancelCheck();
 
+    // ========== Scheduling Tests ==========
+    void testDeviceFreeConduitRunsConcurrently();
+    void testDeviceFreeConduitRespectsRunBefore();
+    void testDeviceConduitsStaySequential();
+    void testNextConduitPrefetched();
+
 private:
     QTemporaryDir *m_tempDir;
     SyncEngine *m_engine;
@@ -172,5 +250,107 @@ void TestSyncEngine::testSetCancelCheck()
     QVERIFY(true);
 }
 
+// ========== Scheduling Tests ==========
+
+void TestSyncEngine::testDeviceFreeConduitRunsConcurrently()
+{
+    KPilotMemoryLink link;
+    QVERIFY(link.openConnection());
+    m_engine->setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    m_engine->setDeviceLink(&link);
+
+    QStringList log;
+    QMutex logMutex;
+    QSemaphore released;
+
+    // The background conduit can only succeed while the device conduit runs
+    auto *web = new ScriptedConduit("web", false, &log, &logMutex);
+    web->hook = [&]() { return released.tryAcquire(1, 5000); };
+    auto *device = new ScriptedConduit("device", true, &log, &logMutex);
+    device->hook = [&]() { released.release(); return true; };
+
+    m_engine->registerConduit(web);
+    m_engine->registerConduit(device);
+
+    SyncResult result = m_engine->syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 2);
+    QCOMPARE(result.timings.size(), 2);
+    QCOMPARE(log.size(), 4);
+}
+
+void TestSyncEngine::testDeviceFreeConduitRespectsRunBefore()
+{
+    KPilotMemoryLink link;
+    QVERIFY(link.openConnection());
+    m_engine->setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    m_engine->setDeviceLink(&link);
+
+    QStringList log;
+    QMutex logMutex;
+
+    auto *web = new ScriptedConduit("web", false, &log, &logMutex);
+    web->before = {"calendar"};
+    web->hook = []() { QThread::msleep(50); return true; };
+    m_engine->registerConduit(web);
+    m_engine->registerConduit(new ScriptedConduit("calendar", true, &log, &logMutex));
+    m_engine->registerConduit(new ScriptedConduit("memos", true, &log, &logMutex));
+
+    SyncResult result = m_engine->syncAll(SyncMode::HotSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 3);
+    QVERIFY(log.indexOf("end:web") < log.indexOf("start:calendar"));
+}
+
+void TestSyncEngine::testDeviceConduitsStaySequential()
+{
+    KPilotMemoryLink link;
+    QVERIFY(link.openConnection());
+    m_engine->setBackend(new LocalFileBackend(m_tempDir->filePath("data")));
+    m_engine->setDeviceLink(&link);
+
+    QStringList log;
+    QMutex logMutex;
+    m_engine->registerConduit(new ScriptedConduit("a", true, &log, &logMutex));
+    m_engine->registerConduit(new ScriptedConduit("b", true, &log, &logMutex));
+    m_engine->registerConduit(new ScriptedConduit("c", true, &log, &logMutex));
+
+    QVERIFY(m_engine->syncAll(SyncMode::HotSync).success);
+    QCOMPARE(log, QStringList({"start:a", "end:a", "start:b", "end:b", "start:c", "end:c"}));
+}
+
+void TestSyncEngine::testNextConduitPrefetched()
+{
+    GeneratorOptions options;
+    options.records = 50;
+
+    KPilotMemoryLink link;
+    link.addDatabase(PalmDbGenerator(options).database(PalmDbGenerator::Address));
+    link.addDatabase(PalmDbGenerator(options).database(PalmDbGenerator::Memo));
+    QVERIFY(link.openConnection());
+
+    auto *backend = new ThreadTrackingBackend(m_tempDir->filePath("data"));
+    m_engine->setBackend(backend);
+    m_engine->setDeviceLink(&link);
+    m_engine->registerConduit(new ContactConduit());
+    m_engine->registerConduit(new MemoConduit());
+
+    // Contacts run first, so memos are loaded on the prefetch thread
+    SyncResult result = m_engine->syncAll(SyncMode::FullSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 100);
+
+    QVERIFY(!backend->loadThreads.value("contacts").isEmpty());
+    QCOMPARE(backend->loadThreads.value("contacts").first(), QThread::currentThread());
+    QVERIFY(!backend->loadThreads.value("memos").isEmpty());
+    QVERIFY(backend->loadThreads.value("memos").first() != QThread::currentThread());
+
+    // Second run prefetches the 50 memo files; none may be missed and recreated
+    result = m_engine->syncAll(SyncMode::FullSync);
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(QDir(m_tempDir->filePath("data/memos")).entryList({"*.md"}, QDir::Files).size(), 50);
+}
+
 QTEST_MAIN(TestSyncEngine)
 #include "test_syncengine.moc"
@@ -0,0 +1,199 @@
+/**
+ * @file test_synclog.cpp
+ * @brief Unit tests for categorized logging and the rotating sync log
+ *
+ * Tests that SyncLogWriter writes and rotates files, that categorized
+ * messages reach the profile log, and that disabled debug output is never
+ * formatted.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "synclog.h"
+
+namespace {
+
+// Counts how often it is formatted into a log message
+struct FormatCounter
+{
+    int *count;
+};
+
+QDebug operator<<(QDebug debug, const FormatCounter &counter)
+{
+    ++*counter.count;
+    return debug << "counted";
+}
+
+QStringList readLines(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+} // namespace
+
+class TestSyncLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    // ========== Writer Tests ==========
+    void testWriterAppendsLines();
+    void testWriterRotates();
+    void testWriterFromManyThreads();
+
+    // ========== Routing Tests ==========
+    void testFormatLine();
+    void testCategoriesReachProfileLog();
+    void testDisabledDebugIsNotFormatted();
+    void testCloseStopsWriting();
+};
+
+void TestSyncLog::initTestCase()
+{
+    SyncLog::install();
+}
+
+void TestSyncLog::cleanup()
+{
+    SyncLog::closeProfileLog();
+    SyncLog::setDebugEnabled(false);
+}
+
+// ========== Writer Tests ==========
+
+void TestSyncLog::testWriterAppendsLines()
+{
+    QTemporaryDir dir;
+    QString path = dir.filePath("logs/sync.log");
+    {
+        SyncLogWriter writer(path);
+        writer.write("first");
+        writer.write("second");
+        writer.flush();
+        QCOMPARE(readLines(path), QStringList({"first", "second"}));
+    }
+
+    // A new writer appends to the existing file
+    SyncLogWriter writer(path);
+    writer.write("third");
+    writer.flush();
+    QCOMPARE(readLines(path), QStringList({"first", "second", "third"}));
+}
+
+void TestSyncLog::testWriterRotates()
+{
+    QTemporaryDir dir;
+    QString path = dir.filePath("sync.log");
+    SyncLogWriter writer(path, 100, 3);
+    QCOMPARE(writer.rotatedFilePath(2), dir.filePath("sync.2.log"));
+
+    // 20 lines of 50 bytes: two lines per file
+    QString line(49, 'x');
+    for (int i = 0; i < 20; ++i) {
+        writer.write(line);
+    }
+    writer.flush();
+
+    QVERIFY(QFile::exists(path));
+    QVERIFY(QFile::exists(dir.filePath("sync.1.log")));
+    QVERIFY(QFile::exists(dir.filePath("sync.2.log")));
+    QVERIFY(!QFile::exists(dir.filePath("sync.3.log")));
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(QFileInfo(writer.rotatedFilePath(i)).size() <= 100);
+    }
+}
+
+void TestSyncLog::testWriterFromManyThreads()
+{
+    QTemporaryDir dir;
+    QString path = dir.filePath("sync.log");
+    SyncLogWriter writer(path);
+
+    QList<QThread*> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.append(QThread::create([&writer, t]() {
+            for (int i = 0; i < 100; ++i) {
+                writer.write(QString("thread %1 line %2").arg(t).arg(i));
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : threads) {
+        QVERIFY(thread->wait(5000));
+        delete thread;
+    }
+    writer.flush();
+
+    QCOMPARE(readLines(path).size(), 400);
+    QCOMPARE(writer.droppedLines(), 0);
+}
+
+// ========== Routing Tests ==========
+
+void TestSyncLog::testFormatLine()
+{
+    QString line = SyncLog::formatLine(QtWarningMsg, "qpilotsync.link", "socket closed");
+    QVERIFY(line.endsWith(" W link: socket closed"));
+
+    line = SyncLog::formatLine(QtInfoMsg, "default", "hello");
+    QVERIFY(line.endsWith(" I default: hello"));
+}
+
+void TestSyncLog::testCategoriesReachProfileLog()
+{
+    QTemporaryDir dir;
+    QVERIFY(SyncLog::openProfileLog(dir.path()));
+    QString path = SyncLog::currentLogFile();
+    QCOMPARE(path, dir.filePath("sync.log"));
+
+    qCInfo(lcConduit) << "conduit info";
+    qCWarning(lcBackend) << "backend warning";
+    qCDebug(lcState) << "state debug, off by default";
+    qDebug() << "uncategorized debug";
+    SyncLog::closeProfileLog();
+
+    QStringList lines = readLines(path);
+    QCOMPARE(lines.size(), 2);
+    QVERIFY(lines.at(0).contains("I conduit: conduit info"));
+    QVERIFY(lines.at(1).contains("W backend: backend warning"));
+}
+
+void TestSyncLog::testDisabledDebugIsNotFormatted()
+{
+    int count = 0;
+    QVERIFY(!lcLink().isDebugEnabled());
+    qCDebug(lcLink) << FormatCounter{&count};
+    QCOMPARE(count, 0);
+
+    SyncLog::setDebugEnabled(true);
+    QVERIFY(lcLink().isDebugEnabled());
+    qCDebug(lcLink) << FormatCounter{&count};
+    QCOMPARE(count, 1);
+}
+
+void TestSyncLog::testCloseStopsWriting()
+{
+    QTemporaryDir dir;
+    SyncLog::openProfileLog(dir.path());
+    QString path = SyncLog::currentLogFile();
+    qCInfo(lcLink) << "while open";
+    SyncLog::closeProfileLog();
+    QVERIFY(SyncLog::currentLogFile().isEmpty());
+
+    qCInfo(lcLink) << "after close";
+    QCOMPARE(readLines(path).size(), 1);
+}
+
+QTEST_MAIN(TestSyncLog)
+#include "test_synclog.moc"
@@ -0,0 +1,120 @@
+/**
+ * @file test_tickleworker.cpp
+ * @brief Unit tests for link activity tracking and TickleWorker
+ *
+ * Tests that keep-alives wait for an idle link and never run while a DLP
+ * command is running or queued. The link is never connected, so a tickle that does go
+ * out fails; that is how the tests see it was attempted.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QSemaphore>
+#include <QThread>
+#include "palm/kpilotdevicelink.h"
+#include "palm/tickleworker.h"
+
+class TestTickleWorker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ========== Link Activity Tests ==========
+    void testCommandResetsIdleTime();
+    void testTickleBusyWhileCallInFlight();
+    void testTickleWaitsForIdlePeriod();
+
+    // ========== Worker Tests ==========
+    void testWorkerHoldsOffWhileLinkInUse();
+    void testWorkerReportsLostConnection();
+};
+
+// ========== Link Activity Tests ==========
+
+void TestTickleWorker::testCommandResetsIdleTime()
+{
+    KPilotDeviceLink link("/dev/null");
+    QTest::qWait(50);
+    QVERIFY(link.idleMs() >= 50);
+
+    link.execute([]() {});
+    QVERIFY(link.idleMs() < 50);
+}
+
+void TestTickleWorker::testTickleBusyWhileCallInFlight()
+{
+    KPilotDeviceLink link("/dev/null");
+    QSemaphore held;
+    QSemaphore release;
+
+    // Another thread is in the middle of a DLP call
+    QThread *caller = QThread::create([&]() {
+        link.execute([&]() {
+            held.release();
+            release.acquire();
+        });
+    });
+    caller->start();
+    QVERIFY(held.tryAcquire(1, 5000));
+
+    QCOMPARE(link.tickle(0), KPilotDeviceLink::TickleResult::Busy);
+
+    release.release();
+    QVERIFY(caller->wait(5000));
+    delete caller;
+
+    // Free again; not connected, so the tickle itself fails
+    QCOMPARE(link.tickle(0), KPilotDeviceLink::TickleResult::Failed);
+}
+
+void TestTickleWorker::testTickleWaitsForIdlePeriod()
+{
+    KPilotDeviceLink link("/dev/null");
+    link.execute([]() {});
+    QCOMPARE(link.tickle(10000), KPilotDeviceLink::TickleResult::NotIdle);
+}
+
+// ========== Worker Tests ==========
+
+void TestTickleWorker::testWorkerHoldsOffWhileLinkInUse()
+{
+    KPilotDeviceLink link("/dev/null");
+    TickleWorker worker;
+    worker.setLink(&link);
+    worker.setIdleInterval(100);
+    QSignalSpy failedSpy(&worker, &TickleWorker::tickleFailed);
+
+    // Steady traffic: the link is never idle for a whole interval
+    QTimer traffic;
+    connect(&traffic, &QTimer::timeout, [&link]() {
+        link.execute([]() {});
+    });
+    traffic.start(20);
+    worker.start();
+
+    QTest::qWait(400);
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(worker.ticklesSent(), 0);
+    QVERIFY(worker.ticklesSkipped() > 0);
+
+    // Once traffic stops, a tickle goes out
+    traffic.stop();
+    QTRY_VERIFY_WITH_TIMEOUT(failedSpy.count() > 0, 2000);
+    worker.stop();
+}
+
+void TestTickleWorker::testWorkerReportsLostConnection()
+{
+    KPilotDeviceLink link("/dev/null");
+    TickleWorker worker;
+    worker.setLink(&link);
+    worker.setIdleInterval(10);
+    QSignalSpy lostSpy(&worker, &TickleWorker::connectionLost);
+
+    worker.start();
+    QTRY_COMPARE_WITH_TIMEOUT(lostSpy.count(), 1, 5000);
+    QVERIFY(!worker.isRunning());
+}
+
+QTEST_MAIN(TestTickleWorker)
+#include "test_tickleworker.moc"
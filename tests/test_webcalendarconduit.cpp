@@ -0,0 +1,764 @@
+/**
+ * @file test_webcalendarconduit.cpp
+ * @brief Unit tests for WebCalendarConduit
+ *
+ * Feeds are served from file:// URLs, or from a minimal in-process HTTP
+ * server for the conditional request tests, so no network is needed.
+ */
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "sync/conduits/webcalendarconduit.h"
+#include "sync/conduits/webfeedrefresher.h"
+#include "sync/localfilebackend.h"
+
+using namespace Sync;
+
+/**
+ * @brief Single-threaded HTTP/1.0 stand-in serving one calendar body
+ *
+ * Honours If-None-Match / If-Modified-Since against its current validators
+ * and records the headers of the last request. It runs on the test thread;
+ * the conduit's blocking fetch spins a local event loop that services it.
+ */
+class HttpStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    QByteArray body;
+    QByteArray etag;
+    QByteArray lastModified;
+    int delayMs = 0;                ///< Response delay; negative never responds
+    int truncateAt = -1;            ///< Send only this many body bytes, then stall
+    QByteArray status = "200 OK";   ///< Status line for full responses
+    QMap<QByteArray, QByteArray> lastRequestHeaders;
+    int requestCount = 0;
+    int notModifiedCount = 0;
+    int inFlight = 0;
+    int maxInFlight = 0;
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost); }
+    QUrl url(const QString &path = "/feed.ics") const {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(m_server.serverPort()).arg(path));
+    }
+
+    HttpStandIn()
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                    handle(socket);
+                });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+private:
+    void handle(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        if (!buffer.contains("\r\n\r\n")) {
+            return;  // Headers incomplete
+        }
+
+        requestCount++;
+        lastRequestHeaders.clear();
+        const QList<QByteArray> lines = buffer.left(buffer.indexOf("\r\n\r\n")).split('\n');
+        for (int i = 1; i < lines.size(); ++i) {
+            int colon = lines[i].indexOf(':');
+            if (colon > 0) {
+                lastRequestHeaders.insert(lines[i].left(colon).trimmed().toLower(),
+                                          lines[i].mid(colon + 1).trimmed());
+            }
+        }
+        m_buffers.remove(socket);
+
+        bool etagMatch = !etag.isEmpty()
+            && lastRequestHeaders.value("if-none-match") == etag;
+        bool dateMatch = !lastModified.isEmpty()
+            && !lastRequestHeaders.contains("if-none-match")
+            && lastRequestHeaders.value("if-modified-since") == lastModified;
+
+        QByteArray response;
+        if (etagMatch || dateMatch) {
+            notModifiedCount++;
+            response = "HTTP/1.1 304 Not Modified\r\n";
+        } else {
+            response = "HTTP/1.1 " + status + "\r\nContent-Type: text/calendar\r\n";
+            response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        }
+        if (!etag.isEmpty()) {
+            response += "ETag: " + etag + "\r\n";
+        }
+        if (!lastModified.isEmpty()) {
+            response += "Last-Modified: " + lastModified + "\r\n";
+        }
+        response += "Connection: close\r\n\r\n";
+        if (!(etagMatch || dateMatch)) {
+            response += body;
+        }
+
+        inFlight++;
+        maxInFlight = qMax(maxInFlight, inFlight);
+        if (delayMs < 0) {
+            return;
+        }
+        if (truncateAt >= 0 && !(etagMatch || dateMatch)) {
+            // Full Content-Length announced, but the body stops part-way
+            response.chop(body.size() - truncateAt);
+            socket->write(response);
+            return;
+        }
+        QTimer::singleShot(delayMs, socket, [this, socket, response]() {
+            inFlight--;
+            socket->write(response);
+            socket->disconnectFromHost();
+        });
+    }
+
+    QTcpServer m_server;
+    QMap<QTcpSocket*, QByteArray> m_buffers;
+};
+
+class TestWebCalendarConduit : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // ========== Incremental Split Tests ==========
+    void testFirstFetchCreatesEvents();
+    void testRefetchUnchanged();
+    void testChangedEventUpdated();
+    void testRemovedEventDeleted();
+    void testDuplicateSummariesKeptApart();
+    void testExistingFilesAdopted();
+
+    // ========== Conditional Fetch Tests ==========
+    void testValidatorsStored();
+    void testValidatorsPersistInSettings();
+    void testNotModifiedSkipsWrite();
+    void testLastModifiedOnly();
+    void testChangedFeedRefetched();
+    void testNoConditionalWithoutLocalCopy();
+    void testNotModifiedPrunesExpiredEvents();
+    void testFilterChangeRefetches();
+
+    // ========== Concurrent Fetch Tests ==========
+    void testFeedsFetchedConcurrently();
+    void testConcurrencyLimit();
+    void testStalledFeedTimesOut();
+    void testConcurrencySettings();
+
+    // ========== Streaming Tests ==========
+    void testLargeFeedStreamed();
+    void testTruncatedDownloadKeepsFiles();
+    void testErrorResponseWritesNothing();
+
+    // ========== Background Refresh Tests ==========
+    void testRefreshStagesWithoutTouchingCollection();
+    void testSyncCopiesStagedFeed();
+    void testStagedChangeKeepsFileName();
+    void testStagedRemovalDeletes();
+    void testRefresherWaitsForIdle();
+
+private:
+    QByteArray calendar(const QStringList &events) const;
+    void useHttpFeed(HttpStandIn &server);
+    void useHttpFeeds(HttpStandIn &server, int count);
+    QString event(const QString &uid, const QString &summary,
+                  const QString &dtstart = "20300101T100000Z") const;
+    void writeFeed(const QStringList &events);
+    SyncResult runSync();
+    QStringList feedFiles() const;
+
+    QTemporaryDir *m_tempDir;
+    LocalFileBackend *m_backend;
+    WebCalendarConduit *m_conduit;
+    QString m_feedPath;
+};
+
+void TestWebCalendarConduit::initTestCase()
+{
+    qDebug() << "Starting WebCalendarConduit tests";
+}
+
+void TestWebCalendarConduit::cleanupTestCase()
+{
+    qDebug() << "WebCalendarConduit tests complete";
+}
+
+void TestWebCalendarConduit::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+
+    m_backend = new LocalFileBackend(m_tempDir->filePath("profile"));
+    m_feedPath = m_tempDir->filePath("feed.ics");
+
+    m_conduit = new WebCalendarConduit();
+    m_conduit->setDateFilter(WebCalendarConduit::DateFilter::All);
+
+    WebCalendarFeed feed;
+    feed.name = "Test Feed";
+    feed.url = QUrl::fromLocalFile(m_feedPath);
+    m_conduit->addFeed(feed);
+}
+
+void TestWebCalendarConduit::cleanup()
+{
+    delete m_conduit;
+    m_conduit = nullptr;
+    delete m_backend;
+    m_backend = nullptr;
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestWebCalendarConduit::event(const QString &uid, const QString &summary,
+                                      const QString &dtstart) const
+{
+    return QString("BEGIN:VEVENT\r\nUID:%1\r\nDTSTART:%2\r\nSUMMARY:%3\r\nEND:VEVENT")
+        .arg(uid, dtstart, summary);
+}
+
+QByteArray TestWebCalendarConduit::calendar(const QStringList &events) const
+{
+    QByteArray data = "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//Test//EN\r\n";
+    for (const QString &e : events) {
+        data += e.toUtf8() + "\r\n";
+    }
+    data += "END:VCALENDAR\r\n";
+    return data;
+}
+
+void TestWebCalendarConduit::writeFeed(const QStringList &events)
+{
+    QFile file(m_feedPath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(calendar(events));
+}
+
+void TestWebCalendarConduit::useHttpFeed(HttpStandIn &server)
+{
+    QVERIFY(server.listen());
+
+    WebCalendarFeed feed;
+    feed.name = "Test Feed";
+    feed.url = server.url();
+    m_conduit->setFeeds({feed});
+}
+
+void TestWebCalendarConduit::useHttpFeeds(HttpStandIn &server, int count)
+{
+    QVERIFY(server.listen());
+
+    QList<WebCalendarFeed> feeds;
+    for (int i = 0; i < count; ++i) {
+        WebCalendarFeed feed;
+        feed.name = QString("Feed %1").arg(i);
+        feed.url = server.url(QString("/feed%1.ics").arg(i));
+        feeds.append(feed);
+    }
+    m_conduit->setFeeds(feeds);
+}
+
+SyncResult TestWebCalendarConduit::runSync()
+{
+    SyncContext context;
+    context.backend = m_backend;
+    return m_conduit->sync(&context);
+}
+
+QStringList TestWebCalendarConduit::feedFiles() const
+{
+    QDir dir(m_tempDir->filePath("profile/calendar/Test Feed"));
+    return dir.entryList({"*.ics"}, QDir::Files, QDir::Name);
+}
+
+// ========== Incremental Split Tests ==========
+
+void TestWebCalendarConduit::testFirstFetchCreatesEvents()
+{
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta"), event("c@test", "Gamma")});
+
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 3);
+    QCOMPARE(result.pcStats.updated, 0);
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(feedFiles().size(), 3);
+    QVERIFY(feedFiles().contains("Alpha 2030-01-01.ics"));
+}
+
+void TestWebCalendarConduit::testRefetchUnchanged()
+{
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    runSync();
+
+    QString path = m_tempDir->filePath("profile/calendar/Test Feed/Alpha 2030-01-01.ics");
+    QDateTime before = QFileInfo(path).lastModified();
+
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.updated, 0);
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(result.pcStats.unchanged, 2);
+    QCOMPARE(QFileInfo(path).lastModified(), before);
+}
+
+void TestWebCalendarConduit::testChangedEventUpdated()
+{
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    runSync();
+
+    // Same UID, new title: rewritten in place rather than created again
+    writeFeed({event("a@test", "Alpha Renamed"), event("b@test", "Beta")});
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.updated, 1);
+    QCOMPARE(result.pcStats.unchanged, 1);
+    QCOMPARE(feedFiles().size(), 2);
+
+    QFile file(m_tempDir->filePath("profile/calendar/Test Feed/Alpha 2030-01-01.ics"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll().contains("SUMMARY:Alpha Renamed"));
+}
+
+void TestWebCalendarConduit::testRemovedEventDeleted()
+{
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    runSync();
+
+    writeFeed({event("b@test", "Beta")});
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.deleted, 1);
+    QCOMPARE(result.pcStats.unchanged, 1);
+    QCOMPARE(feedFiles(), QStringList{"Beta 2030-01-01.ics"});
+}
+
+void TestWebCalendarConduit::testDuplicateSummariesKeptApart()
+{
+    // Two distinct events that map to the same human-readable file name
+    writeFeed({event("a@test", "Standup"), event("b@test", "Standup")});
+
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 2);
+    QCOMPARE(feedFiles().size(), 2);
+
+    result = runSync();
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.unchanged, 2);
+}
+
+void TestWebCalendarConduit::testExistingFilesAdopted()
+{
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    runSync();
+
+    // Files from before the index existed are matched by UID, not duplicated
+    QVERIFY(QFile::remove(m_tempDir->filePath("profile/calendar/Test Feed/.feed-index.json")));
+
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.unchanged, 2);
+    QCOMPARE(feedFiles().size(), 2);
+}
+
+// ========== Conditional Fetch Tests ==========
+
+void TestWebCalendarConduit::testValidatorsStored()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.etag = "\"v1\"";
+    server.lastModified = "Wed, 21 Oct 2026 07:28:00 GMT";
+    useHttpFeed(server);
+
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 1);
+    QCOMPARE(m_conduit->feeds().first().etag, QString("\"v1\""));
+    QCOMPARE(m_conduit->feeds().first().lastModified, QString("Wed, 21 Oct 2026 07:28:00 GMT"));
+
+    // Second fetch sends both validators back
+    runSync();
+    QCOMPARE(server.requestCount, 2);
+    QCOMPARE(server.lastRequestHeaders.value("if-none-match"), QByteArray("\"v1\""));
+    QCOMPARE(server.lastRequestHeaders.value("if-modified-since"),
+             QByteArray("Wed, 21 Oct 2026 07:28:00 GMT"));
+}
+
+void TestWebCalendarConduit::testValidatorsPersistInSettings()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    runSync();
+
+    WebCalendarConduit restored;
+    restored.loadSettings(m_conduit->saveSettings());
+    QCOMPARE(restored.feeds().size(), 1);
+    QCOMPARE(restored.feeds().first().etag, QString("\"v1\""));
+    QVERIFY(restored.feeds().first().lastModified.isEmpty());
+    QCOMPARE(restored.feeds().first().dateFilter, QString("all"));
+}
+
+void TestWebCalendarConduit::testNotModifiedSkipsWrite()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha"), event("b@test", "Beta")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    runSync();
+
+    // Server still claims v1 even though the body differs: nothing may be touched
+    server.body = calendar({event("c@test", "Gamma")});
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(server.notModifiedCount, 1);
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(result.pcStats.unchanged, 2);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics", "Beta 2030-01-01.ics"}));
+}
+
+void TestWebCalendarConduit::testLastModifiedOnly()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.lastModified = "Wed, 21 Oct 2026 07:28:00 GMT";
+    useHttpFeed(server);
+    runSync();
+
+    SyncResult result = runSync();
+    QVERIFY(!server.lastRequestHeaders.contains("if-none-match"));
+    QCOMPARE(server.notModifiedCount, 1);
+    QCOMPARE(result.pcStats.unchanged, 1);
+}
+
+void TestWebCalendarConduit::testChangedFeedRefetched()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    runSync();
+
+    server.body = calendar({event("a@test", "Alpha Renamed")});
+    server.etag = "\"v2\"";
+    SyncResult result = runSync();
+    QCOMPARE(server.notModifiedCount, 0);
+    QCOMPARE(result.pcStats.updated, 1);
+    QCOMPARE(m_conduit->feeds().first().etag, QString("\"v2\""));
+}
+
+void TestWebCalendarConduit::testNoConditionalWithoutLocalCopy()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    runSync();
+
+    // Files removed behind our back: a 304 would leave nothing to sync
+    QDir(m_tempDir->filePath("profile/calendar/Test Feed")).removeRecursively();
+
+    SyncResult result = runSync();
+    QVERIFY(!server.lastRequestHeaders.contains("if-none-match"));
+    QCOMPARE(result.pcStats.created, 1);
+    QCOMPARE(feedFiles().size(), 1);
+}
+
+void TestWebCalendarConduit::testNotModifiedPrunesExpiredEvents()
+{
+    // Starts between the two syncs: kept by the first fetch only
+    QDateTime now(QDate(2029, 1, 1), QTime(9, 0));
+    m_conduit->setClock([&now]() { return now; });
+
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha"), event("s@test", "Soon", "20290101T100000")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    m_conduit->setDateFilter(WebCalendarConduit::DateFilter::FutureOnly);
+
+    QCOMPARE(runSync().pcStats.created, 2);
+    now = now.addSecs(2 * 3600);
+
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(server.notModifiedCount, 1);
+    QCOMPARE(result.pcStats.deleted, 1);
+    QCOMPARE(result.pcStats.unchanged, 1);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics"}));
+}
+
+void TestWebCalendarConduit::testFilterChangeRefetches()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha"), event("p@test", "Past", "20000101T100000Z")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+
+    QCOMPARE(runSync().pcStats.created, 2);
+    QCOMPARE(m_conduit->feeds().first().dateFilter, QString("all"));
+
+    // The files on disk were selected by the old filter: a 304 must not keep them
+    m_conduit->setDateFilter(WebCalendarConduit::DateFilter::FutureOnly);
+    SyncResult result = runSync();
+    QVERIFY(!server.lastRequestHeaders.contains("if-none-match"));
+    QCOMPARE(server.notModifiedCount, 0);
+    QCOMPARE(result.pcStats.deleted, 1);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics"}));
+    QCOMPARE(m_conduit->feeds().first().dateFilter, QString("future"));
+
+    // Same filter again: conditional
+    runSync();
+    QCOMPARE(server.notModifiedCount, 1);
+}
+
+// ========== Concurrent Fetch Tests ==========
+
+void TestWebCalendarConduit::testFeedsFetchedConcurrently()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.delayMs = 200;
+    useHttpFeeds(server, 3);
+
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(server.requestCount, 3);
+    QCOMPARE(server.maxInFlight, 3);
+    QCOMPARE(result.pcStats.created, 3);
+    QVERIFY(QFile::exists(m_tempDir->filePath("profile/calendar/Feed 2/Alpha 2030-01-01.ics")));
+}
+
+void TestWebCalendarConduit::testConcurrencyLimit()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    server.delayMs = 100;
+    useHttpFeeds(server, 4);
+    m_conduit->setMaxConcurrentFetches(2);
+
+    SyncResult result = runSync();
+    QCOMPARE(server.requestCount, 4);
+    QCOMPARE(server.maxInFlight, 2);
+    QCOMPARE(result.pcStats.created, 4);
+}
+
+void TestWebCalendarConduit::testStalledFeedTimesOut()
+{
+    HttpStandIn stalled;
+    stalled.delayMs = -1;
+    QVERIFY(stalled.listen());
+
+    HttpStandIn healthy;
+    healthy.body = calendar({event("a@test", "Alpha")});
+    QVERIFY(healthy.listen());
+
+    WebCalendarFeed slowFeed;
+    slowFeed.name = "Slow";
+    slowFeed.url = stalled.url();
+    WebCalendarFeed fastFeed;
+    fastFeed.name = "Fast";
+    fastFeed.url = healthy.url();
+    m_conduit->setFeeds({slowFeed, fastFeed});
+    m_conduit->setFetchTimeout(1);
+
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 1);
+    QCOMPARE(result.warnings.size(), 1);
+    QVERIFY(QFile::exists(m_tempDir->filePath("profile/calendar/Fast/Alpha 2030-01-01.ics")));
+}
+
+void TestWebCalendarConduit::testConcurrencySettings()
+{
+    m_conduit->setMaxConcurrentFetches(6);
+    m_conduit->setFetchTimeout(45);
+
+    WebCalendarConduit restored;
+    restored.loadSettings(m_conduit->saveSettings());
+    QCOMPARE(restored.maxConcurrentFetches(), 6);
+    QCOMPARE(restored.fetchTimeout(), 45);
+
+    restored.setMaxConcurrentFetches(0);
+    QCOMPARE(restored.maxConcurrentFetches(), 1);
+}
+
+// ========== Streaming Tests ==========
+
+void TestWebCalendarConduit::testLargeFeedStreamed()
+{
+    QStringList events;
+    for (int i = 0; i < 3000; ++i) {
+        events.append(event(QString("e%1@test").arg(i), QString("Event %1").arg(i)));
+    }
+
+    HttpStandIn server;
+    server.body = calendar(events);
+    useHttpFeed(server);
+
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 3000);
+    QCOMPARE(result.pcStats.errors, 0);
+    QCOMPARE(feedFiles().size(), 3000);
+}
+
+void TestWebCalendarConduit::testTruncatedDownloadKeepsFiles()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha"), event("b@test", "Beta")});
+    server.etag = "\"v1\"";
+    useHttpFeed(server);
+    runSync();
+    m_conduit->setFetchTimeout(1);
+
+    // New version stalls after its first event: Beta has not arrived yet,
+    // it must not be treated as removed
+    server.body = calendar({event("a@test", "Alpha Renamed"), event("c@test", "Gamma"),
+                            event("b@test", "Beta")});
+    server.etag = "\"v2\"";
+    server.truncateAt = server.body.indexOf("BEGIN:VEVENT", server.body.indexOf("END:VEVENT"));
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.updated, 1);
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics", "Beta 2030-01-01.ics"}));
+    QVERIFY(m_conduit->feeds().first().etag.isEmpty());
+
+    // Complete download afterwards picks up the rest
+    server.truncateAt = -1;
+    result = runSync();
+    QCOMPARE(result.pcStats.created, 1);
+    QCOMPARE(result.pcStats.unchanged, 2);
+    QCOMPARE(feedFiles().size(), 3);
+}
+
+void TestWebCalendarConduit::testErrorResponseWritesNothing()
+{
+    HttpStandIn server;
+    server.body = calendar({event("a@test", "Alpha")});
+    useHttpFeed(server);
+    runSync();
+
+    // A server error page must not be mistaken for an empty feed
+    server.body = "BEGIN:VCALENDAR\r\nEND:VCALENDAR\r\n";
+    server.status = "500 Internal Server Error";
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.deleted, 0);
+    QCOMPARE(result.warnings.size(), 1);
+    QCOMPARE(feedFiles().size(), 1);
+}
+
+// ========== Background Refresh Tests ==========
+
+void TestWebCalendarConduit::testRefreshStagesWithoutTouchingCollection()
+{
+    m_conduit->setStagingDirectory(m_tempDir->filePath("staging"));
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+
+    SyncResult result = m_conduit->refreshStaged();
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 2);
+    QVERIFY(m_conduit->hasStagedChanges());
+    QVERIFY(feedFiles().isEmpty());
+    QCOMPARE(QDir(m_tempDir->filePath("staging/Test Feed")).entryList({"*.ics"}, QDir::Files).size(), 2);
+}
+
+void TestWebCalendarConduit::testSyncCopiesStagedFeed()
+{
+    m_conduit->setStagingDirectory(m_tempDir->filePath("staging"));
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    m_conduit->refreshStaged();
+
+    // The sync must not download: a feed change after the refresh is not seen
+    writeFeed({event("c@test", "Gamma")});
+    QVERIFY(m_conduit->shouldRun(nullptr));
+    SyncResult result = runSync();
+    QVERIFY(result.success);
+    QCOMPARE(result.pcStats.created, 2);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics", "Beta 2030-01-01.ics"}));
+
+    // Nothing left to copy until the next refresh
+    QVERIFY(!m_conduit->hasStagedChanges());
+    QVERIFY(!m_conduit->shouldRun(nullptr));
+}
+
+void TestWebCalendarConduit::testStagedChangeKeepsFileName()
+{
+    // Files from before background refresh was enabled
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    runSync();
+
+    m_conduit->setStagingDirectory(m_tempDir->filePath("staging"));
+    writeFeed({event("a@test", "Alpha Renamed"), event("b@test", "Beta")});
+    m_conduit->refreshStaged();
+
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.created, 0);
+    QCOMPARE(result.pcStats.updated, 1);
+    QCOMPARE(result.pcStats.unchanged, 1);
+    QCOMPARE(feedFiles().size(), 2);
+
+    QFile file(m_tempDir->filePath("profile/calendar/Test Feed/Alpha 2030-01-01.ics"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll().contains("SUMMARY:Alpha Renamed"));
+}
+
+void TestWebCalendarConduit::testStagedRemovalDeletes()
+{
+    m_conduit->setStagingDirectory(m_tempDir->filePath("staging"));
+    writeFeed({event("a@test", "Alpha"), event("b@test", "Beta")});
+    m_conduit->refreshStaged();
+    runSync();
+
+    writeFeed({event("a@test", "Alpha")});
+    m_conduit->refreshStaged();
+    SyncResult result = runSync();
+    QCOMPARE(result.pcStats.deleted, 1);
+    QCOMPARE(feedFiles(), QStringList({"Alpha 2030-01-01.ics"}));
+}
+
+void TestWebCalendarConduit::testRefresherWaitsForIdle()
+{
+    m_conduit->setStagingDirectory(m_tempDir->filePath("staging"));
+    writeFeed({event("a@test", "Alpha")});
+
+    bool idle = false;
+    WebFeedRefresher refresher(m_conduit);
+    refresher.setCheckInterval(1);
+    refresher.setIdleCheck([&idle]() { return idle; });
+    QSignalSpy finished(&refresher, &WebFeedRefresher::refreshFinished);
+
+    // Busy: the first check passes without refreshing
+    refresher.start();
+    QTest::qWait(100);
+    QVERIFY(!refresher.isRefreshing());
+    QCOMPARE(finished.count(), 0);
+
+    // Never fetched, so due as soon as a check finds the app idle
+    idle = true;
+    QVERIFY(finished.wait(5000));
+    QVERIFY(finished.first().first().value<SyncResult>().success);
+    QVERIFY(m_conduit->hasStagedChanges());
+    QVERIFY(feedFiles().isEmpty());
+    refresher.stop();
+}
+
+QTEST_MAIN(TestWebCalendarConduit)
+#include "test_webcalendarconduit.moc"